@@ -7,6 +7,17 @@
 #include <cpprelude/dynamic_array.h>
 #include <cpprelude/stack_array.h>
 #include <cpprelude/priority_queue.h>
+#include <cpprelude/bits.h>
+
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace cpprelude
 {
@@ -534,4 +545,424 @@ namespace cpprelude
 			it = next(it);
 		}
 	}
+
+	//sorted set algorithms, the ranges must be sorted by the comparator and hold no duplicates
+	//the result is appended to the output with insert_back and it's sorted and without duplicates too
+
+	template<typename a_iterator_type, typename b_iterator_type, typename output_type,
+			 typename Comparator = default_less_than<typename a_iterator_type::data_type>>
+	usize
+	sorted_intersection(a_iterator_type a_it, usize a_count, b_iterator_type b_it, usize b_count,
+						output_type& output, Comparator less_than = Comparator())
+	{
+		usize result = 0, i = 0, j = 0;
+		while(i < a_count && j < b_count)
+		{
+			if(less_than(*a_it, *b_it))
+			{
+				++a_it; ++i;
+			}
+			else if(less_than(*b_it, *a_it))
+			{
+				++b_it; ++j;
+			}
+			else
+			{
+				output.insert_back(*a_it);
+				++result;
+				++a_it; ++i;
+				++b_it; ++j;
+			}
+		}
+		return result;
+	}
+
+	template<typename a_iterator_type, typename b_iterator_type, typename output_type,
+			 typename Comparator = default_less_than<typename a_iterator_type::data_type>>
+	usize
+	sorted_union(a_iterator_type a_it, usize a_count, b_iterator_type b_it, usize b_count,
+				 output_type& output, Comparator less_than = Comparator())
+	{
+		usize result = 0, i = 0, j = 0;
+		while(i < a_count && j < b_count)
+		{
+			if(less_than(*a_it, *b_it))
+			{
+				output.insert_back(*a_it);
+				++a_it; ++i;
+			}
+			else if(less_than(*b_it, *a_it))
+			{
+				output.insert_back(*b_it);
+				++b_it; ++j;
+			}
+			else
+			{
+				output.insert_back(*a_it);
+				++a_it; ++i;
+				++b_it; ++j;
+			}
+			++result;
+		}
+
+		for(; i < a_count; ++i, ++a_it, ++result)
+			output.insert_back(*a_it);
+		for(; j < b_count; ++j, ++b_it, ++result)
+			output.insert_back(*b_it);
+		return result;
+	}
+
+	//the elements of a which are not in b
+	template<typename a_iterator_type, typename b_iterator_type, typename output_type,
+			 typename Comparator = default_less_than<typename a_iterator_type::data_type>>
+	usize
+	sorted_difference(a_iterator_type a_it, usize a_count, b_iterator_type b_it, usize b_count,
+					  output_type& output, Comparator less_than = Comparator())
+	{
+		usize result = 0, i = 0, j = 0;
+		while(i < a_count && j < b_count)
+		{
+			if(less_than(*a_it, *b_it))
+			{
+				output.insert_back(*a_it);
+				++result;
+				++a_it; ++i;
+			}
+			else if(less_than(*b_it, *a_it))
+			{
+				++b_it; ++j;
+			}
+			else
+			{
+				++a_it; ++i;
+				++b_it; ++j;
+			}
+		}
+
+		for(; i < a_count; ++i, ++a_it, ++result)
+			output.insert_back(*a_it);
+		return result;
+	}
+
+	namespace details
+	{
+		//index of the first element in [from, count) which isn't less than the value
+		//the step doubles until it passes the value then it binary searches the last step so it costs O(log distance)
+		template<typename iterator_type, typename T, typename Comparator>
+		inline usize
+		_gallop(iterator_type begin_it, usize from, usize count, const T& value, Comparator& less_than)
+		{
+			usize low = from, high = from, step = 1;
+			while(high < count && less_than(*next(begin_it, high), value))
+			{
+				low = high + 1;
+				high += step;
+				step *= 2;
+			}
+
+			if(high > count)
+				high = count;
+
+			while(low < high)
+			{
+				usize mid = low + (high - low) / 2;
+				if(less_than(*next(begin_it, mid), value))
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			return low;
+		}
+
+		//when one range is this many times bigger than the other galloping beats the linear merge
+		constexpr static usize _gallop_ratio = 32;
+	}
+
+	//intersection which searches the large range for every element of the small one
+	//it's O(small * log(large / small)) so it's meant for ranges of skewed sizes, the large range must be contiguous
+	template<typename small_iterator_type, typename large_iterator_type, typename output_type,
+			 typename Comparator = default_less_than<typename small_iterator_type::data_type>>
+	usize
+	galloping_intersection(small_iterator_type small_it, usize small_count, large_iterator_type large_it, usize large_count,
+						   output_type& output, Comparator less_than = Comparator())
+	{
+		usize result = 0, position = 0;
+		for(usize i = 0; i < small_count && position < large_count; ++i, ++small_it)
+		{
+			position = details::_gallop(large_it, position, large_count, *small_it, less_than);
+			if(position < large_count && !less_than(*small_it, *next(large_it, position)))
+			{
+				output.insert_back(*small_it);
+				++result;
+				++position;
+			}
+		}
+		return result;
+	}
+
+	namespace details
+	{
+		template<typename T>
+		inline usize
+		_scalar_intersection(const T* a, usize a_count, const T* b, usize b_count,
+							 usize i, usize j, dynamic_array<T>& output)
+		{
+			usize result = 0;
+			while(i < a_count && j < b_count)
+			{
+				if(a[i] < b[j])
+					++i;
+				else if(b[j] < a[i])
+					++j;
+				else
+				{
+					output.insert_back(a[i]);
+					++result;
+					++i; ++j;
+				}
+			}
+			return result;
+		}
+
+		//block intersection, a block of a is compared against all the rotations of a block of b
+		//then the block with the smaller last element is skipped, both are skipped if they end with the same element
+		inline usize
+		_simd_intersection(const u32* a, usize a_count, const u32* b, usize b_count, dynamic_array<u32>& output)
+		{
+			usize result = 0, i = 0, j = 0;
+
+		#if defined(__AVX2__)
+			const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+			while(i + 8 <= a_count && j + 8 <= b_count)
+			{
+				__m256i a_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				__m256i b_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+				__m256i matches = _mm256_cmpeq_epi32(a_block, b_block);
+				for(usize k = 1; k < 8; ++k)
+				{
+					b_block = _mm256_permutevar8x32_epi32(b_block, rotate);
+					matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(a_block, b_block));
+				}
+
+				u32 mask = u32(_mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+				for(; mask; mask &= mask - 1, ++result)
+					output.insert_back(a[i + lowest_set_bit(mask)]);
+
+				u32 a_last = a[i + 7], b_last = b[j + 7];
+				if(a_last <= b_last)
+					i += 8;
+				if(b_last <= a_last)
+					j += 8;
+			}
+		#elif defined(__SSE2__)
+			while(i + 4 <= a_count && j + 4 <= b_count)
+			{
+				__m128i a_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				__m128i b_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+				__m128i matches = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi32(a_block, b_block),
+								 _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(0, 3, 2, 1)))),
+					_mm_or_si128(_mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(1, 0, 3, 2))),
+								 _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+				u32 mask = u32(_mm_movemask_ps(_mm_castsi128_ps(matches)));
+				for(; mask; mask &= mask - 1, ++result)
+					output.insert_back(a[i + lowest_set_bit(mask)]);
+
+				u32 a_last = a[i + 3], b_last = b[j + 3];
+				if(a_last <= b_last)
+					i += 4;
+				if(b_last <= a_last)
+					j += 4;
+			}
+		#endif
+
+			return result + _scalar_intersection(a, a_count, b, b_count, i, j, output);
+		}
+
+		inline usize
+		_simd_intersection(const u64* a, usize a_count, const u64* b, usize b_count, dynamic_array<u64>& output)
+		{
+			usize result = 0, i = 0, j = 0;
+
+		#if defined(__AVX2__)
+			while(i + 4 <= a_count && j + 4 <= b_count)
+			{
+				__m256i a_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				__m256i b_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+				__m256i matches = _mm256_or_si256(
+					_mm256_or_si256(_mm256_cmpeq_epi64(a_block, b_block),
+									_mm256_cmpeq_epi64(a_block, _mm256_permute4x64_epi64(b_block, _MM_SHUFFLE(0, 3, 2, 1)))),
+					_mm256_or_si256(_mm256_cmpeq_epi64(a_block, _mm256_permute4x64_epi64(b_block, _MM_SHUFFLE(1, 0, 3, 2))),
+									_mm256_cmpeq_epi64(a_block, _mm256_permute4x64_epi64(b_block, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+				u32 mask = u32(_mm256_movemask_pd(_mm256_castsi256_pd(matches)));
+				for(; mask; mask &= mask - 1, ++result)
+					output.insert_back(a[i + lowest_set_bit(mask)]);
+
+				u64 a_last = a[i + 3], b_last = b[j + 3];
+				if(a_last <= b_last)
+					i += 4;
+				if(b_last <= a_last)
+					j += 4;
+			}
+		#elif defined(__SSE4_1__)
+			while(i + 2 <= a_count && j + 2 <= b_count)
+			{
+				__m128i a_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				__m128i b_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+				__m128i matches = _mm_or_si128(_mm_cmpeq_epi64(a_block, b_block),
+											   _mm_cmpeq_epi64(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(1, 0, 3, 2))));
+
+				u32 mask = u32(_mm_movemask_pd(_mm_castsi128_pd(matches)));
+				for(; mask; mask &= mask - 1, ++result)
+					output.insert_back(a[i + lowest_set_bit(mask)]);
+
+				u64 a_last = a[i + 1], b_last = b[j + 1];
+				if(a_last <= b_last)
+					i += 2;
+				if(b_last <= a_last)
+					j += 2;
+			}
+		#endif
+
+			return result + _scalar_intersection(a, a_count, b, b_count, i, j, output);
+		}
+
+		template<typename T>
+		inline usize
+		_integer_intersection(const T* a, usize a_count, const T* b, usize b_count, dynamic_array<T>& output)
+		{
+			output.reserve(a_count < b_count ? a_count : b_count);
+
+			if(a_count * _gallop_ratio < b_count)
+				return galloping_intersection(sequential_iterator<const T>(a), a_count,
+											  sequential_iterator<const T>(b), b_count, output);
+			if(b_count * _gallop_ratio < a_count)
+				return galloping_intersection(sequential_iterator<const T>(b), b_count,
+											  sequential_iterator<const T>(a), a_count, output);
+			return _simd_intersection(a, a_count, b, b_count, output);
+		}
+	}
+
+	//intersection of sorted integers, it gallops when the sizes are skewed and compares blocks with sse2/avx2 otherwise
+	inline usize
+	sorted_intersection(const u32* a, usize a_count, const u32* b, usize b_count, dynamic_array<u32>& output)
+	{
+		return details::_integer_intersection(a, a_count, b, b_count, output);
+	}
+
+	//intersection of sorted integers, it gallops when the sizes are skewed and compares blocks with sse4.1/avx2 otherwise
+	inline usize
+	sorted_intersection(const u64* a, usize a_count, const u64* b, usize b_count, dynamic_array<u64>& output)
+	{
+		return details::_integer_intersection(a, a_count, b, b_count, output);
+	}
+
+	//a sorted range given to the k way set algorithms
+	template<typename iterator_type>
+	struct sorted_run
+	{
+		iterator_type begin_it;
+		usize count;
+	};
+
+	template<typename iterator_type>
+	inline sorted_run<iterator_type>
+	make_sorted_run(iterator_type begin_it, usize count)
+	{
+		return sorted_run<iterator_type>{begin_it, count};
+	}
+
+	//union of k sorted runs, it merges their heads with a priority queue so it's O(n log k)
+	template<typename iterator_type, typename output_type,
+			 typename Comparator = default_less_than<typename iterator_type::data_type>>
+	usize
+	kway_union(const sorted_run<iterator_type>* runs, usize runs_count,
+			   output_type& output, Comparator less_than = Comparator())
+	{
+		using value_type = typename std::remove_const<typename iterator_type::data_type>::type;
+
+		struct run_head
+		{
+			iterator_type it;
+			usize left;
+		};
+
+		auto head_less_than = [&less_than](const run_head& a, const run_head& b) {
+			return less_than(*a.it, *b.it);
+		};
+
+		priority_queue<run_head, decltype(head_less_than)> heads(head_less_than);
+		for(usize i = 0; i < runs_count; ++i)
+			if(runs[i].count > 0)
+				heads.enqueue(run_head{runs[i].begin_it, runs[i].count});
+
+		usize result = 0;
+		value_type last{};
+		while(!heads.empty())
+		{
+			run_head head = heads.front();
+			heads.dequeue();
+
+			//the values come out in order so a duplicate is never less than the last one
+			if(result == 0 || less_than(last, *head.it))
+			{
+				last = *head.it;
+				output.insert_back(last);
+				++result;
+			}
+
+			if(--head.left > 0)
+			{
+				++head.it;
+				heads.enqueue(head);
+			}
+		}
+		return result;
+	}
+
+	//intersection of k sorted runs, it intersects the smallest runs first so the partial result shrinks fast
+	//and it gallops over the runs which are much bigger than the partial result
+	template<typename iterator_type, typename output_type,
+			 typename Comparator = default_less_than<typename iterator_type::data_type>>
+	usize
+	kway_intersection(const sorted_run<iterator_type>* runs, usize runs_count,
+					  output_type& output, Comparator less_than = Comparator())
+	{
+		using value_type = typename std::remove_const<typename iterator_type::data_type>::type;
+
+		if(runs_count == 0)
+			return 0;
+
+		dynamic_array<usize> order;
+		order.reserve(runs_count);
+		for(usize i = 0; i < runs_count; ++i)
+			order.insert_back(i);
+		insertion_sort(order.begin(), order.count(), [runs](usize a, usize b) {
+			return runs[a].count < runs[b].count;
+		});
+
+		const sorted_run<iterator_type>& smallest = runs[order[0]];
+		dynamic_array<value_type> partial, scratch;
+		partial.reserve(smallest.count);
+		auto it = smallest.begin_it;
+		for(usize i = 0; i < smallest.count; ++i, ++it)
+			partial.insert_back(*it);
+
+		for(usize i = 1; i < runs_count && !partial.empty(); ++i)
+		{
+			const sorted_run<iterator_type>& run = runs[order[i]];
+			scratch.clear();
+			if(partial.count() * details::_gallop_ratio < run.count)
+				galloping_intersection(partial.begin(), partial.count(), run.begin_it, run.count, scratch, less_than);
+			else
+				sorted_intersection(partial.begin(), partial.count(), run.begin_it, run.count, scratch, less_than);
+			std::swap(partial, scratch);
+		}
+
+		for(const auto& value: partial)
+			output.insert_back(value);
+		return partial.count();
+	}
 }
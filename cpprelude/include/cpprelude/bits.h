@@ -0,0 +1,127 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace cpprelude
+{
+	namespace details
+	{
+		//count of set bits in the word
+		inline usize
+		popcount(u64 value)
+		{
+		#if defined(__GNUC__)
+			return usize(__builtin_popcountll(value));
+		#else
+			value = value - ((value >> 1) & 0x5555555555555555ULL);
+			value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+			value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			return usize((value * 0x0101010101010101ULL) >> 56);
+		#endif
+		}
+
+		//index of the lowest set bit, the value must not be 0
+		inline usize
+		lowest_set_bit(u64 value)
+		{
+		#if defined(__GNUC__)
+			return usize(__builtin_ctzll(value));
+		#else
+			usize result = 0;
+			if(!(value & 0xFFFFFFFFULL)) { value >>= 32; result += 32; }
+			if(!(value & 0xFFFFULL)) { value >>= 16; result += 16; }
+			if(!(value & 0xFFULL)) { value >>= 8; result += 8; }
+			if(!(value & 0xFULL)) { value >>= 4; result += 4; }
+			if(!(value & 0x3ULL)) { value >>= 2; result += 2; }
+			if(!(value & 0x1ULL)) { result += 1; }
+			return result;
+		#endif
+		}
+
+		//count of bits needed to represent the value, 0 for 0
+		inline usize
+		significant_bits(u64 value)
+		{
+		#if defined(__GNUC__)
+			return value ? 64 - usize(__builtin_clzll(value)) : 0;
+		#else
+			usize result = 0;
+			if(value >> 32) { value >>= 32; result += 32; }
+			if(value >> 16) { value >>= 16; result += 16; }
+			if(value >> 8) { value >>= 8; result += 8; }
+			if(value >> 4) { value >>= 4; result += 4; }
+			if(value >> 2) { value >>= 2; result += 2; }
+			if(value >> 1) { value >>= 1; result += 1; }
+			return result + usize(value);
+		#endif
+		}
+
+		//index of the set bit with the rank in the word, the word must have more than rank set bits
+		inline usize
+		select_bit(u64 value, usize rank)
+		{
+		#if defined(__BMI2__)
+			return lowest_set_bit(_pdep_u64(u64(1) << rank, value));
+		#else
+			//skip whole bytes then clear the lower set bits of the last one
+			usize result = 0;
+			while(true)
+			{
+				usize byte_count = popcount(value & 0xFF);
+				if(rank < byte_count)
+					break;
+				rank -= byte_count;
+				value >>= 8;
+				result += 8;
+			}
+			for(; rank > 0; --rank)
+				value &= value - 1;
+			return result + lowest_set_bit(value);
+		#endif
+		}
+
+		//count of set bits in an array of words
+		inline usize
+		popcount_words(const u64* words, usize count)
+		{
+			usize result = 0;
+			usize i = 0;
+		#if defined(__AVX2__)
+			//nibble lookup of 32 bytes at a time summed into 64 bit lanes
+			const __m256i lookup = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const __m256i low_mask = _mm256_set1_epi8(0x0F);
+			__m256i total = _mm256_setzero_si256();
+			for(; i + 4 <= count; i += 4)
+			{
+				__m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				__m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(value, low_mask));
+				__m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask));
+				total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+			}
+			alignas(32) u64 lanes[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+			result = usize(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+		#else
+			//independent sums so the popcounts don't wait on each other
+			usize sums[4] = {0, 0, 0, 0};
+			for(; i + 4 <= count; i += 4)
+			{
+				sums[0] += popcount(words[i]);
+				sums[1] += popcount(words[i + 1]);
+				sums[2] += popcount(words[i + 2]);
+				sums[3] += popcount(words[i + 3]);
+			}
+			result = sums[0] + sums[1] + sums[2] + sums[3];
+		#endif
+			for(; i < count; ++i)
+				result += popcount(words[i]);
+			return result;
+		}
+	}
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/api.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+#include "cpprelude/bits.h"
+
+namespace cpprelude
+{
+	/*
+	 * dynamic array of bits packed in 64 bit words
+	 * the bits past the count in the last word are always kept zero so whole word operations don't need masking
+	 */
+	struct dynamic_bitset
+	{
+		constexpr static usize word_bits = 64;
+
+		slice<u64> _words;
+		usize _count;
+		memory_context* _context = platform->global_memory;
+
+		API_CPPR dynamic_bitset(memory_context* context = platform->global_memory);
+		API_CPPR explicit dynamic_bitset(usize count, bool value = false, memory_context* context = platform->global_memory);
+
+		API_CPPR dynamic_bitset(const dynamic_bitset& other);
+		API_CPPR dynamic_bitset(const dynamic_bitset& other, memory_context* context);
+
+		API_CPPR dynamic_bitset(dynamic_bitset&& other);
+
+		API_CPPR dynamic_bitset&
+		operator=(const dynamic_bitset& other);
+
+		API_CPPR dynamic_bitset&
+		operator=(dynamic_bitset&& other);
+
+		API_CPPR ~dynamic_bitset();
+
+		bool
+		test(usize index) const
+		{
+			return (_words[index / word_bits] >> (index % word_bits)) & 1;
+		}
+
+		bool
+		operator[](usize index) const
+		{
+			return test(index);
+		}
+
+		void
+		set(usize index)
+		{
+			_words[index / word_bits] |= u64(1) << (index % word_bits);
+		}
+
+		void
+		set(usize index, bool value)
+		{
+			u64 mask = u64(1) << (index % word_bits);
+			u64& word = _words[index / word_bits];
+			word = (word & ~mask) | ((u64(0) - u64(value)) & mask);
+		}
+
+		void
+		reset(usize index)
+		{
+			_words[index / word_bits] &= ~(u64(1) << (index % word_bits));
+		}
+
+		void
+		flip(usize index)
+		{
+			_words[index / word_bits] ^= u64(1) << (index % word_bits);
+		}
+
+		API_CPPR void
+		set_all();
+
+		API_CPPR void
+		reset_all();
+
+		API_CPPR void
+		flip_all();
+
+		//count of set bits
+		API_CPPR usize
+		popcount() const;
+
+		API_CPPR bool
+		any() const;
+
+		API_CPPR bool
+		none() const;
+
+		API_CPPR bool
+		all() const;
+
+		//index of the first set bit or the count if there's none
+		API_CPPR usize
+		find_first() const;
+
+		//index of the first set bit after the index or the count if there's none
+		API_CPPR usize
+		find_next(usize index) const;
+
+		//the bitwise operations treat a shorter other bitset as zero extended
+		API_CPPR dynamic_bitset&
+		operator&=(const dynamic_bitset& other);
+
+		API_CPPR dynamic_bitset&
+		operator|=(const dynamic_bitset& other);
+
+		API_CPPR dynamic_bitset&
+		operator^=(const dynamic_bitset& other);
+
+		//clears the bits which are set in the other bitset
+		API_CPPR dynamic_bitset&
+		and_not(const dynamic_bitset& other);
+
+		API_CPPR bool
+		operator==(const dynamic_bitset& other) const;
+
+		API_CPPR bool
+		operator!=(const dynamic_bitset& other) const;
+
+		API_CPPR void
+		insert_back(bool value);
+
+		API_CPPR void
+		remove_back();
+
+		API_CPPR void
+		resize(usize count, bool value = false);
+
+		API_CPPR void
+		reserve(usize count);
+
+		API_CPPR void
+		clear();
+
+		API_CPPR void
+		shrink_to_fit();
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		usize
+		capacity() const
+		{
+			return _words.count() * word_bits;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		usize
+		words_count() const
+		{
+			return (_count + word_bits - 1) / word_bits;
+		}
+
+		const u64*
+		words() const
+		{
+			return _words.ptr;
+		}
+
+		API_CPPR void
+		_grow(usize words_count);
+
+		API_CPPR void
+		_clear_tail();
+	};
+
+	/*
+	 * rank and select index over a bitset which must not change while the index is used
+	 * the ranks before each block of 8 words are stored so rank reads one entry and popcounts at most 8 words
+	 * and the blocks holding every 512th set bit are sampled so select only binary searches between two samples
+	 * it costs 12.5% of the bitset size plus the samples
+	 */
+	struct bitset_rank_index
+	{
+		constexpr static usize block_words = 8;
+		constexpr static usize block_bits = block_words * dynamic_bitset::word_bits;
+		constexpr static usize select_sample = 512;
+
+		const dynamic_bitset* _bitset;
+		dynamic_array<u64> _block_ranks;
+		dynamic_array<u64> _select_samples;
+
+		API_CPPR bitset_rank_index(memory_context* context = platform->global_memory);
+		API_CPPR bitset_rank_index(const dynamic_bitset& bitset, memory_context* context = platform->global_memory);
+
+		//rebuilds the index for the bitset
+		API_CPPR void
+		build(const dynamic_bitset& bitset);
+
+		//count of set bits before the index, the index can be the count of the bitset
+		API_CPPR usize
+		rank(usize index) const;
+
+		//index of the set bit with the rank, the rank must be less than the popcount
+		API_CPPR usize
+		select(usize rank) const;
+
+		//count of set bits in the whole bitset
+		API_CPPR usize
+		popcount() const;
+	};
+}
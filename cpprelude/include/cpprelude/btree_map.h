@@ -0,0 +1,1174 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/iterator.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/defaults.h"
+
+#include <initializer_list>
+#include <new>
+
+#if defined(CPU_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace cpprelude
+{
+	namespace details
+	{
+		//a node should fit around 512 bytes of keys, but never less than 8 or more than 128 keys
+		constexpr usize
+		b_tree_default_capacity(usize key_size)
+		{
+			return (512 / key_size) < 8 ? 8 : ((512 / key_size) > 128 ? 128 : (512 / key_size));
+		}
+
+		//moves count elements from src to the uninitialized memory at dst
+		template<typename T>
+		inline void
+		_b_tree_relocate(T* dst, T* src, usize count)
+		{
+			for(usize i = 0; i < count; ++i)
+			{
+				new (dst + i) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+
+		//opens an uninitialized hole at index by shifting [index, count) one step to the right
+		template<typename T>
+		inline void
+		_b_tree_open(T* arr, usize index, usize count)
+		{
+			for(usize i = count; i > index; --i)
+			{
+				new (arr + i) T(std::move(arr[i - 1]));
+				arr[i - 1].~T();
+			}
+		}
+
+		//closes the uninitialized hole at index by shifting [index + 1, count) one step to the left
+		template<typename T>
+		inline void
+		_b_tree_close(T* arr, usize index, usize count)
+		{
+			for(usize i = index + 1; i < count; ++i)
+			{
+				new (arr + i - 1) T(std::move(arr[i]));
+				arr[i].~T();
+			}
+		}
+
+		//in node key search, lower_bound is the count of keys less than the key
+		//upper_bound is the count of keys less than or equal to the key
+		template<typename K, typename ComparatorType>
+		struct b_tree_search
+		{
+			static usize
+			lower_bound(const K* keys, usize count, const K& key, const ComparatorType& less_than)
+			{
+				usize lo = 0, hi = count;
+				while(lo < hi)
+				{
+					usize mid = lo + (hi - lo) / 2;
+					if(less_than(keys[mid], key))
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+				return lo;
+			}
+
+			static usize
+			upper_bound(const K* keys, usize count, const K& key, const ComparatorType& less_than)
+			{
+				usize lo = 0, hi = count;
+				while(lo < hi)
+				{
+					usize mid = lo + (hi - lo) / 2;
+					if(less_than(key, keys[mid]))
+						hi = mid;
+					else
+						lo = mid + 1;
+				}
+				return lo;
+			}
+		};
+
+#if defined(CPU_SSE2)
+		inline usize
+		_b_tree_bit_count4(int mask)
+		{
+			return (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+		}
+
+		//32-bit integer keys are compared 4 at a time, since the keys are sorted the matching
+		//keys form a prefix of the node so we stop at the first block that's not a full match
+		//flip is used to map unsigned keys into the signed range
+		template<u32 flip>
+		struct _b_tree_search_sse2
+		{
+			static usize
+			_count_less(const i32* keys, usize count, i32 key)
+			{
+				__m128i k = _mm_set1_epi32(static_cast<i32>(key ^ flip));
+				__m128i f = _mm_set1_epi32(static_cast<i32>(flip));
+				usize i = 0;
+				for(; i + 4 <= count; i += 4)
+				{
+					__m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), f);
+					int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, k)));
+					if(mask != 0xF)
+						return i + _b_tree_bit_count4(mask);
+				}
+				for(; i < count; ++i)
+					if(static_cast<i32>(keys[i] ^ flip) >= static_cast<i32>(key ^ flip))
+						return i;
+				return count;
+			}
+
+			static usize
+			_count_less_equal(const i32* keys, usize count, i32 key)
+			{
+				__m128i k = _mm_set1_epi32(static_cast<i32>(key ^ flip));
+				__m128i f = _mm_set1_epi32(static_cast<i32>(flip));
+				usize i = 0;
+				for(; i + 4 <= count; i += 4)
+				{
+					__m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), f);
+					int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(block, k)));
+					if(mask != 0)
+						return i + 4 - _b_tree_bit_count4(mask);
+				}
+				for(; i < count; ++i)
+					if(static_cast<i32>(keys[i] ^ flip) > static_cast<i32>(key ^ flip))
+						return i;
+				return count;
+			}
+		};
+
+		template<>
+		struct b_tree_search<i32, default_less_than<i32>>
+		{
+			static usize
+			lower_bound(const i32* keys, usize count, const i32& key, const default_less_than<i32>&)
+			{
+				return _b_tree_search_sse2<0>::_count_less(keys, count, key);
+			}
+
+			static usize
+			upper_bound(const i32* keys, usize count, const i32& key, const default_less_than<i32>&)
+			{
+				return _b_tree_search_sse2<0>::_count_less_equal(keys, count, key);
+			}
+		};
+
+		template<>
+		struct b_tree_search<u32, default_less_than<u32>>
+		{
+			static usize
+			lower_bound(const u32* keys, usize count, const u32& key, const default_less_than<u32>&)
+			{
+				return _b_tree_search_sse2<0x80000000>::_count_less(
+					reinterpret_cast<const i32*>(keys), count, static_cast<i32>(key));
+			}
+
+			static usize
+			upper_bound(const u32* keys, usize count, const u32& key, const default_less_than<u32>&)
+			{
+				return _b_tree_search_sse2<0x80000000>::_count_less_equal(
+					reinterpret_cast<const i32*>(keys), count, static_cast<i32>(key));
+			}
+		};
+#endif
+	}
+
+	//b+ tree, all the elements live in the leaves which are linked together
+	//and the inner nodes only hold copies of the separator keys
+	template<typename T,
+			 typename ComparatorType = default_less_than<T>,
+			 usize node_capacity = details::b_tree_default_capacity(sizeof(T)),
+			 typename ValueType = details::b_tree_empty_value>
+	struct b_tree
+	{
+		static_assert(node_capacity >= 4, "b_tree node capacity should be at least 4");
+
+		using data_type = T;
+		using key_type = T;
+		using node_type = details::b_tree_node<T, node_capacity>;
+		using leaf_type = details::b_tree_leaf<T, ValueType, node_capacity>;
+		using inner_type = details::b_tree_inner<T, node_capacity>;
+		using iterator = b_tree_iterator<T, ValueType, node_capacity>;
+		using const_iterator = b_tree_iterator<T, ValueType, node_capacity>;
+		using search_type = details::b_tree_search<T, ComparatorType>;
+
+		static constexpr usize _min_count = node_capacity / 2;
+
+		node_type *_root;
+		usize _count;
+		memory_context *_context = platform->global_memory;
+		ComparatorType _less_than;
+
+		b_tree(const ComparatorType& compare_function, memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context),
+			 _less_than(compare_function)
+		{}
+
+		b_tree(memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context)
+		{}
+
+		b_tree(std::initializer_list<T> list,
+			const ComparatorType& compare_function = ComparatorType(),
+			memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context), _less_than(compare_function)
+		{
+			for(const auto& value: list)
+				insert(value);
+		}
+
+		b_tree(const b_tree& other)
+			:_root(nullptr), _count(0), _context(other._context),
+			 _less_than(other._less_than)
+		{
+			_copy_content(other);
+		}
+
+		b_tree(const b_tree& other, memory_context* context)
+			:_root(nullptr), _count(0), _context(context),
+			 _less_than(other._less_than)
+		{
+			_copy_content(other);
+		}
+
+		b_tree(b_tree&& other)
+			:_root(other._root), _count(other._count),
+			 _context(other._context),
+			 _less_than(std::move(other._less_than))
+		{
+			other._root = nullptr;
+			other._count = 0;
+			other._context = nullptr;
+		}
+
+		b_tree(b_tree&& other, memory_context* context)
+			:_root(other._root), _count(other._count),
+			 _context(context),
+			 _less_than(std::move(other._less_than))
+		{
+			other._root = nullptr;
+			other._count = 0;
+			other._context = nullptr;
+		}
+
+		~b_tree()
+		{
+			clear();
+			_context = nullptr;
+		}
+
+		b_tree&
+		operator=(const b_tree& other)
+		{
+			clear();
+			_context = other._context;
+			_less_than = other._less_than;
+			_copy_content(other);
+			return *this;
+		}
+
+		b_tree&
+		operator=(b_tree&& other)
+		{
+			clear();
+			_context = other._context;
+			_less_than = std::move(other._less_than);
+
+			_count = other._count;
+			_root = other._root;
+			other._count = 0;
+			other._root = nullptr;
+			other._context = nullptr;
+			return *this;
+		}
+
+		void
+		clear()
+		{
+			if(_root)
+				_reset(_root);
+			_root = nullptr;
+			_count = 0;
+		}
+
+		iterator
+		insert(const T& data)
+		{
+			return _insert(data);
+		}
+
+		iterator
+		insert(T&& data)
+		{
+			return _insert(std::move(data));
+		}
+
+		void
+		remove(const T& data)
+		{
+			remove(lookup(data));
+		}
+
+		void
+		remove(iterator it)
+		{
+			if(it == end())
+				return;
+
+			leaf_type* leaf = const_cast<leaf_type*>(it.node);
+			leaf->keys()[it.index].~T();
+			leaf->values()[it.index].~ValueType();
+			details::_b_tree_close(leaf->keys(), it.index, leaf->count);
+			details::_b_tree_close(leaf->values(), it.index, leaf->count);
+			--leaf->count;
+			--_count;
+
+			_rebalance_leaf(leaf);
+		}
+
+		iterator
+		lookup(const T& data)
+		{
+			return _lookup(data);
+		}
+
+		const_iterator
+		lookup(const T& data) const
+		{
+			return _lookup(data);
+		}
+
+		//first element that's not less than the data
+		iterator
+		lower_bound(const T& data)
+		{
+			return _lower_bound(data);
+		}
+
+		const_iterator
+		lower_bound(const T& data) const
+		{
+			return _lower_bound(data);
+		}
+
+		//first element that's greater than the data
+		iterator
+		upper_bound(const T& data)
+		{
+			return _upper_bound(data);
+		}
+
+		const_iterator
+		upper_bound(const T& data) const
+		{
+			return _upper_bound(data);
+		}
+
+		template<typename function_type, typename user_type = void>
+		void
+		inorder_traverse(function_type&& FT, user_type* user_data = nullptr) const
+		{
+			for(auto it = begin(); it != end(); ++it)
+				FT(it, user_data);
+		}
+
+		void
+		swap(b_tree& other)
+		{
+			std::swap(_root, other._root);
+			std::swap(_count, other._count);
+			std::swap(_context, other._context);
+			std::swap(_less_than, other._less_than);
+		}
+
+		iterator
+		min()
+		{
+			return iterator(_min_leaf());
+		}
+
+		const_iterator
+		min() const
+		{
+			return const_iterator(_min_leaf());
+		}
+
+		iterator
+		max()
+		{
+			auto leaf = _max_leaf();
+			return iterator(leaf, leaf ? leaf->count - 1 : 0);
+		}
+
+		const_iterator
+		max() const
+		{
+			auto leaf = _max_leaf();
+			return const_iterator(leaf, leaf ? leaf->count - 1 : 0);
+		}
+
+		iterator
+		begin()
+		{
+			return min();
+		}
+
+		const_iterator
+		begin() const
+		{
+			return min();
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return min();
+		}
+
+		iterator
+		end()
+		{
+			return iterator();
+		}
+
+		const_iterator
+		end() const
+		{
+			return const_iterator();
+		}
+
+		const_iterator
+		cend() const
+		{
+			return const_iterator();
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		leaf_type*
+		_min_leaf() const
+		{
+			node_type* it = _root;
+			if(it == nullptr)
+				return nullptr;
+
+			while(!it->is_leaf)
+				it = static_cast<inner_type*>(it)->children[0];
+			return static_cast<leaf_type*>(it);
+		}
+
+		leaf_type*
+		_max_leaf() const
+		{
+			node_type* it = _root;
+			if(it == nullptr)
+				return nullptr;
+
+			while(!it->is_leaf)
+				it = static_cast<inner_type*>(it)->children[it->count];
+			return static_cast<leaf_type*>(it);
+		}
+
+		leaf_type*
+		_find_leaf(const T& key) const
+		{
+			node_type* it = _root;
+			while(!it->is_leaf)
+			{
+				auto inner = static_cast<inner_type*>(it);
+				it = inner->children[search_type::upper_bound(inner->keys(), inner->count, key, _less_than)];
+			}
+			return static_cast<leaf_type*>(it);
+		}
+
+		iterator
+		_lookup(const T& key) const
+		{
+			if(_root == nullptr)
+				return iterator();
+
+			leaf_type* leaf = _find_leaf(key);
+			usize index = search_type::lower_bound(leaf->keys(), leaf->count, key, _less_than);
+			if(index < leaf->count && !_less_than(key, leaf->keys()[index]))
+				return iterator(leaf, index);
+			return iterator();
+		}
+
+		iterator
+		_lower_bound(const T& key) const
+		{
+			if(_root == nullptr)
+				return iterator();
+
+			leaf_type* leaf = _find_leaf(key);
+			usize index = search_type::lower_bound(leaf->keys(), leaf->count, key, _less_than);
+			if(index < leaf->count)
+				return iterator(leaf, index);
+			return iterator(leaf->next);
+		}
+
+		iterator
+		_upper_bound(const T& key) const
+		{
+			if(_root == nullptr)
+				return iterator();
+
+			leaf_type* leaf = _find_leaf(key);
+			usize index = search_type::upper_bound(leaf->keys(), leaf->count, key, _less_than);
+			if(index < leaf->count)
+				return iterator(leaf, index);
+			return iterator(leaf->next);
+		}
+
+		template<typename KeyArg, typename ... TArgs>
+		iterator
+		_insert(KeyArg&& key, TArgs&& ... args)
+		{
+			if(_root == nullptr)
+				_root = _create_leaf();
+
+			leaf_type* leaf = _find_leaf(key);
+			usize index = search_type::lower_bound(leaf->keys(), leaf->count, key, _less_than);
+			if(index < leaf->count && !_less_than(key, leaf->keys()[index]))
+				return iterator(leaf, index);
+
+			//make room first then insert into the half that the key belongs to
+			if(leaf->count == node_capacity)
+			{
+				leaf_type* right = _split_leaf(leaf);
+				if(index > leaf->count)
+				{
+					index -= leaf->count;
+					leaf = right;
+				}
+			}
+
+			details::_b_tree_open(leaf->keys(), index, leaf->count);
+			details::_b_tree_open(leaf->values(), index, leaf->count);
+			new (leaf->keys() + index) T(std::forward<KeyArg>(key));
+			new (leaf->values() + index) ValueType(std::forward<TArgs>(args)...);
+			++leaf->count;
+			++_count;
+			return iterator(leaf, index);
+		}
+
+		leaf_type*
+		_split_leaf(leaf_type* leaf)
+		{
+			leaf_type* right = _create_leaf();
+			usize mid = leaf->count / 2;
+			usize moved = leaf->count - mid;
+
+			details::_b_tree_relocate(right->keys(), leaf->keys() + mid, moved);
+			details::_b_tree_relocate(right->values(), leaf->values() + mid, moved);
+			right->count = moved;
+			leaf->count = mid;
+
+			right->next = leaf->next;
+			if(right->next)
+				right->next->prev = right;
+			leaf->next = right;
+			right->prev = leaf;
+
+			_insert_in_parent(leaf, right->keys()[0], right);
+			return right;
+		}
+
+		void
+		_insert_in_parent(node_type* left, const T& separator, node_type* right)
+		{
+			inner_type* parent = static_cast<inner_type*>(left->parent);
+
+			//the root has been split so we grow the tree by one level
+			if(parent == nullptr)
+			{
+				inner_type* root = _create_inner();
+				new (root->keys()) T(separator);
+				root->children[0] = left;
+				root->children[1] = right;
+				root->count = 1;
+				left->parent = root;
+				right->parent = root;
+				_root = root;
+				return;
+			}
+
+			if(parent->count == node_capacity)
+			{
+				//split the parent and push the middle key up a level
+				inner_type* parent_right = _create_inner();
+				usize mid = parent->count / 2;
+				usize moved = parent->count - mid - 1;
+
+				T promoted(std::move(parent->keys()[mid]));
+				parent->keys()[mid].~T();
+				details::_b_tree_relocate(parent_right->keys(), parent->keys() + mid + 1, moved);
+				for(usize i = 0; i <= moved; ++i)
+				{
+					parent_right->children[i] = parent->children[mid + 1 + i];
+					parent_right->children[i]->parent = parent_right;
+				}
+				parent->count = mid;
+				parent_right->count = moved;
+
+				_insert_in_parent(parent, promoted, parent_right);
+
+				//left might have moved to the new right parent
+				parent = static_cast<inner_type*>(left->parent);
+			}
+
+			usize index = _child_index(parent, left);
+			details::_b_tree_open(parent->keys(), index, parent->count);
+			new (parent->keys() + index) T(separator);
+			for(usize i = parent->count + 1; i > index + 1; --i)
+				parent->children[i] = parent->children[i - 1];
+			parent->children[index + 1] = right;
+			right->parent = parent;
+			++parent->count;
+		}
+
+		void
+		_rebalance_leaf(leaf_type* leaf)
+		{
+			if(leaf->parent == nullptr)
+			{
+				if(leaf->count == 0)
+				{
+					_free_leaf(leaf);
+					_root = nullptr;
+				}
+				return;
+			}
+
+			if(leaf->count >= _min_count)
+				return;
+
+			inner_type* parent = static_cast<inner_type*>(leaf->parent);
+			usize index = _child_index(parent, leaf);
+			leaf_type* left = index > 0 ? static_cast<leaf_type*>(parent->children[index - 1]) : nullptr;
+			leaf_type* right = index < parent->count ? static_cast<leaf_type*>(parent->children[index + 1]) : nullptr;
+
+			//borrow the last element of the left sibling
+			if(left && left->count > _min_count)
+			{
+				details::_b_tree_open(leaf->keys(), 0, leaf->count);
+				details::_b_tree_open(leaf->values(), 0, leaf->count);
+				details::_b_tree_relocate(leaf->keys(), left->keys() + left->count - 1, 1);
+				details::_b_tree_relocate(leaf->values(), left->values() + left->count - 1, 1);
+				--left->count;
+				++leaf->count;
+				parent->keys()[index - 1] = leaf->keys()[0];
+				return;
+			}
+
+			//borrow the first element of the right sibling
+			if(right && right->count > _min_count)
+			{
+				details::_b_tree_relocate(leaf->keys() + leaf->count, right->keys(), 1);
+				details::_b_tree_relocate(leaf->values() + leaf->count, right->values(), 1);
+				details::_b_tree_close(right->keys(), 0, right->count);
+				details::_b_tree_close(right->values(), 0, right->count);
+				--right->count;
+				++leaf->count;
+				parent->keys()[index] = right->keys()[0];
+				return;
+			}
+
+			if(left)
+				_merge_leaves(left, leaf, parent, index - 1);
+			else
+				_merge_leaves(leaf, right, parent, index);
+		}
+
+		void
+		_merge_leaves(leaf_type* left, leaf_type* right, inner_type* parent, usize separator_index)
+		{
+			details::_b_tree_relocate(left->keys() + left->count, right->keys(), right->count);
+			details::_b_tree_relocate(left->values() + left->count, right->values(), right->count);
+			left->count += right->count;
+			right->count = 0;
+
+			left->next = right->next;
+			if(left->next)
+				left->next->prev = left;
+
+			_free_leaf(right);
+			_remove_from_inner(parent, separator_index);
+			_rebalance_inner(parent);
+		}
+
+		void
+		_rebalance_inner(inner_type* node)
+		{
+			if(node->parent == nullptr)
+			{
+				//the root has only one child so we shrink the tree by one level
+				if(node->count == 0)
+				{
+					_root = node->children[0];
+					_root->parent = nullptr;
+					_free_inner(node);
+				}
+				return;
+			}
+
+			if(node->count >= _min_count)
+				return;
+
+			inner_type* parent = static_cast<inner_type*>(node->parent);
+			usize index = _child_index(parent, node);
+			inner_type* left = index > 0 ? static_cast<inner_type*>(parent->children[index - 1]) : nullptr;
+			inner_type* right = index < parent->count ? static_cast<inner_type*>(parent->children[index + 1]) : nullptr;
+
+			//rotate through the parent from the left sibling
+			if(left && left->count > _min_count)
+			{
+				details::_b_tree_open(node->keys(), 0, node->count);
+				new (node->keys()) T(std::move(parent->keys()[index - 1]));
+				parent->keys()[index - 1] = std::move(left->keys()[left->count - 1]);
+				left->keys()[left->count - 1].~T();
+
+				for(usize i = node->count + 1; i > 0; --i)
+					node->children[i] = node->children[i - 1];
+				node->children[0] = left->children[left->count];
+				node->children[0]->parent = node;
+
+				--left->count;
+				++node->count;
+				return;
+			}
+
+			//rotate through the parent from the right sibling
+			if(right && right->count > _min_count)
+			{
+				new (node->keys() + node->count) T(std::move(parent->keys()[index]));
+				parent->keys()[index] = std::move(right->keys()[0]);
+				right->keys()[0].~T();
+				details::_b_tree_close(right->keys(), 0, right->count);
+
+				node->children[node->count + 1] = right->children[0];
+				node->children[node->count + 1]->parent = node;
+				for(usize i = 0; i < right->count; ++i)
+					right->children[i] = right->children[i + 1];
+
+				--right->count;
+				++node->count;
+				return;
+			}
+
+			if(left)
+				_merge_inners(left, node, parent, index - 1);
+			else
+				_merge_inners(node, right, parent, index);
+		}
+
+		void
+		_merge_inners(inner_type* left, inner_type* right, inner_type* parent, usize separator_index)
+		{
+			//the separator comes down between the two nodes
+			new (left->keys() + left->count) T(std::move(parent->keys()[separator_index]));
+			details::_b_tree_relocate(left->keys() + left->count + 1, right->keys(), right->count);
+			for(usize i = 0; i <= right->count; ++i)
+			{
+				left->children[left->count + 1 + i] = right->children[i];
+				right->children[i]->parent = left;
+			}
+			left->count += right->count + 1;
+			right->count = 0;
+
+			_free_inner(right);
+			_remove_from_inner(parent, separator_index);
+			_rebalance_inner(parent);
+		}
+
+		//removes the key at index and the child to its right
+		void
+		_remove_from_inner(inner_type* node, usize index)
+		{
+			node->keys()[index].~T();
+			details::_b_tree_close(node->keys(), index, node->count);
+			for(usize i = index + 1; i < node->count; ++i)
+				node->children[i] = node->children[i + 1];
+			--node->count;
+		}
+
+		usize
+		_child_index(inner_type* parent, node_type* child) const
+		{
+			usize index = 0;
+			while(parent->children[index] != child)
+				++index;
+			return index;
+		}
+
+		leaf_type*
+		_create_leaf()
+		{
+			leaf_type* result = _context->template alloc<leaf_type>();
+			new (result) leaf_type();
+			return result;
+		}
+
+		inner_type*
+		_create_inner()
+		{
+			inner_type* result = _context->template alloc<inner_type>();
+			new (result) inner_type();
+			return result;
+		}
+
+		void
+		_free_leaf(leaf_type* leaf)
+		{
+			for(usize i = 0; i < leaf->count; ++i)
+			{
+				leaf->keys()[i].~T();
+				leaf->values()[i].~ValueType();
+			}
+			if(_context) _context->free(make_slice(leaf));
+		}
+
+		void
+		_free_inner(inner_type* inner)
+		{
+			for(usize i = 0; i < inner->count; ++i)
+				inner->keys()[i].~T();
+			if(_context) _context->free(make_slice(inner));
+		}
+
+		void
+		_reset(node_type* node)
+		{
+			if(node->is_leaf)
+			{
+				_free_leaf(static_cast<leaf_type*>(node));
+				return;
+			}
+
+			auto inner = static_cast<inner_type*>(node);
+			for(usize i = 0; i <= inner->count; ++i)
+				_reset(inner->children[i]);
+			_free_inner(inner);
+		}
+
+		void
+		_copy_content(const b_tree& other)
+		{
+			for(auto it = other.begin(); it != other.end(); ++it)
+				_insert(*it, it.node->values()[it.index]);
+		}
+
+		//checks the ordering, the fill factor and the leaf links of the tree
+		bool
+		_is_b_tree() const
+		{
+			if(_root == nullptr)
+				return _count == 0;
+
+			usize depth = 0, leaf_count = 0, element_count = 0;
+			if(!_check_node(_root, nullptr, nullptr, 0, depth, leaf_count, element_count))
+				return false;
+
+			usize linked = 0;
+			leaf_type* prev = nullptr;
+			for(leaf_type* it = _min_leaf(); it != nullptr; it = it->next)
+			{
+				if(it->prev != prev)
+					return false;
+				prev = it;
+				++linked;
+			}
+			return linked == leaf_count && element_count == _count;
+		}
+
+		bool
+		_check_node(const node_type* node, const T* lo, const T* hi, usize level,
+					usize& depth, usize& leaf_count, usize& element_count) const
+		{
+			if(node != _root && node->count == 0)
+				return false;
+
+			for(usize i = 0; i < node->count; ++i)
+			{
+				const T& key = node->keys()[i];
+				if(i > 0 && !_less_than(node->keys()[i - 1], key))
+					return false;
+				if(lo && _less_than(key, *lo))
+					return false;
+				if(hi && !_less_than(key, *hi))
+					return false;
+			}
+
+			if(node->is_leaf)
+			{
+				if(leaf_count == 0)
+					depth = level;
+				else if(depth != level)
+					return false;
+				++leaf_count;
+				element_count += node->count;
+				return true;
+			}
+
+			auto inner = static_cast<const inner_type*>(node);
+			for(usize i = 0; i <= inner->count; ++i)
+			{
+				if(inner->children[i]->parent != node)
+					return false;
+
+				const T* child_lo = i == 0 ? lo : inner->keys() + i - 1;
+				const T* child_hi = i == inner->count ? hi : inner->keys() + i;
+				if(!_check_node(inner->children[i], child_lo, child_hi, level + 1, depth, leaf_count, element_count))
+					return false;
+			}
+			return true;
+		}
+	};
+
+	template<typename KeyType, typename ValueType,
+			 typename ComparatorType = default_less_than<KeyType>,
+			 usize node_capacity = details::b_tree_default_capacity(sizeof(KeyType))>
+	struct b_tree_map: public b_tree<KeyType, ComparatorType, node_capacity, ValueType>
+	{
+		using key_type = KeyType;
+		using value_type = ValueType;
+		using data_type = KeyType;
+		using iterator = b_tree_pair_iterator<key_type, value_type, node_capacity>;
+		using const_iterator = b_tree_const_pair_iterator<key_type, value_type, node_capacity>;
+		using _implementation = b_tree<KeyType, ComparatorType, node_capacity, ValueType>;
+
+		b_tree_map(memory_context* context = platform->global_memory)
+			:_implementation(context)
+		{}
+
+		b_tree_map(const ComparatorType& compare_function, memory_context* context = platform->global_memory)
+			:_implementation(compare_function, context)
+		{}
+
+		b_tree_map(const b_tree_map& other)
+			:_implementation(other)
+		{}
+
+		b_tree_map(const b_tree_map& other, memory_context* context)
+			:_implementation(other, context)
+		{}
+
+		b_tree_map(b_tree_map&& other)
+			:_implementation(std::move(other))
+		{}
+
+		b_tree_map(b_tree_map&& other, memory_context* context)
+			:_implementation(std::move(other), context)
+		{}
+
+		b_tree_map&
+		operator=(const b_tree_map& other)
+		{
+			_implementation::operator=(other);
+			return *this;
+		}
+
+		b_tree_map&
+		operator=(b_tree_map&& other)
+		{
+			_implementation::operator=(std::move(other));
+			return *this;
+		}
+
+		value_type&
+		operator[](const key_type& key)
+		{
+			return iterator(_implementation::_insert(key)).value();
+		}
+
+		value_type&
+		operator[](key_type&& key)
+		{
+			return iterator(_implementation::_insert(std::move(key))).value();
+		}
+
+		iterator
+		insert(const key_type& key)
+		{
+			return _implementation::_insert(key);
+		}
+
+		iterator
+		insert(key_type&& key)
+		{
+			return _implementation::_insert(std::move(key));
+		}
+
+		iterator
+		insert(const key_type& key, const value_type& value)
+		{
+			return _implementation::_insert(key, value);
+		}
+
+		iterator
+		insert(key_type&& key, const value_type& value)
+		{
+			return _implementation::_insert(std::move(key), value);
+		}
+
+		iterator
+		insert(const key_type& key, value_type&& value)
+		{
+			return _implementation::_insert(key, std::move(value));
+		}
+
+		iterator
+		insert(key_type&& key, value_type&& value)
+		{
+			return _implementation::_insert(std::move(key), std::move(value));
+		}
+
+		void
+		remove(const key_type& key)
+		{
+			_implementation::remove(_implementation::_lookup(key));
+		}
+
+		void
+		remove(const iterator& it)
+		{
+			_implementation::remove(typename _implementation::iterator(it.node, it.index));
+		}
+
+		iterator
+		lookup(const key_type& key)
+		{
+			return _implementation::_lookup(key);
+		}
+
+		const_iterator
+		lookup(const key_type& key) const
+		{
+			return _implementation::_lookup(key);
+		}
+
+		iterator
+		lower_bound(const key_type& key)
+		{
+			return _implementation::_lower_bound(key);
+		}
+
+		const_iterator
+		lower_bound(const key_type& key) const
+		{
+			return _implementation::_lower_bound(key);
+		}
+
+		iterator
+		upper_bound(const key_type& key)
+		{
+			return _implementation::_upper_bound(key);
+		}
+
+		const_iterator
+		upper_bound(const key_type& key) const
+		{
+			return _implementation::_upper_bound(key);
+		}
+
+		template<typename function_type, typename user_type = void>
+		void
+		inorder_traverse(function_type&& FT, user_type* user_data = nullptr)
+		{
+			for(auto it = begin(); it != end(); ++it)
+				FT(it, user_data);
+		}
+
+		iterator
+		min()
+		{
+			return _implementation::min();
+		}
+
+		const_iterator
+		min() const
+		{
+			return _implementation::min();
+		}
+
+		iterator
+		max()
+		{
+			return _implementation::max();
+		}
+
+		const_iterator
+		max() const
+		{
+			return _implementation::max();
+		}
+
+		iterator
+		begin()
+		{
+			return _implementation::min();
+		}
+
+		const_iterator
+		begin() const
+		{
+			return _implementation::min();
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return _implementation::min();
+		}
+
+		iterator
+		end()
+		{
+			return iterator();
+		}
+
+		const_iterator
+		end() const
+		{
+			return const_iterator();
+		}
+
+		const_iterator
+		cend() const
+		{
+			return const_iterator();
+		}
+	};
+
+	template<typename T,
+			 typename ComparatorType = default_less_than<T>,
+			 usize node_capacity = details::b_tree_default_capacity(sizeof(T))>
+	using btree_set = b_tree<T, ComparatorType, node_capacity>;
+
+	template<typename KeyType, typename ValueType,
+			 typename ComparatorType = default_less_than<KeyType>,
+			 usize node_capacity = details::b_tree_default_capacity(sizeof(KeyType))>
+	using btree_map = b_tree_map<KeyType, ValueType, ComparatorType, node_capacity>;
+}
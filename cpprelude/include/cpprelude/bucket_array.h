@@ -16,13 +16,27 @@ namespace cpprelude
 		{
 			return KILOBYTES(256)/element_size > 1 ? KILOBYTES(256)/element_size : 1;
 		}
+
+		//the first bucket holds a cache line worth of elements and at least 4 but never more than the max size
+		constexpr usize
+		starting_bucket_size(usize element_size, usize max_size)
+		{
+			usize result = 64/element_size > 4 ? 64/element_size : 4;
+			return result < max_size ? result : max_size;
+		}
 	}
 
+	/*
+	 * a deque made of buckets, the bucket_size is the size of the largest bucket
+	 * nothing is allocated until the first insert then the buckets start small and double in size up to the bucket_size
+	 * the map of buckets has free slots on both ends and the buckets that get empty at one end are recycled
+	 * to the other end when it needs room so a steady stream of queue traffic doesn't allocate
+	 */
 	template<typename T,
 			 usize bucket_size = details::default_size(sizeof(T))>
 	struct bucket_array
 	{
-		using bucket_type = T*;
+		using bucket_type = details::bucket_array_bucket<T>;
 		using map_type = bucket_type*;
 		using iterator = bucket_array_iterator<T, bucket_size>;
 		using const_iterator = const_bucket_array_iterator<T, bucket_size>;
@@ -30,16 +44,16 @@ namespace cpprelude
 
 		map_type _map;
 		memory_context *_context = platform->global_memory;
-		usize _count, _bucket_count;
+		usize _count, _bucket_count, _map_capacity;
 		iterator _begin, _end;
 		iterator _cap_begin, _cap_end;
 
 		bucket_array(memory_context* context = platform->global_memory)
-			:_map(nullptr), _context(context), _count(0), _bucket_count(0)
+			:_map(nullptr), _context(context), _count(0), _bucket_count(0), _map_capacity(0)
 		{ _init(); }
 
 		bucket_array(std::initializer_list<T> list, memory_context* context = platform->global_memory)
-			:_map(nullptr), _context(context), _count(0), _bucket_count(0)
+			:_map(nullptr), _context(context), _count(0), _bucket_count(0), _map_capacity(0)
 		{
 			_init();
 
@@ -48,7 +62,7 @@ namespace cpprelude
 		}
 
 		bucket_array(usize count, const T& fill_value, memory_context* context = platform->global_memory)
-			:_map(nullptr), _context(context), _count(0), _bucket_count(0)
+			:_map(nullptr), _context(context), _count(0), _bucket_count(0), _map_capacity(0)
 		{
 			_init();
 
@@ -57,7 +71,7 @@ namespace cpprelude
 		}
 
 		bucket_array(const bucket_array& other)
-			:_map(nullptr), _context(other._context), _count(0), _bucket_count(0)
+			:_map(nullptr), _context(other._context), _count(0), _bucket_count(0), _map_capacity(0)
 		{
 			_init();
 
@@ -66,7 +80,7 @@ namespace cpprelude
 		}
 
 		bucket_array(const bucket_array& other, memory_context* context)
-			:_map(nullptr), _context(context), _count(0), _bucket_count(0)
+			:_map(nullptr), _context(context), _count(0), _bucket_count(0), _map_capacity(0)
 		{
 			_init();
 
@@ -79,13 +93,15 @@ namespace cpprelude
 			_context(other._context),
 			_count(other._count),
 			_bucket_count(other._bucket_count),
+			_map_capacity(other._map_capacity),
 			_begin(std::move(other._begin)),
 			_end(std::move(other._end)),
 			_cap_begin(std::move(other._cap_begin)),
-			_cap_end(std::move(other._cap_begin))
+			_cap_end(std::move(other._cap_end))
 		{
 			other._count = 0;
 			other._bucket_count = 0;
+			other._map_capacity = 0;
 			other._cap_begin = iterator();
 			other._cap_end = iterator();
 			other._begin = iterator();
@@ -99,13 +115,15 @@ namespace cpprelude
 			 _context(context),
 			 _count(other._count),
 			 _bucket_count(other._bucket_count),
+			 _map_capacity(other._map_capacity),
 			 _begin(std::move(other._begin)),
 			 _end(std::move(other._end)),
 			 _cap_begin(std::move(other._cap_begin)),
-			 _cap_end(std::move(other._cap_begin))
+			 _cap_end(std::move(other._cap_end))
 		{
 			other._count = 0;
 			other._bucket_count = 0;
+			other._map_capacity = 0;
 			other._cap_begin = iterator();
 			other._cap_end = iterator();
 			other._begin = iterator();
@@ -138,14 +156,16 @@ namespace cpprelude
 			_context = other._context;
 			_count = other._count;
 			_bucket_count = other._bucket_count;
+			_map_capacity = other._map_capacity;
 			_cap_begin = std::move(other._cap_begin);
-			_cap_end = std::move(other._cap_begin);
+			_cap_end = std::move(other._cap_end);
 			_begin = std::move(other._begin);
 			_end = std::move(other._end);
 			_map = other._map;
 
 			other._count = 0;
 			other._bucket_count = 0;
+			other._map_capacity = 0;
 			other._cap_begin = iterator();
 			other._cap_end = iterator();
 			other._begin = iterator();
@@ -165,19 +185,44 @@ namespace cpprelude
 		usize
 		capacity() const
 		{
-			return _bucket_count * bucket_size;
+			usize result = 0;
+			for(usize i = 0; i < _bucket_count; ++i)
+				result += _cap_begin._bucket_it[i].size;
+			return result;
 		}
 
 		void
 		reserve(usize new_count)
 		{
-			if(new_count <= capacity())
+			while(capacity() < new_count)
+				_grow_back();
+		}
+
+		//frees the unused buckets at both ends
+		void
+		shrink_to_fit()
+		{
+			if(_count == 0)
+			{
+				reset();
 				return;
+			}
 
-			usize half_count = new_count/2;
-			usize ceil_val = half_count % bucket_size != 0 ? 1 : 0;
-			_insert_bucket_back((half_count/bucket_size) + ceil_val);
-			_insert_bucket_front(half_count/bucket_size);
+			while(_cap_begin._bucket_it != _begin._bucket_it)
+			{
+				_free_bucket(*_cap_begin._bucket_it);
+				auto next_bucket = _cap_begin._bucket_it + 1;
+				_cap_begin = iterator(next_bucket, next_bucket->data, 0);
+				--_bucket_count;
+			}
+
+			while(_cap_end._bucket_it != _end._bucket_it)
+			{
+				_free_bucket(*_cap_end._bucket_it);
+				auto prev_bucket = _cap_end._bucket_it - 1;
+				_cap_end = iterator(prev_bucket, prev_bucket->data + prev_bucket->size - 1, prev_bucket->size - 1);
+				--_bucket_count;
+			}
 		}
 
 		void
@@ -209,19 +254,28 @@ namespace cpprelude
 		T&
 		operator[](usize index)
 		{
-			auto it = _begin;
-			while (index--)
-				++it;
-			return *it;
+			//skip whole buckets instead of walking the elements
+			index += _begin._index;
+			auto bucket = _begin._bucket_it;
+			while(index >= bucket->size)
+			{
+				index -= bucket->size;
+				++bucket;
+			}
+			return bucket->data[index];
 		}
 
 		const T&
 		operator[](usize index) const
 		{
-			auto it = _begin;
-			while (index--)
-				++it;
-			return *it;
+			index += _begin._index;
+			auto bucket = _begin._bucket_it;
+			while(index >= bucket->size)
+			{
+				index -= bucket->size;
+				++bucket;
+			}
+			return bucket->data[index];
 		}
 
 		void
@@ -241,7 +295,7 @@ namespace cpprelude
 		emplace_front(TArgs&& ... args)
 		{
 			if(_begin == _cap_begin)
-				_insert_bucket_front((_bucket_count/2));
+				_grow_front();
 
 			--_begin;
 			new (_begin._element_it) T(std::forward<TArgs>(args)...);
@@ -252,10 +306,10 @@ namespace cpprelude
 		insert_front(const T& value)
 		{
 			if(_begin == _cap_begin)
-				_insert_bucket_front((_bucket_count/2));
+				_grow_front();
 
 			--_begin;
-			*_begin = value;
+			new (_begin._element_it) T(value);
 			++_count;
 		}
 
@@ -263,10 +317,10 @@ namespace cpprelude
 		insert_front(T&& value)
 		{
 			if (_begin == _cap_begin)
-				_insert_bucket_front((_bucket_count/2));
+				_grow_front();
 
 			--_begin;
-			*_begin = std::move(value);
+			new (_begin._element_it) T(std::move(value));
 			++_count;
 		}
 
@@ -282,7 +336,7 @@ namespace cpprelude
 		emplace_back(TArgs&& ... args)
 		{
 			if (_end == _cap_end)
-				_insert_bucket_back((_bucket_count/2));
+				_grow_back();
 
 			new (_end._element_it) T(std::forward<TArgs>(args)...);
 			++_end;
@@ -293,9 +347,9 @@ namespace cpprelude
 		insert_back(const T& value)
 		{
 			if (_end == _cap_end)
-				_insert_bucket_back((_bucket_count/2));
+				_grow_back();
 
-			*_end = value;
+			new (_end._element_it) T(value);
 			++_end;
 			++_count;
 		}
@@ -304,9 +358,9 @@ namespace cpprelude
 		insert_back(T&& value)
 		{
 			if (_end == _cap_end)
-				_insert_bucket_back((_bucket_count/2));
+				_grow_back();
 
-			*_end = std::move(value);
+			new (_end._element_it) T(std::move(value));
 			++_end;
 			++_count;
 		}
@@ -327,8 +381,8 @@ namespace cpprelude
 		{
 			while(removal_count-- && _begin != _end)
 			{
-				(*_begin).~T();
 				--_end;
+				(*_end).~T();
 				--_count;
 			}
 		}
@@ -440,106 +494,146 @@ namespace cpprelude
 		void
 		_init()
 		{
-			_bucket_count = 3;
+			//nothing is allocated until the first insert
+			_map = nullptr;
+			_bucket_count = 0;
+			_map_capacity = 0;
+			_cap_begin = iterator();
+			_cap_end = iterator();
+			_begin = iterator();
+			_end = iterator();
+		}
 
-			//allocates 3 buckets at start
-			_map = _context->template alloc<bucket_type>(_bucket_count);
+		bucket_type
+		_alloc_bucket(usize size)
+		{
+			bucket_type result;
+			result.data = _context->template alloc<T>(size).ptr;
+			result.size = size;
+			return result;
+		}
 
-			//allocate the individual buckets
-			_map[0] = _context->template alloc<T>(bucket_size);
-			_map[1] = _context->template alloc<T>(bucket_size);
-			_map[2] = _context->template alloc<T>(bucket_size);
+		void
+		_free_bucket(bucket_type& bucket)
+		{
+			_context->free(make_slice(bucket.data, bucket.size));
+			bucket.data = nullptr;
+			bucket.size = 0;
+		}
 
-			_init_bucket(_map[0]);
-			_init_bucket(_map[1]);
-			_init_bucket(_map[2]);
+		void
+		_init_map()
+		{
+			_map_capacity = 4;
+			_map = _context->template alloc<bucket_type>(_map_capacity).ptr;
 
-			_cap_begin = iterator(_map, _map[0], 0);
-			_cap_end = iterator(_map + _bucket_count - 1, _map[_bucket_count - 1] + bucket_size - 1, bucket_size - 1);
+			//start in the middle of one small bucket so both ends have room
+			usize size = details::starting_bucket_size(sizeof(T), bucket_size);
+			_map[1] = _alloc_bucket(size);
+			_bucket_count = 1;
 
-			_begin = iterator(_map+1, _map[1], 0);
+			_cap_begin = iterator(_map + 1, _map[1].data, 0);
+			_cap_end = iterator(_map + 1, _map[1].data + size - 1, size - 1);
+			_begin = iterator(_map + 1, _map[1].data + size/2, size/2);
 			_end = _begin;
 		}
 
+		//makes sure the map has a free slot before and after the buckets
+		//the buckets are centered in the map again if there's enough room otherwise the map is doubled
 		void
-		_insert_bucket_back(usize count = 1)
+		_relayout_map()
 		{
-			bucket_type* _new_map = _context->template alloc<bucket_type>(_bucket_count + count);
+			usize new_capacity = _map_capacity;
+			if(_bucket_count * 2 + 2 > _map_capacity)
+				new_capacity = _bucket_count * 2 + 4;
 
-			usize i = 0;
-			for(; i < _bucket_count; ++i)
-			{
-				_new_map[i] = _map[i];
+			map_type new_map = _map;
+			if(new_capacity != _map_capacity)
+				new_map = _context->template alloc<bucket_type>(new_capacity).ptr;
 
-				if(_begin._bucket_it == _map+i)
-				{
-					_begin = iterator(_new_map+i, _new_map[i]+_begin._index, _begin._index);
-				}
+			map_type first = _cap_begin._bucket_it;
+			map_type new_first = new_map + (new_capacity - _bucket_count)/2;
+			std::memmove(new_first, first, _bucket_count * sizeof(bucket_type));
 
-				if(_end._bucket_it == _map+i)
-				{
-					_end = iterator(_new_map+i, _new_map[i]+_end._index, _end._index);
-				}
+			_cap_begin._bucket_it = new_first + (_cap_begin._bucket_it - first);
+			_cap_end._bucket_it = new_first + (_cap_end._bucket_it - first);
+			_begin._bucket_it = new_first + (_begin._bucket_it - first);
+			_end._bucket_it = new_first + (_end._bucket_it - first);
 
-			}
-
-			_context->free(make_slice(_map, _bucket_count));
-
-			_bucket_count += count;
-
-			for (; i < _bucket_count; ++i)
+			if(new_map != _map)
 			{
-				_new_map[i] = _context->template alloc<T>(bucket_size);
-				_init_bucket(_new_map[i]);
+				_context->free(make_slice(_map, _map_capacity));
+				_map = new_map;
+				_map_capacity = new_capacity;
 			}
-
-			_map = _new_map;
-			_cap_begin = iterator(_map, _map[0], 0);
-			_cap_end = iterator(_map + _bucket_count - 1, _map[_bucket_count - 1] + bucket_size - 1, bucket_size - 1);
 		}
 
+		//adds a bucket after the last one, an unused bucket at the front is recycled if there's one
 		void
-		_insert_bucket_front(usize count = 1)
+		_grow_back()
 		{
-			bucket_type* _new_map = _context->template alloc<bucket_type>(_bucket_count + count);
+			if(_map == nullptr)
+			{
+				_init_map();
+				if(_end != _cap_end)
+					return;
+			}
 
-			usize i = count;
-			for (; i < _bucket_count + count; ++i)
+			bucket_type bucket;
+			if(_cap_begin._bucket_it != _begin._bucket_it)
 			{
-				_new_map[i] = _map[i-count];
+				bucket = *_cap_begin._bucket_it;
+				auto next_bucket = _cap_begin._bucket_it + 1;
+				_cap_begin = iterator(next_bucket, next_bucket->data, 0);
+				--_bucket_count;
+			}
+			else
+			{
+				usize size = _cap_end._bucket_it->size * 2;
+				bucket = _alloc_bucket(size < bucket_size ? size : bucket_size);
+			}
 
-				if (_begin._bucket_it == _map + (i - count))
-				{
-					_begin = iterator(_new_map + i, _new_map[i] + _begin._index, _begin._index);
-				}
+			if(_cap_end._bucket_it + 1 == _map + _map_capacity)
+				_relayout_map();
 
-				if (_end._bucket_it == _map + (i - count))
-				{
-					_end = iterator(_new_map + i, _new_map[i] + _end._index, _end._index);
-				}
+			auto last_bucket = _cap_end._bucket_it + 1;
+			*last_bucket = bucket;
+			++_bucket_count;
+			_cap_end = iterator(last_bucket, bucket.data + bucket.size - 1, bucket.size - 1);
+		}
 
+		//adds a bucket before the first one, an unused bucket at the back is recycled if there's one
+		void
+		_grow_front()
+		{
+			if(_map == nullptr)
+			{
+				_init_map();
+				if(_begin != _cap_begin)
+					return;
 			}
 
-			_context->free(make_slice(_map, _bucket_count));
-
-			_bucket_count += count;
-
-			for (i = 0; i < count; ++i)
+			bucket_type bucket;
+			if(_cap_end._bucket_it != _end._bucket_it)
+			{
+				bucket = *_cap_end._bucket_it;
+				auto prev_bucket = _cap_end._bucket_it - 1;
+				_cap_end = iterator(prev_bucket, prev_bucket->data + prev_bucket->size - 1, prev_bucket->size - 1);
+				--_bucket_count;
+			}
+			else
 			{
-				_new_map[i] = _context->template alloc<T>(bucket_size);
-				_init_bucket(_new_map[i]);
+				usize size = _cap_begin._bucket_it->size * 2;
+				bucket = _alloc_bucket(size < bucket_size ? size : bucket_size);
 			}
 
-			_map = _new_map;
-			_cap_begin = iterator(_map, _map[0], 0);
-			_cap_end = iterator(_map + _bucket_count - 1, _map[_bucket_count - 1] + bucket_size - 1, bucket_size - 1);
-		}
+			if(_cap_begin._bucket_it == _map)
+				_relayout_map();
 
-		void
-		_init_bucket(bucket_type bucket)
-		{
-			for(usize i = 0; i < bucket_size; ++i)
-				new (&bucket[i]) T();
+			auto first_bucket = _cap_begin._bucket_it - 1;
+			*first_bucket = bucket;
+			++_bucket_count;
+			_cap_begin = iterator(first_bucket, bucket.data, 0);
 		}
 
 		void
@@ -550,12 +644,9 @@ namespace cpprelude
 			if (_map && _context)
 			{
 				for (usize i = 0; i < _bucket_count; ++i)
-				{
-					auto other_handle = _map[i];
-					_context->free(make_slice(other_handle, bucket_size));
-				}
+					_free_bucket(_cap_begin._bucket_it[i]);
 
-				_context->free(make_slice(_map, _bucket_count));
+				_context->free(make_slice(_map, _map_capacity));
 			}
 
 			_map = nullptr;
@@ -565,6 +656,7 @@ namespace cpprelude
 			_end = iterator();
 			_count = 0;
 			_bucket_count = 0;
+			_map_capacity = 0;
 		}
 	};
 }
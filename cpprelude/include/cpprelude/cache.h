@@ -0,0 +1,685 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+#include "cpprelude/hash_array.h"
+#include "cpprelude/threading.h"
+#include "cpprelude/bits.h"
+
+#include <new>
+#include <utility>
+
+namespace cpprelude
+{
+	enum class CACHE_POLICY: u8
+	{
+		//evicts the least recently used entry
+		LRU,
+		//evicts in insertion order but gives entries which were used since the last pass a second chance
+		//a hit only sets a bit so it doesn't touch the list
+		CLOCK,
+		//adaptive replacement cache, it balances between recent and frequent entries
+		//using the ghost keys of the entries it evicted
+		ARC
+	};
+
+	struct cache_stats
+	{
+		usize hits;
+		usize misses;
+		usize insertions;
+		usize evictions;
+	};
+
+	/*
+	 * bounded cache with a weight budget, every entry has a weight and the cache evicts until their sum fits the capacity
+	 * the entries live in one slab with the hash chains and the recency lists linked through them by index
+	 * so there are no allocations per entry, the freed entries are reused through a free list
+	 * all the lists run from the least recently used entry at the head to the most recently used at the tail
+	 */
+	template<typename K, typename V,
+			 CACHE_POLICY policy = CACHE_POLICY::LRU,
+			 typename hashType = hash<K>>
+	struct bounded_cache
+	{
+		using key_type = K;
+		using value_type = V;
+		using hash_type = hashType;
+
+		constexpr static u32 _invalid = static_cast<u32>(-1);
+
+		//lru and clock only use the recent list, arc keeps the keys it evicted in the ghost lists
+		enum list_type: u8 { RECENT, FREQUENT, RECENT_GHOST, FREQUENT_GHOST, FREE };
+
+		struct _list_type
+		{
+			u32 head;
+			u32 tail;
+			usize weight;
+		};
+
+		//the key and value are constructed in place so ghost entries can drop their values
+		struct _entry_type
+		{
+			alignas(K) ubyte _key[sizeof(K)];
+			alignas(V) ubyte _value[sizeof(V)];
+			usize hash;
+			usize weight;
+			u32 prev, next;
+			u32 chain;
+			u8 list;
+			bool referenced;
+
+			K&
+			key()
+			{
+				return *reinterpret_cast<K*>(_key);
+			}
+
+			const K&
+			key() const
+			{
+				return *reinterpret_cast<const K*>(_key);
+			}
+
+			V&
+			value()
+			{
+				return *reinterpret_cast<V*>(_value);
+			}
+
+			const V&
+			value() const
+			{
+				return *reinterpret_cast<const V*>(_value);
+			}
+		};
+
+		dynamic_array<_entry_type> _entries;
+		dynamic_array<u32> _buckets;
+		_list_type _lists[4];
+		u32 _free_head;
+		//count of resident entries and count of resident and ghost entries
+		usize _count;
+		usize _used;
+		usize _capacity;
+		//arc target weight of the recent list
+		usize _target;
+		cache_stats _stats;
+		hash_type _hasher;
+
+		bounded_cache(usize capacity, memory_context* context = platform->global_memory)
+			:_entries(context),
+			 _buckets(context),
+			 _free_head(_invalid),
+			 _count(0),
+			 _used(0),
+			 _capacity(capacity),
+			 _target(0),
+			 _stats{0, 0, 0, 0}
+		{
+			for(auto& list: _lists)
+				list = _list_type{_invalid, _invalid, 0};
+			_buckets.expand_back(16, u32(_invalid));
+		}
+
+		bounded_cache(const bounded_cache&) = delete;
+
+		bounded_cache&
+		operator=(const bounded_cache&) = delete;
+
+		~bounded_cache()
+		{
+			clear();
+		}
+
+		//returns nullptr on a miss, a hit makes the entry the most recently used
+		V*
+		get(const K& key)
+		{
+			return _get(key, _hasher(key));
+		}
+
+		//copies the value on a hit
+		bool
+		get(const K& key, V& value)
+		{
+			V* result = get(key);
+			if(result == nullptr)
+				return false;
+			value = *result;
+			return true;
+		}
+
+		//looks the key up without counting it or changing its recency
+		const V*
+		peek(const K& key) const
+		{
+			u32 index = _find(key, _hasher(key));
+			if(index == _invalid || _entries[index].list >= RECENT_GHOST)
+				return nullptr;
+			return &_entries[index].value();
+		}
+
+		bool
+		contains(const K& key) const
+		{
+			return peek(key) != nullptr;
+		}
+
+		//inserts or updates the entry evicting others until the weights fit the capacity
+		//returns false if the weight alone is more than the capacity
+		bool
+		put(const K& key, const V& value, usize weight = 1)
+		{
+			return _put(key, value, weight, _hasher(key));
+		}
+
+		bool
+		put(const K& key, V&& value, usize weight = 1)
+		{
+			return _put(key, std::move(value), weight, _hasher(key));
+		}
+
+		//returns false if the key isn't in the cache
+		bool
+		remove(const K& key)
+		{
+			return _remove(key, _hasher(key));
+		}
+
+		void
+		clear()
+		{
+			for(u32 i = 0; i < _entries.count(); ++i)
+				if(_entries[i].list != FREE)
+					_release(i);
+			_target = 0;
+		}
+
+		const cache_stats&
+		stats() const
+		{
+			return _stats;
+		}
+
+		void
+		reset_stats()
+		{
+			_stats = cache_stats{0, 0, 0, 0};
+		}
+
+		//count of entries in the cache
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		//sum of the weights of the entries in the cache
+		usize
+		weight() const
+		{
+			return _lists[RECENT].weight + _lists[FREQUENT].weight;
+		}
+
+		usize
+		capacity() const
+		{
+			return _capacity;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		V*
+		_get(const K& key, usize hash)
+		{
+			u32 index = _find(key, hash);
+			if(index == _invalid || _entries[index].list >= RECENT_GHOST)
+			{
+				++_stats.misses;
+				return nullptr;
+			}
+
+			++_stats.hits;
+			_touch(index);
+			return &_entries[index].value();
+		}
+
+		template<typename VArg>
+		bool
+		_put(const K& key, VArg&& value, usize weight, usize hash)
+		{
+			if(weight > _capacity)
+				return false;
+
+			u32 index = _find(key, hash);
+			if(index != _invalid && _entries[index].list < RECENT_GHOST)
+			{
+				//the new value could be made from the old one so it's built first
+				V new_value(std::forward<VArg>(value));
+				_entry_type& entry = _entries[index];
+				entry.value().~V();
+				new (entry._value) V(std::move(new_value));
+				_lists[entry.list].weight += weight;
+				_lists[entry.list].weight -= entry.weight;
+				entry.weight = weight;
+				_touch(index);
+				_make_room(0, false);
+				return true;
+			}
+
+			list_type list = RECENT;
+			bool frequent_ghost = false;
+			if(index != _invalid)
+			{
+				//a ghost hit means the list it was evicted from should have been bigger
+				//by the ratio of the other ghost list to its own
+				usize hit_ghost = _lists[_entries[index].list].weight;
+				usize other_ghost = _lists[_entries[index].list == RECENT_GHOST ? FREQUENT_GHOST : RECENT_GHOST].weight;
+				usize delta = weight * (hit_ghost > 0 && other_ghost > hit_ghost ? other_ghost / hit_ghost : 1);
+				frequent_ghost = _entries[index].list == FREQUENT_GHOST;
+				if(frequent_ghost)
+					_target = _target > delta ? _target - delta : 0;
+				else
+					_target = _target + delta < _capacity ? _target + delta : _capacity;
+				_list_remove(index);
+				list = FREQUENT;
+			}
+
+			_make_room(weight, frequent_ghost);
+			if(index == _invalid)
+				index = _alloc_entry(key, hash);
+
+			_entry_type& entry = _entries[index];
+			new (entry._value) V(std::forward<VArg>(value));
+			entry.weight = weight;
+			entry.referenced = false;
+			_list_push(list, index);
+			++_count;
+			++_stats.insertions;
+
+			if(policy == CACHE_POLICY::ARC)
+				_trim_ghosts();
+			return true;
+		}
+
+		bool
+		_remove(const K& key, usize hash)
+		{
+			u32 index = _find(key, hash);
+			if(index == _invalid)
+				return false;
+
+			bool resident = _entries[index].list < RECENT_GHOST;
+			_release(index);
+			return resident;
+		}
+
+		u32
+		_find(const K& key, usize hash) const
+		{
+			u32 index = _buckets[hash & (_buckets.count() - 1)];
+			while(index != _invalid)
+			{
+				const _entry_type& entry = _entries[index];
+				if(entry.hash == hash && entry.key() == key)
+					return index;
+				index = entry.chain;
+			}
+			return _invalid;
+		}
+
+		void
+		_touch(u32 index)
+		{
+			switch(policy)
+			{
+				case CACHE_POLICY::LRU:
+					_list_remove(index);
+					_list_push(RECENT, index);
+					break;
+
+				case CACHE_POLICY::CLOCK:
+					_entries[index].referenced = true;
+					break;
+
+				case CACHE_POLICY::ARC:
+					_list_remove(index);
+					_list_push(FREQUENT, index);
+					break;
+			}
+		}
+
+		void
+		_make_room(usize weight, bool frequent_ghost)
+		{
+			while(_count > 0 && this->weight() + weight > _capacity)
+			{
+				switch(policy)
+				{
+					case CACHE_POLICY::LRU:
+						_release(_lists[RECENT].head);
+						break;
+
+					case CACHE_POLICY::CLOCK:
+					{
+						u32 index = _lists[RECENT].head;
+						while(_entries[index].referenced)
+						{
+							_entries[index].referenced = false;
+							_list_remove(index);
+							_list_push(RECENT, index);
+							index = _lists[RECENT].head;
+						}
+						_release(index);
+						break;
+					}
+
+					case CACHE_POLICY::ARC:
+					{
+						usize recent = _lists[RECENT].weight;
+						bool from_recent = _lists[FREQUENT].head == _invalid ||
+							(_lists[RECENT].head != _invalid &&
+							 (recent > _target || (frequent_ghost && recent == _target)));
+
+						u32 index = _lists[from_recent ? RECENT : FREQUENT].head;
+						_list_remove(index);
+						_entries[index].value().~V();
+						_list_push(from_recent ? RECENT_GHOST : FREQUENT_GHOST, index);
+						--_count;
+						break;
+					}
+				}
+				++_stats.evictions;
+			}
+		}
+
+		void
+		_trim_ghosts()
+		{
+			while(_lists[RECENT_GHOST].head != _invalid &&
+				  _lists[RECENT].weight + _lists[RECENT_GHOST].weight > _capacity)
+				_release(_lists[RECENT_GHOST].head);
+
+			while(_lists[RECENT_GHOST].weight + _lists[FREQUENT_GHOST].weight > _capacity)
+				_release(_lists[_lists[FREQUENT_GHOST].head != _invalid ? FREQUENT_GHOST : RECENT_GHOST].head);
+		}
+
+		u32
+		_alloc_entry(const K& key, usize hash)
+		{
+			if(_used == _buckets.count())
+				_rehash(_buckets.count() * 2);
+
+			u32 index;
+			if(_free_head != _invalid)
+			{
+				index = _free_head;
+				_free_head = _entries[index].next;
+			}
+			else
+			{
+				index = static_cast<u32>(_entries.count());
+				_entries.insert_back(_entry_type());
+			}
+
+			_entry_type& entry = _entries[index];
+			new (entry._key) K(key);
+			entry.hash = hash;
+			u32& bucket = _buckets[hash & (_buckets.count() - 1)];
+			entry.chain = bucket;
+			bucket = index;
+			++_used;
+			return index;
+		}
+
+		//unlinks the entry from everything, destroys it and frees it
+		void
+		_release(u32 index)
+		{
+			_entry_type& entry = _entries[index];
+			if(entry.list < RECENT_GHOST)
+			{
+				entry.value().~V();
+				--_count;
+			}
+			_list_remove(index);
+
+			u32* link = &_buckets[entry.hash & (_buckets.count() - 1)];
+			while(*link != index)
+				link = &_entries[*link].chain;
+			*link = entry.chain;
+
+			entry.key().~K();
+			entry.list = FREE;
+			entry.next = _free_head;
+			_free_head = index;
+			--_used;
+		}
+
+		void
+		_rehash(usize buckets_count)
+		{
+			_buckets.clear();
+			_buckets.expand_back(buckets_count, u32(_invalid));
+			for(u32 i = 0; i < _entries.count(); ++i)
+			{
+				_entry_type& entry = _entries[i];
+				if(entry.list == FREE)
+					continue;
+				u32& bucket = _buckets[entry.hash & (buckets_count - 1)];
+				entry.chain = bucket;
+				bucket = i;
+			}
+		}
+
+		void
+		_list_push(list_type list, u32 index)
+		{
+			_entry_type& entry = _entries[index];
+			_list_type& target = _lists[list];
+			entry.list = list;
+			entry.prev = target.tail;
+			entry.next = _invalid;
+			if(target.tail != _invalid)
+				_entries[target.tail].next = index;
+			else
+				target.head = index;
+			target.tail = index;
+			target.weight += entry.weight;
+		}
+
+		void
+		_list_remove(u32 index)
+		{
+			_entry_type& entry = _entries[index];
+			_list_type& source = _lists[entry.list];
+			if(entry.prev != _invalid)
+				_entries[entry.prev].next = entry.next;
+			else
+				source.head = entry.next;
+
+			if(entry.next != _invalid)
+				_entries[entry.next].prev = entry.prev;
+			else
+				source.tail = entry.prev;
+			source.weight -= entry.weight;
+		}
+	};
+
+	/*
+	 * bounded cache split into shards each with its own lock so threads working on different keys rarely contend
+	 * the shard is picked by the high bits of the mixed hash and the capacity is split evenly between the shards
+	 * values are copied out under the lock since a pointer into a shard could be evicted by another thread
+	 */
+	template<typename K, typename V,
+			 CACHE_POLICY policy = CACHE_POLICY::LRU,
+			 typename hashType = hash<K>,
+			 usize shards_count = 16>
+	struct sharded_cache
+	{
+		static_assert((shards_count & (shards_count - 1)) == 0, "sharded_cache shards count must be a power of two");
+
+		using key_type = K;
+		using value_type = V;
+		using cache_type = bounded_cache<K, V, policy, hashType>;
+
+		constexpr static usize cache_line_size = 64;
+
+		//every shard starts a cache line so the locks of neighbouring shards don't share one
+		struct alignas(cache_line_size) _shard_type
+		{
+			binary_semaphore lock;
+			cache_type cache;
+
+			_shard_type(usize capacity, memory_context* context)
+				:cache(capacity, context)
+			{}
+		};
+
+		slice<_shard_type> _shards;
+		slice<ubyte> _memory;
+		memory_context* _context;
+		hashType _hasher;
+
+		sharded_cache(usize capacity, memory_context* context = platform->global_memory)
+			:_context(context)
+		{
+			//the memory context doesn't align to cache lines so the shards are placed at the first aligned byte
+			_memory = _context->template alloc<ubyte>(sizeof(_shard_type) * shards_count + cache_line_size - 1);
+			usize address = (reinterpret_cast<usize>(_memory.ptr) + cache_line_size - 1) & ~(cache_line_size - 1);
+			_shards = make_slice(reinterpret_cast<_shard_type*>(address), shards_count);
+
+			//the first capacity % shards_count shards take one more so the shards add up to the capacity exactly
+			for(usize i = 0; i < shards_count; ++i)
+				new (&_shards[i]) _shard_type(capacity / shards_count + (i < capacity % shards_count ? 1 : 0), context);
+		}
+
+		sharded_cache(const sharded_cache&) = delete;
+
+		sharded_cache&
+		operator=(const sharded_cache&) = delete;
+
+		~sharded_cache()
+		{
+			for(usize i = 0; i < shards_count; ++i)
+				_shards[i].~_shard_type();
+			_context->free(_memory);
+		}
+
+		//copies the value on a hit
+		bool
+		get(const K& key, V& value)
+		{
+			usize hash = _hasher(key);
+			_shard_type& shard = _shard(hash);
+			shard.lock.wait_take();
+			V* result = shard.cache._get(key, hash);
+			if(result != nullptr)
+				value = *result;
+			shard.lock.wait_give();
+			return result != nullptr;
+		}
+
+		bool
+		contains(const K& key)
+		{
+			_shard_type& shard = _shard(_hasher(key));
+			shard.lock.wait_take();
+			bool result = shard.cache.contains(key);
+			shard.lock.wait_give();
+			return result;
+		}
+
+		bool
+		put(const K& key, const V& value, usize weight = 1)
+		{
+			usize hash = _hasher(key);
+			_shard_type& shard = _shard(hash);
+			shard.lock.wait_take();
+			bool result = shard.cache._put(key, value, weight, hash);
+			shard.lock.wait_give();
+			return result;
+		}
+
+		bool
+		put(const K& key, V&& value, usize weight = 1)
+		{
+			usize hash = _hasher(key);
+			_shard_type& shard = _shard(hash);
+			shard.lock.wait_take();
+			bool result = shard.cache._put(key, std::move(value), weight, hash);
+			shard.lock.wait_give();
+			return result;
+		}
+
+		bool
+		remove(const K& key)
+		{
+			usize hash = _hasher(key);
+			_shard_type& shard = _shard(hash);
+			shard.lock.wait_take();
+			bool result = shard.cache._remove(key, hash);
+			shard.lock.wait_give();
+			return result;
+		}
+
+		void
+		clear()
+		{
+			for(usize i = 0; i < shards_count; ++i)
+			{
+				_shards[i].lock.wait_take();
+				_shards[i].cache.clear();
+				_shards[i].lock.wait_give();
+			}
+		}
+
+		//the sum of the shards counters, each shard is read under its own lock
+		cache_stats
+		stats()
+		{
+			cache_stats result{0, 0, 0, 0};
+			for(usize i = 0; i < shards_count; ++i)
+			{
+				_shards[i].lock.wait_take();
+				const cache_stats& shard = _shards[i].cache.stats();
+				result.hits += shard.hits;
+				result.misses += shard.misses;
+				result.insertions += shard.insertions;
+				result.evictions += shard.evictions;
+				_shards[i].lock.wait_give();
+			}
+			return result;
+		}
+
+		usize
+		count()
+		{
+			usize result = 0;
+			for(usize i = 0; i < shards_count; ++i)
+			{
+				_shards[i].lock.wait_take();
+				result += _shards[i].cache.count();
+				_shards[i].lock.wait_give();
+			}
+			return result;
+		}
+
+		_shard_type&
+		_shard(usize hash)
+		{
+			//fibonacci hashing so the shard doesn't depend on the same low bits as the buckets
+			//the top log2(shards_count) bits of the product are the best mixed ones, the shift is split so 1 shard doesn't shift by 64
+			u64 mixed = u64(hash) * 0x9E3779B97F4A7C15ULL;
+			return _shards[usize(mixed >> (63 - details::lowest_set_bit(shards_count)) >> 1)];
+		}
+	};
+}
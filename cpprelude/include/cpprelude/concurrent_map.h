@@ -0,0 +1,560 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/defaults.h"
+#include "cpprelude/epoch.h"
+
+#include <atomic>
+#include <new>
+
+namespace cpprelude
+{
+	namespace details
+	{
+		constexpr u32 skip_list_max_height = 24;
+
+		/*
+		 * skip list node, the next pointers are tagged with a mark bit in the lowest bit
+		 * a marked next pointer means the node is removed from that level
+		 * the node is allocated with room for exactly height next pointers
+		 */
+		template<typename K, typename V>
+		struct skip_list_node
+		{
+			epoch_retired retired;
+			K key;
+			V value;
+			u32 height;
+			//the inserting thread and the removing thread each hold a reference to the node
+			//and the last one to let it go retires it after it's unlinked from all the levels
+			std::atomic<u32> refs;
+			std::atomic<usize> next[1];
+
+			template<typename KeyArg, typename... ValueArgs>
+			skip_list_node(u32 height_, KeyArg&& key_, ValueArgs&&... value_)
+				:key(std::forward<KeyArg>(key_)),
+				 value(std::forward<ValueArgs>(value_)...),
+				 height(height_),
+				 refs(2)
+			{}
+		};
+
+		inline static bool
+		_skip_list_is_marked(usize ptr)
+		{
+			return (ptr & 1) != 0;
+		}
+
+		template<typename K, typename V>
+		inline static skip_list_node<K, V>*
+		_skip_list_ptr(usize ptr)
+		{
+			return reinterpret_cast<skip_list_node<K, V>*>(ptr & ~usize(1));
+		}
+	}
+
+	//skip list iterator, it doesn't pin the epoch domain so to keep using it while other threads
+	//remove elements hold an epoch_guard on the map's epoch() for as long as the iterator is used
+	template<typename K, typename V>
+	struct skip_list_iterator
+	{
+		using node_type = details::skip_list_node<K, V>;
+		using data_type = const K;
+
+		node_type* node;
+
+		skip_list_iterator()
+			:node(nullptr)
+		{}
+
+		skip_list_iterator(node_type* node_)
+			:node(node_)
+		{}
+
+		skip_list_iterator&
+		operator++()
+		{
+			node = _next(node);
+			return *this;
+		}
+
+		bool
+		operator==(const skip_list_iterator& other) const
+		{
+			return node == other.node;
+		}
+
+		bool
+		operator!=(const skip_list_iterator& other) const
+		{
+			return node != other.node;
+		}
+
+		const K&
+		operator*() const
+		{
+			return node->key;
+		}
+
+		V*
+		operator->() const
+		{
+			return &node->value;
+		}
+
+		const K&
+		key() const
+		{
+			return node->key;
+		}
+
+		V&
+		value() const
+		{
+			return node->value;
+		}
+
+		//gets the next node on the bottom level skipping the removed nodes
+		static node_type*
+		_next(node_type* it)
+		{
+			it = details::_skip_list_ptr<K, V>(it->next[0].load(std::memory_order_acquire));
+			while(it != nullptr)
+			{
+				usize next = it->next[0].load(std::memory_order_acquire);
+				if(!details::_skip_list_is_marked(next))
+					break;
+				it = details::_skip_list_ptr<K, V>(next);
+			}
+			return it;
+		}
+	};
+
+	/*
+	 * lock free ordered map based on the skip list by Herlihy, Lev, Luchangco and Shavit
+	 * insert, lookup, remove and iteration could be called from many threads at the same time
+	 * removed nodes are reclaimed using epoch based reclamation, every operation pins the epoch only while it runs
+	 * so iterators and references to values need an epoch_guard on epoch() if other threads could remove them
+	 */
+	template<typename KeyType, typename ValueType,
+		typename ComparatorType = default_less_than<KeyType>>
+	struct skip_list_map
+	{
+		using key_type = KeyType;
+		using value_type = ValueType;
+		using node_type = details::skip_list_node<key_type, value_type>;
+		using iterator = skip_list_iterator<key_type, value_type>;
+		using const_iterator = skip_list_iterator<key_type, value_type>;
+
+		constexpr static u32 max_height = details::skip_list_max_height;
+
+		std::atomic<usize> _head[max_height];
+		std::atomic<usize> _count;
+		memory_context* _context = platform->global_memory;
+		ComparatorType _less_than;
+		epoch_domain _epoch;
+
+		skip_list_map(memory_context* context = platform->global_memory)
+			:_count(0), _context(context), _epoch(_free_retired, this)
+		{
+			for(u32 i = 0; i < max_height; ++i)
+				_head[i].store(0, std::memory_order_relaxed);
+		}
+
+		skip_list_map(const ComparatorType& compare_function, memory_context* context = platform->global_memory)
+			:_count(0), _context(context), _less_than(compare_function), _epoch(_free_retired, this)
+		{
+			for(u32 i = 0; i < max_height; ++i)
+				_head[i].store(0, std::memory_order_relaxed);
+		}
+
+		skip_list_map(const skip_list_map&) = delete;
+
+		skip_list_map&
+		operator=(const skip_list_map&) = delete;
+
+		~skip_list_map()
+		{
+			clear();
+		}
+
+		//not thread safe
+		void
+		clear()
+		{
+			node_type* it = details::_skip_list_ptr<key_type, value_type>(_head[0].load());
+			while(it != nullptr)
+			{
+				node_type* next = details::_skip_list_ptr<key_type, value_type>(it->next[0].load());
+				_destroy_node(it);
+				it = next;
+			}
+
+			for(u32 i = 0; i < max_height; ++i)
+				_head[i].store(0);
+			_count.store(0);
+			_epoch.flush();
+		}
+
+		iterator
+		insert(const key_type& key)
+		{
+			return _insert(key);
+		}
+
+		iterator
+		insert(key_type&& key)
+		{
+			return _insert(std::move(key));
+		}
+
+		iterator
+		insert(const key_type& key, const value_type& value)
+		{
+			return _insert(key, value);
+		}
+
+		iterator
+		insert(key_type&& key, value_type&& value)
+		{
+			return _insert(std::move(key), std::move(value));
+		}
+
+		//the returned reference is valid as long as the key isn't removed
+		value_type&
+		operator[](const key_type& key)
+		{
+			auto it = lookup(key);
+			if(it != end())
+				return it.value();
+			return _insert(key).value();
+		}
+
+		//returns whether the key was found and removed
+		bool
+		remove(const key_type& key)
+		{
+			epoch_guard guard(_epoch);
+			std::atomic<usize>* preds[max_height];
+			node_type* succs[max_height];
+
+			while(true)
+			{
+				if(!_find(key, preds, succs))
+					return false;
+
+				node_type* victim = succs[0];
+
+				//mark the upper levels first so no new links are built on top of the node
+				for(u32 level = victim->height; level-- > 1;)
+				{
+					usize next = victim->next[level].load();
+					while(!details::_skip_list_is_marked(next))
+						victim->next[level].compare_exchange_weak(next, next | 1);
+				}
+
+				//marking the bottom level decides which thread removes the node
+				usize next = victim->next[0].load();
+				bool removed = false;
+				while(!details::_skip_list_is_marked(next))
+				{
+					if(victim->next[0].compare_exchange_weak(next, next | 1))
+					{
+						removed = true;
+						break;
+					}
+				}
+
+				if(removed)
+				{
+					--_count;
+					_find(key, preds, succs, victim);
+					_release(victim);
+					return true;
+				}
+			}
+		}
+
+		iterator
+		lookup(const key_type& key)
+		{
+			epoch_guard guard(_epoch);
+			node_type* node = _search<false>(key);
+			if(node == nullptr || _less_than(key, node->key))
+				return end();
+			return iterator(node);
+		}
+
+		//returns an iterator to the first element that's not less than the given key
+		iterator
+		lower_bound(const key_type& key)
+		{
+			epoch_guard guard(_epoch);
+			return iterator(_search<false>(key));
+		}
+
+		//returns an iterator to the first element that's greater than the given key
+		iterator
+		upper_bound(const key_type& key)
+		{
+			epoch_guard guard(_epoch);
+			return iterator(_search<true>(key));
+		}
+
+		usize
+		count() const
+		{
+			return _count.load(std::memory_order_relaxed);
+		}
+
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		//the domain to hold an epoch_guard on while using iterators that other threads could invalidate
+		epoch_domain&
+		epoch()
+		{
+			return _epoch;
+		}
+
+		iterator
+		begin()
+		{
+			epoch_guard guard(_epoch);
+			node_type* node = details::_skip_list_ptr<key_type, value_type>(_head[0].load(std::memory_order_acquire));
+			if(node != nullptr && details::_skip_list_is_marked(node->next[0].load(std::memory_order_acquire)))
+				node = iterator::_next(node);
+			return iterator(node);
+		}
+
+		iterator
+		end()
+		{
+			return iterator();
+		}
+
+		const_iterator
+		cbegin()
+		{
+			return begin();
+		}
+
+		const_iterator
+		cend()
+		{
+			return end();
+		}
+
+		template<typename KeyArg, typename... ValueArgs>
+		iterator
+		_insert(KeyArg&& key, ValueArgs&&... value)
+		{
+			epoch_guard guard(_epoch);
+			std::atomic<usize>* preds[max_height];
+			node_type* succs[max_height];
+
+			if(_find(key, preds, succs))
+				return iterator(succs[0]);
+
+			u32 height = _random_height();
+			node_type* node = _create_node(height, std::forward<KeyArg>(key), std::forward<ValueArgs>(value)...);
+
+			//link the bottom level which makes the node visible
+			while(true)
+			{
+				for(u32 level = 0; level < height; ++level)
+					node->next[level].store(reinterpret_cast<usize>(succs[level]), std::memory_order_relaxed);
+
+				usize expected = reinterpret_cast<usize>(succs[0]);
+				if(preds[0]->compare_exchange_strong(expected, reinterpret_cast<usize>(node)))
+					break;
+
+				if(_find(node->key, preds, succs))
+				{
+					_destroy_node(node);
+					return iterator(succs[0]);
+				}
+			}
+			++_count;
+
+			_link_upper_levels(node, preds, succs);
+
+			//the node could have been removed while it was being linked so make sure it's fully unlinked
+			if(details::_skip_list_is_marked(node->next[0].load()))
+				_find(node->key, preds, succs, node);
+
+			_release(node);
+			return iterator(node);
+		}
+
+		void
+		_link_upper_levels(node_type* node, std::atomic<usize>** preds, node_type** succs)
+		{
+			for(u32 level = 1; level < node->height; ++level)
+			{
+				while(true)
+				{
+					usize expected = reinterpret_cast<usize>(succs[level]);
+					if(preds[level]->compare_exchange_strong(expected, reinterpret_cast<usize>(node)))
+						break;
+
+					_find(node->key, preds, succs);
+					//the node got removed from the bottom level so stop linking it
+					if(succs[0] != node)
+						return;
+
+					usize next = node->next[level].load();
+					if(details::_skip_list_is_marked(next))
+						return;
+					if(!node->next[level].compare_exchange_strong(next, reinterpret_cast<usize>(succs[level])))
+						return;
+				}
+			}
+		}
+
+		//finds the preds and succs of the key on all levels and unlinks the removed nodes on the way
+		//if a target is given the search goes past the nodes with an equal key until it reaches the target
+		bool
+		_find(const key_type& key, std::atomic<usize>** preds, node_type** succs, node_type* target = nullptr)
+		{
+			while(!_try_find(key, preds, succs, target));
+			return succs[0] != nullptr && !_less_than(key, succs[0]->key);
+		}
+
+		bool
+		_try_find(const key_type& key, std::atomic<usize>** preds, node_type** succs, node_type* target)
+		{
+			std::atomic<usize>* pred_next = _head;
+			for(u32 level = max_height; level-- > 0;)
+			{
+				node_type* curr = details::_skip_list_ptr<key_type, value_type>(pred_next[level].load());
+				while(curr != nullptr)
+				{
+					usize next = curr->next[level].load();
+					if(details::_skip_list_is_marked(next))
+					{
+						usize expected = reinterpret_cast<usize>(curr);
+						if(!pred_next[level].compare_exchange_strong(expected, next & ~usize(1)))
+							return false;
+						curr = details::_skip_list_ptr<key_type, value_type>(next);
+						continue;
+					}
+
+					bool go_right = _less_than(curr->key, key) ||
+						(target != nullptr && curr != target && !_less_than(key, curr->key));
+					if(!go_right)
+						break;
+
+					pred_next = curr->next;
+					curr = details::_skip_list_ptr<key_type, value_type>(next);
+				}
+				preds[level] = pred_next + level;
+				succs[level] = curr;
+			}
+			return true;
+		}
+
+		//read only search which skips the removed nodes, returns the first node not less than the key
+		//or the first node greater than the key in case of upper bound
+		template<bool upper>
+		node_type*
+		_search(const key_type& key)
+		{
+			std::atomic<usize>* pred_next = _head;
+			node_type* curr = nullptr;
+			for(u32 level = max_height; level-- > 0;)
+			{
+				curr = details::_skip_list_ptr<key_type, value_type>(pred_next[level].load(std::memory_order_acquire));
+				while(curr != nullptr)
+				{
+					usize next = curr->next[level].load(std::memory_order_acquire);
+					if(details::_skip_list_is_marked(curr->next[0].load(std::memory_order_acquire)))
+					{
+						curr = details::_skip_list_ptr<key_type, value_type>(next);
+						continue;
+					}
+
+					bool go_right = upper ? !_less_than(key, curr->key) : _less_than(curr->key, key);
+					if(!go_right)
+						break;
+
+					pred_next = curr->next;
+					curr = details::_skip_list_ptr<key_type, value_type>(next);
+				}
+			}
+			return curr;
+		}
+
+		//geometric height with p = 1/4 which keeps the nodes small and the towers short
+		static u32
+		_random_height()
+		{
+			static thread_local u64 state = 0;
+			if(state == 0)
+				state = reinterpret_cast<usize>(&state) | 1;
+
+			//xorshift64*
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			u64 bits = state * 0x2545F4914F6CDD1DULL;
+
+			u32 height = 1;
+			while(height < max_height && (bits & 3) == 0)
+			{
+				++height;
+				bits >>= 2;
+			}
+			return height;
+		}
+
+		static usize
+		_node_size(u32 height)
+		{
+			return sizeof(node_type) + (height - 1) * sizeof(std::atomic<usize>);
+		}
+
+		template<typename KeyArg, typename... ValueArgs>
+		node_type*
+		_create_node(u32 height, KeyArg&& key, ValueArgs&&... value)
+		{
+			auto memory = _context->template alloc<ubyte>(_node_size(height));
+			node_type* node = new (memory.ptr) node_type(height, std::forward<KeyArg>(key), std::forward<ValueArgs>(value)...);
+			for(u32 level = 1; level < height; ++level)
+				new (node->next + level) std::atomic<usize>(0);
+			return node;
+		}
+
+		void
+		_destroy_node(node_type* node)
+		{
+			usize size = _node_size(node->height);
+			node->~node_type();
+			_context->free(make_slice(reinterpret_cast<ubyte*>(node), size));
+		}
+
+		void
+		_release(node_type* node)
+		{
+			if(node->refs.fetch_sub(1) == 1)
+				_epoch.retire(&node->retired);
+		}
+
+		static void
+		_free_retired(void* self, epoch_retired* retired)
+		{
+			auto map = reinterpret_cast<skip_list_map*>(self);
+			map->_destroy_node(reinterpret_cast<node_type*>(retired));
+		}
+	};
+
+	template<typename KeyType, typename ValueType,
+		typename ComparatorType = default_less_than<KeyType>>
+	using concurrent_map = skip_list_map<KeyType, ValueType, ComparatorType>;
+}
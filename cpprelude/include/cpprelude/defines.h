@@ -8,6 +8,11 @@
     #define OS_LINUX
 #endif
 
+//instruction set definitions
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CPU_SSE2
+#endif
+
 #define BYTES(amount) (amount)
 #define KILOBYTES(amount) (BYTES(amount) * 1024ULL)
 #define MEGABYTES(amount) (KILOBYTES(amount) * 1024ULL)
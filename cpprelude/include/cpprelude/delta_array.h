@@ -0,0 +1,162 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/api.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+
+namespace cpprelude
+{
+	/*
+	 * compressed array of sorted u64 values
+	 * the values are split into blocks of 128 and every block keeps the differences between its consecutive values
+	 * packed with the bit width of the biggest one, so a block of width b takes 2 * b words
+	 * every block keeps its first value and the offset of its words as skip pointers to seek without decoding
+	 * the last incomplete block is kept uncompressed until it's full
+	 */
+	struct delta_array
+	{
+		constexpr static usize block_size = 128;
+
+		struct const_iterator
+		{
+			const delta_array* _array;
+			usize _index;
+			usize _block;
+			usize _position;
+			usize _block_count;
+			u64 _values[block_size];
+
+			API_CPPR const_iterator&
+			operator++();
+
+			API_CPPR const_iterator
+			operator++(int);
+
+			bool
+			operator==(const const_iterator& other) const
+			{
+				return _index == other._index;
+			}
+
+			bool
+			operator!=(const const_iterator& other) const
+			{
+				return _index != other._index;
+			}
+
+			u64
+			operator*() const
+			{
+				return _values[_position];
+			}
+
+			//index of the value in the array
+			usize
+			index() const
+			{
+				return _index;
+			}
+
+			//moves forward to the first value which isn't less than the value
+			//it jumps over the blocks using their first values, returns false if it reached the end
+			API_CPPR bool
+			seek(u64 value);
+
+			API_CPPR void
+			_load(usize block);
+		};
+
+		using iterator = const_iterator;
+
+		dynamic_array<u64> _words;
+		dynamic_array<u64> _firsts;
+		dynamic_array<usize> _offsets;
+		dynamic_array<u64> _tail;
+		usize _count;
+
+		API_CPPR delta_array(memory_context* context = platform->global_memory);
+
+		//returns false if the value is less than the last value
+		API_CPPR bool
+		append(u64 value);
+
+		//appends the values until one of them is less than the value before it, returns the count of appended values
+		API_CPPR usize
+		append(const slice<u64>& values);
+
+		//decodes the prefix of the value's block so it's slower than iterating
+		API_CPPR u64
+		operator[](usize index) const;
+
+		API_CPPR u64
+		back() const;
+
+		//index of the first value which isn't less than the value or count() if there's none
+		API_CPPR usize
+		lower_bound(u64 value) const;
+
+		API_CPPR bool
+		contains(u64 value) const;
+
+		//appends all the values to the output
+		API_CPPR void
+		decode(dynamic_array<u64>& output) const;
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		API_CPPR void
+		clear();
+
+		//bytes used by the packed words, the skip pointers and the uncompressed tail
+		API_CPPR usize
+		memory_size() const;
+
+		//iterator to the first value which isn't less than the value
+		API_CPPR const_iterator
+		seek(u64 value) const;
+
+		API_CPPR const_iterator
+		begin() const;
+
+		API_CPPR const_iterator
+		cbegin() const;
+
+		API_CPPR const_iterator
+		end() const;
+
+		API_CPPR const_iterator
+		cend() const;
+
+		//count of blocks including the tail
+		usize
+		_blocks_count() const
+		{
+			return _firsts.count() + (_tail.empty() ? 0 : 1);
+		}
+
+		//the last block from the given block whose first value is less than the value
+		//or the given block itself if its first value isn't less
+		API_CPPR usize
+		_find_block(u64 value, usize from) const;
+
+		//decodes the first count values of the block into values
+		API_CPPR void
+		_decode_block(usize block, u64* values, usize count) const;
+
+		API_CPPR void
+		_pack_tail();
+	};
+}
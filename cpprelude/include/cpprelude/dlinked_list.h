@@ -5,6 +5,7 @@
 #include "cpprelude/iterator.h"
 #include "cpprelude/memory_context.h"
 #include "cpprelude/platform.h"
+#include "cpprelude/defaults.h"
 #include <initializer_list>
 #include <iterator>
 
@@ -457,6 +458,132 @@ namespace cpprelude
 			_tail->prev = _head;
 		}
 
+		//moves all the elements of the other list before the given iterator of this list in O(1)
+		//lists with different memory contexts copy the elements instead and the other list is left empty
+		void
+		splice_before(const iterator& it, dlinked_list<T>& other)
+		{
+			if(this == &other || other._count == 0)
+				return;
+
+			//nodes can't change hands if they are allocated from different contexts
+			if(_context != other._context)
+			{
+				dlinked_list<T> copy(other, _context);
+				other.reset();
+				splice_before(it, copy);
+				return;
+			}
+
+			splice_before(it, other, other.begin(), other.end());
+		}
+
+		//moves the [first, last) range of the other list before the given iterator of this list
+		//it only relinks the nodes, the range is walked to count it unless it's the whole other list
+		void
+		splice_before(const iterator& it, dlinked_list<T>& other, const iterator& first, const iterator& last)
+		{
+			if(first == last)
+				return;
+
+			if(_context != other._context)
+			{
+				dlinked_list<T> range(other._context);
+				range.splice_before(range.end(), other, first, last);
+				dlinked_list<T> copy(range, _context);
+				splice_before(it, copy);
+				return;
+			}
+
+			if(this != &other)
+			{
+				usize count = 0;
+				if(first._node == other._head->next && last._node == other._tail)
+					count = other._count;
+				else
+					for(auto node = first._node; node != last._node; node = node->next)
+						++count;
+
+				other._count -= count;
+				_count += count;
+			}
+
+			node_type* first_node = first._node;
+			node_type* last_node = last._node->prev;
+
+			//unlink the range
+			first_node->prev->next = last._node;
+			last._node->prev = first_node->prev;
+
+			//link it before it
+			node_type* next_node = it._node;
+			first_node->prev = next_node->prev;
+			next_node->prev->next = first_node;
+			last_node->next = next_node;
+			next_node->prev = last_node;
+		}
+
+		//merges the other sorted list into this sorted list by relinking, equal elements of this list come first
+		template<typename Comparator = default_less_than<T>>
+		void
+		merge(dlinked_list<T>& other, Comparator less_than = Comparator())
+		{
+			if(this == &other)
+				return;
+
+			if(_context != other._context)
+			{
+				dlinked_list<T> copy(other, _context);
+				other.reset();
+				merge(copy, less_than);
+				return;
+			}
+
+			node_type* it = _head->next;
+			node_type* other_it = other._head->next;
+			while(other_it != other._tail)
+			{
+				if(it == _tail || less_than(other_it->data, it->data))
+				{
+					node_type* next_node = other_it->next;
+					_insert_front_helper(it, other_it);
+					other_it = next_node;
+				}
+				else
+				{
+					it = it->next;
+				}
+			}
+
+			_count += other._count;
+			other._count = 0;
+			other._head->next = other._tail;
+			other._tail->prev = other._head;
+		}
+
+		//stable bottom up merge sort which only relinks the nodes, no allocations and no element moves
+		template<typename Comparator = default_less_than<T>>
+		void
+		sort(Comparator less_than = Comparator())
+		{
+			if(_count < 2)
+				return;
+
+			//sort the chain through the next pointers then fix the prev pointers in one pass
+			_tail->prev->next = nullptr;
+			node_type* first = details::sort_node_chain(_head->next, less_than, static_cast<node_type**>(nullptr));
+
+			node_type* prev_node = _head;
+			for(node_type* node = first; node != nullptr; node = node->next)
+			{
+				prev_node->next = node;
+				node->prev = prev_node;
+				prev_node = node;
+			}
+			prev_node->next = _tail;
+			_tail->prev = prev_node;
+		}
+
 		bool
 		empty() const
 		{
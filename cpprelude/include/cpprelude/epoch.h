@@ -0,0 +1,102 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/api.h"
+
+#include <atomic>
+
+namespace cpprelude
+{
+	//header of an object retired through an epoch_domain, it's embedded in the retired object
+	struct epoch_retired
+	{
+		epoch_retired* next = nullptr;
+	};
+
+	/*
+	 * epoch based memory reclamation
+	 * threads pin the domain before reading shared pointers and unpin when they are done
+	 * retired objects are stamped with the global epoch and freed once the epoch moves two steps ahead
+	 * which can only happen after every thread that might still see them has unpinned
+	 * the slots come in chunks of slots_count and a new chunk is added when all of them are pinned
+	 */
+	struct epoch_domain
+	{
+		constexpr static usize slots_count = 64;
+		using free_func = void(*)(void*, epoch_retired*);
+
+		//each slot lives in its own cache line so pinning threads don't share lines
+		struct _slot_type
+		{
+			std::atomic<usize> state;
+			ubyte _padding[64 - sizeof(std::atomic<usize>)];
+		};
+
+		struct _slot_chunk
+		{
+			_slot_type slots[slots_count];
+			std::atomic<_slot_chunk*> next;
+		};
+
+		_slot_chunk _slots;
+		std::atomic<usize> _epoch;
+		std::atomic<usize> _retired_count;
+		std::atomic<epoch_retired*> _limbo[3];
+		free_func _free;
+		void* _user;
+
+		API_CPPR epoch_domain(free_func free_function, void* user_data = nullptr);
+
+		epoch_domain(const epoch_domain&) = delete;
+
+		epoch_domain&
+		operator=(const epoch_domain&) = delete;
+
+		API_CPPR ~epoch_domain();
+
+		//pins the calling thread and returns the slot to unpin later, it adds a chunk of slots if all of them are taken
+		API_CPPR usize
+		pin();
+
+		API_CPPR void
+		unpin(usize slot);
+
+		//retires an object which is no longer reachable from the shared structure, the caller must be pinned
+		API_CPPR void
+		retire(epoch_retired* object);
+
+		//frees all the retired objects, no thread must be pinned
+		API_CPPR void
+		flush();
+
+		API_CPPR bool
+		_try_advance();
+
+		API_CPPR void
+		_free_list(epoch_retired* list);
+
+		API_CPPR _slot_type&
+		_slot(usize slot);
+	};
+
+	//pins the epoch domain for the lifetime of the guard
+	struct epoch_guard
+	{
+		epoch_domain* _domain;
+		usize _slot;
+
+		epoch_guard(epoch_domain& domain)
+			:_domain(&domain), _slot(domain.pin())
+		{}
+
+		epoch_guard(const epoch_guard&) = delete;
+
+		epoch_guard&
+		operator=(const epoch_guard&) = delete;
+
+		~epoch_guard()
+		{
+			_domain->unpin(_slot);
+		}
+	};
+}
@@ -0,0 +1,751 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/iterator.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/defaults.h"
+#include "cpprelude/dynamic_array.h"
+#include "cpprelude/algorithm.h"
+
+#include <initializer_list>
+#include <new>
+
+namespace cpprelude
+{
+	namespace details
+	{
+		//orders indices of a keys column by key then by index so the first occurrence of a key comes first
+		template<typename K, typename ComparatorType>
+		struct flat_index_less_than
+		{
+			const K* keys;
+			const ComparatorType* less_than;
+
+			bool
+			operator()(usize a, usize b) const
+			{
+				if((*less_than)(keys[a], keys[b]))
+					return true;
+				if((*less_than)(keys[b], keys[a]))
+					return false;
+				return a < b;
+			}
+		};
+
+		//count of keys in [lo, hi) which are less than the key
+		template<typename K, typename ComparatorType>
+		inline usize
+		flat_lower_bound(const K* keys, usize lo, usize hi, const K& key, const ComparatorType& less_than)
+		{
+			while(lo < hi)
+			{
+				usize mid = lo + (hi - lo) / 2;
+				if(less_than(keys[mid], key))
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return lo;
+		}
+
+		//count of keys in [lo, hi) which are less than or equal to the key
+		template<typename K, typename ComparatorType>
+		inline usize
+		flat_upper_bound(const K* keys, usize lo, usize hi, const K& key, const ComparatorType& less_than)
+		{
+			while(lo < hi)
+			{
+				usize mid = lo + (hi - lo) / 2;
+				if(less_than(key, keys[mid]))
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+			return lo;
+		}
+
+		//the keys in [0, sorted_count) are sorted and unique and the rest were appended by a batch insert
+		//returns the indices of the appended keys that should be merged in sorted order
+		//keys which already exist or are repeated in the batch are dropped, the first occurrence wins
+		template<typename K, typename ComparatorType>
+		inline dynamic_array<usize>
+		flat_batch_order(const dynamic_array<K>& keys, usize sorted_count, const ComparatorType& less_than)
+		{
+			usize batch_count = keys.count() - sorted_count;
+			dynamic_array<usize> order(keys._context);
+			order.reserve(batch_count);
+			for(usize i = 0; i < batch_count; ++i)
+				order.insert_back(sorted_count + i);
+
+			if(batch_count > 1)
+				quick_sort(order.begin(), batch_count,
+					flat_index_less_than<K, ComparatorType>{keys.data(), &less_than});
+
+			usize kept = 0, search_start = 0;
+			for(usize i = 0; i < batch_count; ++i)
+			{
+				const K& key = keys[order[i]];
+				if(kept > 0 && !less_than(keys[order[kept - 1]], key))
+					continue;
+
+				//the batch is sorted so the search can start where the last one ended
+				search_start = flat_lower_bound(keys.data(), search_start, sorted_count, key, less_than);
+				if(search_start < sorted_count && !less_than(key, keys[search_start]))
+					continue;
+
+				order[kept++] = order[i];
+			}
+			order.remove_back(batch_count - kept);
+			return order;
+		}
+
+		//replaces dst with src by destroying and move constructing it in place so dst's old content is always released
+		template<typename T>
+		inline void
+		flat_move(T& dst, T& src)
+		{
+			dst.~T();
+			new (&dst) T(std::move(src));
+		}
+
+		//moves the element at index from down to index to keeping the order of the elements in between
+		template<typename T>
+		inline void
+		flat_rotate_down(dynamic_array<T>& arr, usize from, usize to)
+		{
+			T tmp(std::move(arr[from]));
+			for(usize i = from; i > to; --i)
+				flat_move(arr[i], arr[i - 1]);
+			flat_move(arr[to], tmp);
+		}
+
+		template<typename T>
+		inline void
+		flat_erase(dynamic_array<T>& arr, usize index)
+		{
+			for(usize i = index + 1; i < arr.count(); ++i)
+				flat_move(arr[i - 1], arr[i]);
+			arr.remove_back();
+		}
+	}
+
+	//a sorted set stored in a single contiguous array, it's best for small read mostly sets
+	//lookups are binary searches and single inserts/removals shift the elements after them
+	template<typename T, typename ComparatorType = default_less_than<T>>
+	struct flat_set
+	{
+		using data_type = T;
+		using key_type = T;
+		using iterator = sequential_iterator<const T>;
+		using const_iterator = sequential_iterator<const T>;
+
+		dynamic_array<T> _keys;
+		ComparatorType _less_than;
+
+		flat_set(memory_context* context = platform->global_memory)
+			:_keys(context)
+		{}
+
+		flat_set(const ComparatorType& compare_function, memory_context* context = platform->global_memory)
+			:_keys(context), _less_than(compare_function)
+		{}
+
+		flat_set(std::initializer_list<T> list,
+				 const ComparatorType& compare_function = ComparatorType(),
+				 memory_context* context = platform->global_memory)
+			:_keys(context), _less_than(compare_function)
+		{
+			insert_batch(list.begin(), list.size());
+		}
+
+		flat_set(const flat_set& other)
+			:_keys(other._keys), _less_than(other._less_than)
+		{}
+
+		flat_set(const flat_set& other, memory_context* context)
+			:_keys(other._keys, context), _less_than(other._less_than)
+		{}
+
+		flat_set(flat_set&& other)
+			:_keys(std::move(other._keys)), _less_than(std::move(other._less_than))
+		{}
+
+		flat_set(flat_set&& other, memory_context* context)
+			:_keys(std::move(other._keys), context), _less_than(std::move(other._less_than))
+		{}
+
+		flat_set&
+		operator=(const flat_set& other)
+		{
+			_keys = other._keys;
+			_less_than = other._less_than;
+			return *this;
+		}
+
+		flat_set&
+		operator=(flat_set&& other)
+		{
+			_keys = std::move(other._keys);
+			_less_than = std::move(other._less_than);
+			return *this;
+		}
+
+		iterator
+		insert(const T& data)
+		{
+			return iterator(_keys.data() + _insert(data));
+		}
+
+		iterator
+		insert(T&& data)
+		{
+			return iterator(_keys.data() + _insert(std::move(data)));
+		}
+
+		//appends the elements then sorts and merges them with the existing ones in one pass
+		template<typename iterator_type>
+		void
+		insert_batch(iterator_type it, usize count)
+		{
+			usize sorted_count = _keys.count();
+			_keys.reserve(count);
+			for(usize i = 0; i < count; ++i)
+			{
+				_keys.insert_back(*it);
+				it = next(it);
+			}
+			_merge_batch(sorted_count);
+		}
+
+		void
+		insert_batch(std::initializer_list<T> list)
+		{
+			insert_batch(list.begin(), list.size());
+		}
+
+		void
+		remove(const T& data)
+		{
+			usize index = _lookup(data);
+			if(index != _keys.count())
+				details::flat_erase(_keys, index);
+		}
+
+		void
+		remove(const_iterator it)
+		{
+			usize index = it._element - _keys.data();
+			if(index != _keys.count())
+				details::flat_erase(_keys, index);
+		}
+
+		const_iterator
+		lookup(const T& data) const
+		{
+			return const_iterator(_keys.data() + _lookup(data));
+		}
+
+		const_iterator
+		lower_bound(const T& data) const
+		{
+			return const_iterator(_keys.data() +
+				details::flat_lower_bound(_keys.data(), 0, _keys.count(), data, _less_than));
+		}
+
+		const_iterator
+		upper_bound(const T& data) const
+		{
+			return const_iterator(_keys.data() +
+				details::flat_upper_bound(_keys.data(), 0, _keys.count(), data, _less_than));
+		}
+
+		const T&
+		operator[](usize index) const
+		{
+			return _keys[index];
+		}
+
+		void
+		reserve(usize count)
+		{
+			_keys.reserve(count);
+		}
+
+		void
+		shrink_to_fit()
+		{
+			_keys.shrink_to_fit();
+		}
+
+		void
+		clear()
+		{
+			_keys.clear();
+		}
+
+		usize
+		count() const
+		{
+			return _keys.count();
+		}
+
+		bool
+		empty() const
+		{
+			return _keys.empty();
+		}
+
+		const_iterator
+		begin() const
+		{
+			return _keys.begin();
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return _keys.cbegin();
+		}
+
+		const_iterator
+		end() const
+		{
+			return _keys.end();
+		}
+
+		const_iterator
+		cend() const
+		{
+			return _keys.cend();
+		}
+
+		usize
+		_lookup(const T& data) const
+		{
+			usize index = details::flat_lower_bound(_keys.data(), 0, _keys.count(), data, _less_than);
+			if(index < _keys.count() && !_less_than(data, _keys[index]))
+				return index;
+			return _keys.count();
+		}
+
+		template<typename KeyArg>
+		usize
+		_insert(KeyArg&& data)
+		{
+			usize index = details::flat_lower_bound(_keys.data(), 0, _keys.count(), data, _less_than);
+			if(index < _keys.count() && !_less_than(data, _keys[index]))
+				return index;
+
+			_keys.insert_back(std::forward<KeyArg>(data));
+			details::flat_rotate_down(_keys, _keys.count() - 1, index);
+			return index;
+		}
+
+		void
+		_merge_batch(usize sorted_count)
+		{
+			dynamic_array<usize> order = details::flat_batch_order(_keys, sorted_count, _less_than);
+			usize kept = order.count();
+
+			//move the kept elements out of the tail then merge from the back so nothing is overwritten
+			dynamic_array<T> batch(_keys._context);
+			batch.reserve(kept);
+			for(usize i = 0; i < kept; ++i)
+				batch.insert_back(std::move(_keys[order[i]]));
+
+			usize i = sorted_count, j = kept, w = sorted_count + kept;
+			while(j > 0)
+			{
+				if(i > 0 && _less_than(batch[j - 1], _keys[i - 1]))
+				{
+					--i; --w;
+					details::flat_move(_keys[w], _keys[i]);
+				}
+				else
+				{
+					--j; --w;
+					details::flat_move(_keys[w], batch[j]);
+				}
+			}
+			_keys.remove_back(_keys.count() - (sorted_count + kept));
+		}
+
+		bool
+		_is_sorted() const
+		{
+			for(usize i = 1; i < _keys.count(); ++i)
+				if(!_less_than(_keys[i - 1], _keys[i]))
+					return false;
+			return true;
+		}
+	};
+
+	//a sorted map stored as two parallel columns of keys and values so searches only touch the keys
+	template<typename KeyType, typename ValueType,
+			 typename ComparatorType = default_less_than<KeyType>>
+	struct flat_map
+	{
+		using key_type = KeyType;
+		using value_type = ValueType;
+		using data_type = KeyType;
+		using iterator = flat_map_iterator<key_type, value_type>;
+		using const_iterator = const_flat_map_iterator<key_type, value_type>;
+
+		dynamic_array<key_type> _keys;
+		dynamic_array<value_type> _values;
+		ComparatorType _less_than;
+
+		flat_map(memory_context* context = platform->global_memory)
+			:_keys(context), _values(context)
+		{}
+
+		flat_map(const ComparatorType& compare_function, memory_context* context = platform->global_memory)
+			:_keys(context), _values(context), _less_than(compare_function)
+		{}
+
+		flat_map(std::initializer_list<details::pair_node<key_type, value_type>> list,
+				 const ComparatorType& compare_function = ComparatorType(),
+				 memory_context* context = platform->global_memory)
+			:_keys(context), _values(context), _less_than(compare_function)
+		{
+			insert_batch(list);
+		}
+
+		flat_map(const flat_map& other)
+			:_keys(other._keys), _values(other._values), _less_than(other._less_than)
+		{}
+
+		flat_map(const flat_map& other, memory_context* context)
+			:_keys(other._keys, context), _values(other._values, context), _less_than(other._less_than)
+		{}
+
+		flat_map(flat_map&& other)
+			:_keys(std::move(other._keys)),
+			 _values(std::move(other._values)),
+			 _less_than(std::move(other._less_than))
+		{}
+
+		flat_map(flat_map&& other, memory_context* context)
+			:_keys(std::move(other._keys), context),
+			 _values(std::move(other._values), context),
+			 _less_than(std::move(other._less_than))
+		{}
+
+		flat_map&
+		operator=(const flat_map& other)
+		{
+			_keys = other._keys;
+			_values = other._values;
+			_less_than = other._less_than;
+			return *this;
+		}
+
+		flat_map&
+		operator=(flat_map&& other)
+		{
+			_keys = std::move(other._keys);
+			_values = std::move(other._values);
+			_less_than = std::move(other._less_than);
+			return *this;
+		}
+
+		value_type&
+		operator[](const key_type& key)
+		{
+			return _values[_insert(key)];
+		}
+
+		value_type&
+		operator[](key_type&& key)
+		{
+			return _values[_insert(std::move(key))];
+		}
+
+		iterator
+		insert(const key_type& key)
+		{
+			return _iterator_at(_insert(key));
+		}
+
+		iterator
+		insert(key_type&& key)
+		{
+			return _iterator_at(_insert(std::move(key)));
+		}
+
+		iterator
+		insert(const key_type& key, const value_type& value)
+		{
+			return _iterator_at(_insert(key, value));
+		}
+
+		iterator
+		insert(key_type&& key, const value_type& value)
+		{
+			return _iterator_at(_insert(std::move(key), value));
+		}
+
+		iterator
+		insert(const key_type& key, value_type&& value)
+		{
+			return _iterator_at(_insert(key, std::move(value)));
+		}
+
+		iterator
+		insert(key_type&& key, value_type&& value)
+		{
+			return _iterator_at(_insert(std::move(key), std::move(value)));
+		}
+
+		//appends the pairs then sorts and merges them with the existing ones in one pass
+		template<typename key_iterator_type, typename value_iterator_type>
+		void
+		insert_batch(key_iterator_type key_it, value_iterator_type value_it, usize count)
+		{
+			usize sorted_count = _keys.count();
+			_keys.reserve(count);
+			_values.reserve(count);
+			for(usize i = 0; i < count; ++i)
+			{
+				_keys.insert_back(*key_it);
+				_values.insert_back(*value_it);
+				key_it = next(key_it);
+				value_it = next(value_it);
+			}
+			_merge_batch(sorted_count);
+		}
+
+		void
+		insert_batch(std::initializer_list<details::pair_node<key_type, value_type>> list)
+		{
+			usize sorted_count = _keys.count();
+			_keys.reserve(list.size());
+			_values.reserve(list.size());
+			for(const auto& pair: list)
+			{
+				_keys.insert_back(pair.key);
+				_values.insert_back(pair.value);
+			}
+			_merge_batch(sorted_count);
+		}
+
+		void
+		remove(const key_type& key)
+		{
+			usize index = _lookup(key);
+			if(index != _keys.count())
+				_erase(index);
+		}
+
+		void
+		remove(const const_iterator& it)
+		{
+			usize index = it.key_it._element - _keys.data();
+			if(index != _keys.count())
+				_erase(index);
+		}
+
+		iterator
+		lookup(const key_type& key)
+		{
+			return _iterator_at(_lookup(key));
+		}
+
+		const_iterator
+		lookup(const key_type& key) const
+		{
+			return _iterator_at(_lookup(key));
+		}
+
+		iterator
+		lower_bound(const key_type& key)
+		{
+			return _iterator_at(details::flat_lower_bound(_keys.data(), 0, _keys.count(), key, _less_than));
+		}
+
+		const_iterator
+		lower_bound(const key_type& key) const
+		{
+			return _iterator_at(details::flat_lower_bound(_keys.data(), 0, _keys.count(), key, _less_than));
+		}
+
+		iterator
+		upper_bound(const key_type& key)
+		{
+			return _iterator_at(details::flat_upper_bound(_keys.data(), 0, _keys.count(), key, _less_than));
+		}
+
+		const_iterator
+		upper_bound(const key_type& key) const
+		{
+			return _iterator_at(details::flat_upper_bound(_keys.data(), 0, _keys.count(), key, _less_than));
+		}
+
+		template<typename function_type, typename user_type = void>
+		void
+		inorder_traverse(function_type&& FT, user_type* user_data = nullptr)
+		{
+			for(auto it = begin(); it != end(); ++it)
+				FT(it, user_data);
+		}
+
+		void
+		reserve(usize count)
+		{
+			_keys.reserve(count);
+			_values.reserve(count);
+		}
+
+		void
+		shrink_to_fit()
+		{
+			_keys.shrink_to_fit();
+			_values.shrink_to_fit();
+		}
+
+		void
+		clear()
+		{
+			_keys.clear();
+			_values.clear();
+		}
+
+		usize
+		count() const
+		{
+			return _keys.count();
+		}
+
+		bool
+		empty() const
+		{
+			return _keys.empty();
+		}
+
+		iterator
+		begin()
+		{
+			return _iterator_at(0);
+		}
+
+		const_iterator
+		begin() const
+		{
+			return _iterator_at(0);
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return _iterator_at(0);
+		}
+
+		iterator
+		end()
+		{
+			return _iterator_at(_keys.count());
+		}
+
+		const_iterator
+		end() const
+		{
+			return _iterator_at(_keys.count());
+		}
+
+		const_iterator
+		cend() const
+		{
+			return _iterator_at(_keys.count());
+		}
+
+		iterator
+		_iterator_at(usize index)
+		{
+			return iterator(_keys.data() + index, _values.data() + index);
+		}
+
+		const_iterator
+		_iterator_at(usize index) const
+		{
+			return const_iterator(_keys.data() + index, _values.data() + index);
+		}
+
+		usize
+		_lookup(const key_type& key) const
+		{
+			usize index = details::flat_lower_bound(_keys.data(), 0, _keys.count(), key, _less_than);
+			if(index < _keys.count() && !_less_than(key, _keys[index]))
+				return index;
+			return _keys.count();
+		}
+
+		template<typename KeyArg, typename ... TArgs>
+		usize
+		_insert(KeyArg&& key, TArgs&& ... args)
+		{
+			usize index = details::flat_lower_bound(_keys.data(), 0, _keys.count(), key, _less_than);
+			if(index < _keys.count() && !_less_than(key, _keys[index]))
+				return index;
+
+			_keys.insert_back(std::forward<KeyArg>(key));
+			_values.emplace_back(std::forward<TArgs>(args)...);
+			details::flat_rotate_down(_keys, _keys.count() - 1, index);
+			details::flat_rotate_down(_values, _values.count() - 1, index);
+			return index;
+		}
+
+		void
+		_erase(usize index)
+		{
+			details::flat_erase(_keys, index);
+			details::flat_erase(_values, index);
+		}
+
+		void
+		_merge_batch(usize sorted_count)
+		{
+			dynamic_array<usize> order = details::flat_batch_order(_keys, sorted_count, _less_than);
+			usize kept = order.count();
+
+			//move the kept pairs out of the tail then merge from the back so nothing is overwritten
+			dynamic_array<key_type> batch_keys(_keys._context);
+			dynamic_array<value_type> batch_values(_values._context);
+			batch_keys.reserve(kept);
+			batch_values.reserve(kept);
+			for(usize i = 0; i < kept; ++i)
+			{
+				batch_keys.insert_back(std::move(_keys[order[i]]));
+				batch_values.insert_back(std::move(_values[order[i]]));
+			}
+
+			usize i = sorted_count, j = kept, w = sorted_count + kept;
+			while(j > 0)
+			{
+				if(i > 0 && _less_than(batch_keys[j - 1], _keys[i - 1]))
+				{
+					--i; --w;
+					details::flat_move(_keys[w], _keys[i]);
+					details::flat_move(_values[w], _values[i]);
+				}
+				else
+				{
+					--j; --w;
+					details::flat_move(_keys[w], batch_keys[j]);
+					details::flat_move(_values[w], batch_values[j]);
+				}
+			}
+			_keys.remove_back(_keys.count() - (sorted_count + kept));
+			_values.remove_back(_values.count() - (sorted_count + kept));
+		}
+
+		bool
+		_is_sorted() const
+		{
+			for(usize i = 1; i < _keys.count(); ++i)
+				if(!_less_than(_keys[i - 1], _keys[i]))
+					return false;
+			return true;
+		}
+	};
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/api.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+
+namespace cpprelude
+{
+	//an edge of a graph, the weight is ignored by unweighted graphs
+	struct graph_edge
+	{
+		u32 from;
+		u32 to;
+		r32 weight;
+	};
+
+	//the neighbours of a vertex, they're contiguous in the graph and sorted by vertex
+	struct csr_neighbours
+	{
+		const u32* _targets;
+		const r32* _weights;
+		usize _count;
+
+		const u32*
+		begin() const
+		{
+			return _targets;
+		}
+
+		const u32*
+		end() const
+		{
+			return _targets + _count;
+		}
+
+		u32
+		operator[](usize index) const
+		{
+			return _targets[index];
+		}
+
+		//weight of the edge to the neighbour at the index, 1 for unweighted graphs
+		r32
+		weight(usize index) const
+		{
+			return _weights ? _weights[index] : 1;
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+	};
+
+	/*
+	 * compressed sparse row graph, the out edges of every vertex are stored contiguously and sorted
+	 * offsets[v] to offsets[v + 1] is the range of the targets of vertex v
+	 * so a graph takes 4 bytes per edge, 4 more if it's weighted, and 8 bytes per vertex
+	 * an undirected graph stores every edge in both directions
+	 * the graph is immutable, it's built from an edge list at once
+	 */
+	struct csr_graph
+	{
+		constexpr static u32 unreached = static_cast<u32>(-1);
+
+		dynamic_array<usize> _offsets;
+		dynamic_array<u32> _targets;
+		dynamic_array<r32> _weights;
+		bool _undirected;
+
+		API_CPPR csr_graph(memory_context* context = platform->global_memory);
+
+		//builds the graph with a counting sort of the edges by their source split over threads_count threads
+		//0 threads means a thread per hardware thread
+		API_CPPR void
+		build(usize vertices_count, const slice<graph_edge>& edges,
+			  bool undirected, bool weighted, usize threads_count = 0);
+
+		csr_neighbours
+		neighbours(u32 vertex) const
+		{
+			usize begin = _offsets[vertex];
+			return csr_neighbours{_targets.data() + begin,
+								  _weights.empty() ? nullptr : _weights.data() + begin,
+								  _offsets[vertex + 1] - begin};
+		}
+
+		usize
+		degree(u32 vertex) const
+		{
+			return _offsets[vertex + 1] - _offsets[vertex];
+		}
+
+		usize
+		vertices_count() const
+		{
+			return _offsets.empty() ? 0 : _offsets.count() - 1;
+		}
+
+		//count of stored edges, an undirected edge is stored twice
+		usize
+		edges_count() const
+		{
+			return _targets.count();
+		}
+
+		bool
+		undirected() const
+		{
+			return _undirected;
+		}
+
+		bool
+		weighted() const
+		{
+			return !_weights.empty();
+		}
+
+		//breadth first search, levels gets the count of edges from the source to every vertex or unreached
+		//undirected graphs switch to scanning the unreached vertices for parents when the frontier gets big
+		//returns the count of reached vertices
+		API_CPPR usize
+		bfs(u32 source, dynamic_array<u32>& levels, usize threads_count = 0) const;
+
+		//labels every vertex with a dense id of its component, the ids are ordered by the smallest vertex of each component
+		//the components of a directed graph are the weakly connected ones, returns the count of components
+		API_CPPR usize
+		connected_components(dynamic_array<u32>& labels, usize threads_count = 0) const;
+
+		//kruskal's minimum spanning forest, edges gets the edges of the forest, returns their total weight
+		//a directed graph is treated as undirected
+		API_CPPR r64
+		minimum_spanning_forest(dynamic_array<graph_edge>& edges) const;
+	};
+}
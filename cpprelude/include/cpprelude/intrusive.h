@@ -0,0 +1,971 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/defaults.h"
+#include "cpprelude/tree_map.h"
+
+/*
+ * intrusive containers don't own or allocate their elements, instead the links live inside the elements
+ * an element type derives from the hook of each container it could be put in, and the tag template argument
+ * tells the hooks apart so an element could be in several containers of the same kind at once
+ *
+ * struct job: intrusive_list_hook<struct by_age>, intrusive_list_hook<struct by_owner>
+ * {
+ *     ...
+ * };
+ * intrusive_list<job, by_age> jobs_by_age;
+ * intrusive_list<job, by_owner> jobs_by_owner;
+ *
+ * the element must outlive its time in the container, and it's removed by address in O(1) for lists and O(log n) for trees
+ */
+
+namespace cpprelude
+{
+	template<typename Tag = void>
+	struct intrusive_slist_hook
+	{
+		intrusive_slist_hook* next = nullptr;
+	};
+
+	template<typename Tag = void>
+	struct intrusive_list_hook
+	{
+		intrusive_list_hook *prev = nullptr, *next = nullptr;
+
+		//whether the element is currently in a list
+		bool
+		linked() const
+		{
+			return next != nullptr;
+		}
+	};
+
+	//same layout as the red_black_tree_node minus the data so the red black fixup logic works on it
+	template<typename Tag = void>
+	struct intrusive_tree_hook
+	{
+		enum color_type: bool { RED, BLACK };
+		intrusive_tree_hook *left = nullptr, *right = nullptr, *parent = nullptr;
+		color_type color = RED;
+	};
+
+	template<typename T, typename Tag = void>
+	struct intrusive_slist_iterator
+	{
+		using data_type = T;
+		using hook_type = intrusive_slist_hook<Tag>;
+
+		hook_type* _node;
+
+		intrusive_slist_iterator()
+			:_node(nullptr)
+		{}
+
+		intrusive_slist_iterator(hook_type* node)
+			:_node(node)
+		{}
+
+		intrusive_slist_iterator&
+		operator++()
+		{
+			_node = _node->next;
+			return *this;
+		}
+
+		intrusive_slist_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			_node = _node->next;
+			return result;
+		}
+
+		bool
+		operator==(const intrusive_slist_iterator& other) const
+		{
+			return _node == other._node;
+		}
+
+		bool
+		operator!=(const intrusive_slist_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		T&
+		operator*() const
+		{
+			return *static_cast<T*>(_node);
+		}
+
+		T*
+		operator->() const
+		{
+			return static_cast<T*>(_node);
+		}
+	};
+
+	template<typename T, typename Tag = void>
+	struct intrusive_list_iterator
+	{
+		using data_type = T;
+		using hook_type = intrusive_list_hook<Tag>;
+
+		hook_type* _node;
+
+		intrusive_list_iterator()
+			:_node(nullptr)
+		{}
+
+		intrusive_list_iterator(hook_type* node)
+			:_node(node)
+		{}
+
+		intrusive_list_iterator&
+		operator++()
+		{
+			_node = _node->next;
+			return *this;
+		}
+
+		intrusive_list_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			_node = _node->next;
+			return result;
+		}
+
+		intrusive_list_iterator&
+		operator--()
+		{
+			_node = _node->prev;
+			return *this;
+		}
+
+		intrusive_list_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			_node = _node->prev;
+			return result;
+		}
+
+		bool
+		operator==(const intrusive_list_iterator& other) const
+		{
+			return _node == other._node;
+		}
+
+		bool
+		operator!=(const intrusive_list_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		T&
+		operator*() const
+		{
+			return *static_cast<T*>(_node);
+		}
+
+		T*
+		operator->() const
+		{
+			return static_cast<T*>(_node);
+		}
+	};
+
+	template<typename T, typename Tag = void>
+	struct intrusive_tree_iterator
+	{
+		using data_type = T;
+		using hook_type = intrusive_tree_hook<Tag>;
+
+		hook_type* _node;
+
+		intrusive_tree_iterator()
+			:_node(nullptr)
+		{}
+
+		intrusive_tree_iterator(hook_type* node)
+			:_node(node)
+		{}
+
+		intrusive_tree_iterator&
+		operator++()
+		{
+			if(_node->right != nullptr)
+			{
+				_node = _node->right;
+				while(_node->left != nullptr)
+					_node = _node->left;
+			}
+			else
+			{
+				hook_type* child = _node;
+				_node = _node->parent;
+				while(_node != nullptr && child == _node->right)
+				{
+					child = _node;
+					_node = _node->parent;
+				}
+			}
+			return *this;
+		}
+
+		intrusive_tree_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			operator++();
+			return result;
+		}
+
+		intrusive_tree_iterator&
+		operator--()
+		{
+			if(_node->left != nullptr)
+			{
+				_node = _node->left;
+				while(_node->right != nullptr)
+					_node = _node->right;
+			}
+			else
+			{
+				hook_type* child = _node;
+				_node = _node->parent;
+				while(_node != nullptr && child == _node->left)
+				{
+					child = _node;
+					_node = _node->parent;
+				}
+			}
+			return *this;
+		}
+
+		intrusive_tree_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			operator--();
+			return result;
+		}
+
+		bool
+		operator==(const intrusive_tree_iterator& other) const
+		{
+			return _node == other._node;
+		}
+
+		bool
+		operator!=(const intrusive_tree_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		T&
+		operator*() const
+		{
+			return *static_cast<T*>(_node);
+		}
+
+		T*
+		operator->() const
+		{
+			return static_cast<T*>(_node);
+		}
+	};
+
+	//singly linked intrusive list, T must derive from intrusive_slist_hook<Tag>
+	template<typename T, typename Tag = void>
+	struct intrusive_slist
+	{
+		using data_type = T;
+		using hook_type = intrusive_slist_hook<Tag>;
+		using iterator = intrusive_slist_iterator<T, Tag>;
+		using const_iterator = intrusive_slist_iterator<T, Tag>;
+
+		hook_type* _head;
+		usize _count;
+
+		intrusive_slist()
+			:_head(nullptr), _count(0)
+		{}
+
+		intrusive_slist(const intrusive_slist&) = delete;
+
+		intrusive_slist(intrusive_slist&& other)
+			:_head(other._head), _count(other._count)
+		{
+			other._head = nullptr;
+			other._count = 0;
+		}
+
+		~intrusive_slist()
+		{
+			clear();
+		}
+
+		intrusive_slist&
+		operator=(const intrusive_slist&) = delete;
+
+		intrusive_slist&
+		operator=(intrusive_slist&& other)
+		{
+			if(this == &other)
+				return *this;
+
+			clear();
+			_head = other._head;
+			_count = other._count;
+			other._head = nullptr;
+			other._count = 0;
+			return *this;
+		}
+
+		void
+		insert_front(T& value)
+		{
+			hook_type* node = &value;
+			node->next = _head;
+			_head = node;
+			++_count;
+		}
+
+		void
+		insert_after(const iterator& it, T& value)
+		{
+			hook_type* node = &value;
+			node->next = it._node->next;
+			it._node->next = node;
+			++_count;
+		}
+
+		void
+		remove_front()
+		{
+			hook_type* node = _head;
+			_head = node->next;
+			node->next = nullptr;
+			--_count;
+		}
+
+		void
+		remove_after(const iterator& it)
+		{
+			hook_type* node = it._node->next;
+			it._node->next = node->next;
+			node->next = nullptr;
+			--_count;
+		}
+
+		//unlinks all the elements, the elements themselves are untouched
+		void
+		clear()
+		{
+			while(_head != nullptr)
+				remove_front();
+		}
+
+		T&
+		front() const
+		{
+			return *static_cast<T*>(_head);
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		iterator
+		begin() const
+		{
+			return iterator(_head);
+		}
+
+		iterator
+		cbegin() const
+		{
+			return iterator(_head);
+		}
+
+		iterator
+		end() const
+		{
+			return iterator(nullptr);
+		}
+
+		iterator
+		cend() const
+		{
+			return iterator(nullptr);
+		}
+	};
+
+	//doubly linked intrusive list, T must derive from intrusive_list_hook<Tag>
+	//the elements are linked in a circle through a sentinel hook which lives inside the list
+	template<typename T, typename Tag = void>
+	struct intrusive_list
+	{
+		using data_type = T;
+		using hook_type = intrusive_list_hook<Tag>;
+		using iterator = intrusive_list_iterator<T, Tag>;
+		using const_iterator = intrusive_list_iterator<T, Tag>;
+
+		hook_type _sentinel;
+		usize _count;
+
+		intrusive_list()
+			:_count(0)
+		{
+			_sentinel.prev = _sentinel.next = &_sentinel;
+		}
+
+		intrusive_list(const intrusive_list&) = delete;
+
+		intrusive_list(intrusive_list&& other)
+			:_count(0)
+		{
+			_sentinel.prev = _sentinel.next = &_sentinel;
+			_steal(other);
+		}
+
+		~intrusive_list()
+		{
+			clear();
+		}
+
+		intrusive_list&
+		operator=(const intrusive_list&) = delete;
+
+		intrusive_list&
+		operator=(intrusive_list&& other)
+		{
+			if(this == &other)
+				return *this;
+
+			clear();
+			_steal(other);
+			return *this;
+		}
+
+		void
+		insert_front(T& value)
+		{
+			_link_after(&_sentinel, &value);
+		}
+
+		void
+		insert_back(T& value)
+		{
+			_link_after(_sentinel.prev, &value);
+		}
+
+		void
+		insert_after(const iterator& it, T& value)
+		{
+			_link_after(it._node, &value);
+		}
+
+		void
+		insert_before(const iterator& it, T& value)
+		{
+			_link_after(it._node->prev, &value);
+		}
+
+		//unlinks the element in O(1) without searching for it
+		void
+		remove(T& value)
+		{
+			hook_type* node = &value;
+			node->prev->next = node->next;
+			node->next->prev = node->prev;
+			node->prev = node->next = nullptr;
+			--_count;
+		}
+
+		void
+		remove(const iterator& it)
+		{
+			remove(*it);
+		}
+
+		void
+		remove_front()
+		{
+			remove(front());
+		}
+
+		void
+		remove_back()
+		{
+			remove(back());
+		}
+
+		//unlinks all the elements, the elements themselves are untouched
+		void
+		clear()
+		{
+			hook_type* it = _sentinel.next;
+			while(it != &_sentinel)
+			{
+				hook_type* next_node = it->next;
+				it->prev = it->next = nullptr;
+				it = next_node;
+			}
+			_sentinel.prev = _sentinel.next = &_sentinel;
+			_count = 0;
+		}
+
+		//moves all the elements of the other list to the back of this list in O(1)
+		void
+		splice_back(intrusive_list& other)
+		{
+			if(other._count == 0 || this == &other)
+				return;
+
+			hook_type* first = other._sentinel.next;
+			hook_type* last = other._sentinel.prev;
+			first->prev = _sentinel.prev;
+			_sentinel.prev->next = first;
+			last->next = &_sentinel;
+			_sentinel.prev = last;
+			_count += other._count;
+
+			other._sentinel.prev = other._sentinel.next = &other._sentinel;
+			other._count = 0;
+		}
+
+		//an iterator to an element which is known to be in this list
+		iterator
+		iterator_of(T& value) const
+		{
+			return iterator(&value);
+		}
+
+		T&
+		front() const
+		{
+			return *static_cast<T*>(_sentinel.next);
+		}
+
+		T&
+		back() const
+		{
+			return *static_cast<T*>(_sentinel.prev);
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		iterator
+		begin() const
+		{
+			return iterator(_sentinel.next);
+		}
+
+		iterator
+		cbegin() const
+		{
+			return iterator(_sentinel.next);
+		}
+
+		iterator
+		end() const
+		{
+			return iterator(const_cast<hook_type*>(&_sentinel));
+		}
+
+		iterator
+		cend() const
+		{
+			return end();
+		}
+
+		void
+		_link_after(hook_type* prev_node, hook_type* node)
+		{
+			node->prev = prev_node;
+			node->next = prev_node->next;
+			prev_node->next->prev = node;
+			prev_node->next = node;
+			++_count;
+		}
+
+		void
+		_steal(intrusive_list& other)
+		{
+			if(other._count > 0)
+			{
+				_sentinel.next = other._sentinel.next;
+				_sentinel.prev = other._sentinel.prev;
+				_sentinel.next->prev = &_sentinel;
+				_sentinel.prev->next = &_sentinel;
+				other._sentinel.prev = other._sentinel.next = &other._sentinel;
+			}
+			_count = other._count;
+			other._count = 0;
+		}
+	};
+
+	//intrusive red black tree, T must derive from intrusive_tree_hook<Tag>
+	//elements are unique by the comparator like the red_black_tree
+	template<typename T,
+			 typename ComparatorType = default_less_than<T>,
+			 typename Tag = void>
+	struct intrusive_tree
+	{
+		using data_type = T;
+		using hook_type = intrusive_tree_hook<Tag>;
+		using iterator = intrusive_tree_iterator<T, Tag>;
+		using const_iterator = intrusive_tree_iterator<T, Tag>;
+		using color_type = typename hook_type::color_type;
+		using fixup_type = details::red_black_fixup<hook_type>;
+
+		hook_type* _root;
+		usize _count;
+		ComparatorType _less_than;
+
+		intrusive_tree(const ComparatorType& compare_function = ComparatorType())
+			:_root(nullptr), _count(0), _less_than(compare_function)
+		{}
+
+		intrusive_tree(const intrusive_tree&) = delete;
+
+		intrusive_tree(intrusive_tree&& other)
+			:_root(other._root), _count(other._count), _less_than(std::move(other._less_than))
+		{
+			other._root = nullptr;
+			other._count = 0;
+		}
+
+		~intrusive_tree()
+		{
+			clear();
+		}
+
+		intrusive_tree&
+		operator=(const intrusive_tree&) = delete;
+
+		intrusive_tree&
+		operator=(intrusive_tree&& other)
+		{
+			if(this == &other)
+				return *this;
+
+			clear();
+			_root = other._root;
+			_count = other._count;
+			_less_than = std::move(other._less_than);
+			other._root = nullptr;
+			other._count = 0;
+			return *this;
+		}
+
+		//links the element into the tree, if an equal element is already in the tree
+		//the given element isn't linked and an iterator to the existing one is returned
+		iterator
+		insert(T& value)
+		{
+			hook_type* parent = nullptr;
+			hook_type* it = _root;
+			bool is_left = false;
+			while(it != nullptr)
+			{
+				parent = it;
+				if(_less_than(value, _data(it)))
+				{
+					it = it->left;
+					is_left = true;
+				}
+				else if(_less_than(_data(it), value))
+				{
+					it = it->right;
+					is_left = false;
+				}
+				else
+				{
+					return iterator(it);
+				}
+			}
+
+			hook_type* node = &value;
+			node->left = node->right = nullptr;
+			node->parent = parent;
+			node->color = color_type::RED;
+			if(parent == nullptr)
+				_root = node;
+			else if(is_left)
+				parent->left = node;
+			else
+				parent->right = node;
+
+			++_count;
+			fixup_type::insert_fixup(_root, node);
+			return iterator(node);
+		}
+
+		//unlinks the element which must be in the tree, it relinks the nodes around it instead of copying data
+		void
+		remove(T& value)
+		{
+			hook_type* z = &value;
+			hook_type* y = z;
+			hook_type *x = nullptr, *x_parent = nullptr;
+			color_type removed_color = y->color;
+
+			if(z->left == nullptr)
+			{
+				x = z->right;
+				x_parent = z->parent;
+				_transplant(z, z->right);
+			}
+			else if(z->right == nullptr)
+			{
+				x = z->left;
+				x_parent = z->parent;
+				_transplant(z, z->left);
+			}
+			else
+			{
+				y = z->right;
+				while(y->left != nullptr)
+					y = y->left;
+				removed_color = y->color;
+				x = y->right;
+
+				if(y->parent == z)
+				{
+					x_parent = y;
+				}
+				else
+				{
+					x_parent = y->parent;
+					_transplant(y, y->right);
+					y->right = z->right;
+					y->right->parent = y;
+				}
+
+				_transplant(z, y);
+				y->left = z->left;
+				y->left->parent = y;
+				y->color = z->color;
+			}
+
+			z->left = z->right = z->parent = nullptr;
+			--_count;
+
+			if(removed_color == color_type::BLACK)
+				fixup_type::delete_fixup(_root, x, x_parent);
+		}
+
+		void
+		remove(const iterator& it)
+		{
+			remove(*it);
+		}
+
+		iterator
+		lookup(const T& value) const
+		{
+			hook_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(value, _data(it)))
+					it = it->left;
+				else if(_less_than(_data(it), value))
+					it = it->right;
+				else
+					return iterator(it);
+			}
+			return end();
+		}
+
+		iterator
+		lower_bound(const T& value) const
+		{
+			hook_type *it = _root, *result = nullptr;
+			while(it != nullptr)
+			{
+				if(_less_than(_data(it), value))
+				{
+					it = it->right;
+				}
+				else
+				{
+					result = it;
+					it = it->left;
+				}
+			}
+			return iterator(result);
+		}
+
+		iterator
+		upper_bound(const T& value) const
+		{
+			hook_type *it = _root, *result = nullptr;
+			while(it != nullptr)
+			{
+				if(_less_than(value, _data(it)))
+				{
+					result = it;
+					it = it->left;
+				}
+				else
+				{
+					it = it->right;
+				}
+			}
+			return iterator(result);
+		}
+
+		//unlinks all the elements, the elements themselves are untouched
+		void
+		clear()
+		{
+			_clear(_root);
+			_root = nullptr;
+			_count = 0;
+		}
+
+		iterator
+		min() const
+		{
+			if(_root == nullptr)
+				return end();
+
+			hook_type* it = _root;
+			while(it->left != nullptr)
+				it = it->left;
+			return iterator(it);
+		}
+
+		iterator
+		max() const
+		{
+			if(_root == nullptr)
+				return end();
+
+			hook_type* it = _root;
+			while(it->right != nullptr)
+				it = it->right;
+			return iterator(it);
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		iterator
+		begin() const
+		{
+			return min();
+		}
+
+		iterator
+		cbegin() const
+		{
+			return min();
+		}
+
+		iterator
+		end() const
+		{
+			return iterator(nullptr);
+		}
+
+		iterator
+		cend() const
+		{
+			return iterator(nullptr);
+		}
+
+		static const T&
+		_data(hook_type* node)
+		{
+			return *static_cast<T*>(node);
+		}
+
+		//replaces the subtree rooted at old_node with the one rooted at new_node in old_node's parent
+		void
+		_transplant(hook_type* old_node, hook_type* new_node)
+		{
+			if(old_node->parent == nullptr)
+				_root = new_node;
+			else if(old_node == old_node->parent->left)
+				old_node->parent->left = new_node;
+			else
+				old_node->parent->right = new_node;
+
+			if(new_node != nullptr)
+				new_node->parent = old_node->parent;
+		}
+
+		void
+		_clear(hook_type* node)
+		{
+			while(node != nullptr)
+			{
+				_clear(node->left);
+				hook_type* right = node->right;
+				node->left = node->right = node->parent = nullptr;
+				node = right;
+			}
+		}
+
+		bool
+		_is_red_black_tree() const
+		{
+			return _black_height(_root) != -1;
+		}
+
+		//black height of the subtree or -1 if it breaks the red black or the ordering rules
+		isize
+		_black_height(hook_type* node) const
+		{
+			if(node == nullptr)
+				return 1;
+
+			if(node->left != nullptr && (node->left->parent != node || !_less_than(_data(node->left), _data(node))))
+				return -1;
+			if(node->right != nullptr && (node->right->parent != node || !_less_than(_data(node), _data(node->right))))
+				return -1;
+			if(node->color == color_type::RED &&
+			   ((node->left != nullptr && node->left->color == color_type::RED) ||
+				(node->right != nullptr && node->right->color == color_type::RED)))
+				return -1;
+
+			isize left = _black_height(node->left);
+			isize right = _black_height(node->right);
+			if(left == -1 || right == -1 || left != right)
+				return -1;
+			return left + (node->color == color_type::BLACK ? 1 : 0);
+		}
+	};
+}
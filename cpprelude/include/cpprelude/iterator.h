@@ -32,6 +32,69 @@ namespace cpprelude
 			{}
 		};
 
+		//bottom up merge sort of a null terminated chain of nodes linked by next, it only relinks the nodes
+		//it's stable and needs no extra memory, returns the new head and sets tail to the last node
+		template<typename node_type, typename Comparator>
+		inline node_type*
+		sort_node_chain(node_type* head, Comparator& less_than, node_type** tail_out)
+		{
+			node_type* tail = head;
+			for(usize run_count = 1; head != nullptr; run_count *= 2)
+			{
+				node_type* p = head;
+				head = tail = nullptr;
+				usize merges_count = 0;
+
+				while(p != nullptr)
+				{
+					++merges_count;
+
+					//q starts after at most run_count nodes of p
+					node_type* q = p;
+					usize p_count = 0;
+					while(p_count < run_count && q != nullptr)
+					{
+						++p_count;
+						q = q->next;
+					}
+					usize q_count = run_count;
+
+					//merge the two runs, ties take from p first to keep it stable
+					while(p_count > 0 || (q_count > 0 && q != nullptr))
+					{
+						node_type* e;
+						if(p_count == 0)
+						{
+							e = q; q = q->next; --q_count;
+						}
+						else if(q_count == 0 || q == nullptr || !less_than(q->data, p->data))
+						{
+							e = p; p = p->next; --p_count;
+						}
+						else
+						{
+							e = q; q = q->next; --q_count;
+						}
+
+						if(tail != nullptr)
+							tail->next = e;
+						else
+							head = e;
+						tail = e;
+					}
+					p = q;
+				}
+				tail->next = nullptr;
+
+				if(merges_count <= 1)
+					break;
+			}
+
+			if(tail_out != nullptr)
+				*tail_out = tail;
+			return head;
+		}
+
 		template<typename key_type, typename value_type>
 		struct pair_node
 		{
@@ -90,13 +153,23 @@ namespace cpprelude
 			}
 		};
 
-		template<typename T>
+		//default red black tree augmentation which stores nothing in the nodes
+		struct red_black_tree_no_augment
+		{
+			template<typename node_type>
+			static void
+			update(node_type*)
+			{}
+		};
+
+		template<typename T, typename AugmentType = red_black_tree_no_augment>
 		struct red_black_tree_node
 		{
 			enum color_type: bool { RED, BLACK };
-			red_black_tree_node<T> *left, *right, *parent;
+			red_black_tree_node *left, *right, *parent;
 			T data;
 			color_type color;
+			AugmentType augment;
 
 			red_black_tree_node()
 				:left(nullptr),
@@ -121,6 +194,115 @@ namespace cpprelude
 				 color(color_)
 			{}
 		};
+
+		//empty value used by the b tree when it's used as a set
+		struct b_tree_empty_value
+		{};
+
+		/*
+		 * b tree nodes are layouted this way
+		 * node  = [parent | count | is_leaf | keys[capacity]]
+		 * leaf  = [node | prev | next | values[capacity]]
+		 * inner = [node | children[capacity + 1]]
+		 * keys and values are stored contiguously and are only constructed in the [0, count) range
+		 */
+		template<typename K, usize capacity>
+		struct b_tree_node
+		{
+			b_tree_node* parent;
+			usize count;
+			bool is_leaf;
+			alignas(K) ubyte _keys[sizeof(K) * capacity];
+
+			b_tree_node(bool leaf)
+				:parent(nullptr), count(0), is_leaf(leaf)
+			{}
+
+			K*
+			keys()
+			{
+				return reinterpret_cast<K*>(_keys);
+			}
+
+			const K*
+			keys() const
+			{
+				return reinterpret_cast<const K*>(_keys);
+			}
+		};
+
+		template<typename K, typename V, usize capacity>
+		struct b_tree_leaf: public b_tree_node<K, capacity>
+		{
+			b_tree_leaf *prev, *next;
+			alignas(V) ubyte _values[sizeof(V) * capacity];
+
+			b_tree_leaf()
+				:b_tree_node<K, capacity>(true), prev(nullptr), next(nullptr)
+			{}
+
+			V*
+			values()
+			{
+				return reinterpret_cast<V*>(_values);
+			}
+
+			const V*
+			values() const
+			{
+				return reinterpret_cast<const V*>(_values);
+			}
+		};
+
+		template<typename K, usize capacity>
+		struct b_tree_inner: public b_tree_node<K, capacity>
+		{
+			b_tree_node<K, capacity>* children[capacity + 1];
+
+			b_tree_inner()
+				:b_tree_node<K, capacity>(false)
+			{}
+		};
+
+		/*
+		 * unrolled list node layout
+		 * node = [prev | next | first | last | data[capacity]]
+		 * the elements live in the [first, last) range of data so the node could grow from both ends
+		 * the list sentinel is a bare unrolled_node_base with first == last == 0
+		 */
+		struct unrolled_node_base
+		{
+			unrolled_node_base *prev, *next;
+			usize first, last;
+
+			unrolled_node_base()
+				:prev(this), next(this), first(0), last(0)
+			{}
+
+			usize
+			count() const
+			{
+				return last - first;
+			}
+		};
+
+		template<typename T, usize capacity>
+		struct unrolled_node: public unrolled_node_base
+		{
+			alignas(T) ubyte _data[sizeof(T) * capacity];
+
+			T*
+			data()
+			{
+				return reinterpret_cast<T*>(_data);
+			}
+
+			const T*
+			data() const
+			{
+				return reinterpret_cast<const T*>(_data);
+			}
+		};
 	}
 
 	template<typename T>
@@ -214,6 +396,38 @@ namespace cpprelude
 		}
 	};
 
+	//a pair of iterators denoting the [first, last) range of elements
+	template<typename iterator_type>
+	struct iterator_range
+	{
+		iterator_type first, last;
+
+		iterator_range()
+		{}
+
+		iterator_range(const iterator_type& first_, const iterator_type& last_)
+			:first(first_), last(last_)
+		{}
+
+		iterator_type
+		begin() const
+		{
+			return first;
+		}
+
+		iterator_type
+		end() const
+		{
+			return last;
+		}
+
+		bool
+		empty() const
+		{
+			return first == last;
+		}
+	};
+
 	template<typename T>
 	struct const_forward_iterator;
 
@@ -568,6 +782,223 @@ namespace cpprelude
 		}
 	};
 
+	template<typename T, usize capacity>
+	struct const_unrolled_list_iterator;
+
+	//an element is addressed by its node and its index inside the node's data
+	template<typename T, usize capacity>
+	struct unrolled_list_iterator
+	{
+		using data_type = T;
+		using node_type = details::unrolled_node<T, capacity>;
+
+		details::unrolled_node_base* _node;
+		usize _index;
+
+		unrolled_list_iterator()
+			:_node(nullptr), _index(0)
+		{}
+
+		unrolled_list_iterator(details::unrolled_node_base* node, usize index)
+			:_node(node), _index(index)
+		{}
+
+		unrolled_list_iterator&
+		operator++()
+		{
+			if(++_index >= _node->last)
+			{
+				_node = _node->next;
+				_index = _node->first;
+			}
+			return *this;
+		}
+
+		unrolled_list_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			operator++();
+			return result;
+		}
+
+		unrolled_list_iterator&
+		operator--()
+		{
+			if(_index <= _node->first)
+			{
+				_node = _node->prev;
+				_index = _node->last;
+			}
+			--_index;
+			return *this;
+		}
+
+		unrolled_list_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			operator--();
+			return result;
+		}
+
+		bool
+		operator==(const unrolled_list_iterator& other) const
+		{
+			return _node == other._node && _index == other._index;
+		}
+
+		bool
+		operator!=(const unrolled_list_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		bool
+		operator==(const const_unrolled_list_iterator<T, capacity>& other) const
+		{
+			return _node == other._node && _index == other._index;
+		}
+
+		bool
+		operator!=(const const_unrolled_list_iterator<T, capacity>& other) const
+		{
+			return !operator==(other);
+		}
+
+		const T&
+		operator*() const
+		{
+			return static_cast<node_type*>(_node)->data()[_index];
+		}
+
+		T&
+		operator*()
+		{
+			return static_cast<node_type*>(_node)->data()[_index];
+		}
+
+		T*
+		operator->()
+		{
+			return static_cast<node_type*>(_node)->data() + _index;
+		}
+
+		const T*
+		operator->() const
+		{
+			return static_cast<node_type*>(_node)->data() + _index;
+		}
+	};
+
+	template<typename T, usize capacity>
+	struct const_unrolled_list_iterator
+	{
+		using data_type = T;
+		using node_type = details::unrolled_node<T, capacity>;
+
+		const details::unrolled_node_base* _node;
+		usize _index;
+
+		const_unrolled_list_iterator()
+			:_node(nullptr), _index(0)
+		{}
+
+		const_unrolled_list_iterator(const details::unrolled_node_base* node, usize index)
+			:_node(node), _index(index)
+		{}
+
+		const_unrolled_list_iterator(const unrolled_list_iterator<T, capacity>& other)
+			:_node(other._node), _index(other._index)
+		{}
+
+		const_unrolled_list_iterator&
+		operator++()
+		{
+			if(++_index >= _node->last)
+			{
+				_node = _node->next;
+				_index = _node->first;
+			}
+			return *this;
+		}
+
+		const_unrolled_list_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			operator++();
+			return result;
+		}
+
+		const_unrolled_list_iterator&
+		operator--()
+		{
+			if(_index <= _node->first)
+			{
+				_node = _node->prev;
+				_index = _node->last;
+			}
+			--_index;
+			return *this;
+		}
+
+		const_unrolled_list_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			operator--();
+			return result;
+		}
+
+		bool
+		operator==(const const_unrolled_list_iterator& other) const
+		{
+			return _node == other._node && _index == other._index;
+		}
+
+		bool
+		operator!=(const const_unrolled_list_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		bool
+		operator==(const unrolled_list_iterator<T, capacity>& other) const
+		{
+			return _node == other._node && _index == other._index;
+		}
+
+		bool
+		operator!=(const unrolled_list_iterator<T, capacity>& other) const
+		{
+			return !operator==(other);
+		}
+
+		const T&
+		operator*() const
+		{
+			return static_cast<const node_type*>(_node)->data()[_index];
+		}
+
+		const T*
+		operator->() const
+		{
+			return static_cast<const node_type*>(_node)->data() + _index;
+		}
+	};
+
+	namespace details
+	{
+		//a bucket of a bucket_array, buckets have different sizes since they grow geometrically
+		template<typename T>
+		struct bucket_array_bucket
+		{
+			T* data;
+			usize size;
+		};
+	}
+
 	template<typename T, usize bucket_size>
 	struct const_bucket_array_iterator;
 
@@ -575,7 +1006,7 @@ namespace cpprelude
 	struct bucket_array_iterator
 	{
 		using data_type = T;
-		T** _bucket_it;
+		details::bucket_array_bucket<T>* _bucket_it;
 		T* _element_it;
 		usize _index;
 
@@ -583,7 +1014,7 @@ namespace cpprelude
 			:_bucket_it(nullptr), _element_it(nullptr), _index(0)
 		{}
 
-		bucket_array_iterator(T** bucket_it,
+		bucket_array_iterator(details::bucket_array_bucket<T>* bucket_it,
 							  T* element_it, usize index)
 			:_bucket_it(bucket_it), _element_it(element_it), _index(index)
 		{}
@@ -593,11 +1024,11 @@ namespace cpprelude
 		{
 			++_index;
 
-			if (_index >= bucket_size)
+			if (_index >= _bucket_it->size)
 			{
 				_index = 0;
 				++_bucket_it;
-				_element_it = *_bucket_it;
+				_element_it = _bucket_it->data;
 			}
 			else
 			{
@@ -614,11 +1045,11 @@ namespace cpprelude
 
 			++_index;
 
-			if (_index >= bucket_size)
+			if (_index >= _bucket_it->size)
 			{
 				_index = 0;
 				++_bucket_it;
-				_element_it = *_bucket_it;
+				_element_it = _bucket_it->data;
 			}
 			else
 			{
@@ -639,8 +1070,8 @@ namespace cpprelude
 			else
 			{
 				--_bucket_it;
-				_index = bucket_size - 1;
-				_element_it = *_bucket_it + _index;
+				_index = _bucket_it->size - 1;
+				_element_it = _bucket_it->data + _index;
 			}
 
 			return *this;
@@ -659,8 +1090,8 @@ namespace cpprelude
 			else
 			{
 				--_bucket_it;
-				_index = bucket_size - 1;
-				_element_it = *_bucket_it + _index;
+				_index = _bucket_it->size - 1;
+				_element_it = _bucket_it->data + _index;
 			}
 
 			return result;
@@ -719,7 +1150,7 @@ namespace cpprelude
 	struct const_bucket_array_iterator
 	{
 		using data_type = T;
-		const T** _bucket_it;
+		const details::bucket_array_bucket<T>* _bucket_it;
 		const T* _element_it;
 		usize _index;
 
@@ -727,13 +1158,13 @@ namespace cpprelude
 			:_bucket_it(nullptr), _element_it(nullptr), _index(0)
 		{}
 
-		const_bucket_array_iterator(const T** bucket_it,
+		const_bucket_array_iterator(const details::bucket_array_bucket<T>* bucket_it,
 							  const T* element_it, usize index)
 			:_bucket_it(bucket_it), _element_it(element_it), _index(index)
 		{}
 
 		const_bucket_array_iterator(const bucket_array_iterator<T, bucket_size>& other)
-			:_bucket_it(const_cast<const T**>(other._bucket_it)),
+			:_bucket_it(other._bucket_it),
 			 _element_it(const_cast<const T*>(other._element_it)),
 			 _index(other._index)
 		{}
@@ -743,11 +1174,11 @@ namespace cpprelude
 		{
 			++_index;
 
-			if (_index >= bucket_size)
+			if (_index >= _bucket_it->size)
 			{
 				_index = 0;
 				++_bucket_it;
-				_element_it = *_bucket_it;
+				_element_it = _bucket_it->data;
 			}
 			else
 			{
@@ -764,11 +1195,11 @@ namespace cpprelude
 
 			++_index;
 
-			if (_index >= bucket_size)
+			if (_index >= _bucket_it->size)
 			{
 				_index = 0;
 				++_bucket_it;
-				_element_it = *_bucket_it;
+				_element_it = _bucket_it->data;
 			}
 			else
 			{
@@ -789,8 +1220,8 @@ namespace cpprelude
 			else
 			{
 				--_bucket_it;
-				_index = bucket_size - 1;
-				_element_it = *_bucket_it + _index;
+				_index = _bucket_it->size - 1;
+				_element_it = _bucket_it->data + _index;
 			}
 
 			return *this;
@@ -809,8 +1240,8 @@ namespace cpprelude
 			else
 			{
 				--_bucket_it;
-				_index = bucket_size - 1;
-				_element_it = *_bucket_it + _index;
+				_index = _bucket_it->size - 1;
+				_element_it = _bucket_it->data + _index;
 			}
 
 			return result;
@@ -1178,47 +1609,259 @@ namespace cpprelude
 		}
 	};
 
-	template<typename value_type>
-	struct hash_array_value_iterator
+	template<typename key_type, typename value_type>
+	struct const_flat_map_iterator;
+
+	//iterates the parallel key and value columns of a flat_map together
+	template<typename key_type, typename value_type>
+	struct flat_map_iterator
 	{
+		sequential_iterator<const key_type> key_it;
 		sequential_iterator<value_type> value_it;
-		sequential_iterator<u8> _flag_it;
-		usize _capacity;
 
-		hash_array_value_iterator()
-		{_capacity = 0;}
+		flat_map_iterator()
+		{}
 
-		hash_array_value_iterator(value_type* value, u8* flag, usize capacity)
-			:value_it(value), _flag_it(flag), _capacity(capacity)
+		flat_map_iterator(const key_type* key, value_type* value)
+			:key_it(key), value_it(value)
 		{}
 
-		hash_array_value_iterator&
+		flat_map_iterator&
 		operator++()
 		{
-			++_flag_it;
+			++key_it;
 			++value_it;
-			--_capacity;
-
-			while(*_flag_it == 0 && _capacity > 0)
-			{
-				++_flag_it;
-				++value_it;
-				--_capacity;
-			}
-
 			return *this;
 		}
 
-		hash_array_value_iterator&
+		flat_map_iterator
 		operator++(int)
 		{
 			auto result = *this;
-
-			++_flag_it;
+			++key_it;
 			++value_it;
-			--_capacity;
+			return result;
+		}
 
-			while(*_flag_it == 0 && _capacity > 0)
+		flat_map_iterator&
+		operator--()
+		{
+			--key_it;
+			--value_it;
+			return *this;
+		}
+
+		flat_map_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			--key_it;
+			--value_it;
+			return result;
+		}
+
+		bool
+		operator==(const flat_map_iterator& other) const
+		{
+			return key_it == other.key_it;
+		}
+
+		bool
+		operator!=(const flat_map_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		bool
+		operator==(const const_flat_map_iterator<key_type, value_type>& other) const
+		{
+			return key_it == other.key_it;
+		}
+
+		bool
+		operator!=(const const_flat_map_iterator<key_type, value_type>& other) const
+		{
+			return !operator==(other);
+		}
+
+		const key_type&
+		operator*() const
+		{
+			return *key_it;
+		}
+
+		const key_type&
+		key() const
+		{
+			return *key_it;
+		}
+
+		value_type&
+		value()
+		{
+			return *value_it;
+		}
+
+		const value_type&
+		value() const
+		{
+			return *value_it;
+		}
+
+		value_type*
+		operator->()
+		{
+			return value_it;
+		}
+
+		const value_type*
+		operator->() const
+		{
+			return value_it;
+		}
+	};
+
+	template<typename key_type, typename value_type>
+	struct const_flat_map_iterator
+	{
+		sequential_iterator<const key_type> key_it;
+		sequential_iterator<const value_type> value_it;
+
+		const_flat_map_iterator()
+		{}
+
+		const_flat_map_iterator(const key_type* key, const value_type* value)
+			:key_it(key), value_it(value)
+		{}
+
+		const_flat_map_iterator(const flat_map_iterator<key_type, value_type>& other)
+			:key_it(other.key_it), value_it(other.value_it)
+		{}
+
+		const_flat_map_iterator&
+		operator++()
+		{
+			++key_it;
+			++value_it;
+			return *this;
+		}
+
+		const_flat_map_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			++key_it;
+			++value_it;
+			return result;
+		}
+
+		const_flat_map_iterator&
+		operator--()
+		{
+			--key_it;
+			--value_it;
+			return *this;
+		}
+
+		const_flat_map_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			--key_it;
+			--value_it;
+			return result;
+		}
+
+		bool
+		operator==(const const_flat_map_iterator& other) const
+		{
+			return key_it == other.key_it;
+		}
+
+		bool
+		operator!=(const const_flat_map_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		bool
+		operator==(const flat_map_iterator<key_type, value_type>& other) const
+		{
+			return key_it == other.key_it;
+		}
+
+		bool
+		operator!=(const flat_map_iterator<key_type, value_type>& other) const
+		{
+			return !operator==(other);
+		}
+
+		const key_type&
+		operator*() const
+		{
+			return *key_it;
+		}
+
+		const key_type&
+		key() const
+		{
+			return *key_it;
+		}
+
+		const value_type&
+		value() const
+		{
+			return *value_it;
+		}
+
+		const value_type*
+		operator->() const
+		{
+			return value_it;
+		}
+	};
+
+	template<typename value_type>
+	struct hash_array_value_iterator
+	{
+		sequential_iterator<value_type> value_it;
+		sequential_iterator<u8> _flag_it;
+		usize _capacity;
+
+		hash_array_value_iterator()
+		{_capacity = 0;}
+
+		hash_array_value_iterator(value_type* value, u8* flag, usize capacity)
+			:value_it(value), _flag_it(flag), _capacity(capacity)
+		{}
+
+		hash_array_value_iterator&
+		operator++()
+		{
+			++_flag_it;
+			++value_it;
+			--_capacity;
+
+			while(*_flag_it == 0 && _capacity > 0)
+			{
+				++_flag_it;
+				++value_it;
+				--_capacity;
+			}
+
+			return *this;
+		}
+
+		hash_array_value_iterator&
+		operator++(int)
+		{
+			auto result = *this;
+
+			++_flag_it;
+			++value_it;
+			--_capacity;
+
+			while(*_flag_it == 0 && _capacity > 0)
 			{
 				++_flag_it;
 				++value_it;
@@ -1469,11 +2112,11 @@ namespace cpprelude
 		}
 	};
 
-	template<typename T>
+	template<typename T, typename AugmentType = details::red_black_tree_no_augment>
 	struct red_black_tree_iterator
 	{
 		using data_type = const T;
-		using node_type = const details::red_black_tree_node<T>;
+		using node_type = const details::red_black_tree_node<T, AugmentType>;
 
 		node_type* node;
 
@@ -1615,17 +2258,19 @@ namespace cpprelude
 		}
 	};
 
-	template<typename KeyType, typename ValueType>
+	template<typename KeyType, typename ValueType,
+			 typename AugmentType = details::red_black_tree_no_augment>
 	struct red_black_tree_const_pair_iterator;
 
-	template<typename KeyType, typename ValueType>
-	struct red_black_tree_pair_iterator: public red_black_tree_iterator<details::pair_node<KeyType, ValueType>>
+	template<typename KeyType, typename ValueType,
+			 typename AugmentType = details::red_black_tree_no_augment>
+	struct red_black_tree_pair_iterator: public red_black_tree_iterator<details::pair_node<KeyType, ValueType>, AugmentType>
 	{
 		using key_type = KeyType;
 		using value_type = ValueType;
 		using data_type = const details::pair_node<KeyType, ValueType>;
-		using node_type = const details::red_black_tree_node<details::pair_node<KeyType, ValueType>>;
-		using _implementation = red_black_tree_iterator<details::pair_node<KeyType, ValueType>>;
+		using node_type = const details::red_black_tree_node<details::pair_node<KeyType, ValueType>, AugmentType>;
+		using _implementation = red_black_tree_iterator<details::pair_node<KeyType, ValueType>, AugmentType>;
 
 		red_black_tree_pair_iterator()
 			:_implementation()
@@ -1635,7 +2280,7 @@ namespace cpprelude
 			:_implementation(node_)
 		{}
 
-		red_black_tree_pair_iterator(const red_black_tree_iterator<details::pair_node<KeyType, ValueType>>& it)
+		red_black_tree_pair_iterator(const red_black_tree_iterator<details::pair_node<KeyType, ValueType>, AugmentType>& it)
 			:_implementation(it.node)
 		{}
 
@@ -1682,13 +2327,13 @@ namespace cpprelude
 		}
 
 		bool
-		operator==(const red_black_tree_const_pair_iterator<key_type, value_type>& other) const
+		operator==(const red_black_tree_const_pair_iterator<key_type, value_type, AugmentType>& other) const
 		{
 			return this->node == other.node;
 		}
 
 		bool
-		operator!=(const red_black_tree_const_pair_iterator<key_type, value_type>& other) const
+		operator!=(const red_black_tree_const_pair_iterator<key_type, value_type, AugmentType>& other) const
 		{
 			return this->node != other.node;
 		}
@@ -1734,14 +2379,14 @@ namespace cpprelude
 		}
 	};
 
-	template<typename KeyType, typename ValueType>
-	struct red_black_tree_const_pair_iterator: public red_black_tree_iterator<details::pair_node<KeyType, ValueType>>
+	template<typename KeyType, typename ValueType, typename AugmentType>
+	struct red_black_tree_const_pair_iterator: public red_black_tree_iterator<details::pair_node<KeyType, ValueType>, AugmentType>
 	{
 		using key_type = KeyType;
 		using value_type = ValueType;
 		using data_type = const details::pair_node<KeyType, ValueType>;
-		using node_type = const details::red_black_tree_node<details::pair_node<KeyType, ValueType>>;
-		using _implementation = red_black_tree_iterator<details::pair_node<KeyType, ValueType>>;
+		using node_type = const details::red_black_tree_node<details::pair_node<KeyType, ValueType>, AugmentType>;
+		using _implementation = red_black_tree_iterator<details::pair_node<KeyType, ValueType>, AugmentType>;
 
 		red_black_tree_const_pair_iterator()
 			:_implementation()
@@ -1751,7 +2396,7 @@ namespace cpprelude
 			:_implementation(node_)
 		{}
 
-		red_black_tree_const_pair_iterator(const red_black_tree_iterator<details::pair_node<KeyType, ValueType>>& it)
+		red_black_tree_const_pair_iterator(const red_black_tree_iterator<details::pair_node<KeyType, ValueType>, AugmentType>& it)
 			:_implementation(it.node)
 		{}
 
@@ -1826,6 +2471,313 @@ namespace cpprelude
 		}
 	};
 
+	template<typename K, typename V, usize capacity>
+	struct b_tree_iterator
+	{
+		using data_type = const K;
+		using node_type = const details::b_tree_leaf<K, V, capacity>;
+
+		node_type* node;
+		usize index;
+
+		b_tree_iterator()
+			:node(nullptr), index(0)
+		{}
+
+		b_tree_iterator(node_type* node_, usize index_ = 0)
+			:node(node_), index(index_)
+		{}
+
+		b_tree_iterator&
+		operator++()
+		{
+			_move_next();
+			return *this;
+		}
+
+		b_tree_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			_move_next();
+			return result;
+		}
+
+		b_tree_iterator&
+		operator--()
+		{
+			_move_prev();
+			return *this;
+		}
+
+		b_tree_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			_move_prev();
+			return result;
+		}
+
+		bool
+		operator==(const b_tree_iterator& other) const
+		{
+			return node == other.node && index == other.index;
+		}
+
+		bool
+		operator!=(const b_tree_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		data_type*
+		operator->() const
+		{
+			return node->keys() + index;
+		}
+
+		data_type&
+		operator*() const
+		{
+			return node->keys()[index];
+		}
+
+		//moves inside the leaf then hops to the next leaf using the leaf links
+		void
+		_move_next()
+		{
+			if(node == nullptr)
+				return;
+
+			++index;
+			if(index >= node->count)
+			{
+				node = node->next;
+				index = 0;
+			}
+		}
+
+		void
+		_move_prev()
+		{
+			if(node == nullptr)
+				return;
+
+			if(index > 0)
+			{
+				--index;
+			}
+			else
+			{
+				node = node->prev;
+				index = node ? node->count - 1 : 0;
+			}
+		}
+	};
+
+	template<typename K, typename V, usize capacity>
+	struct b_tree_const_pair_iterator;
+
+	template<typename K, typename V, usize capacity>
+	struct b_tree_pair_iterator: public b_tree_iterator<K, V, capacity>
+	{
+		using key_type = K;
+		using value_type = V;
+		using data_type = const K;
+		using node_type = const details::b_tree_leaf<K, V, capacity>;
+		using _implementation = b_tree_iterator<K, V, capacity>;
+
+		b_tree_pair_iterator()
+			:_implementation()
+		{}
+
+		b_tree_pair_iterator(node_type* node_, usize index_ = 0)
+			:_implementation(node_, index_)
+		{}
+
+		b_tree_pair_iterator(const _implementation& it)
+			:_implementation(it.node, it.index)
+		{}
+
+		b_tree_pair_iterator&
+		operator++()
+		{
+			this->_move_next();
+			return *this;
+		}
+
+		b_tree_pair_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			this->_move_next();
+			return result;
+		}
+
+		b_tree_pair_iterator&
+		operator--()
+		{
+			this->_move_prev();
+			return *this;
+		}
+
+		b_tree_pair_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			this->_move_prev();
+			return result;
+		}
+
+		bool
+		operator==(const b_tree_pair_iterator& other) const
+		{
+			return this->node == other.node && this->index == other.index;
+		}
+
+		bool
+		operator!=(const b_tree_pair_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		bool
+		operator==(const b_tree_const_pair_iterator<K, V, capacity>& other) const
+		{
+			return this->node == other.node && this->index == other.index;
+		}
+
+		bool
+		operator!=(const b_tree_const_pair_iterator<K, V, capacity>& other) const
+		{
+			return !operator==(other);
+		}
+
+		value_type*
+		operator->()
+		{
+			return const_cast<value_type*>(this->node->values() + this->index);
+		}
+
+		const value_type*
+		operator->() const
+		{
+			return this->node->values() + this->index;
+		}
+
+		const key_type&
+		operator*() const
+		{
+			return this->node->keys()[this->index];
+		}
+
+		const key_type&
+		key() const
+		{
+			return this->node->keys()[this->index];
+		}
+
+		value_type&
+		value()
+		{
+			return const_cast<value_type&>(this->node->values()[this->index]);
+		}
+
+		const value_type&
+		value() const
+		{
+			return this->node->values()[this->index];
+		}
+	};
+
+	template<typename K, typename V, usize capacity>
+	struct b_tree_const_pair_iterator: public b_tree_iterator<K, V, capacity>
+	{
+		using key_type = K;
+		using value_type = V;
+		using data_type = const K;
+		using node_type = const details::b_tree_leaf<K, V, capacity>;
+		using _implementation = b_tree_iterator<K, V, capacity>;
+
+		b_tree_const_pair_iterator()
+			:_implementation()
+		{}
+
+		b_tree_const_pair_iterator(node_type* node_, usize index_ = 0)
+			:_implementation(node_, index_)
+		{}
+
+		b_tree_const_pair_iterator(const _implementation& it)
+			:_implementation(it.node, it.index)
+		{}
+
+		b_tree_const_pair_iterator&
+		operator++()
+		{
+			this->_move_next();
+			return *this;
+		}
+
+		b_tree_const_pair_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			this->_move_next();
+			return result;
+		}
+
+		b_tree_const_pair_iterator&
+		operator--()
+		{
+			this->_move_prev();
+			return *this;
+		}
+
+		b_tree_const_pair_iterator
+		operator--(int)
+		{
+			auto result = *this;
+			this->_move_prev();
+			return result;
+		}
+
+		bool
+		operator==(const b_tree_const_pair_iterator& other) const
+		{
+			return this->node == other.node && this->index == other.index;
+		}
+
+		bool
+		operator!=(const b_tree_const_pair_iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		const value_type*
+		operator->() const
+		{
+			return this->node->values() + this->index;
+		}
+
+		const key_type&
+		operator*() const
+		{
+			return this->node->keys()[this->index];
+		}
+
+		const key_type&
+		key() const
+		{
+			return this->node->keys()[this->index];
+		}
+
+		const value_type&
+		value() const
+		{
+			return this->node->values()[this->index];
+		}
+	};
+
 	template<typename T>
 	T
 	next(T it, usize n = 1)
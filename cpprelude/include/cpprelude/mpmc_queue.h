@@ -0,0 +1,332 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/ring_buffer.h"
+
+#include <atomic>
+#include <thread>
+#include <new>
+
+namespace cpprelude
+{
+	/*
+	 * bounded lock free multi producer multi consumer queue
+	 * every cell has a sequence number that tells which lap of the ring it's ready for
+	 * a cell at position pos is free for the producer of pos when its sequence is pos
+	 * and holds a value for the consumer of pos when its sequence is pos + 1
+	 * so producers only contend on the enqueue position and consumers only on the dequeue position
+	 */
+	template<typename T>
+	struct mpmc_queue
+	{
+		using data_type = T;
+
+		constexpr static usize cache_line_size = 64;
+
+		struct _cell_type
+		{
+			std::atomic<usize> sequence;
+			alignas(T) ubyte _data[sizeof(T)];
+
+			T*
+			data()
+			{
+				return reinterpret_cast<T*>(_data);
+			}
+		};
+
+		struct alignas(cache_line_size) _position_type
+		{
+			std::atomic<usize> value;
+		};
+
+		//the positions are aligned to their own cache lines so they don't share the read only part's line
+		slice<_cell_type> _cells;
+		usize _mask;
+		memory_context* _context;
+		_position_type _enqueue_pos;
+		_position_type _dequeue_pos;
+
+		mpmc_queue(usize capacity, memory_context* context = platform->global_memory)
+			:_mask(details::ring_buffer_capacity(capacity) - 1),
+			 _context(context)
+		{
+			_cells = _context->template alloc<_cell_type>(_mask + 1);
+			for(usize i = 0; i <= _mask; ++i)
+				new (&_cells[i].sequence) std::atomic<usize>(i);
+			_enqueue_pos.value.store(0, std::memory_order_relaxed);
+			_dequeue_pos.value.store(0, std::memory_order_relaxed);
+		}
+
+		mpmc_queue(const mpmc_queue&) = delete;
+
+		mpmc_queue&
+		operator=(const mpmc_queue&) = delete;
+
+		~mpmc_queue()
+		{
+			usize dequeue_pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+			usize enqueue_pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+			for(; dequeue_pos != enqueue_pos; ++dequeue_pos)
+				_cells[dequeue_pos & _mask].data()->~T();
+			_context->free(_cells);
+		}
+
+		template<typename ... TArgs>
+		bool
+		try_emplace(TArgs&& ... args)
+		{
+			_cell_type* cell = _claim_enqueue();
+			if(cell == nullptr)
+				return false;
+
+			new (cell->data()) T(std::forward<TArgs>(args)...);
+			cell->sequence.store(cell->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool
+		try_enqueue(const T& item)
+		{
+			return try_emplace(item);
+		}
+
+		bool
+		try_enqueue(T&& item)
+		{
+			return try_emplace(std::move(item));
+		}
+
+		//blocks until there's room in the queue
+		template<typename ... TArgs>
+		void
+		emplace(TArgs&& ... args)
+		{
+			_cell_type* cell = nullptr;
+			while((cell = _claim_enqueue()) == nullptr)
+				std::this_thread::yield();
+
+			new (cell->data()) T(std::forward<TArgs>(args)...);
+			cell->sequence.store(cell->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		void
+		enqueue(const T& item)
+		{
+			emplace(item);
+		}
+
+		void
+		enqueue(T&& item)
+		{
+			emplace(std::move(item));
+		}
+
+		//moves the front element to item
+		bool
+		try_dequeue(T& item)
+		{
+			_cell_type* cell = _claim_dequeue();
+			if(cell == nullptr)
+				return false;
+
+			_release_dequeue(cell, item);
+			return true;
+		}
+
+		//blocks until there's an element in the queue
+		void
+		dequeue(T& item)
+		{
+			_cell_type* cell = nullptr;
+			while((cell = _claim_dequeue()) == nullptr)
+				std::this_thread::yield();
+
+			_release_dequeue(cell, item);
+		}
+
+		//claims as many consecutive free cells as possible up to items_count with a single compare exchange
+		//returns the count of enqueued items
+		usize
+		try_enqueue_batch(const T* items, usize items_count)
+		{
+			if(items_count == 0)
+				return 0;
+
+			usize pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+			while(true)
+			{
+				usize claim = 0;
+				for(; claim < items_count && claim <= _mask; ++claim)
+				{
+					usize sequence = _cells[(pos + claim) & _mask].sequence.load(std::memory_order_acquire);
+					if(sequence != pos + claim)
+						break;
+				}
+
+				if(claim == 0)
+				{
+					//either the queue is full or another producer moved the position
+					usize sequence = _cells[pos & _mask].sequence.load(std::memory_order_acquire);
+					if(isize(sequence - pos) < 0)
+						return 0;
+					pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if(_enqueue_pos.value.compare_exchange_weak(pos, pos + claim, std::memory_order_relaxed))
+				{
+					for(usize i = 0; i < claim; ++i)
+					{
+						_cell_type& cell = _cells[(pos + i) & _mask];
+						new (cell.data()) T(items[i]);
+						cell.sequence.store(pos + i + 1, std::memory_order_release);
+					}
+					return claim;
+				}
+			}
+		}
+
+		//blocks until all the items are enqueued
+		void
+		enqueue_batch(const T* items, usize items_count)
+		{
+			while(items_count > 0)
+			{
+				usize done = try_enqueue_batch(items, items_count);
+				if(done == 0)
+					std::this_thread::yield();
+				items += done;
+				items_count -= done;
+			}
+		}
+
+		//claims as many consecutive full cells as possible up to items_count with a single compare exchange
+		//returns the count of dequeued items
+		usize
+		try_dequeue_batch(T* items, usize items_count)
+		{
+			if(items_count == 0)
+				return 0;
+
+			usize pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+			while(true)
+			{
+				usize claim = 0;
+				for(; claim < items_count && claim <= _mask; ++claim)
+				{
+					usize sequence = _cells[(pos + claim) & _mask].sequence.load(std::memory_order_acquire);
+					if(sequence != pos + claim + 1)
+						break;
+				}
+
+				if(claim == 0)
+				{
+					//either the queue is empty or another consumer moved the position
+					usize sequence = _cells[pos & _mask].sequence.load(std::memory_order_acquire);
+					if(isize(sequence - (pos + 1)) < 0)
+						return 0;
+					pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if(_dequeue_pos.value.compare_exchange_weak(pos, pos + claim, std::memory_order_relaxed))
+				{
+					for(usize i = 0; i < claim; ++i)
+					{
+						_cell_type& cell = _cells[(pos + i) & _mask];
+						items[i] = std::move(*cell.data());
+						cell.data()->~T();
+						cell.sequence.store(pos + i + _mask + 1, std::memory_order_release);
+					}
+					return claim;
+				}
+			}
+		}
+
+		//the count could be stale by the time it's returned if other threads are active
+		usize
+		count() const
+		{
+			usize dequeue_pos = _dequeue_pos.value.load(std::memory_order_acquire);
+			usize enqueue_pos = _enqueue_pos.value.load(std::memory_order_acquire);
+			return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+		}
+
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		usize
+		capacity() const
+		{
+			return _mask + 1;
+		}
+
+		_cell_type*
+		_claim_enqueue()
+		{
+			usize pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+			while(true)
+			{
+				_cell_type* cell = _cells.ptr + (pos & _mask);
+				usize sequence = cell->sequence.load(std::memory_order_acquire);
+				isize diff = isize(sequence - pos);
+				if(diff == 0)
+				{
+					if(_enqueue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						return cell;
+				}
+				else if(diff < 0)
+				{
+					//the consumer of the previous lap didn't release the cell yet so the queue is full
+					return nullptr;
+				}
+				else
+				{
+					pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		_cell_type*
+		_claim_dequeue()
+		{
+			usize pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+			while(true)
+			{
+				_cell_type* cell = _cells.ptr + (pos & _mask);
+				usize sequence = cell->sequence.load(std::memory_order_acquire);
+				isize diff = isize(sequence - (pos + 1));
+				if(diff == 0)
+				{
+					if(_dequeue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						return cell;
+				}
+				else if(diff < 0)
+				{
+					//the producer of this position didn't publish the value yet so the queue is empty
+					return nullptr;
+				}
+				else
+				{
+					pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		void
+		_release_dequeue(_cell_type* cell, T& item)
+		{
+			item = std::move(*cell->data());
+			cell->data()->~T();
+			//the claimed cell's sequence is pos + 1 so the next lap's producer waits for pos + capacity
+			cell->sequence.store(cell->sequence.load(std::memory_order_relaxed) + _mask, std::memory_order_release);
+		}
+	};
+}
@@ -0,0 +1,573 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/defaults.h"
+#include "cpprelude/iterator.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <new>
+
+namespace cpprelude
+{
+	namespace details
+	{
+		//max depth of the persistent tree, an avl tree of depth 64 has more than 2^44 nodes
+		constexpr usize persistent_map_max_depth = 64;
+
+		//immutable tree node shared between the versions of the map
+		template<typename K, typename V>
+		struct persistent_map_node
+		{
+			const persistent_map_node* left;
+			const persistent_map_node* right;
+			K key;
+			V value;
+			u32 height;
+			mutable std::atomic<u32> refs;
+
+			template<typename KeyArg, typename ValueArg>
+			persistent_map_node(KeyArg&& key_, ValueArg&& value_,
+				const persistent_map_node* left_, const persistent_map_node* right_, u32 height_)
+				:left(left_), right(right_),
+				 key(std::forward<KeyArg>(key_)), value(std::forward<ValueArg>(value_)),
+				 height(height_), refs(1)
+			{}
+		};
+	}
+
+	//in order iterator of the persistent map, it keeps the path of the nodes left to visit
+	template<typename K, typename V>
+	struct persistent_map_iterator
+	{
+		using node_type = const details::persistent_map_node<K, V>;
+		using data_type = const K;
+
+		node_type* _stack[details::persistent_map_max_depth];
+		usize _depth;
+
+		persistent_map_iterator()
+			:_depth(0)
+		{}
+
+		persistent_map_iterator&
+		operator++()
+		{
+			node_type* it = _stack[--_depth];
+			_push_left(it->right);
+			return *this;
+		}
+
+		persistent_map_iterator
+		operator++(int)
+		{
+			auto result = *this;
+			++(*this);
+			return result;
+		}
+
+		bool
+		operator==(const persistent_map_iterator& other) const
+		{
+			return node() == other.node();
+		}
+
+		bool
+		operator!=(const persistent_map_iterator& other) const
+		{
+			return node() != other.node();
+		}
+
+		const K&
+		operator*() const
+		{
+			return node()->key;
+		}
+
+		const V*
+		operator->() const
+		{
+			return &node()->value;
+		}
+
+		const K&
+		key() const
+		{
+			return node()->key;
+		}
+
+		const V&
+		value() const
+		{
+			return node()->value;
+		}
+
+		node_type*
+		node() const
+		{
+			return _depth == 0 ? nullptr : _stack[_depth - 1];
+		}
+
+		void
+		_push_left(node_type* it)
+		{
+			for(; it != nullptr; it = it->left)
+				_stack[_depth++] = it;
+		}
+	};
+
+	/*
+	 * persistent ordered map, it's an avl tree where updates copy the path from the root to the changed node
+	 * and share the rest of the nodes with the older versions using reference counting
+	 * copying the map is O(1) and gives a snapshot which is never affected by later updates
+	 * snapshots could be read from other threads while the original is being updated
+	 */
+	template<typename KeyType, typename ValueType,
+		typename ComparatorType = default_less_than<KeyType>>
+	struct persistent_map
+	{
+		using key_type = KeyType;
+		using value_type = ValueType;
+		using node_type = details::persistent_map_node<key_type, value_type>;
+		using iterator = persistent_map_iterator<key_type, value_type>;
+		using const_iterator = persistent_map_iterator<key_type, value_type>;
+
+		const node_type* _root;
+		usize _count;
+		memory_context* _context = platform->global_memory;
+		ComparatorType _less_than;
+
+		persistent_map(memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context)
+		{}
+
+		persistent_map(const ComparatorType& compare_function, memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context), _less_than(compare_function)
+		{}
+
+		persistent_map(std::initializer_list<details::pair_node<key_type, value_type>> list,
+			const ComparatorType& compare_function = ComparatorType(),
+			memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context), _less_than(compare_function)
+		{
+			for(const auto& item: list)
+				insert(item.key, item.value);
+		}
+
+		persistent_map(const persistent_map& other)
+			:_root(_retain(other._root)), _count(other._count),
+			 _context(other._context), _less_than(other._less_than)
+		{}
+
+		persistent_map(persistent_map&& other)
+			:_root(other._root), _count(other._count),
+			 _context(other._context), _less_than(std::move(other._less_than))
+		{
+			other._root = nullptr;
+			other._count = 0;
+		}
+
+		~persistent_map()
+		{
+			clear();
+		}
+
+		persistent_map&
+		operator=(const persistent_map& other)
+		{
+			if(_root == other._root)
+				return *this;
+
+			clear();
+			_root = _retain(other._root);
+			_count = other._count;
+			_context = other._context;
+			_less_than = other._less_than;
+			return *this;
+		}
+
+		persistent_map&
+		operator=(persistent_map&& other)
+		{
+			if(this == &other)
+				return *this;
+
+			clear();
+			_root = other._root;
+			_count = other._count;
+			_context = other._context;
+			_less_than = std::move(other._less_than);
+			other._root = nullptr;
+			other._count = 0;
+			return *this;
+		}
+
+		//returns a version of the map which won't be affected by later updates in O(1)
+		persistent_map
+		snapshot() const
+		{
+			return *this;
+		}
+
+		void
+		clear()
+		{
+			_release(_root);
+			_root = nullptr;
+			_count = 0;
+		}
+
+		//inserts the key and value if the key doesn't exist, returns whether it was inserted
+		bool
+		insert(const key_type& key, const value_type& value = value_type())
+		{
+			return _update(key, value, false);
+		}
+
+		//inserts the key and value or replaces the value if the key exists
+		void
+		update(const key_type& key, const value_type& value)
+		{
+			_update(key, value, true);
+		}
+
+		//returns whether the key was found and removed
+		bool
+		remove(const key_type& key)
+		{
+			bool removed = false;
+			const node_type* new_root = _remove(_root, key, removed);
+			_release(_root);
+			_root = new_root;
+			if(removed)
+				--_count;
+			return removed;
+		}
+
+		const_iterator
+		lookup(const key_type& key) const
+		{
+			auto it = lower_bound(key);
+			if(it != end() && _less_than(key, *it))
+				return end();
+			return it;
+		}
+
+		const value_type*
+		lookup_value(const key_type& key) const
+		{
+			const node_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(key, it->key))
+					it = it->left;
+				else if(_less_than(it->key, key))
+					it = it->right;
+				else
+					return &it->value;
+			}
+			return nullptr;
+		}
+
+		//returns an iterator to the first element that's not less than the given key
+		const_iterator
+		lower_bound(const key_type& key) const
+		{
+			const_iterator result;
+			const node_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(it->key, key))
+				{
+					it = it->right;
+				}
+				else
+				{
+					result._stack[result._depth++] = it;
+					it = it->left;
+				}
+			}
+			return result;
+		}
+
+		//returns an iterator to the first element that's greater than the given key
+		const_iterator
+		upper_bound(const key_type& key) const
+		{
+			const_iterator result;
+			const node_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(key, it->key))
+				{
+					result._stack[result._depth++] = it;
+					it = it->left;
+				}
+				else
+				{
+					it = it->right;
+				}
+			}
+			return result;
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		const_iterator
+		begin() const
+		{
+			const_iterator result;
+			result._push_left(_root);
+			return result;
+		}
+
+		const_iterator
+		end() const
+		{
+			return const_iterator();
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator
+		cend() const
+		{
+			return end();
+		}
+
+		bool
+		_is_avl_tree() const
+		{
+			return _check_node(_root) != -1;
+		}
+
+		isize
+		_check_node(const node_type* it) const
+		{
+			if(it == nullptr)
+				return 0;
+
+			isize left = _check_node(it->left);
+			isize right = _check_node(it->right);
+			if(left == -1 || right == -1)
+				return -1;
+			if(left - right > 1 || right - left > 1)
+				return -1;
+			if(it->left && !_less_than(it->left->key, it->key))
+				return -1;
+			if(it->right && !_less_than(it->key, it->right->key))
+				return -1;
+
+			isize height = (left > right ? left : right) + 1;
+			if(height != static_cast<isize>(it->height))
+				return -1;
+			return height;
+		}
+
+		bool
+		_update(const key_type& key, const value_type& value, bool replace)
+		{
+			bool inserted = false;
+			const node_type* new_root = _insert(_root, key, value, replace, inserted);
+			_release(_root);
+			_root = new_root;
+			if(inserted)
+				++_count;
+			return inserted;
+		}
+
+		//all the functions returning a node return an owned reference to it
+		const node_type*
+		_insert(const node_type* it, const key_type& key, const value_type& value, bool replace, bool& inserted)
+		{
+			if(it == nullptr)
+			{
+				inserted = true;
+				return _create_node(key, value, nullptr, nullptr);
+			}
+
+			if(_less_than(key, it->key))
+			{
+				const node_type* left = _insert(it->left, key, value, replace, inserted);
+				if(left == it->left)
+				{
+					_release(left);
+					return _retain(it);
+				}
+				return _balance(it->key, it->value, left, _retain(it->right));
+			}
+			else if(_less_than(it->key, key))
+			{
+				const node_type* right = _insert(it->right, key, value, replace, inserted);
+				if(right == it->right)
+				{
+					_release(right);
+					return _retain(it);
+				}
+				return _balance(it->key, it->value, _retain(it->left), right);
+			}
+
+			if(!replace)
+				return _retain(it);
+			return _create_node(it->key, value, _retain(it->left), _retain(it->right));
+		}
+
+		const node_type*
+		_remove(const node_type* it, const key_type& key, bool& removed)
+		{
+			if(it == nullptr)
+				return nullptr;
+
+			if(_less_than(key, it->key))
+			{
+				const node_type* left = _remove(it->left, key, removed);
+				if(!removed)
+				{
+					_release(left);
+					return _retain(it);
+				}
+				return _balance(it->key, it->value, left, _retain(it->right));
+			}
+			else if(_less_than(it->key, key))
+			{
+				const node_type* right = _remove(it->right, key, removed);
+				if(!removed)
+				{
+					_release(right);
+					return _retain(it);
+				}
+				return _balance(it->key, it->value, _retain(it->left), right);
+			}
+
+			removed = true;
+			if(it->left == nullptr)
+				return _retain(it->right);
+			if(it->right == nullptr)
+				return _retain(it->left);
+
+			//replace the node with the smallest node in its right subtree
+			const node_type* successor = it->right;
+			while(successor->left != nullptr)
+				successor = successor->left;
+
+			return _balance(successor->key, successor->value, _retain(it->left), _remove_min(it->right));
+		}
+
+		const node_type*
+		_remove_min(const node_type* it)
+		{
+			if(it->left == nullptr)
+				return _retain(it->right);
+			return _balance(it->key, it->value, _remove_min(it->left), _retain(it->right));
+		}
+
+		static u32
+		_height(const node_type* it)
+		{
+			return it != nullptr ? it->height : 0;
+		}
+
+		//creates a node out of the given key, value and owned children restoring the avl balance with copying rotations
+		const node_type*
+		_balance(const key_type& key, const value_type& value, const node_type* left, const node_type* right)
+		{
+			u32 left_height = _height(left);
+			u32 right_height = _height(right);
+
+			if(left_height > right_height + 1)
+			{
+				const node_type* result = nullptr;
+				if(_height(left->left) >= _height(left->right))
+				{
+					const node_type* new_right = _create_node(key, value, _retain(left->right), right);
+					result = _create_node(left->key, left->value, _retain(left->left), new_right);
+				}
+				else
+				{
+					const node_type* pivot = left->right;
+					const node_type* new_left = _create_node(left->key, left->value, _retain(left->left), _retain(pivot->left));
+					const node_type* new_right = _create_node(key, value, _retain(pivot->right), right);
+					result = _create_node(pivot->key, pivot->value, new_left, new_right);
+				}
+				_release(left);
+				return result;
+			}
+			else if(right_height > left_height + 1)
+			{
+				const node_type* result = nullptr;
+				if(_height(right->right) >= _height(right->left))
+				{
+					const node_type* new_left = _create_node(key, value, left, _retain(right->left));
+					result = _create_node(right->key, right->value, new_left, _retain(right->right));
+				}
+				else
+				{
+					const node_type* pivot = right->left;
+					const node_type* new_left = _create_node(key, value, left, _retain(pivot->left));
+					const node_type* new_right = _create_node(right->key, right->value, _retain(pivot->right), _retain(right->right));
+					result = _create_node(pivot->key, pivot->value, new_left, new_right);
+				}
+				_release(right);
+				return result;
+			}
+
+			return _create_node(key, value, left, right);
+		}
+
+		const node_type*
+		_create_node(const key_type& key, const value_type& value, const node_type* left, const node_type* right)
+		{
+			u32 left_height = _height(left);
+			u32 right_height = _height(right);
+			auto result = _context->template alloc<node_type>();
+			new (result.ptr) node_type(key, value, left, right,
+				(left_height > right_height ? left_height : right_height) + 1);
+			return result.ptr;
+		}
+
+		static const node_type*
+		_retain(const node_type* it)
+		{
+			if(it != nullptr)
+				it->refs.fetch_add(1, std::memory_order_relaxed);
+			return it;
+		}
+
+		void
+		_release(const node_type* it)
+		{
+			while(it != nullptr)
+			{
+				if(it->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+					return;
+
+				const node_type* left = it->left;
+				const node_type* right = it->right;
+				node_type* node = const_cast<node_type*>(it);
+				node->~node_type();
+				_context->free(make_slice(node));
+
+				//recurse on one side and loop on the other to bound the stack by the tree depth
+				_release(left);
+				it = right;
+			}
+		}
+	};
+}
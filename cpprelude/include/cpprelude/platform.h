@@ -118,6 +118,10 @@ namespace cpprelude
 
 		API_CPPR bool
 		file_move_to_end(const file_handle& handle);
+
+		//nanoseconds since an arbitrary point in the past, it never goes back like the wall clock could
+		API_CPPR u64
+		monotonic_time() const;
 	};
 
 	API_CPPR void
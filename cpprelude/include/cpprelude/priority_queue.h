@@ -4,12 +4,19 @@
 #include "cpprelude/memory_context.h"
 #include "cpprelude/platform.h"
 #include "cpprelude/defaults.h"
+#include "cpprelude/bits.h"
+
+#include <type_traits>
+#include <cassert>
 
 namespace cpprelude {
 	// Minheap is the default
-	template<typename T, typename Comparator = default_less_than<T>>
+	// the heap is d-ary, 4 children per node means half the levels of a binary heap and the children share a cache line
+	template<typename T, typename Comparator = default_less_than<T>, usize arity = 4>
 	struct priority_queue
 	{
+		static_assert(arity >= 2, "priority_queue arity must be at least 2");
+
 		using data_type = T;
 		dynamic_array<T> _array;
 		usize _count;
@@ -20,8 +27,10 @@ namespace cpprelude {
 		{}
 
 		priority_queue(usize count, Comparator compare_function = Comparator(), memory_context* context = platform->global_memory)
-			:_array(count, context), _count(0), _compare(compare_function)
-		{}
+			:_array(context), _count(0), _compare(compare_function)
+		{
+			_array.reserve(count);
+		}
 
 		priority_queue(const priority_queue& other, Comparator compare_function = Comparator(), memory_context* context = platform->global_memory)
 			:_array(other._array, context), _count(other._count), _compare(compare_function)
@@ -60,11 +69,7 @@ namespace cpprelude {
 		void
 		enqueue(const T& item)
 		{
-			if (_count == _array.count())
-				_array.insert_back(item);
-			else
-				_array[_count] = item;
-
+			_array.insert_back(item);
 			_bubble_up(_count);
 			++_count;
 		}
@@ -72,11 +77,7 @@ namespace cpprelude {
 		void
 		enqueue(T&& item)
 		{
-			if (_count == _array.count())
-				_array.insert_back(std::move(item));
-			else
-				_array[_count] = std::move(item);
-
+			_array.insert_back(std::move(item));
 			_bubble_up(_count);
 			++_count;
 		}
@@ -86,12 +87,8 @@ namespace cpprelude {
 		{
 			if (_count == 0) return false;
 			std::swap(_array[0], _array[_count - 1]);
+			_array.remove_back();
 			--_count;
-			if (_count <= _array.count() * 0.25)
-			{
-				_array.shrink_back(_array.count() - _count);
-			}
-			
 			_bubble_down(0);
 			return true;
 		}
@@ -120,11 +117,13 @@ namespace cpprelude {
 			return _count == 0;
 		}
 
+		//bottom up heap construction which is O(n)
 		void
 		_heapify()
 		{
-			for (usize i = 0; i <_count; i++)
-				_bubble_up(i);
+			if (_count < 2) return;
+			for (usize i = (_count - 2) / arity + 1; i > 0; --i)
+				_bubble_down(i - 1);
 		}
 
 		void
@@ -132,9 +131,9 @@ namespace cpprelude {
 		{
 			while (index > 0)
 			{
-				usize parent = (index - 1) / 2;
+				usize parent = (index - 1) / arity;
 				//which index has the highest priority item
-				if (!_compare(_array[parent], _array[index]))
+				if (_compare(_array[index], _array[parent]))
 				{
 					std::swap(_array[parent], _array[index]);
 					index = parent;
@@ -148,15 +147,16 @@ namespace cpprelude {
 		{
 			while (true)
 			{
-				usize l = 2 * k + 1;
-				usize r = 2 * k + 2;
-				usize root = k;
+				usize first_child = arity * k + 1;
+				if (first_child >= _count) break;
+				usize last_child = first_child + arity < _count ? first_child + arity : _count;
+
 				//which index has the highest priority item
-				if (l < _count && !_compare(_array[root], _array[l]))
-					root = l;
-				if (r < _count && !_compare(_array[root], _array[r]))
-					root = r;
-				
+				usize root = k;
+				for (usize child = first_child; child < last_child; ++child)
+					if (_compare(_array[child], _array[root]))
+						root = child;
+
 				//If it is the same index then there is no violation for heap's rules
 				if (root == k) break;
 				//swap
@@ -179,4 +179,385 @@ namespace cpprelude {
 			return _array.decay_continuous();
 		}
 	};
+
+	/*
+	 * d-ary heap that gives every enqueued element a stable handle
+	 * the handle could be used to change the element's priority or remove it in O(log n)
+	 * a handle's slot is reused by later elements with a new generation so an old handle never refers to them
+	 */
+	template<typename T, typename Comparator = default_less_than<T>, usize arity = 4>
+	struct addressable_priority_queue
+	{
+		static_assert(arity >= 2, "addressable_priority_queue arity must be at least 2");
+
+		using data_type = T;
+
+		struct handle
+		{
+			u32 index;
+			u32 generation;
+
+			bool
+			operator==(const handle& other) const
+			{
+				return index == other.index && generation == other.generation;
+			}
+
+			bool
+			operator!=(const handle& other) const
+			{
+				return !operator==(other);
+			}
+		};
+
+		constexpr static usize _invalid_position = static_cast<usize>(-1);
+
+		struct _entry_type
+		{
+			T value;
+			u32 id;
+		};
+
+		dynamic_array<_entry_type> _heap;
+		//position of each slot's element in the heap or _invalid_position if the slot is free
+		dynamic_array<usize> _positions;
+		//bumped every time the slot is freed so the handles given before don't match
+		dynamic_array<u32> _generations;
+		dynamic_array<u32> _free_slots;
+		Comparator _compare;
+
+		addressable_priority_queue(Comparator compare_function = Comparator(), memory_context* context = platform->global_memory)
+			:_heap(context), _positions(context), _generations(context), _free_slots(context), _compare(compare_function)
+		{}
+
+		handle
+		enqueue(const T& item)
+		{
+			return emplace(item);
+		}
+
+		handle
+		enqueue(T&& item)
+		{
+			return emplace(std::move(item));
+		}
+
+		template<typename ... TArgs>
+		handle
+		emplace(TArgs&& ... args)
+		{
+			u32 id;
+			if (_free_slots.empty())
+			{
+				id = u32(_positions.count());
+				_positions.insert_back(usize(_invalid_position));
+				_generations.insert_back(0);
+			}
+			else
+			{
+				id = *_free_slots.back();
+				_free_slots.remove_back();
+			}
+
+			_heap.insert_back(_entry_type{T(std::forward<TArgs>(args)...), id});
+			_positions[id] = _heap.count() - 1;
+			_sift_up(_heap.count() - 1);
+			return handle{id, _generations[id]};
+		}
+
+		bool
+		dequeue()
+		{
+			if (_heap.empty()) return false;
+			_remove_at(0);
+			return true;
+		}
+
+		const T&
+		front() const
+		{
+			return _heap[0].value;
+		}
+
+		handle
+		front_handle() const
+		{
+			u32 id = _heap[0].id;
+			return handle{id, _generations[id]};
+		}
+
+		//the handle must be in the queue
+		const T&
+		operator[](handle id) const
+		{
+			return _heap[_positions[id.index]].value;
+		}
+
+		bool
+		contains(handle id) const
+		{
+			return id.index < _positions.count() &&
+				   _positions[id.index] != _invalid_position &&
+				   _generations[id.index] == id.generation;
+		}
+
+		//sets the value of the element and moves it up or down the heap as needed
+		void
+		update(handle id, const T& value)
+		{
+			usize index = _positions[id.index];
+			bool higher = _compare(value, _heap[index].value);
+			_heap[index].value = value;
+			if (higher)
+				_sift_up(index);
+			else
+				_sift_down(index);
+		}
+
+		//the new value must not have a lower priority than the current one
+		void
+		decrease_key(handle id, const T& value)
+		{
+			usize index = _positions[id.index];
+			_heap[index].value = value;
+			_sift_up(index);
+		}
+
+		//the new value must not have a higher priority than the current one
+		void
+		increase_key(handle id, const T& value)
+		{
+			usize index = _positions[id.index];
+			_heap[index].value = value;
+			_sift_down(index);
+		}
+
+		bool
+		remove(handle id)
+		{
+			if (!contains(id)) return false;
+			_remove_at(_positions[id.index]);
+			return true;
+		}
+
+		usize
+		count() const
+		{
+			return _heap.count();
+		}
+
+		bool
+		empty() const
+		{
+			return _heap.empty();
+		}
+
+		//the slots are kept with new generations so the handles given before clear don't match later elements
+		void
+		clear()
+		{
+			for (const auto& entry: _heap)
+			{
+				_positions[entry.id] = _invalid_position;
+				++_generations[entry.id];
+				_free_slots.insert_back(entry.id);
+			}
+			_heap.clear();
+		}
+
+		void
+		_remove_at(usize index)
+		{
+			u32 id = _heap[index].id;
+			usize last = _heap.count() - 1;
+			if (index != last)
+			{
+				std::swap(_heap[index], _heap[last]);
+				_positions[_heap[index].id] = index;
+			}
+			_heap.remove_back();
+			_positions[id] = _invalid_position;
+			++_generations[id];
+			_free_slots.insert_back(id);
+
+			//the last entry took the removed entry's place so it could need to move either way
+			if (index < _heap.count())
+			{
+				u32 moved = _heap[index].id;
+				_sift_up(index);
+				if (_positions[moved] == index)
+					_sift_down(index);
+			}
+		}
+
+		//the moving entry is kept aside and the others are shifted into the hole instead of swapping at every level
+		void
+		_sift_up(usize index)
+		{
+			_entry_type entry = std::move(_heap[index]);
+			while (index > 0)
+			{
+				usize parent = (index - 1) / arity;
+				if (!_compare(entry.value, _heap[parent].value))
+					break;
+
+				_heap[index] = std::move(_heap[parent]);
+				_positions[_heap[index].id] = index;
+				index = parent;
+			}
+			_heap[index] = std::move(entry);
+			_positions[_heap[index].id] = index;
+		}
+
+		void
+		_sift_down(usize index)
+		{
+			usize heap_count = _heap.count();
+			if (index >= heap_count) return;
+
+			_entry_type entry = std::move(_heap[index]);
+			while (true)
+			{
+				usize first_child = arity * index + 1;
+				if (first_child >= heap_count) break;
+				usize last_child = first_child + arity < heap_count ? first_child + arity : heap_count;
+
+				usize best = first_child;
+				for (usize child = first_child + 1; child < last_child; ++child)
+					if (_compare(_heap[child].value, _heap[best].value))
+						best = child;
+
+				if (!_compare(_heap[best].value, entry.value))
+					break;
+
+				_heap[index] = std::move(_heap[best]);
+				_positions[_heap[index].id] = index;
+				index = best;
+			}
+			_heap[index] = std::move(entry);
+			_positions[_heap[index].id] = index;
+		}
+	};
+
+	/*
+	 * radix heap for monotone integer keys, the extracted keys never decrease
+	 * like the distances in dijkstra or the deadlines of timers
+	 * elements are kept in buckets by the highest bit where their key differs from the last extracted key
+	 * so an element moves down at most once per bit and enqueue is O(1)
+	 */
+	template<typename K, typename V>
+	struct radix_heap
+	{
+		static_assert(std::is_unsigned<K>::value, "radix_heap keys must be unsigned integers");
+
+		struct entry_type
+		{
+			K key;
+			V value;
+		};
+
+		constexpr static usize buckets_count = sizeof(K) * 8 + 1;
+
+		dynamic_array<entry_type> _buckets[buckets_count];
+		K _last;
+		usize _count;
+
+		radix_heap(memory_context* context = platform->global_memory)
+			:_last(0), _count(0)
+		{
+			for (auto& bucket: _buckets)
+				bucket._context = context;
+		}
+
+		//the key must not be less than the last extracted key
+		void
+		enqueue(K key, const V& value)
+		{
+			_buckets[_bucket_index(key)].insert_back(entry_type{key, value});
+			++_count;
+		}
+
+		void
+		enqueue(K key, V&& value)
+		{
+			_buckets[_bucket_index(key)].insert_back(entry_type{key, std::move(value)});
+			++_count;
+		}
+
+		//the heap must not be empty
+		const entry_type&
+		front()
+		{
+			assert(_count > 0);
+			_refill();
+			return *_buckets[0].back();
+		}
+
+		bool
+		dequeue()
+		{
+			if (_count == 0) return false;
+			_refill();
+			_buckets[0].remove_back();
+			--_count;
+			return true;
+		}
+
+		//the last extracted key which is a lower bound for all the keys in the heap
+		K
+		last_key() const
+		{
+			return _last;
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		void
+		clear()
+		{
+			for (auto& bucket: _buckets)
+				bucket.clear();
+			_count = 0;
+			_last = 0;
+		}
+
+		usize
+		_bucket_index(K key) const
+		{
+			return details::significant_bits(u64(key ^ _last));
+		}
+
+		//makes the min key the last key so all the min elements end up in the first bucket
+		void
+		_refill()
+		{
+			//an empty heap has no non empty bucket to stop the search
+			if (_count == 0 || !_buckets[0].empty()) return;
+
+			usize index = 1;
+			while (_buckets[index].empty())
+				++index;
+
+			auto& bucket = _buckets[index];
+			K min_key = bucket[0].key;
+			for (usize i = 1; i < bucket.count(); ++i)
+				if (bucket[i].key < min_key)
+					min_key = bucket[i].key;
+
+			_last = min_key;
+			for (auto& entry: bucket)
+				_buckets[_bucket_index(entry.key)].insert_back(std::move(entry));
+			bucket.clear();
+		}
+	};
 }
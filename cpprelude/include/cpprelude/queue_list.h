@@ -6,12 +6,13 @@
 
 namespace cpprelude
 {
-	template<typename T>
+	//list_type is the backing list, it could be swapped with unrolled_list<T> to store several elements per node
+	template<typename T, typename list_type = dlinked_list<T>>
 	struct queue_list
 	{
 		using data_type = T;
 
-		dlinked_list<T> _list;
+		list_type _list;
 
 		queue_list(memory_context* context = platform->global_memory)
 			:_list(context)
@@ -84,7 +85,7 @@ namespace cpprelude
 			return _list.count();
 		}
 
-		slice<typename dlinked_list<T>::node_type>
+		slice<typename list_type::node_type>
 		decay()
 		{
 			return _list.decay();
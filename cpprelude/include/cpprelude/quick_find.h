@@ -2,6 +2,7 @@
 #include "cpprelude/defines.h"
 #include "cpprelude/api.h"
 #include "cpprelude/dynamic_array.h"
+#include "cpprelude/quick_union.h"
 
 namespace cpprelude
 {
@@ -19,6 +20,10 @@ namespace cpprelude
 		API_CPPR void
 		connect(usize x, usize y);
 
+		//connects the ends of all the edges and relabels the elements once instead of once per edge
+		API_CPPR void
+		connect_all(const slice<quick_union_edge>& edges);
+
 		API_CPPR usize
 		count() const;
 	};
@@ -3,6 +3,11 @@
 #include "cpprelude/defines.h"
 #include "cpprelude/api.h"
 #include "cpprelude/dynamic_array.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+
+#include <atomic>
 
 namespace cpprelude
 {
@@ -30,4 +35,97 @@ namespace cpprelude
 		API_CPPR usize
 		_root(usize a);
 	};
-}
\ No newline at end of file
+
+	//an edge between two elements, it's what the bulk connect functions take
+	struct quick_union_edge
+	{
+		usize a;
+		usize b;
+	};
+
+	/*
+	 * union find with u32 parents and a rank byte per element, so it takes 5 bytes per element instead of 16
+	 * the root with the smaller rank goes under the other and finding a root halves the path on the way
+	 * it's limited to 2^32 - 1 elements
+	 */
+	struct compact_quick_union
+	{
+		dynamic_array<u32> _nodes;
+		dynamic_array<u8> _ranks;
+
+		API_CPPR compact_quick_union(memory_context* context = platform->global_memory);
+
+		explicit API_CPPR compact_quick_union(usize count, memory_context* context = platform->global_memory);
+
+		//adds count elements each in its own set
+		API_CPPR void
+		init(usize count);
+
+		//returns true if the two elements were in different sets
+		API_CPPR bool
+		connect(u32 a, u32 b);
+
+		//connects the ends of all the edges, returns the count of edges that merged two sets
+		API_CPPR usize
+		connect_all(const slice<quick_union_edge>& edges);
+
+		API_CPPR bool
+		is_connected(u32 a, u32 b);
+
+		//labels every element with a dense id of its set, the ids are ordered by the smallest element of each set
+		//sizes gets the count of elements of each set, returns the count of sets
+		API_CPPR usize
+		label_components(dynamic_array<u32>& labels, dynamic_array<u32>& sizes);
+
+		API_CPPR usize
+		count() const;
+
+		API_CPPR u32
+		_root(u32 a);
+	};
+
+	/*
+	 * concurrent union find, connect, is_connected and _root could be called from any count of threads at once
+	 * the parent links are atomics and a root is only linked with a compare and swap which fails if another thread linked it first
+	 * a root is always linked under the root with the smaller index so the links never form a cycle
+	 * finding the root halves the path on the way without retrying, so it never waits on other threads
+	 */
+	struct concurrent_quick_union
+	{
+		slice<std::atomic<usize>> _nodes;
+		memory_context* _context = platform->global_memory;
+
+		API_CPPR concurrent_quick_union(memory_context* context = platform->global_memory);
+
+		explicit API_CPPR concurrent_quick_union(usize count, memory_context* context = platform->global_memory);
+
+		concurrent_quick_union(const concurrent_quick_union&) = delete;
+
+		concurrent_quick_union&
+		operator=(const concurrent_quick_union&) = delete;
+
+		API_CPPR ~concurrent_quick_union();
+
+		//makes count disjoint elements, it must not be called while other threads use the union find
+		API_CPPR void
+		init(usize count);
+
+		//returns true if the two elements were in different sets
+		API_CPPR bool
+		connect(usize a, usize b);
+
+		API_CPPR bool
+		is_connected(usize a, usize b);
+
+		API_CPPR usize
+		count() const;
+
+		API_CPPR usize
+		_root(usize a);
+	};
+
+	//connects the ends of all the edges splitting them over threads_count threads, 0 means a thread per hardware thread
+	//returns the count of connects that merged two sets so the count of sets is the count of elements minus it
+	API_CPPR usize
+	connect_all(concurrent_quick_union& sets, const slice<quick_union_edge>& edges, usize threads_count = 0);
+}
@@ -0,0 +1,1133 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/string.h"
+#include "cpprelude/bits.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace cpprelude
+{
+	/*
+	 * key of a radix tree, it's a view over the bytes of the key which must outlive the call it's passed to
+	 * integers are stored big endian in the key itself so the byte order of the keys is their numeric order
+	 */
+	struct radix_key
+	{
+		const ubyte* ptr;
+		usize size;
+		ubyte _integer[8];
+
+		radix_key(const byte* data, usize size_)
+			:ptr(reinterpret_cast<const ubyte*>(data)), size(size_)
+		{}
+
+		radix_key(const byte* str)
+			:ptr(reinterpret_cast<const ubyte*>(str)), size(std::strlen(str))
+		{}
+
+		//the last byte of a string is its terminating 0 so it's not part of the key
+		radix_key(const string& str)
+			:ptr(reinterpret_cast<const ubyte*>(str.data())), size(str.size() ? str.size() - 1 : 0)
+		{}
+
+		explicit radix_key(u64 value)
+		{
+			_store(value, sizeof(u64));
+		}
+
+		explicit radix_key(u32 value)
+		{
+			_store(value, sizeof(u32));
+		}
+
+		//the sign bit is flipped so the negative numbers come before the positive ones
+		explicit radix_key(i64 value)
+		{
+			_store(u64(value) ^ (u64(1) << 63), sizeof(i64));
+		}
+
+		explicit radix_key(i32 value)
+		{
+			_store(u32(value) ^ (u32(1) << 31), sizeof(i32));
+		}
+
+		radix_key(const radix_key& other)
+		{
+			*this = other;
+		}
+
+		radix_key&
+		operator=(const radix_key& other)
+		{
+			std::memcpy(_integer, other._integer, sizeof(_integer));
+			size = other.size;
+			ptr = other.ptr == other._integer ? _integer : other.ptr;
+			return *this;
+		}
+
+		ubyte
+		operator[](usize index) const
+		{
+			return ptr[index];
+		}
+
+		void
+		_store(u64 value, usize size_)
+		{
+			for(usize i = 0; i < size_; ++i)
+				_integer[i] = ubyte(value >> ((size_ - 1 - i) * 8));
+			ptr = _integer;
+			size = size_;
+		}
+	};
+
+	/*
+	 * adaptive radix tree, a trie over the bytes of the keys whose inner nodes grow from 4 to 16 to 48 to 256 children
+	 * so it never pays for 256 child pointers in the sparse levels
+	 * chains of single child nodes are compressed into a prefix of the node, only the first bytes of the prefix are kept
+	 * in the node and the rest is checked against a leaf since every leaf under the node has the same prefix
+	 * a key that ends at an inner node, which happens when a key is a prefix of another, is kept as the terminal of that node
+	 * leaves are tagged in the lowest bit of the child pointers
+	 */
+	template<typename V>
+	struct radix_tree
+	{
+		using value_type = V;
+
+		constexpr static usize _max_prefix = 10;
+
+		enum node_kind: u8 { NODE4, NODE16, NODE48, NODE256 };
+
+		struct _leaf_type
+		{
+			V value;
+			usize key_size;
+			ubyte key[1];
+
+			template<typename VArg>
+			_leaf_type(const radix_key& key_, VArg&& value_)
+				:value(std::forward<VArg>(value_)), key_size(key_.size)
+			{
+				std::memcpy(key, key_.ptr, key_.size);
+			}
+		};
+
+		struct _node_type
+		{
+			node_kind kind;
+			u16 count;
+			u32 prefix_size;
+			ubyte prefix[_max_prefix];
+			_leaf_type* terminal;
+		};
+
+		struct _node4_type: _node_type
+		{
+			ubyte keys[4];
+			void* children[4];
+		};
+
+		struct _node16_type: _node_type
+		{
+			ubyte keys[16];
+			void* children[16];
+		};
+
+		//index holds the slot of the child plus one, 0 means there's no child
+		struct _node48_type: _node_type
+		{
+			ubyte index[256];
+			void* children[48];
+		};
+
+		struct _node256_type: _node_type
+		{
+			void* children[256];
+		};
+
+		void* _root;
+		usize _count;
+		memory_context* _context = platform->global_memory;
+
+		radix_tree(memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context)
+		{}
+
+		radix_tree(const radix_tree&) = delete;
+
+		radix_tree&
+		operator=(const radix_tree&) = delete;
+
+		radix_tree(radix_tree&& other)
+			:_root(other._root), _count(other._count), _context(other._context)
+		{
+			other._root = nullptr;
+			other._count = 0;
+		}
+
+		radix_tree&
+		operator=(radix_tree&& other)
+		{
+			clear();
+			_root = other._root;
+			_count = other._count;
+			_context = other._context;
+			other._root = nullptr;
+			other._count = 0;
+			return *this;
+		}
+
+		~radix_tree()
+		{
+			clear();
+		}
+
+		//inserts the value or assigns it if the key exists, returns true if the key is new
+		bool
+		insert(const radix_key& key, const V& value)
+		{
+			return _insert(key, value);
+		}
+
+		bool
+		insert(const radix_key& key, V&& value)
+		{
+			return _insert(key, std::move(value));
+		}
+
+		//returns nullptr if the key doesn't exist
+		V*
+		lookup(const radix_key& key)
+		{
+			_leaf_type* leaf = _lookup(key);
+			return leaf ? &leaf->value : nullptr;
+		}
+
+		const V*
+		lookup(const radix_key& key) const
+		{
+			_leaf_type* leaf = _lookup(key);
+			return leaf ? &leaf->value : nullptr;
+		}
+
+		bool
+		contains(const radix_key& key) const
+		{
+			return _lookup(key) != nullptr;
+		}
+
+		//returns false if the key doesn't exist
+		bool
+		remove(const radix_key& key)
+		{
+			if(_root == nullptr)
+				return false;
+
+			if(_is_leaf(_root))
+			{
+				_leaf_type* leaf = _as_leaf(_root);
+				if(!_leaf_matches(leaf, key))
+					return false;
+				_free_leaf(leaf);
+				_root = nullptr;
+				--_count;
+				return true;
+			}
+
+			void** ref = &_root;
+			usize depth = 0;
+			while(true)
+			{
+				_node_type* node = static_cast<_node_type*>(*ref);
+				if(node->prefix_size > 0)
+				{
+					if(!_prefix_matches(node, key, depth))
+						return false;
+					depth += node->prefix_size;
+				}
+
+				if(depth > key.size)
+					return false;
+
+				if(depth == key.size)
+				{
+					if(node->terminal == nullptr || !_leaf_matches(node->terminal, key))
+						return false;
+					_free_leaf(node->terminal);
+					node->terminal = nullptr;
+					--_count;
+					if(node->kind == NODE4)
+						_collapse(ref, node);
+					return true;
+				}
+
+				void** child = _find_child(node, key[depth]);
+				if(child == nullptr)
+					return false;
+
+				if(_is_leaf(*child))
+				{
+					_leaf_type* leaf = _as_leaf(*child);
+					if(!_leaf_matches(leaf, key))
+						return false;
+					_free_leaf(leaf);
+					_remove_child(ref, node, key[depth], child);
+					--_count;
+					return true;
+				}
+
+				ref = child;
+				++depth;
+			}
+		}
+
+		//the value of the longest key in the tree which is a prefix of the given key, or nullptr if there's none
+		//the size of the matched key is written to prefix_size if it's not nullptr
+		V*
+		longest_prefix(const radix_key& key, usize* prefix_size = nullptr)
+		{
+			_leaf_type* result = nullptr;
+			//whether the bytes of the key up to depth were all compared, skipping a long prefix means a candidate must be checked
+			bool exact = true;
+			void* it = _root;
+			usize depth = 0;
+			while(it != nullptr)
+			{
+				if(_is_leaf(it))
+				{
+					_leaf_type* leaf = _as_leaf(it);
+					if(_leaf_is_prefix(leaf, key))
+						result = leaf;
+					break;
+				}
+
+				_node_type* node = static_cast<_node_type*>(it);
+				if(node->prefix_size > 0)
+				{
+					if(!_prefix_matches(node, key, depth))
+						break;
+					depth += node->prefix_size;
+					exact &= node->prefix_size <= _max_prefix;
+				}
+
+				if(depth > key.size)
+					break;
+
+				if(node->terminal != nullptr)
+				{
+					if(!exact && !_leaf_is_prefix(node->terminal, key))
+						break;
+					exact = true;
+					result = node->terminal;
+				}
+
+				if(depth == key.size)
+					break;
+
+				void** child = _find_child(node, key[depth]);
+				if(child == nullptr)
+					break;
+				it = *child;
+				++depth;
+			}
+
+			if(result == nullptr)
+				return nullptr;
+			if(prefix_size != nullptr)
+				*prefix_size = result->key_size;
+			return &result->value;
+		}
+
+		//applys the function to all the keys which start with the prefix in byte order
+		//the function is called as FT(const radix_key& key, V& value, user_type* user_data)
+		template<typename function_type, typename user_type = void>
+		void
+		prefix_traverse(const radix_key& prefix, function_type&& FT, user_type* user_data = nullptr)
+		{
+			void* it = _root;
+			usize depth = 0;
+			while(it != nullptr)
+			{
+				if(_is_leaf(it))
+				{
+					if(_leaf_is_prefix(prefix, _as_leaf(it)))
+						_traverse(it, FT, user_data);
+					return;
+				}
+
+				_node_type* node = static_cast<_node_type*>(it);
+				if(depth + node->prefix_size >= prefix.size)
+				{
+					//every key under the node starts with the same bytes so checking one of them checks them all
+					if(_leaf_is_prefix(prefix, _minimum(node)))
+						_traverse(it, FT, user_data);
+					return;
+				}
+
+				if(node->prefix_size > 0)
+				{
+					if(!_prefix_matches(node, prefix, depth))
+						return;
+					depth += node->prefix_size;
+				}
+
+				void** child = _find_child(node, prefix[depth]);
+				if(child == nullptr)
+					return;
+				it = *child;
+				++depth;
+			}
+		}
+
+		template<typename function_type, typename user_type = void>
+		void
+		prefix_traverse(const radix_key& prefix, function_type&& FT, user_type* user_data = nullptr) const
+		{
+			const_cast<radix_tree*>(this)->prefix_traverse(prefix,
+				[&FT](const radix_key& key, V& value, user_type* data) {
+					FT(key, static_cast<const V&>(value), data);
+				}, user_data);
+		}
+
+		//applys the function to all the keys in byte order
+		template<typename function_type, typename user_type = void>
+		void
+		inorder_traverse(function_type&& FT, user_type* user_data = nullptr)
+		{
+			if(_root != nullptr)
+				_traverse(_root, FT, user_data);
+		}
+
+		template<typename function_type, typename user_type = void>
+		void
+		inorder_traverse(function_type&& FT, user_type* user_data = nullptr) const
+		{
+			prefix_traverse(radix_key("", 0), std::forward<function_type>(FT), user_data);
+		}
+
+		void
+		clear()
+		{
+			if(_root != nullptr)
+				_free(_root);
+			_root = nullptr;
+			_count = 0;
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		static bool
+		_is_leaf(const void* it)
+		{
+			return reinterpret_cast<usize>(it) & 1;
+		}
+
+		static _leaf_type*
+		_as_leaf(void* it)
+		{
+			return reinterpret_cast<_leaf_type*>(reinterpret_cast<usize>(it) & ~usize(1));
+		}
+
+		static void*
+		_tag_leaf(_leaf_type* leaf)
+		{
+			return reinterpret_cast<void*>(reinterpret_cast<usize>(leaf) | 1);
+		}
+
+		static bool
+		_leaf_matches(const _leaf_type* leaf, const radix_key& key)
+		{
+			return leaf->key_size == key.size && std::memcmp(leaf->key, key.ptr, key.size) == 0;
+		}
+
+		//whether the leaf key is a prefix of the key
+		static bool
+		_leaf_is_prefix(const _leaf_type* leaf, const radix_key& key)
+		{
+			return leaf->key_size <= key.size && std::memcmp(leaf->key, key.ptr, leaf->key_size) == 0;
+		}
+
+		//whether the key is a prefix of the leaf key
+		static bool
+		_leaf_is_prefix(const radix_key& prefix, const _leaf_type* leaf)
+		{
+			return prefix.size <= leaf->key_size && std::memcmp(leaf->key, prefix.ptr, prefix.size) == 0;
+		}
+
+		//compares the bytes of the prefix kept in the node, the rest of a long prefix is skipped
+		static bool
+		_prefix_matches(const _node_type* node, const radix_key& key, usize depth)
+		{
+			usize size = node->prefix_size < _max_prefix ? node->prefix_size : _max_prefix;
+			if(depth + size > key.size)
+				return false;
+			return std::memcmp(node->prefix, key.ptr + depth, size) == 0;
+		}
+
+		//count of the prefix bytes of the node which match the key, long prefixes are compared against a leaf
+		static usize
+		_prefix_mismatch(const _node_type* node, const radix_key& key, usize depth)
+		{
+			usize limit = node->prefix_size < key.size - depth ? node->prefix_size : key.size - depth;
+			usize i = 0;
+			for(; i < limit && i < _max_prefix; ++i)
+				if(node->prefix[i] != key[depth + i])
+					return i;
+
+			if(i < limit)
+			{
+				const _leaf_type* leaf = _minimum(node);
+				for(; i < limit; ++i)
+					if(leaf->key[depth + i] != key[depth + i])
+						return i;
+			}
+			return limit;
+		}
+
+		static _leaf_type*
+		_minimum(const _node_type* node)
+		{
+			while(true)
+			{
+				if(node->terminal != nullptr)
+					return node->terminal;
+
+				void* child = nullptr;
+				switch(node->kind)
+				{
+					case NODE4:
+						child = static_cast<const _node4_type*>(node)->children[0];
+						break;
+					case NODE16:
+						child = static_cast<const _node16_type*>(node)->children[0];
+						break;
+					case NODE48:
+					{
+						auto it = static_cast<const _node48_type*>(node);
+						usize b = 0;
+						while(it->index[b] == 0)
+							++b;
+						child = it->children[it->index[b] - 1];
+						break;
+					}
+					case NODE256:
+					{
+						auto it = static_cast<const _node256_type*>(node);
+						usize b = 0;
+						while(it->children[b] == nullptr)
+							++b;
+						child = it->children[b];
+						break;
+					}
+				}
+
+				if(_is_leaf(child))
+					return _as_leaf(child);
+				node = static_cast<const _node_type*>(child);
+			}
+		}
+
+		static void**
+		_find_child(_node_type* node, ubyte b)
+		{
+			switch(node->kind)
+			{
+				case NODE4:
+				{
+					auto it = static_cast<_node4_type*>(node);
+					for(usize i = 0; i < it->count; ++i)
+						if(it->keys[i] == b)
+							return &it->children[i];
+					return nullptr;
+				}
+				case NODE16:
+				{
+					auto it = static_cast<_node16_type*>(node);
+				#if defined(__SSE2__)
+					__m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it->keys));
+					u32 mask = u32(_mm_movemask_epi8(_mm_cmpeq_epi8(keys, _mm_set1_epi8(char(b)))));
+					mask &= (u32(1) << it->count) - 1;
+					if(mask)
+						return &it->children[details::lowest_set_bit(mask)];
+				#else
+					for(usize i = 0; i < it->count; ++i)
+						if(it->keys[i] == b)
+							return &it->children[i];
+				#endif
+					return nullptr;
+				}
+				case NODE48:
+				{
+					auto it = static_cast<_node48_type*>(node);
+					if(it->index[b])
+						return &it->children[it->index[b] - 1];
+					return nullptr;
+				}
+				case NODE256:
+				{
+					auto it = static_cast<_node256_type*>(node);
+					if(it->children[b])
+						return &it->children[b];
+					return nullptr;
+				}
+			}
+			return nullptr;
+		}
+
+		_leaf_type*
+		_lookup(const radix_key& key) const
+		{
+			void* it = _root;
+			usize depth = 0;
+			while(it != nullptr)
+			{
+				if(_is_leaf(it))
+				{
+					_leaf_type* leaf = _as_leaf(it);
+					return _leaf_matches(leaf, key) ? leaf : nullptr;
+				}
+
+				_node_type* node = static_cast<_node_type*>(it);
+				if(node->prefix_size > 0)
+				{
+					if(!_prefix_matches(node, key, depth))
+						return nullptr;
+					depth += node->prefix_size;
+				}
+
+				if(depth > key.size)
+					return nullptr;
+
+				if(depth == key.size)
+					return node->terminal && _leaf_matches(node->terminal, key) ? node->terminal : nullptr;
+
+				void** child = _find_child(node, key[depth]);
+				if(child == nullptr)
+					return nullptr;
+				it = *child;
+				++depth;
+			}
+			return nullptr;
+		}
+
+		template<typename VArg>
+		bool
+		_insert(const radix_key& key, VArg&& value)
+		{
+			void** ref = &_root;
+			usize depth = 0;
+			while(true)
+			{
+				if(*ref == nullptr)
+				{
+					*ref = _tag_leaf(_make_leaf(key, std::forward<VArg>(value)));
+					++_count;
+					return true;
+				}
+
+				if(_is_leaf(*ref))
+				{
+					_leaf_type* leaf = _as_leaf(*ref);
+					if(_leaf_matches(leaf, key))
+					{
+						leaf->value = std::forward<VArg>(value);
+						return false;
+					}
+
+					//split the leaf into a node holding the common bytes of both keys
+					usize common = depth;
+					while(common < leaf->key_size && common < key.size && leaf->key[common] == key[common])
+						++common;
+
+					_node4_type* node = _make_node<_node4_type>(NODE4);
+					_set_prefix(node, key.ptr + depth, common - depth);
+					_attach(ref, node, leaf, common);
+					_attach(ref, node, _make_leaf(key, std::forward<VArg>(value)), common);
+					*ref = node;
+					++_count;
+					return true;
+				}
+
+				_node_type* node = static_cast<_node_type*>(*ref);
+				if(node->prefix_size > 0)
+				{
+					usize mismatch = _prefix_mismatch(node, key, depth);
+					if(mismatch < node->prefix_size)
+					{
+						//split the prefix of the node at the first byte that differs
+						_node4_type* parent = _make_node<_node4_type>(NODE4);
+						_set_prefix(parent, node->prefix, mismatch);
+
+						ubyte b;
+						usize rest = node->prefix_size - mismatch - 1;
+						if(node->prefix_size <= _max_prefix)
+						{
+							b = node->prefix[mismatch];
+							std::memmove(node->prefix, node->prefix + mismatch + 1, rest);
+						}
+						else
+						{
+							const _leaf_type* leaf = _minimum(node);
+							b = leaf->key[depth + mismatch];
+							std::memcpy(node->prefix, leaf->key + depth + mismatch + 1, rest < _max_prefix ? rest : _max_prefix);
+						}
+						node->prefix_size = u32(rest);
+
+						void* parent_ref = parent;
+						_add_child(&parent_ref, parent, b, node);
+						_attach(&parent_ref, parent, _make_leaf(key, std::forward<VArg>(value)), depth + mismatch);
+						*ref = parent_ref;
+						++_count;
+						return true;
+					}
+					depth += node->prefix_size;
+				}
+
+				if(depth == key.size)
+				{
+					if(node->terminal != nullptr)
+					{
+						node->terminal->value = std::forward<VArg>(value);
+						return false;
+					}
+					node->terminal = _make_leaf(key, std::forward<VArg>(value));
+					++_count;
+					return true;
+				}
+
+				void** child = _find_child(node, key[depth]);
+				if(child == nullptr)
+				{
+					_add_child(ref, node, key[depth], _tag_leaf(_make_leaf(key, std::forward<VArg>(value))));
+					++_count;
+					return true;
+				}
+
+				ref = child;
+				++depth;
+			}
+		}
+
+		//puts the leaf in the node whose children are at depth, as its terminal if the key ends there
+		void
+		_attach(void** ref, _node_type* node, _leaf_type* leaf, usize depth)
+		{
+			if(leaf->key_size == depth)
+				node->terminal = leaf;
+			else
+				_add_child(ref, node, leaf->key[depth], _tag_leaf(leaf));
+		}
+
+		static void
+		_set_prefix(_node_type* node, const ubyte* prefix, usize size)
+		{
+			node->prefix_size = u32(size);
+			std::memcpy(node->prefix, prefix, size < _max_prefix ? size : _max_prefix);
+		}
+
+		static void
+		_copy_header(_node_type* dst, const _node_type* src)
+		{
+			dst->count = src->count;
+			dst->prefix_size = src->prefix_size;
+			std::memcpy(dst->prefix, src->prefix, _max_prefix);
+			dst->terminal = src->terminal;
+		}
+
+		//adds the child to the node which is at ref, it replaces the node with a bigger one if it's full
+		void
+		_add_child(void** ref, _node_type* node, ubyte b, void* child)
+		{
+			switch(node->kind)
+			{
+				case NODE4:
+				{
+					auto it = static_cast<_node4_type*>(node);
+					if(it->count < 4)
+					{
+						usize i = 0;
+						while(i < it->count && it->keys[i] < b)
+							++i;
+						std::memmove(it->keys + i + 1, it->keys + i, it->count - i);
+						std::memmove(it->children + i + 1, it->children + i, (it->count - i) * sizeof(void*));
+						it->keys[i] = b;
+						it->children[i] = child;
+						++it->count;
+						return;
+					}
+
+					_node16_type* bigger = _make_node<_node16_type>(NODE16);
+					_copy_header(bigger, it);
+					std::memcpy(bigger->keys, it->keys, 4);
+					std::memcpy(bigger->children, it->children, 4 * sizeof(void*));
+					_free_node(it);
+					*ref = bigger;
+					_add_child(ref, bigger, b, child);
+					return;
+				}
+				case NODE16:
+				{
+					auto it = static_cast<_node16_type*>(node);
+					if(it->count < 16)
+					{
+						usize i = it->count;
+					#if defined(__SSE2__)
+						//the bytes are compared as signed so the sign bits are flipped to keep the unsigned order
+						__m128i flip = _mm_set1_epi8(char(0x80));
+						__m128i keys = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it->keys)), flip);
+						__m128i key = _mm_xor_si128(_mm_set1_epi8(char(b)), flip);
+						u32 mask = u32(_mm_movemask_epi8(_mm_cmplt_epi8(key, keys)));
+						mask &= (u32(1) << it->count) - 1;
+						if(mask)
+							i = details::lowest_set_bit(mask);
+					#else
+						i = 0;
+						while(i < it->count && it->keys[i] < b)
+							++i;
+					#endif
+						std::memmove(it->keys + i + 1, it->keys + i, it->count - i);
+						std::memmove(it->children + i + 1, it->children + i, (it->count - i) * sizeof(void*));
+						it->keys[i] = b;
+						it->children[i] = child;
+						++it->count;
+						return;
+					}
+
+					_node48_type* bigger = _make_node<_node48_type>(NODE48);
+					_copy_header(bigger, it);
+					for(usize i = 0; i < 16; ++i)
+					{
+						bigger->children[i] = it->children[i];
+						bigger->index[it->keys[i]] = ubyte(i + 1);
+					}
+					_free_node(it);
+					*ref = bigger;
+					_add_child(ref, bigger, b, child);
+					return;
+				}
+				case NODE48:
+				{
+					auto it = static_cast<_node48_type*>(node);
+					if(it->count < 48)
+					{
+						usize slot = 0;
+						while(it->children[slot] != nullptr)
+							++slot;
+						it->children[slot] = child;
+						it->index[b] = ubyte(slot + 1);
+						++it->count;
+						return;
+					}
+
+					_node256_type* bigger = _make_node<_node256_type>(NODE256);
+					_copy_header(bigger, it);
+					for(usize i = 0; i < 256; ++i)
+						if(it->index[i])
+							bigger->children[i] = it->children[it->index[i] - 1];
+					_free_node(it);
+					*ref = bigger;
+					_add_child(ref, bigger, b, child);
+					return;
+				}
+				case NODE256:
+				{
+					auto it = static_cast<_node256_type*>(node);
+					it->children[b] = child;
+					++it->count;
+					return;
+				}
+			}
+		}
+
+		//removes the child in the slot from the node which is at ref, it replaces the node with a smaller one if it's sparse enough
+		void
+		_remove_child(void** ref, _node_type* node, ubyte b, void** slot)
+		{
+			switch(node->kind)
+			{
+				case NODE4:
+				{
+					auto it = static_cast<_node4_type*>(node);
+					usize i = usize(slot - it->children);
+					std::memmove(it->keys + i, it->keys + i + 1, it->count - i - 1);
+					std::memmove(it->children + i, it->children + i + 1, (it->count - i - 1) * sizeof(void*));
+					--it->count;
+					_collapse(ref, it);
+					return;
+				}
+				case NODE16:
+				{
+					auto it = static_cast<_node16_type*>(node);
+					usize i = usize(slot - it->children);
+					std::memmove(it->keys + i, it->keys + i + 1, it->count - i - 1);
+					std::memmove(it->children + i, it->children + i + 1, (it->count - i - 1) * sizeof(void*));
+					--it->count;
+					if(it->count > 3)
+						return;
+
+					_node4_type* smaller = _make_node<_node4_type>(NODE4);
+					_copy_header(smaller, it);
+					std::memcpy(smaller->keys, it->keys, it->count);
+					std::memcpy(smaller->children, it->children, it->count * sizeof(void*));
+					_free_node(it);
+					*ref = smaller;
+					return;
+				}
+				case NODE48:
+				{
+					auto it = static_cast<_node48_type*>(node);
+					*slot = nullptr;
+					it->index[b] = 0;
+					--it->count;
+					if(it->count > 12)
+						return;
+
+					_node16_type* smaller = _make_node<_node16_type>(NODE16);
+					_copy_header(smaller, it);
+					usize j = 0;
+					for(usize i = 0; i < 256; ++i)
+					{
+						if(it->index[i])
+						{
+							smaller->keys[j] = ubyte(i);
+							smaller->children[j] = it->children[it->index[i] - 1];
+							++j;
+						}
+					}
+					_free_node(it);
+					*ref = smaller;
+					return;
+				}
+				case NODE256:
+				{
+					auto it = static_cast<_node256_type*>(node);
+					*slot = nullptr;
+					--it->count;
+					if(it->count > 37)
+						return;
+
+					_node48_type* smaller = _make_node<_node48_type>(NODE48);
+					_copy_header(smaller, it);
+					usize j = 0;
+					for(usize i = 0; i < 256; ++i)
+					{
+						if(it->children[i])
+						{
+							smaller->children[j] = it->children[i];
+							smaller->index[i] = ubyte(++j);
+						}
+					}
+					_free_node(it);
+					*ref = smaller;
+					return;
+				}
+			}
+		}
+
+		//a node4 left with one entry is replaced by it, a child node takes the prefix of the node and its byte
+		void
+		_collapse(void** ref, _node_type* node)
+		{
+			auto it = static_cast<_node4_type*>(node);
+			if(it->count == 0 && it->terminal != nullptr)
+			{
+				*ref = _tag_leaf(it->terminal);
+				_free_node(it);
+				return;
+			}
+
+			if(it->count != 1 || it->terminal != nullptr)
+				return;
+
+			void* child = it->children[0];
+			if(!_is_leaf(child))
+			{
+				_node_type* child_node = static_cast<_node_type*>(child);
+				ubyte prefix[_max_prefix];
+				usize size = it->prefix_size < _max_prefix ? it->prefix_size : _max_prefix;
+				std::memcpy(prefix, it->prefix, size);
+				if(size < _max_prefix)
+					prefix[size++] = it->keys[0];
+				usize rest = _max_prefix - size;
+				std::memcpy(prefix + size, child_node->prefix, child_node->prefix_size < rest ? child_node->prefix_size : rest);
+				std::memcpy(child_node->prefix, prefix, _max_prefix);
+				child_node->prefix_size += it->prefix_size + 1;
+			}
+			*ref = child;
+			_free_node(it);
+		}
+
+		template<typename function_type, typename user_type>
+		void
+		_traverse(void* it, function_type& FT, user_type* user_data)
+		{
+			if(_is_leaf(it))
+			{
+				_leaf_type* leaf = _as_leaf(it);
+				FT(radix_key(reinterpret_cast<const byte*>(leaf->key), leaf->key_size), leaf->value, user_data);
+				return;
+			}
+
+			_node_type* node = static_cast<_node_type*>(it);
+			if(node->terminal != nullptr)
+				_traverse(_tag_leaf(node->terminal), FT, user_data);
+
+			switch(node->kind)
+			{
+				case NODE4:
+				{
+					auto n = static_cast<_node4_type*>(node);
+					for(usize i = 0; i < n->count; ++i)
+						_traverse(n->children[i], FT, user_data);
+					break;
+				}
+				case NODE16:
+				{
+					auto n = static_cast<_node16_type*>(node);
+					for(usize i = 0; i < n->count; ++i)
+						_traverse(n->children[i], FT, user_data);
+					break;
+				}
+				case NODE48:
+				{
+					auto n = static_cast<_node48_type*>(node);
+					for(usize i = 0; i < 256; ++i)
+						if(n->index[i])
+							_traverse(n->children[n->index[i] - 1], FT, user_data);
+					break;
+				}
+				case NODE256:
+				{
+					auto n = static_cast<_node256_type*>(node);
+					for(usize i = 0; i < 256; ++i)
+						if(n->children[i])
+							_traverse(n->children[i], FT, user_data);
+					break;
+				}
+			}
+		}
+
+		void
+		_free(void* it)
+		{
+			if(_is_leaf(it))
+			{
+				_free_leaf(_as_leaf(it));
+				return;
+			}
+
+			_node_type* node = static_cast<_node_type*>(it);
+			if(node->terminal != nullptr)
+				_free_leaf(node->terminal);
+
+			switch(node->kind)
+			{
+				case NODE4:
+				{
+					auto n = static_cast<_node4_type*>(node);
+					for(usize i = 0; i < n->count; ++i)
+						_free(n->children[i]);
+					break;
+				}
+				case NODE16:
+				{
+					auto n = static_cast<_node16_type*>(node);
+					for(usize i = 0; i < n->count; ++i)
+						_free(n->children[i]);
+					break;
+				}
+				case NODE48:
+				{
+					auto n = static_cast<_node48_type*>(node);
+					for(usize i = 0; i < 48; ++i)
+						if(n->children[i])
+							_free(n->children[i]);
+					break;
+				}
+				case NODE256:
+				{
+					auto n = static_cast<_node256_type*>(node);
+					for(usize i = 0; i < 256; ++i)
+						if(n->children[i])
+							_free(n->children[i]);
+					break;
+				}
+			}
+			_free_node(node);
+		}
+
+		template<typename VArg>
+		_leaf_type*
+		_make_leaf(const radix_key& key, VArg&& value)
+		{
+			slice<ubyte> memory = _context->template alloc<ubyte>(sizeof(_leaf_type) + key.size);
+			return new (memory.ptr) _leaf_type(key, std::forward<VArg>(value));
+		}
+
+		void
+		_free_leaf(_leaf_type* leaf)
+		{
+			slice<ubyte> memory(reinterpret_cast<ubyte*>(leaf), sizeof(_leaf_type) + leaf->key_size);
+			leaf->~_leaf_type();
+			_context->free(memory);
+		}
+
+		template<typename node_type>
+		node_type*
+		_make_node(node_kind kind)
+		{
+			slice<node_type> memory = _context->template alloc<node_type>();
+			std::memset(memory.ptr, 0, sizeof(node_type));
+			memory.ptr->kind = kind;
+			return memory.ptr;
+		}
+
+		void
+		_free_node(_node_type* node)
+		{
+			switch(node->kind)
+			{
+				case NODE4:
+					_free_node_memory(static_cast<_node4_type*>(node));
+					break;
+				case NODE16:
+					_free_node_memory(static_cast<_node16_type*>(node));
+					break;
+				case NODE48:
+					_free_node_memory(static_cast<_node48_type*>(node));
+					break;
+				case NODE256:
+					_free_node_memory(static_cast<_node256_type*>(node));
+					break;
+			}
+		}
+
+		template<typename node_type>
+		void
+		_free_node_memory(node_type* node)
+		{
+			slice<node_type> memory = make_slice(node);
+			_context->free(memory);
+		}
+	};
+}
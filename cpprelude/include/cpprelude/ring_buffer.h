@@ -1,93 +1,452 @@
 #pragma once
 
 #include "cpprelude/defines.h"
-#include "cpprelude/bucket_list.h"
+#include "cpprelude/memory.h"
 #include "cpprelude/memory_context.h"
 #include "cpprelude/platform.h"
 
+#include <atomic>
+#include <new>
+
 namespace cpprelude
 {
+	namespace details
+	{
+		//smallest power of two that's not less than the value and at least 2
+		constexpr usize
+		ring_buffer_capacity(usize value)
+		{
+			usize result = 2;
+			while(result < value)
+				result *= 2;
+			return result;
+		}
+	}
+
+	/*
+	 * a fixed capacity circular queue stored in one contiguous power of two slice
+	 * the read and write heads are free running counters so the slot of a head is head & (capacity - 1)
+	 * and the count is write - read which lets the buffer use all of its slots
+	 */
 	template<typename T,
-			 usize bucket_size>
+			 usize starting_capacity = 64>
 	struct ring_buffer
 	{
 		using data_type = T;
-		
-		bucket_list<T, bucket_size> _array;
-		usize _capacity, _write_head, _read_head;
+
+		slice<T> _data;
+		usize _mask, _write_head, _read_head;
+		memory_context* _context = platform->global_memory;
 
 		ring_buffer(memory_context* context = platform->global_memory)
-			:_capacity(bucket_size),
+			:ring_buffer(starting_capacity, context)
+		{}
+
+		ring_buffer(usize capacity, memory_context* context = platform->global_memory)
+			:_mask(details::ring_buffer_capacity(capacity) - 1),
 			 _write_head(0),
 			 _read_head(0),
-			 _array(context)
+			 _context(context)
+		{
+			_data = _context->template alloc<T>(_mask + 1);
+		}
+
+		ring_buffer(const ring_buffer& other)
+			:ring_buffer(other, other._context)
 		{}
 
-		bool
-		push(const T& value)
+		ring_buffer(const ring_buffer& other, memory_context* context)
+			:_mask(other._mask),
+			 _write_head(0),
+			 _read_head(0),
+			 _context(context)
 		{
-			auto write_position = (_write_head + 1) % _capacity;
-			if(write_position != _read_head)
+			_data = _context->template alloc<T>(_mask + 1);
+			for(usize i = 0; i < other.count(); ++i)
+				push(other[i]);
+		}
+
+		ring_buffer(ring_buffer&& other)
+			:_data(std::move(other._data)),
+			 _mask(other._mask),
+			 _write_head(other._write_head),
+			 _read_head(other._read_head),
+			 _context(other._context)
+		{
+			other._write_head = other._read_head = 0;
+			other._context = nullptr;
+		}
+
+		~ring_buffer()
+		{
+			clear();
+			if(_context)
 			{
-				_array[_write_head] = value;
-				_write_head = write_position;
-				return true;
+				_context->free(_data);
+				_context = nullptr;
 			}
-			return false;
+		}
+
+		ring_buffer&
+		operator=(const ring_buffer& other)
+		{
+			if(this == &other)
+				return *this;
+
+			clear();
+			if(_context)
+				_context->free(_data);
+			_context = other._context;
+			_mask = other._mask;
+			_data = _context->template alloc<T>(_mask + 1);
+			for(usize i = 0; i < other.count(); ++i)
+				push(other[i]);
+			return *this;
+		}
+
+		ring_buffer&
+		operator=(ring_buffer&& other)
+		{
+			if(this == &other)
+				return *this;
+
+			clear();
+			if(_context)
+				_context->free(_data);
+
+			_data = std::move(other._data);
+			_mask = other._mask;
+			_write_head = other._write_head;
+			_read_head = other._read_head;
+			_context = other._context;
+			other._write_head = other._read_head = 0;
+			other._context = nullptr;
+			return *this;
+		}
+
+		template<typename ... TArgs>
+		bool
+		emplace(TArgs&& ... args)
+		{
+			if(full())
+				return false;
+
+			new (_data.ptr + (_write_head & _mask)) T(std::forward<TArgs>(args)...);
+			++_write_head;
+			return true;
+		}
+
+		bool
+		push(const T& value)
+		{
+			return emplace(value);
 		}
 
 		bool
 		push(T&& value)
 		{
-		    auto write_position = (_write_head + 1) % _capacity;
-			if(write_position != _read_head)
-			{
-				_array[_write_head] = value;
-				_write_head = write_position;
-				return true;
-			}
-			return false;
+			return emplace(std::move(value));
 		}
 
 		T&
 		front()
 		{
-			return _array[_read_head];
+			return _data[_read_head & _mask];
 		}
 
-		T
+		const T&
 		front() const
 		{
-			return _array[_read_head];
+			return _data[_read_head & _mask];
+		}
+
+		T&
+		back()
+		{
+			return _data[(_write_head - 1) & _mask];
+		}
+
+		const T&
+		back() const
+		{
+			return _data[(_write_head - 1) & _mask];
 		}
 
 		bool
 		pop()
 		{
-			if (_read_head !=  _write_head)
-			{
-				_read_head = (_read_head + 1) % _capacity;
-				return true;
-			}
+			if(empty())
+				return false;
+
+			_data[_read_head & _mask].~T();
+			++_read_head;
+			return true;
+		}
+
+		//index 0 is the front of the buffer
+		T&
+		operator[](usize index)
+		{
+			return _data[(_read_head + index) & _mask];
+		}
+
+		const T&
+		operator[](usize index) const
+		{
+			return _data[(_read_head + index) & _mask];
+		}
 
-			return false;
+		usize
+		count() const
+		{
+			return _write_head - _read_head;
 		}
 
 		usize
 		capacity() const
 		{
-			return _capacity;
+			return _mask + 1;
+		}
+
+		bool
+		empty() const
+		{
+			return _write_head == _read_head;
 		}
 
+		bool
+		full() const
+		{
+			return count() == capacity();
+		}
+
+		void
+		clear()
+		{
+			while(pop());
+			_write_head = _read_head = 0;
+		}
+
+		//doubles the capacity, the elements are moved to the front of the new slice in order
 		bool
 		expand()
 		{
-			//if the data isn't wrapped around the end where we will expand
-			if(_write_head < _read_head)
+			usize elements_count = count();
+			slice<T> new_data = _context->template alloc<T>((_mask + 1) * 2);
+			for(usize i = 0; i < elements_count; ++i)
+			{
+				T& value = _data[(_read_head + i) & _mask];
+				new (new_data.ptr + i) T(std::move(value));
+				value.~T();
+			}
+
+			_context->free(_data);
+			_data = std::move(new_data);
+			_mask = _mask * 2 + 1;
+			_read_head = 0;
+			_write_head = elements_count;
+			return true;
+		}
+	};
+
+	/*
+	 * lock free single producer single consumer ring buffer
+	 * only one thread could push and only one other thread could pop at the same time
+	 * the heads live in their own cache lines along with a cached copy of the other side's head
+	 * so a side only reads the other side's cache line when its cached copy says the buffer is full or empty
+	 */
+	template<typename T>
+	struct spsc_ring_buffer
+	{
+		using data_type = T;
+
+		constexpr static usize cache_line_size = 64;
+
+		struct alignas(cache_line_size) _producer_type
+		{
+			std::atomic<usize> write_head;
+			usize cached_read_head;
+		};
+
+		struct alignas(cache_line_size) _consumer_type
+		{
+			std::atomic<usize> read_head;
+			usize cached_write_head;
+		};
+
+		//the heads are aligned to their own cache lines so they don't share the read only part's line
+		slice<T> _data;
+		usize _mask;
+		memory_context* _context;
+		_producer_type _producer;
+		_consumer_type _consumer;
+
+		spsc_ring_buffer(usize capacity, memory_context* context = platform->global_memory)
+			:_mask(details::ring_buffer_capacity(capacity) - 1),
+			 _context(context)
+		{
+			_data = _context->template alloc<T>(_mask + 1);
+			_producer.write_head.store(0, std::memory_order_relaxed);
+			_producer.cached_read_head = 0;
+			_consumer.read_head.store(0, std::memory_order_relaxed);
+			_consumer.cached_write_head = 0;
+		}
+
+		spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+
+		spsc_ring_buffer&
+		operator=(const spsc_ring_buffer&) = delete;
+
+		~spsc_ring_buffer()
+		{
+			usize read_head = _consumer.read_head.load(std::memory_order_relaxed);
+			usize write_head = _producer.write_head.load(std::memory_order_relaxed);
+			for(; read_head != write_head; ++read_head)
+				_data[read_head & _mask].~T();
+			_context->free(_data);
+		}
+
+		//producer side
+
+		template<typename ... TArgs>
+		bool
+		emplace(TArgs&& ... args)
+		{
+			usize write_head = _producer.write_head.load(std::memory_order_relaxed);
+			if(write_head - _producer.cached_read_head > _mask)
+			{
+				_producer.cached_read_head = _consumer.read_head.load(std::memory_order_acquire);
+				if(write_head - _producer.cached_read_head > _mask)
+					return false;
+			}
+
+			new (_data.ptr + (write_head & _mask)) T(std::forward<TArgs>(args)...);
+			_producer.write_head.store(write_head + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool
+		push(const T& value)
+		{
+			return emplace(value);
+		}
+
+		bool
+		push(T&& value)
+		{
+			return emplace(std::move(value));
+		}
+
+		//pushes as many of the values as there's room for and publishes them at once
+		//returns the count of pushed values
+		usize
+		push_batch(const T* values, usize values_count)
+		{
+			usize write_head = _producer.write_head.load(std::memory_order_relaxed);
+			usize room = _mask + 1 - (write_head - _producer.cached_read_head);
+			if(room < values_count)
+			{
+				_producer.cached_read_head = _consumer.read_head.load(std::memory_order_acquire);
+				room = _mask + 1 - (write_head - _producer.cached_read_head);
+			}
+
+			usize result = values_count < room ? values_count : room;
+			for(usize i = 0; i < result; ++i)
+				new (_data.ptr + ((write_head + i) & _mask)) T(values[i]);
+
+			if(result > 0)
+				_producer.write_head.store(write_head + result, std::memory_order_release);
+			return result;
+		}
+
+		//consumer side
+
+		//returns the front element or nullptr if the buffer is empty
+		T*
+		front()
+		{
+			usize read_head = _consumer.read_head.load(std::memory_order_relaxed);
+			if(read_head == _consumer.cached_write_head)
+			{
+				_consumer.cached_write_head = _producer.write_head.load(std::memory_order_acquire);
+				if(read_head == _consumer.cached_write_head)
+					return nullptr;
+			}
+			return _data.ptr + (read_head & _mask);
+		}
+
+		bool
+		pop()
+		{
+			T* value = front();
+			if(value == nullptr)
 				return false;
-			_array.expand();
-			_capacity += bucket_size;
+
+			value->~T();
+			_consumer.read_head.store(_consumer.read_head.load(std::memory_order_relaxed) + 1,
+				std::memory_order_release);
+			return true;
+		}
+
+		//moves the front element to value then pops it
+		bool
+		pop(T& value)
+		{
+			T* front_value = front();
+			if(front_value == nullptr)
+				return false;
+
+			value = std::move(*front_value);
+			front_value->~T();
+			_consumer.read_head.store(_consumer.read_head.load(std::memory_order_relaxed) + 1,
+				std::memory_order_release);
 			return true;
 		}
+
+		//moves up to values_count elements to values and releases their slots at once
+		//returns the count of popped values
+		usize
+		pop_batch(T* values, usize values_count)
+		{
+			usize read_head = _consumer.read_head.load(std::memory_order_relaxed);
+			usize available = _consumer.cached_write_head - read_head;
+			if(available < values_count)
+			{
+				_consumer.cached_write_head = _producer.write_head.load(std::memory_order_acquire);
+				available = _consumer.cached_write_head - read_head;
+			}
+
+			usize result = values_count < available ? values_count : available;
+			for(usize i = 0; i < result; ++i)
+			{
+				T& value = _data[(read_head + i) & _mask];
+				values[i] = std::move(value);
+				value.~T();
+			}
+
+			if(result > 0)
+				_consumer.read_head.store(read_head + result, std::memory_order_release);
+			return result;
+		}
+
+		//the count could be stale by the time it's returned if the other side is active
+		usize
+		count() const
+		{
+			usize read_head = _consumer.read_head.load(std::memory_order_acquire);
+			return _producer.write_head.load(std::memory_order_acquire) - read_head;
+		}
+
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		usize
+		capacity() const
+		{
+			return _mask + 1;
+		}
 	};
 }
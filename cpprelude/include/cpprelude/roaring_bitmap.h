@@ -0,0 +1,168 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/api.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+#include "cpprelude/io.h"
+
+namespace cpprelude
+{
+	/*
+	 * compressed set of u32 values in the style of roaring bitmaps
+	 * the values are split by their high 16 bits into chunks of 64K and each chunk is kept in the smallest container
+	 * an array of sorted u16 when it has up to 4096 values, a bitmap of 1024 words when it has more
+	 * or runs of consecutive values after run_optimize when that's smaller
+	 * the chunks are sorted by their key so the set operations walk both bitmaps in order
+	 */
+	struct roaring_bitmap
+	{
+		constexpr static u32 array_limit = 4096;
+		constexpr static usize bitmap_words = 1024;
+
+		struct _container_type
+		{
+			enum kind_type: u8 { ARRAY, BITMAP, RUN };
+
+			u16 key;
+			kind_type kind;
+			//count of values in an array or count of runs in a run container
+			u32 size;
+			u32 cardinality;
+			//sorted values of an array or pairs of start and length - 1 of a run container
+			slice<u16> values;
+			slice<u64> words;
+		};
+
+		struct const_iterator
+		{
+			const roaring_bitmap* _bitmap;
+			usize _container;
+			u32 _index;
+			u32 _value;
+
+			API_CPPR const_iterator&
+			operator++();
+
+			API_CPPR const_iterator
+			operator++(int);
+
+			API_CPPR bool
+			operator==(const const_iterator& other) const;
+
+			API_CPPR bool
+			operator!=(const const_iterator& other) const;
+
+			u32
+			operator*() const
+			{
+				return _value;
+			}
+
+			API_CPPR void
+			_load_first();
+		};
+
+		using iterator = const_iterator;
+
+		dynamic_array<_container_type> _containers;
+		memory_context* _context = platform->global_memory;
+
+		API_CPPR roaring_bitmap(memory_context* context = platform->global_memory);
+
+		API_CPPR roaring_bitmap(const roaring_bitmap& other);
+		API_CPPR roaring_bitmap(const roaring_bitmap& other, memory_context* context);
+
+		API_CPPR roaring_bitmap(roaring_bitmap&& other);
+
+		API_CPPR roaring_bitmap&
+		operator=(const roaring_bitmap& other);
+
+		API_CPPR roaring_bitmap&
+		operator=(roaring_bitmap&& other);
+
+		API_CPPR ~roaring_bitmap();
+
+		//returns false if the value was already in the bitmap
+		API_CPPR bool
+		insert(u32 value);
+
+		//returns false if the value wasn't in the bitmap
+		API_CPPR bool
+		remove(u32 value);
+
+		API_CPPR bool
+		contains(u32 value) const;
+
+		//count of values in the bitmap
+		API_CPPR usize
+		cardinality() const;
+
+		API_CPPR bool
+		empty() const;
+
+		API_CPPR void
+		clear();
+
+		//converts the chunks of consecutive values to runs when that takes less memory
+		//inserting or removing in a run container converts it back
+		API_CPPR void
+		run_optimize();
+
+		//bytes used by the containers
+		API_CPPR usize
+		memory_size() const;
+
+		API_CPPR roaring_bitmap&
+		operator&=(const roaring_bitmap& other);
+
+		API_CPPR roaring_bitmap&
+		operator|=(const roaring_bitmap& other);
+
+		//removes the values which are in the other bitmap
+		API_CPPR roaring_bitmap&
+		and_not(const roaring_bitmap& other);
+
+		API_CPPR bool
+		operator==(const roaring_bitmap& other) const;
+
+		API_CPPR bool
+		operator!=(const roaring_bitmap& other) const;
+
+		API_CPPR const_iterator
+		begin() const;
+
+		API_CPPR const_iterator
+		cbegin() const;
+
+		API_CPPR const_iterator
+		end() const;
+
+		API_CPPR const_iterator
+		cend() const;
+
+		//index of the container with the key or the index it should be inserted at
+		API_CPPR usize
+		_find(u16 key) const;
+
+		API_CPPR void
+		_reset();
+	};
+
+	API_CPPR roaring_bitmap
+	operator&(const roaring_bitmap& a, const roaring_bitmap& b);
+
+	API_CPPR roaring_bitmap
+	operator|(const roaring_bitmap& a, const roaring_bitmap& b);
+
+	//writes the bitmap and returns the count of written bytes
+	API_CPPR usize
+	print_bin(io_trait *trait, const roaring_bitmap& bitmap);
+
+	//reads a bitmap written by print_bin into the bitmap and returns the count of read bytes
+	//the bitmap is left empty if the data is invalid or incomplete
+	API_CPPR usize
+	scan_bin(io_trait *trait, roaring_bitmap& bitmap);
+}
@@ -5,6 +5,7 @@
 #include "cpprelude/iterator.h"
 #include "cpprelude/memory_context.h"
 #include "cpprelude/platform.h"
+#include "cpprelude/defaults.h"
 #include <initializer_list>
 #include <iterator>
 
@@ -70,6 +71,7 @@ namespace cpprelude
 				other_it = &(*other_it)->next;
 				++_count;
 			}
+			*it = nullptr;
 		}
 
 		slinked_list(const slinked_list<T>& other, memory_context* context)
@@ -91,6 +93,7 @@ namespace cpprelude
 				other_it = &(*other_it)->next;
 				++_count;
 			}
+			*it = nullptr;
 		}
 
 		slinked_list(slinked_list<T>&& other)
@@ -141,6 +144,7 @@ namespace cpprelude
 				other_it = &(*other_it)->next;
 				++_count;
 			}
+			*it = nullptr;
 
 			return *this;
 		}
@@ -360,6 +364,166 @@ namespace cpprelude
 				it = next_node;
 				--_count;
 			}
+			_head = nullptr;
+		}
+
+		//moves all the elements of the other list to the front of this list, it only relinks the nodes
+		//lists with different memory contexts copy the elements instead and the other list is left empty
+		void
+		splice_front(slinked_list<T>& other)
+		{
+			if(this == &other || other._head == nullptr)
+				return;
+
+			//nodes can't change hands if they are allocated from different contexts
+			if(_context != other._context)
+			{
+				slinked_list<T> copy(other, _context);
+				other.reset();
+				splice_front(copy);
+				return;
+			}
+
+			node_type* last = other._head;
+			while(last->next != nullptr)
+				last = last->next;
+
+			last->next = _head;
+			_head = other._head;
+			_count += other._count;
+			other._head = nullptr;
+			other._count = 0;
+		}
+
+		//moves all the elements of the other list after the given element of this list
+		void
+		splice_after(const iterator& it, slinked_list<T>& other)
+		{
+			if(this == &other || other._head == nullptr)
+				return;
+
+			if(_context != other._context)
+			{
+				slinked_list<T> copy(other, _context);
+				other.reset();
+				splice_after(it, copy);
+				return;
+			}
+
+			node_type* last = other._head;
+			while(last->next != nullptr)
+				last = last->next;
+
+			last->next = it._node->next;
+			it._node->next = other._head;
+			_count += other._count;
+			other._head = nullptr;
+			other._count = 0;
+		}
+
+		//moves count elements starting from first in the other list after the given element of this list
+		//the other list is walked from its head to find the node before first
+		void
+		splice_after(const iterator& it, slinked_list<T>& other, const iterator& first, usize count)
+		{
+			if(count == 0)
+				return;
+
+			if(_context != other._context)
+			{
+				slinked_list<T> range(other._context);
+				range.splice_front(other, first, count);
+				slinked_list<T> copy(range, _context);
+				splice_after(it, copy);
+				return;
+			}
+
+			node_type* last = other._unlink_range(first._node, count);
+			last->next = it._node->next;
+			it._node->next = first._node;
+			_count += count;
+		}
+
+		//moves count elements starting from first in the other list to the front of this list
+		void
+		splice_front(slinked_list<T>& other, const iterator& first, usize count)
+		{
+			if(count == 0)
+				return;
+
+			if(_context != other._context)
+			{
+				slinked_list<T> range(other._context);
+				range.splice_front(other, first, count);
+				slinked_list<T> copy(range, _context);
+				splice_front(copy);
+				return;
+			}
+
+			node_type* last = other._unlink_range(first._node, count);
+			last->next = _head;
+			_head = first._node;
+			_count += count;
+		}
+
+		//merges the other sorted list into this sorted list by relinking, equal elements of this list come first
+		template<typename Comparator = default_less_than<T>>
+		void
+		merge(slinked_list<T>& other, Comparator less_than = Comparator())
+		{
+			if(this == &other)
+				return;
+
+			if(_context != other._context)
+			{
+				slinked_list<T> copy(other, _context);
+				other.reset();
+				merge(copy, less_than);
+				return;
+			}
+
+			node_type** it = &_head;
+			node_type* other_it = other._head;
+			while(other_it != nullptr)
+			{
+				if(*it == nullptr || less_than(other_it->data, (*it)->data))
+				{
+					node_type* next_node = other_it->next;
+					other_it->next = *it;
+					*it = other_it;
+					other_it = next_node;
+				}
+				it = &(*it)->next;
+			}
+
+			_count += other._count;
+			other._head = nullptr;
+			other._count = 0;
+		}
+
+		//stable bottom up merge sort which only relinks the nodes, no allocations and no element moves
+		template<typename Comparator = default_less_than<T>>
+		void
+		sort(Comparator less_than = Comparator())
+		{
+			_head = details::sort_node_chain(_head, less_than, static_cast<node_type**>(nullptr));
+		}
+
+		//unlinks count nodes starting from first and returns the last of them
+		node_type*
+		_unlink_range(node_type* first, usize count)
+		{
+			node_type** prev_next = &_head;
+			while(*prev_next != first)
+				prev_next = &(*prev_next)->next;
+
+			node_type* last = first;
+			for(usize i = 1; i < count; ++i)
+				last = last->next;
+
+			*prev_next = last->next;
+			_count -= count;
+			return last;
 		}
 
 		bool
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+#include "cpprelude/iterator.h"
+
+#include <utility>
+
+namespace cpprelude
+{
+	/*
+	 * slot map, values are kept densely packed in a dynamic array and referred to by handles
+	 * a handle is the index of a slot which holds the dense index of the value, and the generation of the slot
+	 * removing a value moves the last value into its place and bumps the generation of its slot so old handles stop matching
+	 * freed slots are reused through a free list threaded through the slots
+	 */
+	template<typename T>
+	struct slot_map
+	{
+		using iterator = sequential_iterator<T>;
+		using const_iterator = sequential_iterator<const T>;
+		using data_type = T;
+
+		constexpr static u32 _invalid = static_cast<u32>(-1);
+
+		struct handle
+		{
+			u32 index;
+			u32 generation;
+
+			bool
+			operator==(const handle& other) const
+			{
+				return index == other.index && generation == other.generation;
+			}
+
+			bool
+			operator!=(const handle& other) const
+			{
+				return !operator==(other);
+			}
+		};
+
+		struct _slot_type
+		{
+			//dense index of the value while the slot is used or the next free slot while it's free
+			u32 target;
+			//odd while the slot is used so a handle to a freed slot never matches
+			u32 generation;
+		};
+
+		dynamic_array<T> _values;
+		//slot of each dense value, it's how a moved value finds its slot
+		dynamic_array<u32> _value_slots;
+		dynamic_array<_slot_type> _slots;
+		u32 _free_head;
+
+		slot_map(memory_context* context = platform->global_memory)
+			:_values(context),
+			 _value_slots(context),
+			 _slots(context),
+			 _free_head(_invalid)
+		{}
+
+		handle
+		insert(const T& value)
+		{
+			_values.insert_back(value);
+			return _bind_last();
+		}
+
+		handle
+		insert(T&& value)
+		{
+			_values.insert_back(std::move(value));
+			return _bind_last();
+		}
+
+		template<typename ... TArgs>
+		handle
+		emplace(TArgs&& ... args)
+		{
+			_values.emplace_back(std::forward<TArgs>(args)...);
+			return _bind_last();
+		}
+
+		//removes the value in O(1) by moving the last value into its place
+		//returns false if the handle is stale
+		bool
+		remove(handle value_handle)
+		{
+			if(!contains(value_handle))
+				return false;
+
+			_slot_type& slot = _slots[value_handle.index];
+			u32 dense = slot.target;
+			u32 last = static_cast<u32>(_values.count() - 1);
+			if(dense != last)
+			{
+				std::swap(_values[dense], _values[last]);
+				_value_slots[dense] = _value_slots[last];
+				_slots[_value_slots[dense]].target = dense;
+			}
+			_values.remove_back();
+			_value_slots.remove_back();
+
+			++slot.generation;
+			slot.target = _free_head;
+			_free_head = value_handle.index;
+			return true;
+		}
+
+		bool
+		contains(handle value_handle) const
+		{
+			return value_handle.index < _slots.count() &&
+				   _slots[value_handle.index].generation == value_handle.generation;
+		}
+
+		//returns nullptr if the handle is stale
+		T*
+		get(handle value_handle)
+		{
+			if(!contains(value_handle))
+				return nullptr;
+			return &_values[_slots[value_handle.index].target];
+		}
+
+		const T*
+		get(handle value_handle) const
+		{
+			if(!contains(value_handle))
+				return nullptr;
+			return &_values[_slots[value_handle.index].target];
+		}
+
+		//the handle must be valid
+		T&
+		operator[](handle value_handle)
+		{
+			return _values[_slots[value_handle.index].target];
+		}
+
+		const T&
+		operator[](handle value_handle) const
+		{
+			return _values[_slots[value_handle.index].target];
+		}
+
+		//handle of the value at the dense index
+		handle
+		handle_of(usize dense_index) const
+		{
+			u32 index = _value_slots[dense_index];
+			return handle{index, _slots[index].generation};
+		}
+
+		void
+		reserve(usize count)
+		{
+			_values.reserve(count);
+			_value_slots.reserve(count);
+			_slots.reserve(count);
+		}
+
+		//removes all the values, all the handles become stale
+		void
+		clear()
+		{
+			for(usize i = 0; i < _value_slots.count(); ++i)
+			{
+				_slot_type& slot = _slots[_value_slots[i]];
+				++slot.generation;
+				slot.target = _free_head;
+				_free_head = _value_slots[i];
+			}
+			_values.clear();
+			_value_slots.clear();
+		}
+
+		usize
+		count() const
+		{
+			return _values.count();
+		}
+
+		bool
+		empty() const
+		{
+			return _values.count() == 0;
+		}
+
+		//the values are dense so iterating them is iterating an array, removing while iterating moves the last value
+		const_iterator
+		begin() const
+		{
+			return _values.begin();
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return _values.cbegin();
+		}
+
+		iterator
+		begin()
+		{
+			return _values.begin();
+		}
+
+		const_iterator
+		end() const
+		{
+			return _values.end();
+		}
+
+		const_iterator
+		cend() const
+		{
+			return _values.cend();
+		}
+
+		iterator
+		end()
+		{
+			return _values.end();
+		}
+
+		handle
+		_bind_last()
+		{
+			u32 dense = static_cast<u32>(_values.count() - 1);
+			u32 index;
+			if(_free_head != _invalid)
+			{
+				index = _free_head;
+				_free_head = _slots[index].target;
+			}
+			else
+			{
+				index = static_cast<u32>(_slots.count());
+				_slots.insert_back(_slot_type{0, 0});
+			}
+
+			_slot_type& slot = _slots[index];
+			slot.target = dense;
+			++slot.generation;
+			_value_slots.insert_back(index);
+			return handle{index, slot.generation};
+		}
+	};
+}
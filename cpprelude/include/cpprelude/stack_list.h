@@ -6,12 +6,13 @@
 
 namespace cpprelude
 {
-	template<typename T>
+	//list_type is the backing list, it could be swapped with unrolled_list<T> to store several elements per node
+	template<typename T, typename list_type = slinked_list<T>>
 	struct stack_list
 	{
 		using data_type = T;
 
-		slinked_list<T> _list;
+		list_type _list;
 
 		stack_list(memory_context* context = platform->global_memory)
 			:_list(context)
@@ -26,7 +27,7 @@ namespace cpprelude
 		{}
 
 		stack_list(stack_list&& other, memory_context* context)
-			:_list(std::move(other), context)
+			:_list(std::move(other._list), context)
 		{}
 
 		template<typename ... TArgs>
@@ -84,7 +85,7 @@ namespace cpprelude
 			return _list.count();
 		}
 
-		slice<typename slinked_list<T>::node_type>
+		slice<typename list_type::node_type>
 		decay()
 		{
 			return _list.decay();
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/dynamic_array.h"
+#include "cpprelude/bits.h"
+
+namespace cpprelude
+{
+	/*
+	 * hierarchical timing wheel
+	 * time is counted in ticks, each level has 64 slots and a slot of level l spans 64^l ticks
+	 * a timer is put in the level of the highest 6 bit group where its deadline differs from the current tick
+	 * and it's moved down a level when the wheel reaches its slot so each timer is touched at most once per level
+	 * the timers live in a pool of nodes linked into the slots by index so scheduling and cancelling are O(1)
+	 * and advancing jumps straight to the next occupied slot using a bitmap per level
+	 */
+	template<typename T>
+	struct timing_wheel
+	{
+		using data_type = T;
+
+		constexpr static usize slot_bits = 6;
+		constexpr static usize slots_count = 64;
+		//11 levels of 6 bits cover the whole 64 bit tick range
+		constexpr static usize levels_count = 11;
+		constexpr static u32 _invalid = static_cast<u32>(-1);
+
+		//handle of a scheduled timer, it's invalidated once the timer expires or gets cancelled
+		struct handle
+		{
+			u32 index;
+			u32 generation;
+		};
+
+		//the value is alive only while the timer is armed so cancelled timers don't hold on to it
+		struct _node_type
+		{
+			union
+			{
+				T value;
+			};
+			u64 deadline;
+			u32 prev, next;
+			u32 generation;
+			u8 level, slot;
+			bool armed;
+
+			_node_type()
+				:deadline(0), prev(_invalid), next(_invalid), generation(0), level(0), slot(0), armed(false)
+			{}
+
+			_node_type(_node_type&& other)
+				:deadline(other.deadline),
+				 prev(other.prev),
+				 next(other.next),
+				 generation(other.generation),
+				 level(other.level),
+				 slot(other.slot),
+				 armed(other.armed)
+			{
+				if(armed)
+					new (&value) T(std::move(other.value));
+			}
+
+			~_node_type()
+			{
+				if(armed)
+					value.~T();
+			}
+		};
+
+		dynamic_array<_node_type> _nodes;
+		u32 _free_head;
+		u32 _heads[levels_count][slots_count];
+		u64 _occupied[levels_count];
+		u64 _now;
+		u64 _start;
+		u64 _tick_duration;
+		usize _count;
+
+		//the tick duration is in nanoseconds of the platform monotonic clock and tick 0 is the time of construction
+		timing_wheel(u64 tick_duration = 1000000, memory_context* context = platform->global_memory)
+			:_nodes(context),
+			 _free_head(_invalid),
+			 _now(0),
+			 _start(platform->monotonic_time()),
+			 _tick_duration(tick_duration),
+			 _count(0)
+		{
+			for(usize level = 0; level < levels_count; ++level)
+			{
+				_occupied[level] = 0;
+				for(usize slot = 0; slot < slots_count; ++slot)
+					_heads[level][slot] = _invalid;
+			}
+		}
+
+		timing_wheel(const timing_wheel&) = delete;
+
+		timing_wheel&
+		operator=(const timing_wheel&) = delete;
+
+		//schedules the value to expire after the delay in nanoseconds from now
+		handle
+		schedule(u64 delay, const T& value)
+		{
+			return _schedule(current_tick() + (delay + _tick_duration - 1) / _tick_duration, value);
+		}
+
+		handle
+		schedule(u64 delay, T&& value)
+		{
+			return _schedule(current_tick() + (delay + _tick_duration - 1) / _tick_duration, std::move(value));
+		}
+
+		//schedules the value to expire at the tick, a tick that's not after the wheel's tick expires on the next advance
+		handle
+		schedule_at_tick(u64 tick, const T& value)
+		{
+			return _schedule(tick, value);
+		}
+
+		handle
+		schedule_at_tick(u64 tick, T&& value)
+		{
+			return _schedule(tick, std::move(value));
+		}
+
+		//returns false if the timer already expired or got cancelled
+		bool
+		cancel(handle timer)
+		{
+			if(!armed(timer))
+				return false;
+
+			_unlink(timer.index);
+			_free_node(timer.index);
+			--_count;
+			return true;
+		}
+
+		bool
+		armed(handle timer) const
+		{
+			return timer.index < _nodes.count() &&
+				   _nodes[timer.index].generation == timer.generation &&
+				   _nodes[timer.index].armed;
+		}
+
+		//moves the wheel to the tick and appends the values of the expired timers to the expired array
+		//returns the count of expired timers
+		usize
+		advance(u64 tick, dynamic_array<T>& expired)
+		{
+			usize result = 0;
+			while(true)
+			{
+				//with no timers the next event is the max u64 sentinel which even the max tick shouldn't reach
+				if(_count == 0)
+					break;
+
+				u64 event = next_event_tick();
+				if(event > tick)
+					break;
+
+				_now = event;
+
+				//move the timers of the slots the wheel just reached a level down
+				for(usize level = levels_count - 1; level > 0; --level)
+				{
+					usize shift = level * slot_bits;
+					if(_now & ((u64(1) << shift) - 1))
+						continue;
+
+					usize slot = (_now >> shift) & (slots_count - 1);
+					u32 index = _take_slot(level, slot);
+					while(index != _invalid)
+					{
+						u32 next = _nodes[index].next;
+						_link(index);
+						index = next;
+					}
+				}
+
+				//expire the whole slot at once
+				u32 index = _take_slot(0, _now & (slots_count - 1));
+				while(index != _invalid)
+				{
+					u32 next = _nodes[index].next;
+					expired.insert_back(std::move(_nodes[index].value));
+					_free_node(index);
+					--_count;
+					++result;
+					index = next;
+				}
+			}
+
+			if(tick > _now)
+				_now = tick;
+			return result;
+		}
+
+		//advances the wheel to the current time of the platform monotonic clock
+		usize
+		poll(dynamic_array<T>& expired)
+		{
+			return advance(current_tick(), expired);
+		}
+
+		//the tick of the platform monotonic clock now
+		u64
+		current_tick() const
+		{
+			return (platform->monotonic_time() - _start) / _tick_duration;
+		}
+
+		//the tick the wheel is at
+		u64
+		now() const
+		{
+			return _now;
+		}
+
+		//the wheel has nothing to do before this tick, it's the max u64 if there are no timers
+		u64
+		next_event_tick() const
+		{
+			u64 result = static_cast<u64>(-1);
+			for(usize level = 0; level < levels_count; ++level)
+			{
+				if(_occupied[level] == 0)
+					continue;
+
+				usize shift = level * slot_bits;
+				u64 base = 0;
+				if(level + 1 < levels_count)
+					base = (_now >> (shift + slot_bits)) << (shift + slot_bits);
+
+				u64 tick = base + (u64(details::lowest_set_bit(_occupied[level])) << shift);
+				if(tick < result)
+					result = tick;
+			}
+			return result;
+		}
+
+		void
+		reserve(usize timers_count)
+		{
+			_nodes.reserve(timers_count);
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		template<typename U>
+		handle
+		_schedule(u64 tick, U&& value)
+		{
+			u32 index;
+			if(_free_head != _invalid)
+			{
+				index = _free_head;
+				_free_head = _nodes[index].next;
+			}
+			else
+			{
+				index = static_cast<u32>(_nodes.count());
+				_nodes.insert_back(_node_type());
+			}
+
+			_node_type& node = _nodes[index];
+			new (&node.value) T(std::forward<U>(value));
+			node.deadline = tick > _now ? tick : _now + 1;
+			node.armed = true;
+			_link(index);
+			++_count;
+			return handle{index, node.generation};
+		}
+
+		void
+		_link(u32 index)
+		{
+			_node_type& node = _nodes[index];
+			u64 diff = node.deadline ^ _now;
+
+			usize level = 0;
+			while(level + 1 < levels_count && (diff >> ((level + 1) * slot_bits)) != 0)
+				++level;
+			usize slot = (node.deadline >> (level * slot_bits)) & (slots_count - 1);
+
+			u32& head = _heads[level][slot];
+			node.level = static_cast<u8>(level);
+			node.slot = static_cast<u8>(slot);
+			node.prev = _invalid;
+			node.next = head;
+			if(head != _invalid)
+				_nodes[head].prev = index;
+			head = index;
+			_occupied[level] |= u64(1) << slot;
+		}
+
+		void
+		_unlink(u32 index)
+		{
+			_node_type& node = _nodes[index];
+			if(node.prev != _invalid)
+				_nodes[node.prev].next = node.next;
+			else
+				_heads[node.level][node.slot] = node.next;
+
+			if(node.next != _invalid)
+				_nodes[node.next].prev = node.prev;
+
+			if(_heads[node.level][node.slot] == _invalid)
+				_occupied[node.level] &= ~(u64(1) << node.slot);
+		}
+
+		//detaches the whole list of the slot and returns its head
+		u32
+		_take_slot(usize level, usize slot)
+		{
+			u32 result = _heads[level][slot];
+			_heads[level][slot] = _invalid;
+			_occupied[level] &= ~(u64(1) << slot);
+			return result;
+		}
+
+		void
+		_free_node(u32 index)
+		{
+			_node_type& node = _nodes[index];
+			node.value.~T();
+			node.armed = false;
+			++node.generation;
+			node.next = _free_head;
+			_free_head = index;
+		}
+	};
+}
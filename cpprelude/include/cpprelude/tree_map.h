@@ -7,22 +7,321 @@
 #include "cpprelude/memory.h"
 #include "cpprelude/defaults.h"
 
+#include <type_traits>
+
 //because of the idiots at microsoft
 #undef min
 #undef max
 
 namespace cpprelude
 {
+	//closed interval [low, high] used as the element of the interval trees
+	template<typename T>
+	struct interval
+	{
+		T low, high;
+
+		interval()
+		{}
+
+		interval(const T& low_, const T& high_)
+			:low(low_), high(high_)
+		{}
+
+		bool
+		overlaps(const interval& other) const
+		{
+			return !(high < other.low) && !(other.high < low);
+		}
+
+		bool
+		operator<(const interval& other) const
+		{
+			return low < other.low || (!(other.low < low) && high < other.high);
+		}
+
+		bool
+		operator==(const interval& other) const
+		{
+			return !(*this < other) && !(other < *this);
+		}
+
+		bool
+		operator!=(const interval& other) const
+		{
+			return !operator==(other);
+		}
+	};
+
+	/*
+	 * augmentations store extra data in every node which is computed from the node and its children
+	 * the tree calls AugmentType::update(node) whenever the node's children or data change
+	 * (insertion, removal and rotations) so the data stays valid in O(log n) per operation
+	 */
+
+	//stores the count of nodes in the subtree, enables rank, select and count_range
+	struct red_black_tree_size_augment
+	{
+		usize size = 1;
+
+		template<typename node_type>
+		static void
+		update(node_type* node)
+		{
+			usize size = 1;
+			if(node->left != nullptr)
+				size += node->left->augment.size;
+			if(node->right != nullptr)
+				size += node->right->augment.size;
+			node->augment.size = size;
+		}
+	};
+
+	//stores the max high endpoint in the subtree of intervals, enables the overlap queries
+	template<typename T>
+	struct red_black_tree_interval_augment
+	{
+		T max_high;
+
+		template<typename node_type>
+		static void
+		update(node_type* node)
+		{
+			const T* max_high = &node->data.high;
+			if(node->left != nullptr && *max_high < node->left->augment.max_high)
+				max_high = &node->left->augment.max_high;
+			if(node->right != nullptr && *max_high < node->right->augment.max_high)
+				max_high = &node->right->augment.max_high;
+			node->augment.max_high = *max_high;
+		}
+	};
+
+	namespace details
+	{
+		//the red black balancing logic, it works on any node type with left, right, parent and color members
+		//and is shared between the red_black_tree and the intrusive_tree
+		//AugmentType::update is called on the nodes whose children change by a rotation
+		template<typename node_type, typename AugmentType = red_black_tree_no_augment>
+		struct red_black_fixup
+		{
+			using color_type = typename node_type::color_type;
+
+			static void
+			insert_fixup(node_type*& root, node_type* z)
+			{
+				auto is_red = [](node_type* p) { return p != nullptr && p->color == color_type::RED; };
+
+				while (is_red(z->parent))
+				{
+					if (z->parent == z->parent->parent->left)
+					{
+						node_type* y = z->parent->parent->right;
+						if (is_red(y))
+						{ //Casse 1
+							z->parent->color = color_type::BLACK;
+							y->color = color_type::BLACK;
+							z->parent->parent->color = color_type::RED;
+							z = z->parent->parent;
+						}
+						else
+						{
+							if (z == z->parent->right)
+							{ //case 2
+								z = z->parent;
+								left_rotation(root, z);
+							}
+							//case 3
+							z->parent->color = color_type::BLACK;
+							z->parent->parent->color = color_type::RED;
+							right_rotation(root, z->parent->parent);
+						}
+					}
+					else
+					{// right instead of left
+
+						node_type* y = z->parent->parent->left;
+						if (is_red(y))
+						{ //Casse 1
+							z->parent->color = color_type::BLACK;
+							y->color = color_type::BLACK;
+							z->parent->parent->color = color_type::RED;
+							z = z->parent->parent;
+						}
+						else
+						{
+							if (z == z->parent->left)
+							{ //case 2
+								z = z->parent;
+								right_rotation(root, z);
+							}
+							//case 3
+							z->parent->color = color_type::BLACK;
+							z->parent->parent->color = color_type::RED;
+							left_rotation(root, z->parent->parent);
+						}
+					}
+				}
+				root->color = color_type::BLACK;
+			}
+
+			static void
+			delete_fixup(node_type*& root, node_type* node, node_type* node_parent)
+			{
+				node_type* w = nullptr;
+				bool is_node_black = true;
+				if (node != nullptr)
+					is_node_black = node->color == color_type::BLACK;
+
+				while (node != root && is_node_black)
+				{
+					if (node == node_parent->left)
+					{
+						w = node_parent->right;
+						if (w->color == color_type::RED)
+						{	//Case 1
+							w->color = color_type::BLACK;
+							node_parent->color = color_type::RED;
+							left_rotation(root, node_parent);
+							w = node_parent->right;
+						}
+						bool is_w_left_black = true;
+						bool is_w_right_black = true;
+						if (w->left != nullptr)
+							is_w_left_black = w->left->color == color_type::BLACK;
+						if (w->right != nullptr)
+							is_w_right_black = w->right->color == color_type::BLACK;
+
+						if (is_w_left_black	&& is_w_right_black)
+						{ //Case 2: black sibling with black childern
+							w->color = color_type::RED;
+							node = node_parent;
+							node_parent = node->parent;
+							is_node_black = node->color == color_type::BLACK;
+						}
+						else
+						{
+							if (is_w_right_black)
+							{	//Case 3
+								w->left->color = color_type::BLACK;
+								w->color = color_type::RED;
+								right_rotation(root, w);
+								w = node_parent->right;
+							}
+							//Case 4
+							w->color = node_parent->color;
+							node_parent->color = color_type::BLACK;
+							if (w->right != nullptr)
+								w->right->color = color_type::BLACK;
+							left_rotation(root, node_parent);
+							node = root;
+							node_parent = nullptr;
+						}
+
+					}
+					else
+					{
+						w = node_parent->left;
+						if (w->color == color_type::RED)
+						{	//Case 1
+							w->color = color_type::BLACK;
+							node_parent->color = color_type::RED;
+							right_rotation(root, node_parent);
+							w = node_parent->left;
+						}
+
+						bool is_w_left_black = true;
+						bool is_w_right_black = true;
+						if (w->left != nullptr)
+							is_w_left_black = w->left->color == color_type::BLACK;
+						if (w->right != nullptr)
+							is_w_right_black = w->right->color == color_type::BLACK;
+
+						if (is_w_left_black	&& is_w_right_black)
+						{	//Case 2
+							w->color = color_type::RED;
+							node = node_parent;
+							node_parent = node->parent;
+							is_node_black = node->color == color_type::BLACK;
+						}
+						else
+						{
+							if (is_w_left_black)
+							{	//Case 3
+								w->right->color = color_type::BLACK;
+								w->color = color_type::RED;
+								left_rotation(root, w);
+								w = node_parent->left;
+							}
+							//Case 4
+							w->color = node_parent->color;
+							node_parent->color = color_type::BLACK;
+							if (w->left != nullptr)// check this
+								w->left->color = color_type::BLACK;
+							right_rotation(root, node_parent);
+							node = root;
+							node_parent = nullptr;
+						}
+					}
+				}
+				if (node != nullptr)
+					node->color = color_type::BLACK;
+			}
+
+			static void
+			left_rotation(node_type*& root, node_type* x)
+			{
+				node_type* y = x->right;
+				x->right = y->left;
+				if (y->left != nullptr)
+					y->left->parent = x;
+				y->parent = x->parent;
+				if (x->parent == nullptr)
+					root = y;
+				else if (x == x->parent->left)
+					x->parent->left = y;
+				else
+					x->parent->right = y;
+				y->left = x;
+				x->parent = y;
+
+				AugmentType::update(x);
+				AugmentType::update(y);
+			}
+
+			static void
+			right_rotation(node_type*& root, node_type* x)
+			{
+				node_type* y = x->left;
+				x->left = y->right;
+				if (y->right != nullptr)
+					y->right->parent = x;
+				y->parent = x->parent;
+				if (x->parent == nullptr)
+					root = y;
+				else if (x == x->parent->right)
+					x->parent->right = y;
+				else
+					x->parent->left = y;
+				y->right = x;
+				x->parent = y;
+
+				AugmentType::update(x);
+				AugmentType::update(y);
+			}
+		};
+	}
+
 	//red black tree implmenetion follows Introduction to Algorithms, Second Edition,” by Thomas H. Cormen, Charles E, Chapter 14
 
 	template<typename T,
-			 typename ComparatorType = default_less_than<T>>
+			 typename ComparatorType = default_less_than<T>,
+			 typename AugmentType = details::red_black_tree_no_augment>
 	struct red_black_tree
 	{
 		using data_type = T;
-		using node_type = details::red_black_tree_node<data_type>;
-		using iterator = red_black_tree_iterator<T>;
-		using const_iterator = red_black_tree_iterator<T>;
+		using node_type = details::red_black_tree_node<data_type, AugmentType>;
+		using iterator = red_black_tree_iterator<T, AugmentType>;
+		using const_iterator = red_black_tree_iterator<T, AugmentType>;
 		using color_type = typename node_type::color_type;
 
 		node_type *_root;
@@ -54,11 +353,21 @@ namespace cpprelude
 				}
 		}
 
+		//builds the tree in linear time from a sorted range, equal elements are inserted once
+		template<typename iterator_type>
+		red_black_tree(iterator_type it, usize count,
+			const ComparatorType& compare_function = ComparatorType(),
+			memory_context* context = platform->global_memory)
+			:_root(nullptr), _count(0), _context(context), _less_than(compare_function)
+		{
+			_bulk_load(it, count);
+		}
+
 		red_black_tree(const red_black_tree& other)
 			:_root(nullptr), _count(0), _context(other._context),
 			 _less_than(other._less_than)
 		{
-			_copy_content(other);
+			_copy_sorted_content(other);
 		}
 
 		red_black_tree(const red_black_tree& other,
@@ -74,7 +383,7 @@ namespace cpprelude
 			:_root(nullptr), _count(0), _context(context),
 			 _less_than(other._less_than)
 		{
-			_copy_content(other);
+			_copy_sorted_content(other);
 		}
 
 		red_black_tree(const red_black_tree& other,
@@ -139,7 +448,7 @@ namespace cpprelude
 			clear();
 			_context = other._context;
 			_less_than = other._less_than;
-			_copy_content(other);
+			_copy_sorted_content(other);
 			return *this;
 		}
 
@@ -231,6 +540,8 @@ namespace cpprelude
 			if (y != node_to_delete)
 				const_cast<node_type*>(node_to_delete.node)->data = *y;
 
+			_update_augment_path(x_parent);
+
 			if (y.node->color == color_type::BLACK)
 				_rb_delete_fixup(x, x_parent);
 
@@ -267,6 +578,108 @@ namespace cpprelude
 			return lookup(data);
 		}
 
+		//returns an iterator to the first element that's not less than the given data
+		iterator
+		lower_bound(const T& data)
+		{
+			return iterator(_lower_bound(data));
+		}
+
+		const_iterator
+		lower_bound(const T& data) const
+		{
+			return const_iterator(_lower_bound(data));
+		}
+
+		//returns an iterator to the first element that's greater than the given data
+		iterator
+		upper_bound(const T& data)
+		{
+			return iterator(_upper_bound(data));
+		}
+
+		const_iterator
+		upper_bound(const T& data) const
+		{
+			return const_iterator(_upper_bound(data));
+		}
+
+		iterator_range<iterator>
+		equal_range(const T& data)
+		{
+			return iterator_range<iterator>(lower_bound(data), upper_bound(data));
+		}
+
+		iterator_range<const_iterator>
+		equal_range(const T& data) const
+		{
+			return iterator_range<const_iterator>(lower_bound(data), upper_bound(data));
+		}
+
+		//returns the count of elements less than the given data, needs the red_black_tree_size_augment
+		usize
+		rank(const T& data) const
+		{
+			usize result = 0;
+			node_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(it->data, data))
+				{
+					result += _subtree_size(it->left) + 1;
+					it = it->right;
+				}
+				else
+				{
+					it = it->left;
+				}
+			}
+			return result;
+		}
+
+		//returns an iterator to the element with the given zero based index in order, needs the red_black_tree_size_augment
+		iterator
+		select(usize index)
+		{
+			return iterator(_select(index));
+		}
+
+		const_iterator
+		select(usize index) const
+		{
+			return const_iterator(_select(index));
+		}
+
+		//returns the count of elements in the [low, high) range, needs the red_black_tree_size_augment
+		usize
+		count_range(const T& low, const T& high) const
+		{
+			if(!_less_than(low, high))
+				return 0;
+			return rank(high) - rank(low);
+		}
+
+		//returns an iterator to an interval which overlaps the given one, needs the red_black_tree_interval_augment
+		iterator
+		lookup_overlap(const T& query)
+		{
+			return iterator(_lookup_overlap(query));
+		}
+
+		const_iterator
+		lookup_overlap(const T& query) const
+		{
+			return const_iterator(_lookup_overlap(query));
+		}
+
+		//applys the function to all the intervals which overlap the given one in order, needs the red_black_tree_interval_augment
+		template<typename function_type, typename user_type = void>
+		void
+		overlap_traverse(const T& query, function_type&& FT, user_type* user_data = nullptr) const
+		{
+			_overlap_traverse(std::forward<function_type>(FT), query, _root, user_data);
+		}
+
 		iterator
 		root()
 		{
@@ -330,6 +743,96 @@ namespace cpprelude
 			std::swap(_less_than, other._less_than);
 		}
 
+		//merges the other tree into this one in linear time, if an element exists in both trees this tree's element is kept
+		void
+		merge(const red_black_tree& other)
+		{
+			if(this == &other || other.empty())
+				return;
+
+			if(empty())
+			{
+				_bulk_load(other.begin(), other._count);
+				return;
+			}
+
+			auto ours = _context->template alloc<node_type*>(_count);
+			auto merged = _context->template alloc<node_type*>(_count + other._count);
+			usize ours_count = _flatten(ours.ptr);
+
+			usize i = 0, merged_count = 0;
+			for(auto it = other.begin(); it != other.end(); ++it)
+			{
+				while(i < ours_count && _less_than(ours[i]->data, *it))
+					merged[merged_count++] = ours[i++];
+
+				if(i < ours_count && !_less_than(*it, ours[i]->data))
+					continue;
+
+				merged[merged_count++] = _create_node(*it);
+			}
+			while(i < ours_count)
+				merged[merged_count++] = ours[i++];
+
+			_link_balanced(merged.ptr, merged_count);
+
+			_context->free(ours);
+			_context->free(merged);
+		}
+
+		//merges the other tree into this one in linear time by relinking its nodes, the other tree is left empty
+		void
+		merge(red_black_tree&& other)
+		{
+			if(this == &other || other.empty())
+				return;
+
+			//nodes can't change hands if they are allocated from different contexts
+			if(_context != other._context)
+			{
+				merge(static_cast<const red_black_tree&>(other));
+				other.clear();
+				return;
+			}
+
+			if(empty())
+			{
+				std::swap(_root, other._root);
+				std::swap(_count, other._count);
+				return;
+			}
+
+			auto ours = _context->template alloc<node_type*>(_count);
+			auto theirs = _context->template alloc<node_type*>(other._count);
+			auto merged = _context->template alloc<node_type*>(_count + other._count);
+			usize ours_count = _flatten(ours.ptr);
+			usize theirs_count = other._flatten(theirs.ptr);
+
+			other._root = nullptr;
+			other._count = 0;
+
+			usize i = 0, j = 0, merged_count = 0;
+			while(i < ours_count && j < theirs_count)
+			{
+				if(_less_than(ours[i]->data, theirs[j]->data))
+					merged[merged_count++] = ours[i++];
+				else if(_less_than(theirs[j]->data, ours[i]->data))
+					merged[merged_count++] = theirs[j++];
+				else
+					_free_mem(theirs[j++]);
+			}
+			while(i < ours_count)
+				merged[merged_count++] = ours[i++];
+			while(j < theirs_count)
+				merged[merged_count++] = theirs[j++];
+
+			_link_balanced(merged.ptr, merged_count);
+
+			_context->free(ours);
+			_context->free(theirs);
+			_context->free(merged);
+		}
+
 		iterator
 		min()
 		{
@@ -466,6 +969,7 @@ namespace cpprelude
 				else
 					y->right = z;
 			}
+			_update_augment_path(z);
 			_insert_fixup(z);
 			return z;
 		}
@@ -500,6 +1004,7 @@ namespace cpprelude
 				else
 					y->right = z;
 			}
+			_update_augment_path(z);
 			_insert_fixup(z);
 			return z;
 		}
@@ -507,198 +1012,42 @@ namespace cpprelude
 		void
 		_insert_fixup(node_type* z)
 		{
-			auto is_red = [](node_type* p) { return p != nullptr && p->color == color_type::RED; };
-
-			while (is_red(z->parent))
-			{
-				if (z->parent == z->parent->parent->left)
-				{
-					node_type* y = z->parent->parent->right;
-					if (is_red(y))
-					{ //Casse 1
-						z->parent->color = color_type::BLACK;
-						y->color = color_type::BLACK;
-						z->parent->parent->color = color_type::RED;
-						z = z->parent->parent;
-					}
-					else
-					{
-						if (z == z->parent->right)
-						{ //case 2
-							z = z->parent;
-							_left_rotation(z);
-						}
-						//case 3
-						z->parent->color = color_type::BLACK;
-						z->parent->parent->color = color_type::RED;
-						_right_rotation(z->parent->parent);
-					}
-				}
-				else
-				{// right instead of left
-
-					node_type* y = z->parent->parent->left;
-					if (is_red(y))
-					{ //Casse 1
-						z->parent->color = color_type::BLACK;
-						y->color = color_type::BLACK;
-						z->parent->parent->color = color_type::RED;
-						z = z->parent->parent;
-					}
-					else
-					{
-						if (z == z->parent->left)
-						{ //case 2
-							z = z->parent;
-							_right_rotation(z);
-						}
-						//case 3
-						z->parent->color = color_type::BLACK;
-						z->parent->parent->color = color_type::RED;
-						_left_rotation(z->parent->parent);
-					}
-				}
-			}
-			_root->color = color_type::BLACK;
+			details::red_black_fixup<node_type, AugmentType>::insert_fixup(_root, z);
 		}
 
 		void
 		_rb_delete_fixup(node_type* node, node_type* node_parent)
 		{
-			node_type* w = nullptr;
-			bool is_node_black = true;
-			if (node != nullptr)
-				is_node_black = node->color == color_type::BLACK;
-
-			while (node != _root && is_node_black)
-			{
-				if (node == node_parent->left)
-				{
-					w = node_parent->right;
-					if (w->color == color_type::RED)
-					{	//Case 1
-						w->color = color_type::BLACK;
-						node_parent->color = color_type::RED;
-						_left_rotation(node_parent);
-						w = node_parent->right;
-					}
-					bool is_w_left_black = true;
-					bool is_w_right_black = true;
-					if (w->left != nullptr)
-						is_w_left_black = w->left->color == color_type::BLACK;
-					if (w->right != nullptr)
-						is_w_right_black = w->right->color == color_type::BLACK;
-
-					if (is_w_left_black	&& is_w_right_black)
-					{ //Case 2: black sibling with black childern
-						w->color = color_type::RED;
-						node = node_parent;
-						node_parent = node->parent;
-						is_node_black = node->color == color_type::BLACK;
-					}
-					else
-					{
-						if (is_w_right_black)
-						{	//Case 3
-							w->left->color = color_type::BLACK;
-							w->color = color_type::RED;
-							_right_rotation(w);
-							w = node_parent->right;
-						}
-						//Case 4
-						w->color = node_parent->color;
-						node_parent->color = color_type::BLACK;
-						if (w->right != nullptr)
-							w->right->color = color_type::BLACK;
-						_left_rotation(node_parent);
-						node = _root;
-						node_parent = nullptr;
-					}
-
-				}
-				else
-				{
-					w = node_parent->left;
-					if (w->color == color_type::RED)
-					{	//Case 1
-						w->color = color_type::BLACK;
-						node_parent->color = color_type::RED;
-						_right_rotation(node_parent);
-						w = node_parent->left;
-					}
-
-					bool is_w_left_black = true;
-					bool is_w_right_black = true;
-					if (w->left != nullptr)
-						is_w_left_black = w->left->color == color_type::BLACK;
-					if (w->right != nullptr)
-						is_w_right_black = w->right->color == color_type::BLACK;
-
-					if (is_w_left_black	&& is_w_right_black)
-					{	//Case 2
-						w->color = color_type::RED;
-						node = node_parent;
-						node_parent = node->parent;
-						is_node_black = node->color == color_type::BLACK;
-					}
-					else
-					{
-						if (is_w_left_black)
-						{	//Case 3
-							w->right->color = color_type::BLACK;
-							w->color = color_type::RED;
-							_left_rotation(w);
-							w = node_parent->left;
-						}
-						//Case 4
-						w->color = node_parent->color;
-						node_parent->color = color_type::BLACK;
-						if (w->left != nullptr)// check this
-							w->left->color = color_type::BLACK;
-						_right_rotation(node_parent);
-						node = _root;
-						node_parent = nullptr;
-					}
-				}
-			}
-			if (node != nullptr)
-				node->color = color_type::BLACK;
+			details::red_black_fixup<node_type, AugmentType>::delete_fixup(_root, node, node_parent);
 		}
 
 		void
 		_left_rotation(node_type* x)
 		{
-			node_type* y = x->right;
-			x->right = y->left;
-			if (y->left != nullptr)
-				y->left->parent = x;
-			y->parent = x->parent;
-			if (x->parent == nullptr)
-				_root = y;
-			else if (x == x->parent->left)
-				x->parent->left = y;
-			else
-				x->parent->right = y;
-			y->left = x;
-			x->parent = y;
+			details::red_black_fixup<node_type, AugmentType>::left_rotation(_root, x);
 		}
 
 		void
 		_right_rotation(node_type* x)
 		{
-			node_type* y = x->left;
-			x->left = y->right;
-			if (y->right != nullptr)
-				y->right->parent = x;
-			y->parent = x->parent;
-			if (x->parent == nullptr)
-				_root = y;
-			else if (x == x->parent->right)
-				x->parent->right = y;
-			else
-				x->parent->left = y;
-			y->right = x;
-			x->parent = y;
+			details::red_black_fixup<node_type, AugmentType>::right_rotation(_root, x);
+		}
+
+		void
+		_update_augment(node_type* node)
+		{
+			AugmentType::update(node);
+		}
+
+		//updates the augmented data of the node and all its ancestors
+		void
+		_update_augment_path(node_type* node)
+		{
+			if(std::is_same<AugmentType, details::red_black_tree_no_augment>::value)
+				return;
+
+			for(; node != nullptr; node = node->parent)
+				AugmentType::update(node);
 		}
 
 		node_type*
@@ -723,8 +1072,73 @@ namespace cpprelude
 			if (it == nullptr) return;
 
 			it->data.~data_type();
-			if(_context) _context->free(make_slice(it));
 			--_count;
+
+			if(_context) _context->free(make_slice(it));
+		}
+
+		//fills the given array with the nodes of the tree in order
+		usize
+		_flatten(node_type** nodes)
+		{
+			usize i = 0;
+			for(auto it = begin(); it != end(); ++it)
+				nodes[i++] = const_cast<node_type*>(it.node);
+			return i;
+		}
+
+		template<typename iterator_type>
+		void
+		_bulk_load(iterator_type it, usize count)
+		{
+			if(count == 0)
+				return;
+
+			auto nodes = _context->template alloc<node_type*>(count);
+			usize nodes_count = 0;
+			for(usize i = 0; i < count; ++i, ++it)
+			{
+				if(nodes_count > 0 && !_less_than(nodes[nodes_count - 1]->data, *it))
+					continue;
+				nodes[nodes_count++] = _create_node(*it);
+			}
+
+			_link_balanced(nodes.ptr, nodes_count);
+			_context->free(nodes);
+		}
+
+		//links the given sorted nodes into a perfectly balanced tree, all the nodes are black except the
+		//deepest level which is red so every path has the same count of black nodes
+		void
+		_link_balanced(node_type** nodes, usize count)
+		{
+			_count = count;
+			_root = nullptr;
+			if(count == 0)
+				return;
+
+			usize red_depth = 0;
+			for(usize i = count; i > 1; i >>= 1)
+				++red_depth;
+
+			_root = _build_balanced(nodes, count, nullptr, 0, red_depth);
+			_root->color = color_type::BLACK;
+		}
+
+		node_type*
+		_build_balanced(node_type** nodes, usize count, node_type* parent, usize depth, usize red_depth)
+		{
+			if(count == 0)
+				return nullptr;
+
+			usize mid = count / 2;
+			node_type* node = nodes[mid];
+			node->parent = parent;
+			node->color = depth == red_depth ? color_type::RED : color_type::BLACK;
+			node->left = _build_balanced(nodes, mid, node, depth + 1, red_depth);
+			node->right = _build_balanced(nodes + mid + 1, count - mid - 1, node, depth + 1, red_depth);
+			_update_augment(node);
+			return node;
 		}
 
 		void
@@ -767,6 +1181,15 @@ namespace cpprelude
 			other.preorder_traverse(func, this);
 		}
 
+		void
+		_copy_sorted_content(const red_black_tree& other)
+		{
+			if(other.empty())
+				return;
+
+			_bulk_load(other.begin(), other._count);
+		}
+
 		template<typename function_type, typename user_type>
 		void
 		_inorder_traverse(function_type&& fT, iterator it, user_type* user_data)
@@ -872,20 +1295,123 @@ namespace cpprelude
 		{
 			return _lookup(key, it);
 		}
+
+		node_type*
+		_lower_bound(const data_type& key) const
+		{
+			node_type* result = nullptr;
+			node_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(it->data, key))
+				{
+					it = it->right;
+				}
+				else
+				{
+					result = it;
+					it = it->left;
+				}
+			}
+			return result;
+		}
+
+		node_type*
+		_upper_bound(const data_type& key) const
+		{
+			node_type* result = nullptr;
+			node_type* it = _root;
+			while(it != nullptr)
+			{
+				if(_less_than(key, it->data))
+				{
+					result = it;
+					it = it->left;
+				}
+				else
+				{
+					it = it->right;
+				}
+			}
+			return result;
+		}
+
+		static usize
+		_subtree_size(node_type* it)
+		{
+			return it != nullptr ? it->augment.size : 0;
+		}
+
+		node_type*
+		_select(usize index) const
+		{
+			node_type* it = _root;
+			while(it != nullptr)
+			{
+				usize left_size = _subtree_size(it->left);
+				if(index < left_size)
+				{
+					it = it->left;
+				}
+				else if(index > left_size)
+				{
+					index -= left_size + 1;
+					it = it->right;
+				}
+				else
+				{
+					return it;
+				}
+			}
+			return nullptr;
+		}
+
+		node_type*
+		_lookup_overlap(const data_type& query) const
+		{
+			node_type* it = _root;
+			while(it != nullptr && !it->data.overlaps(query))
+			{
+				//if the left subtree reaches the query then either it has an overlap or nothing does
+				if(it->left != nullptr && !(it->left->augment.max_high < query.low))
+					it = it->left;
+				else
+					it = it->right;
+			}
+			return it;
+		}
+
+		template<typename function_type, typename user_type>
+		void
+		_overlap_traverse(function_type&& fT, const data_type& query, node_type* it, user_type* user_data) const
+		{
+			if(it == nullptr || it->augment.max_high < query.low)
+				return;
+
+			_overlap_traverse(std::forward<function_type>(fT), query, it->left, user_data);
+
+			if(it->data.overlaps(query))
+				fT(const_iterator(it), user_data);
+
+			//all the intervals in the right subtree start after this one
+			if(!(query.high < it->data.low))
+				_overlap_traverse(std::forward<function_type>(fT), query, it->right, user_data);
+		}
 	};
 
 	template<typename KeyType, typename ValueType,
-		typename ComparatorType = default_less_than<details::pair_node<KeyType, ValueType>>>
-	struct red_black_map: public red_black_tree<details::pair_node<KeyType, ValueType>, ComparatorType>
+		typename ComparatorType = default_less_than<details::pair_node<KeyType, ValueType>>,
+		typename AugmentType = details::red_black_tree_no_augment>
+	struct red_black_map: public red_black_tree<details::pair_node<KeyType, ValueType>, ComparatorType, AugmentType>
 	{
 		using key_type = KeyType;
 		using value_type = ValueType;
 		using data_type = details::pair_node<key_type, value_type>;
-		using node_type = details::red_black_tree_node<data_type>;
-		using iterator = red_black_tree_pair_iterator<key_type, value_type>;
-		using const_iterator = red_black_tree_const_pair_iterator<key_type, value_type>;
+		using node_type = details::red_black_tree_node<data_type, AugmentType>;
+		using iterator = red_black_tree_pair_iterator<key_type, value_type, AugmentType>;
+		using const_iterator = red_black_tree_const_pair_iterator<key_type, value_type, AugmentType>;
 		using color_type = typename node_type::color_type;
-		using _implementation = red_black_tree<data_type, ComparatorType>;
+		using _implementation = red_black_tree<data_type, ComparatorType, AugmentType>;
 
 		red_black_map(memory_context* context = platform->global_memory)
 			:_implementation(context)
@@ -901,6 +1427,13 @@ namespace cpprelude
 			:_implementation(list, compare_function, context)
 		{}
 
+		template<typename iterator_type>
+		red_black_map(iterator_type it, usize count,
+			const ComparatorType& compare_function = ComparatorType(),
+			memory_context* context = platform->global_memory)
+			:_implementation(it, count, compare_function, context)
+		{}
+
 		red_black_map(const red_black_map& other)
 			:_implementation(other)
 		{}
@@ -1028,6 +1561,66 @@ namespace cpprelude
 
 		using _implementation::lookup;
 
+		iterator
+		lower_bound(const key_type& key)
+		{
+			return _implementation::lower_bound(data_type(key));
+		}
+
+		const_iterator
+		lower_bound(const key_type& key) const
+		{
+			return _implementation::lower_bound(data_type(key));
+		}
+
+		iterator
+		upper_bound(const key_type& key)
+		{
+			return _implementation::upper_bound(data_type(key));
+		}
+
+		const_iterator
+		upper_bound(const key_type& key) const
+		{
+			return _implementation::upper_bound(data_type(key));
+		}
+
+		iterator_range<iterator>
+		equal_range(const key_type& key)
+		{
+			return iterator_range<iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		iterator_range<const_iterator>
+		equal_range(const key_type& key) const
+		{
+			return iterator_range<const_iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		usize
+		rank(const key_type& key) const
+		{
+			return _implementation::rank(data_type(key));
+		}
+
+		iterator
+		select(usize index)
+		{
+			return _implementation::select(index);
+		}
+
+		const_iterator
+		select(usize index) const
+		{
+			return _implementation::select(index);
+		}
+
+		usize
+		count_range(const key_type& low, const key_type& high) const
+		{
+			return _implementation::count_range(data_type(low), data_type(high));
+		}
+
 		iterator
 		begin()
 		{
@@ -1072,4 +1665,15 @@ namespace cpprelude
 	template<typename KeyType, typename ValueType,
 		typename ComparatorType = default_less_than<details::pair_node<KeyType, ValueType>>>
 	using tree_map = red_black_map<KeyType, ValueType, ComparatorType>;
+
+	template<typename T,
+			 typename ComparatorType = default_less_than<T>>
+	using rank_tree_set = red_black_tree<T, ComparatorType, red_black_tree_size_augment>;
+
+	template<typename KeyType, typename ValueType,
+		typename ComparatorType = default_less_than<details::pair_node<KeyType, ValueType>>>
+	using rank_tree_map = red_black_map<KeyType, ValueType, ComparatorType, red_black_tree_size_augment>;
+
+	template<typename T>
+	using interval_tree = red_black_tree<interval<T>, default_less_than<interval<T>>, red_black_tree_interval_augment<T>>;
 }
@@ -0,0 +1,616 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/iterator.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include <initializer_list>
+#include <new>
+
+namespace cpprelude
+{
+	namespace details
+	{
+		//a node spans whole cache lines, at least 4 of them and enough to hold 4 elements
+		constexpr usize
+		unrolled_list_default_capacity(usize element_size)
+		{
+			usize lines = (sizeof(unrolled_node_base) + 4 * element_size + 63) / 64;
+			if(lines < 4)
+				lines = 4;
+			return (lines * 64 - sizeof(unrolled_node_base)) / element_size;
+		}
+	}
+
+	/*
+	 * a doubly linked list that stores several elements per node
+	 * nodes are linked in a circle through the sentinel which lives inside the list itself
+	 * every node has at least one element, empty nodes are freed right away except for one spare node
+	 * which is kept around so a queue that keeps draining and filling the same node doesn't hit the allocator
+	 */
+	template<typename T,
+			 usize node_capacity = details::unrolled_list_default_capacity(sizeof(T))>
+	struct unrolled_list
+	{
+		static_assert(node_capacity >= 2, "unrolled_list node capacity should be at least 2");
+
+		using iterator = unrolled_list_iterator<T, node_capacity>;
+		using const_iterator = const_unrolled_list_iterator<T, node_capacity>;
+		using data_type = T;
+		using node_type = details::unrolled_node<T, node_capacity>;
+		using base_type = details::unrolled_node_base;
+
+		base_type _sentinel;
+		base_type* _spare;
+		usize _count;
+		memory_context *_context = platform->global_memory;
+
+		unrolled_list(memory_context* context = platform->global_memory)
+			:_spare(nullptr), _count(0), _context(context)
+		{}
+
+		unrolled_list(std::initializer_list<T> list, memory_context* context = platform->global_memory)
+			:_spare(nullptr), _count(0), _context(context)
+		{
+			for(const auto& value: list)
+				insert_back(value);
+		}
+
+		unrolled_list(usize count, const T& fill_value, memory_context* context = platform->global_memory)
+			:_spare(nullptr), _count(0), _context(context)
+		{
+			expand_back(count, fill_value);
+		}
+
+		unrolled_list(const unrolled_list& other)
+			:_spare(nullptr), _count(0), _context(other._context)
+		{
+			for(const auto& value: other)
+				insert_back(value);
+		}
+
+		unrolled_list(const unrolled_list& other, memory_context* context)
+			:_spare(nullptr), _count(0), _context(context)
+		{
+			for(const auto& value: other)
+				insert_back(value);
+		}
+
+		unrolled_list(unrolled_list&& other)
+			:_spare(nullptr), _count(0), _context(other._context)
+		{
+			_steal(other);
+		}
+
+		unrolled_list(unrolled_list&& other, memory_context* context)
+			:_spare(nullptr), _count(0), _context(context)
+		{
+			_steal(other);
+		}
+
+		~unrolled_list()
+		{
+			reset();
+		}
+
+		unrolled_list&
+		operator=(const unrolled_list& other)
+		{
+			if(this == &other)
+				return *this;
+
+			reset();
+			_context = other._context;
+			for(const auto& value: other)
+				insert_back(value);
+
+			return *this;
+		}
+
+		unrolled_list&
+		operator=(unrolled_list&& other)
+		{
+			if(this == &other)
+				return *this;
+
+			reset();
+			_context = other._context;
+			_steal(other);
+
+			return *this;
+		}
+
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		void
+		expand_front(usize additional_count, const T& fill_value)
+		{
+			for(usize i = 0; i < additional_count; ++i)
+				insert_front(fill_value);
+		}
+
+		void
+		expand_back(usize additional_count, const T& fill_value)
+		{
+			for(usize i = 0; i < additional_count; ++i)
+				insert_back(fill_value);
+		}
+
+		void
+		shrink_front(usize shrinkage_count)
+		{
+			remove_front(shrinkage_count);
+		}
+
+		void
+		shrink_back(usize shrinkage_count)
+		{
+			remove_back(shrinkage_count);
+		}
+
+		//walks node by node from the nearest end
+		T&
+		operator[](usize index)
+		{
+			return const_cast<T&>(static_cast<const unrolled_list&>(*this)[index]);
+		}
+
+		const T&
+		operator[](usize index) const
+		{
+			if(index < _count / 2)
+			{
+				const base_type* it = _sentinel.next;
+				while(index >= it->count())
+				{
+					index -= it->count();
+					it = it->next;
+				}
+				return _data(it)[it->first + index];
+			}
+			else
+			{
+				index = _count - 1 - index;
+				const base_type* it = _sentinel.prev;
+				while(index >= it->count())
+				{
+					index -= it->count();
+					it = it->prev;
+				}
+				return _data(it)[it->last - 1 - index];
+			}
+		}
+
+		void
+		insert_front(std::initializer_list<T> list)
+		{
+			auto it = list.end();
+			for(usize i = 0; i < list.size(); ++i)
+				insert_front(*--it);
+		}
+
+		template<typename ... TArgs>
+		void
+		emplace_front(TArgs&& ... args)
+		{
+			base_type* head = _sentinel.next;
+			//new front nodes are filled from their end so a run of front inserts packs them fully
+			if(head == &_sentinel || head->first == 0)
+				head = _create_node(&_sentinel, node_capacity);
+
+			new (_data(head) + head->first - 1) T(std::forward<TArgs>(args)...);
+			--head->first;
+			++_count;
+		}
+
+		void
+		insert_front(const T& value)
+		{
+			emplace_front(value);
+		}
+
+		void
+		insert_front(T&& value)
+		{
+			emplace_front(std::move(value));
+		}
+
+		void
+		insert_back(std::initializer_list<T> list)
+		{
+			for(const auto& value: list)
+				insert_back(value);
+		}
+
+		template<typename ... TArgs>
+		void
+		emplace_back(TArgs&& ... args)
+		{
+			base_type* tail = _sentinel.prev;
+			if(tail == &_sentinel || tail->last == node_capacity)
+				tail = _create_node(_sentinel.prev, 0);
+
+			new (_data(tail) + tail->last) T(std::forward<TArgs>(args)...);
+			++tail->last;
+			++_count;
+		}
+
+		void
+		insert_back(const T& value)
+		{
+			emplace_back(value);
+		}
+
+		void
+		insert_back(T&& value)
+		{
+			emplace_back(std::move(value));
+		}
+
+		template<typename ... TArgs>
+		void
+		emplace_after(const iterator& it, TArgs&& ... args)
+		{
+			_emplace_at(it._node, it._index + 1, std::forward<TArgs>(args)...);
+		}
+
+		void
+		insert_after(const iterator& it, const T& value)
+		{
+			_emplace_at(it._node, it._index + 1, value);
+		}
+
+		void
+		insert_after(const iterator& it, T&& value)
+		{
+			_emplace_at(it._node, it._index + 1, std::move(value));
+		}
+
+		template<typename ... TArgs>
+		void
+		emplace_before(const iterator& it, TArgs&& ... args)
+		{
+			if(it._node == &_sentinel)
+				emplace_back(std::forward<TArgs>(args)...);
+			else
+				_emplace_at(it._node, it._index, std::forward<TArgs>(args)...);
+		}
+
+		void
+		insert_before(const iterator& it, const T& value)
+		{
+			emplace_before(it, value);
+		}
+
+		void
+		insert_before(const iterator& it, T&& value)
+		{
+			emplace_before(it, std::move(value));
+		}
+
+		void
+		remove_front(usize removal_count = 1)
+		{
+			while(removal_count--)
+			{
+				base_type* head = _sentinel.next;
+				_data(head)[head->first].~T();
+				++head->first;
+				--_count;
+
+				if(head->count() == 0)
+					_free_node(head);
+			}
+		}
+
+		void
+		remove_back(usize removal_count = 1)
+		{
+			while(removal_count--)
+			{
+				base_type* tail = _sentinel.prev;
+				--tail->last;
+				_data(tail)[tail->last].~T();
+				--_count;
+
+				if(tail->count() == 0)
+					_free_node(tail);
+			}
+		}
+
+		void
+		remove(iterator it)
+		{
+			base_type* node = it._node;
+			T* data = _data(node);
+			data[it._index].~T();
+			--_count;
+
+			//close the hole by shifting the shorter side of the node
+			if(it._index - node->first < node->last - it._index - 1)
+			{
+				for(usize i = it._index; i > node->first; --i)
+					_relocate(data + i, data + i - 1);
+				++node->first;
+			}
+			else
+			{
+				for(usize i = it._index + 1; i < node->last; ++i)
+					_relocate(data + i - 1, data + i);
+				--node->last;
+			}
+
+			if(node->count() == 0)
+				_free_node(node);
+			else
+				_merge_sparse(node);
+		}
+
+		void
+		reset()
+		{
+			base_type* it = _sentinel.next;
+			while(it != &_sentinel)
+			{
+				base_type* next_node = it->next;
+				T* data = _data(it);
+				for(usize i = it->first; i < it->last; ++i)
+					data[i].~T();
+				_context->free(make_slice(static_cast<node_type*>(it)));
+				it = next_node;
+			}
+			_sentinel.next = _sentinel.prev = &_sentinel;
+			_count = 0;
+
+			if(_spare)
+			{
+				_context->free(make_slice(static_cast<node_type*>(_spare)));
+				_spare = nullptr;
+			}
+		}
+
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		const_iterator
+		front() const
+		{
+			return const_iterator(_sentinel.next, _sentinel.next->first);
+		}
+
+		iterator
+		front()
+		{
+			return iterator(_sentinel.next, _sentinel.next->first);
+		}
+
+		const_iterator
+		back() const
+		{
+			return const_iterator(_sentinel.prev, _sentinel.prev->last - 1);
+		}
+
+		iterator
+		back()
+		{
+			return iterator(_sentinel.prev, _sentinel.prev->last - 1);
+		}
+
+		const_iterator
+		cbegin() const
+		{
+			return front();
+		}
+
+		const_iterator
+		begin() const
+		{
+			return front();
+		}
+
+		iterator
+		begin()
+		{
+			return front();
+		}
+
+		const_iterator
+		cend() const
+		{
+			return const_iterator(&_sentinel, 0);
+		}
+
+		const_iterator
+		end() const
+		{
+			return const_iterator(&_sentinel, 0);
+		}
+
+		iterator
+		end()
+		{
+			return iterator(&_sentinel, 0);
+		}
+
+		//hands the chain of nodes to the caller, the first node's prev and the last node's next are null
+		slice<node_type>
+		decay()
+		{
+			if(_count == 0)
+				return slice<node_type>();
+
+			_sentinel.next->prev = nullptr;
+			_sentinel.prev->next = nullptr;
+			slice<node_type> result = make_slice(static_cast<node_type*>(_sentinel.next));
+
+			_sentinel.next = _sentinel.prev = &_sentinel;
+			_count = 0;
+			return result;
+		}
+
+		slice<T>
+		decay_continuous()
+		{
+			//allocate the memory of supplied allocator
+			auto result = _context->template alloc<T>(_count);
+
+			//move the elements over
+			usize i = 0;
+			for(auto&& value: *this)
+				new (&result[i++]) T(std::move(value));
+
+			//reset this list
+			reset();
+
+			//return the piece of memory
+			return result;
+		}
+
+		static T*
+		_data(base_type* node)
+		{
+			return static_cast<node_type*>(node)->data();
+		}
+
+		static const T*
+		_data(const base_type* node)
+		{
+			return static_cast<const node_type*>(node)->data();
+		}
+
+		static void
+		_relocate(T* dst, T* src)
+		{
+			new (dst) T(std::move(*src));
+			src->~T();
+		}
+
+		//creates an empty node after the given node with its elements starting at index
+		base_type*
+		_create_node(base_type* after, usize index)
+		{
+			base_type* node = _spare;
+			_spare = nullptr;
+			if(node == nullptr)
+				node = new (_context->template alloc<node_type>().ptr) node_type;
+
+			node->first = node->last = index;
+			node->prev = after;
+			node->next = after->next;
+			after->next->prev = node;
+			after->next = node;
+			return node;
+		}
+
+		//unlinks an empty node and keeps it as the spare if there's none
+		void
+		_free_node(base_type* node)
+		{
+			node->prev->next = node->next;
+			node->next->prev = node->prev;
+
+			if(_spare == nullptr)
+				_spare = node;
+			else
+				_context->free(make_slice(static_cast<node_type*>(node)));
+		}
+
+		//inserts before the index inside the node, index could be node->last to append to the node
+		template<typename ... TArgs>
+		void
+		_emplace_at(base_type* node, usize index, TArgs&& ... args)
+		{
+			if(node->count() == node_capacity)
+			{
+				//split the full node and move its upper half to a new node
+				usize mid = node->first + node->count() / 2;
+				base_type* right = _create_node(node, 0);
+				T* src = _data(node);
+				T* dst = _data(right);
+				for(usize i = mid; i < node->last; ++i)
+					_relocate(dst + right->last++, src + i);
+				node->last = mid;
+
+				if(index > mid)
+				{
+					index -= mid;
+					node = right;
+				}
+			}
+
+			T* data = _data(node);
+			if(node->last < node_capacity)
+			{
+				for(usize i = node->last; i > index; --i)
+					_relocate(data + i, data + i - 1);
+				++node->last;
+			}
+			else
+			{
+				for(usize i = node->first; i < index; ++i)
+					_relocate(data + i - 1, data + i);
+				--node->first;
+				--index;
+			}
+
+			new (data + index) T(std::forward<TArgs>(args)...);
+			++_count;
+		}
+
+		//merges a node that became sparse by removals in the middle with a neighbour it fits with
+		void
+		_merge_sparse(base_type* node)
+		{
+			if(node->count() > node_capacity / 4)
+				return;
+
+			base_type *left = node, *right = node->next;
+			if(right == &_sentinel || left->count() + right->count() > node_capacity)
+			{
+				left = node->prev;
+				right = node;
+				if(left == &_sentinel || left->count() + right->count() > node_capacity)
+					return;
+			}
+
+			T* left_data = _data(left);
+			if(left->last + right->count() > node_capacity)
+			{
+				for(usize i = left->first; i < left->last; ++i)
+					_relocate(left_data + i - left->first, left_data + i);
+				left->last -= left->first;
+				left->first = 0;
+			}
+
+			T* right_data = _data(right);
+			for(usize i = right->first; i < right->last; ++i)
+				_relocate(left_data + left->last++, right_data + i);
+			right->first = right->last = 0;
+			_free_node(right);
+		}
+
+		//takes the nodes of the other list and leaves it empty
+		void
+		_steal(unrolled_list& other)
+		{
+			if(other._count > 0)
+			{
+				_sentinel.next = other._sentinel.next;
+				_sentinel.prev = other._sentinel.prev;
+				_sentinel.next->prev = &_sentinel;
+				_sentinel.prev->next = &_sentinel;
+				other._sentinel.next = other._sentinel.prev = &other._sentinel;
+			}
+			_count = other._count;
+			other._count = 0;
+		}
+	};
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/memory.h"
+#include "cpprelude/memory_context.h"
+#include "cpprelude/platform.h"
+#include "cpprelude/epoch.h"
+#include "cpprelude/ring_buffer.h"
+
+#include <atomic>
+#include <type_traits>
+#include <new>
+
+namespace cpprelude
+{
+	/*
+	 * chase-lev work stealing deque
+	 * the owner thread pushes and pops at the bottom without locking, other threads steal from the top
+	 * the only contended operation is taking the last element or stealing which is a single compare exchange on the top
+	 * the buffer grows by doubling and the old buffers are retired to an epoch domain since thieves might still read them
+	 * elements are read before the thief knows it won them so they are kept in atomics which means T must be trivially copyable
+	 * like a task pointer or an index
+	 */
+	template<typename T>
+	struct work_stealing_deque
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "work_stealing_deque elements must be trivially copyable");
+
+		using data_type = T;
+
+		constexpr static usize cache_line_size = 64;
+
+		struct alignas(std::atomic<T>) _buffer_type
+		{
+			epoch_retired retired;
+			usize mask;
+
+			std::atomic<T>*
+			data()
+			{
+				return reinterpret_cast<std::atomic<T>*>(this + 1);
+			}
+
+			T
+			get(isize index)
+			{
+				return data()[usize(index) & mask].load(std::memory_order_relaxed);
+			}
+
+			void
+			put(isize index, const T& value)
+			{
+				data()[usize(index) & mask].store(value, std::memory_order_relaxed);
+			}
+		};
+
+		struct _index_type
+		{
+			std::atomic<isize> value;
+			ubyte _padding[cache_line_size - sizeof(std::atomic<isize>)];
+		};
+
+		//the top is written by the thieves and the bottom only by the owner so they live in separate cache lines
+		_index_type _top;
+		_index_type _bottom;
+		std::atomic<_buffer_type*> _buffer;
+		memory_context* _context;
+		epoch_domain _epoch;
+
+		work_stealing_deque(usize capacity = 64, memory_context* context = platform->global_memory)
+			:_context(context), _epoch(_free_retired, this)
+		{
+			_top.value.store(0, std::memory_order_relaxed);
+			_bottom.value.store(0, std::memory_order_relaxed);
+			_buffer.store(_alloc_buffer(details::ring_buffer_capacity(capacity)), std::memory_order_relaxed);
+		}
+
+		work_stealing_deque(const work_stealing_deque&) = delete;
+
+		work_stealing_deque&
+		operator=(const work_stealing_deque&) = delete;
+
+		~work_stealing_deque()
+		{
+			_epoch.flush();
+			_free_buffer(_buffer.load(std::memory_order_relaxed));
+		}
+
+		//owner only, pushes the value to the bottom of the deque growing it if it's full
+		void
+		push(const T& value)
+		{
+			isize bottom = _bottom.value.load(std::memory_order_relaxed);
+			isize top = _top.value.load(std::memory_order_acquire);
+			_buffer_type* buffer = _buffer.load(std::memory_order_relaxed);
+			if(bottom - top > isize(buffer->mask))
+				buffer = _grow(buffer, top, bottom);
+
+			buffer->put(bottom, value);
+			std::atomic_thread_fence(std::memory_order_release);
+			_bottom.value.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		//owner only, pops the newest value from the bottom of the deque
+		//returns false if the deque is empty or a thief took the last value
+		bool
+		pop(T& value)
+		{
+			isize bottom = _bottom.value.load(std::memory_order_relaxed) - 1;
+			_buffer_type* buffer = _buffer.load(std::memory_order_relaxed);
+			_bottom.value.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			isize top = _top.value.load(std::memory_order_relaxed);
+
+			if(top > bottom)
+			{
+				_bottom.value.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			value = buffer->get(bottom);
+			if(top < bottom)
+				return true;
+
+			//this is the last value so race the thieves for it
+			bool won = _top.value.compare_exchange_strong(top, top + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed);
+			_bottom.value.store(bottom + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		//any thread, steals the oldest value from the top of the deque
+		//returns false if the deque is empty or another thread won the value
+		bool
+		steal(T& value)
+		{
+			epoch_guard guard(_epoch);
+
+			isize top = _top.value.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			isize bottom = _bottom.value.load(std::memory_order_acquire);
+			if(top >= bottom)
+				return false;
+
+			_buffer_type* buffer = _buffer.load(std::memory_order_acquire);
+			T result = buffer->get(top);
+			if(!_top.value.compare_exchange_strong(top, top + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed))
+				return false;
+
+			value = result;
+			return true;
+		}
+
+		//the count could be stale by the time it's returned if other threads are active
+		usize
+		count() const
+		{
+			isize bottom = _bottom.value.load(std::memory_order_acquire);
+			isize top = _top.value.load(std::memory_order_acquire);
+			return bottom > top ? usize(bottom - top) : 0;
+		}
+
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		usize
+		capacity() const
+		{
+			return _buffer.load(std::memory_order_acquire)->mask + 1;
+		}
+
+		_buffer_type*
+		_alloc_buffer(usize capacity)
+		{
+			slice<ubyte> memory = _context->template alloc<ubyte>(sizeof(_buffer_type) + capacity * sizeof(std::atomic<T>));
+			_buffer_type* buffer = new (memory.ptr) _buffer_type();
+			buffer->mask = capacity - 1;
+			for(usize i = 0; i < capacity; ++i)
+				new (buffer->data() + i) std::atomic<T>();
+			return buffer;
+		}
+
+		void
+		_free_buffer(_buffer_type* buffer)
+		{
+			usize size = sizeof(_buffer_type) + (buffer->mask + 1) * sizeof(std::atomic<T>);
+			_context->free(make_slice(reinterpret_cast<ubyte*>(buffer), size));
+		}
+
+		_buffer_type*
+		_grow(_buffer_type* buffer, isize top, isize bottom)
+		{
+			_buffer_type* new_buffer = _alloc_buffer((buffer->mask + 1) * 2);
+			for(isize i = top; i < bottom; ++i)
+				new_buffer->put(i, buffer->get(i));
+			_buffer.store(new_buffer, std::memory_order_release);
+
+			//thieves could still be reading the old buffer so it's freed once they are all done
+			epoch_guard guard(_epoch);
+			_epoch.retire(&buffer->retired);
+			return new_buffer;
+		}
+
+		static void
+		_free_retired(void* self, epoch_retired* retired)
+		{
+			auto deque = reinterpret_cast<work_stealing_deque*>(self);
+			deque->_free_buffer(reinterpret_cast<_buffer_type*>(retired));
+		}
+	};
+}
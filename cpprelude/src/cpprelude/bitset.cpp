@@ -0,0 +1,414 @@
+#include "cpprelude/bitset.h"
+
+#include <cstring>
+
+namespace cpprelude
+{
+	dynamic_bitset::dynamic_bitset(memory_context* context)
+		:_count(0), _context(context)
+	{}
+
+	dynamic_bitset::dynamic_bitset(usize count, bool value, memory_context* context)
+		:_count(0), _context(context)
+	{
+		resize(count, value);
+	}
+
+	dynamic_bitset::dynamic_bitset(const dynamic_bitset& other)
+		:dynamic_bitset(other, other._context)
+	{}
+
+	dynamic_bitset::dynamic_bitset(const dynamic_bitset& other, memory_context* context)
+		:_count(other._count), _context(context)
+	{
+		if(other._words.valid())
+		{
+			_words = _context->template alloc<u64>(other._words.count());
+			std::memcpy(_words.ptr, other._words.ptr, _words.size);
+		}
+	}
+
+	dynamic_bitset::dynamic_bitset(dynamic_bitset&& other)
+		:_words(std::move(other._words)), _count(other._count), _context(other._context)
+	{
+		other._count = 0;
+	}
+
+	dynamic_bitset&
+	dynamic_bitset::operator=(const dynamic_bitset& other)
+	{
+		if(this == &other)
+			return *this;
+
+		if(_words.count() < other.words_count())
+		{
+			if(_words.valid())
+				_context->free(_words);
+			_words = _context->template alloc<u64>(other._words.count());
+		}
+
+		usize copied = other.words_count();
+		if(copied > 0)
+			std::memcpy(_words.ptr, other._words.ptr, copied * sizeof(u64));
+		for(usize i = copied; i < _words.count(); ++i)
+			_words[i] = 0;
+		_count = other._count;
+		return *this;
+	}
+
+	dynamic_bitset&
+	dynamic_bitset::operator=(dynamic_bitset&& other)
+	{
+		if(_words.valid())
+			_context->free(_words);
+
+		_words = std::move(other._words);
+		_count = other._count;
+		_context = other._context;
+		other._count = 0;
+		return *this;
+	}
+
+	dynamic_bitset::~dynamic_bitset()
+	{
+		if(_words.valid())
+			_context->free(_words);
+		_count = 0;
+	}
+
+	void
+	dynamic_bitset::set_all()
+	{
+		usize words = words_count();
+		for(usize i = 0; i < words; ++i)
+			_words[i] = ~u64(0);
+		_clear_tail();
+	}
+
+	void
+	dynamic_bitset::reset_all()
+	{
+		usize words = words_count();
+		for(usize i = 0; i < words; ++i)
+			_words[i] = 0;
+	}
+
+	void
+	dynamic_bitset::flip_all()
+	{
+		usize words = words_count();
+		for(usize i = 0; i < words; ++i)
+			_words[i] = ~_words[i];
+		_clear_tail();
+	}
+
+	usize
+	dynamic_bitset::popcount() const
+	{
+		return details::popcount_words(_words.ptr, words_count());
+	}
+
+	bool
+	dynamic_bitset::any() const
+	{
+		usize words = words_count();
+		for(usize i = 0; i < words; ++i)
+			if(_words[i])
+				return true;
+		return false;
+	}
+
+	bool
+	dynamic_bitset::none() const
+	{
+		return !any();
+	}
+
+	bool
+	dynamic_bitset::all() const
+	{
+		usize full_words = _count / word_bits;
+		for(usize i = 0; i < full_words; ++i)
+			if(_words[i] != ~u64(0))
+				return false;
+
+		usize rest = _count % word_bits;
+		return rest == 0 || _words[full_words] == (u64(1) << rest) - 1;
+	}
+
+	usize
+	dynamic_bitset::find_first() const
+	{
+		usize words = words_count();
+		for(usize i = 0; i < words; ++i)
+			if(_words[i])
+				return i * word_bits + details::lowest_set_bit(_words[i]);
+		return _count;
+	}
+
+	usize
+	dynamic_bitset::find_next(usize index) const
+	{
+		++index;
+		if(index >= _count)
+			return _count;
+
+		usize i = index / word_bits;
+		u64 word = _words[i] & (~u64(0) << (index % word_bits));
+		usize words = words_count();
+		while(word == 0)
+		{
+			if(++i == words)
+				return _count;
+			word = _words[i];
+		}
+		return i * word_bits + details::lowest_set_bit(word);
+	}
+
+	dynamic_bitset&
+	dynamic_bitset::operator&=(const dynamic_bitset& other)
+	{
+		usize words = words_count();
+		usize shared = other.words_count() < words ? other.words_count() : words;
+		for(usize i = 0; i < shared; ++i)
+			_words[i] &= other._words[i];
+		for(usize i = shared; i < words; ++i)
+			_words[i] = 0;
+		return *this;
+	}
+
+	dynamic_bitset&
+	dynamic_bitset::operator|=(const dynamic_bitset& other)
+	{
+		usize shared = other.words_count() < words_count() ? other.words_count() : words_count();
+		for(usize i = 0; i < shared; ++i)
+			_words[i] |= other._words[i];
+		_clear_tail();
+		return *this;
+	}
+
+	dynamic_bitset&
+	dynamic_bitset::operator^=(const dynamic_bitset& other)
+	{
+		usize shared = other.words_count() < words_count() ? other.words_count() : words_count();
+		for(usize i = 0; i < shared; ++i)
+			_words[i] ^= other._words[i];
+		_clear_tail();
+		return *this;
+	}
+
+	dynamic_bitset&
+	dynamic_bitset::and_not(const dynamic_bitset& other)
+	{
+		usize shared = other.words_count() < words_count() ? other.words_count() : words_count();
+		for(usize i = 0; i < shared; ++i)
+			_words[i] &= ~other._words[i];
+		return *this;
+	}
+
+	bool
+	dynamic_bitset::operator==(const dynamic_bitset& other) const
+	{
+		if(_count != other._count)
+			return false;
+
+		usize words = words_count();
+		return words == 0 || std::memcmp(_words.ptr, other._words.ptr, words * sizeof(u64)) == 0;
+	}
+
+	bool
+	dynamic_bitset::operator!=(const dynamic_bitset& other) const
+	{
+		return !operator==(other);
+	}
+
+	void
+	dynamic_bitset::insert_back(bool value)
+	{
+		if(_count == capacity())
+			_grow(_words.count() ? _words.count() * 2 : 1);
+
+		//the bit is already zero since it's past the count
+		if(value)
+			set(_count);
+		++_count;
+	}
+
+	void
+	dynamic_bitset::remove_back()
+	{
+		--_count;
+		reset(_count);
+	}
+
+	void
+	dynamic_bitset::resize(usize count, bool value)
+	{
+		usize words = (count + word_bits - 1) / word_bits;
+		if(words > _words.count())
+			_grow(words > _words.count() * 2 ? words : _words.count() * 2);
+
+		if(count > _count)
+		{
+			if(value)
+			{
+				usize i = _count / word_bits;
+				if(_count % word_bits)
+					_words[i++] |= ~u64(0) << (_count % word_bits);
+				for(; i < words; ++i)
+					_words[i] = ~u64(0);
+			}
+		}
+		else
+		{
+			//zero the dropped bits to keep everything past the count zero
+			usize old_words = words_count();
+			for(usize i = words; i < old_words; ++i)
+				_words[i] = 0;
+		}
+
+		_count = count;
+		_clear_tail();
+	}
+
+	void
+	dynamic_bitset::reserve(usize count)
+	{
+		usize words = (count + word_bits - 1) / word_bits;
+		if(words > _words.count())
+			_grow(words);
+	}
+
+	void
+	dynamic_bitset::clear()
+	{
+		reset_all();
+		_count = 0;
+	}
+
+	void
+	dynamic_bitset::shrink_to_fit()
+	{
+		usize words = words_count();
+		if(words == _words.count())
+			return;
+
+		if(words == 0)
+		{
+			_context->free(_words);
+			return;
+		}
+		_context->template realloc<u64>(_words, words);
+	}
+
+	void
+	dynamic_bitset::_grow(usize words_count)
+	{
+		usize old_count = _words.count();
+		if(_words.valid())
+			_context->template realloc<u64>(_words, words_count);
+		else
+			_words = _context->template alloc<u64>(words_count);
+
+		for(usize i = old_count; i < words_count; ++i)
+			_words[i] = 0;
+	}
+
+	void
+	dynamic_bitset::_clear_tail()
+	{
+		usize rest = _count % word_bits;
+		if(rest)
+			_words[_count / word_bits] &= (u64(1) << rest) - 1;
+	}
+
+
+	bitset_rank_index::bitset_rank_index(memory_context* context)
+		:_bitset(nullptr), _block_ranks(context), _select_samples(context)
+	{}
+
+	bitset_rank_index::bitset_rank_index(const dynamic_bitset& bitset, memory_context* context)
+		:_bitset(nullptr), _block_ranks(context), _select_samples(context)
+	{
+		build(bitset);
+	}
+
+	void
+	bitset_rank_index::build(const dynamic_bitset& bitset)
+	{
+		_bitset = &bitset;
+		_block_ranks.clear();
+		_select_samples.clear();
+
+		usize words = bitset.words_count();
+		usize blocks = (words + block_words - 1) / block_words;
+		_block_ranks.reserve(blocks + 1);
+
+		u64 total = 0;
+		for(usize block = 0; block < blocks; ++block)
+		{
+			_block_ranks.insert_back(total);
+
+			usize start = block * block_words;
+			usize end = start + block_words < words ? start + block_words : words;
+			u64 block_end = total + details::popcount_words(bitset.words() + start, end - start);
+
+			//sample the block of every set bit whose rank is a multiple of the sample rate
+			for(u64 sample = _select_samples.count() * select_sample; sample < block_end; sample += select_sample)
+				_select_samples.insert_back(block);
+			total = block_end;
+		}
+		_block_ranks.insert_back(total);
+	}
+
+	usize
+	bitset_rank_index::rank(usize index) const
+	{
+		const u64* words = _bitset->words();
+		usize block = index / block_bits;
+		usize word = index / dynamic_bitset::word_bits;
+
+		usize result = usize(_block_ranks[block]);
+		result += details::popcount_words(words + block * block_words, word - block * block_words);
+
+		usize rest = index % dynamic_bitset::word_bits;
+		if(rest)
+			result += details::popcount(words[word] & ((u64(1) << rest) - 1));
+		return result;
+	}
+
+	usize
+	bitset_rank_index::select(usize rank) const
+	{
+		//the block holding the rank lies between the samples around it
+		usize sample = rank / select_sample;
+		usize low = usize(_select_samples[sample]);
+		usize high = sample + 1 < _select_samples.count() ? usize(_select_samples[sample + 1]) : _block_ranks.count() - 2;
+
+		//the last block that starts at or before the rank
+		while(low < high)
+		{
+			usize mid = low + (high - low + 1) / 2;
+			if(_block_ranks[mid] <= rank)
+				low = mid;
+			else
+				high = mid - 1;
+		}
+
+		const u64* words = _bitset->words();
+		usize rest = rank - usize(_block_ranks[low]);
+		for(usize word = low * block_words; ; ++word)
+		{
+			usize word_count = details::popcount(words[word]);
+			if(rest < word_count)
+				return word * dynamic_bitset::word_bits + details::select_bit(words[word], rest);
+			rest -= word_count;
+		}
+	}
+
+	usize
+	bitset_rank_index::popcount() const
+	{
+		return usize(_block_ranks[_block_ranks.count() - 1]);
+	}
+}
@@ -0,0 +1,305 @@
+#include "cpprelude/delta_array.h"
+#include "cpprelude/bits.h"
+
+namespace cpprelude
+{
+	//section(packing helpers)
+	inline static void
+	_delta_pack(const u64* deltas, usize bits, u64* words)
+	{
+		if(bits == 0)
+			return;
+
+		usize position = 0;
+		for(usize i = 0; i < delta_array::block_size; ++i, position += bits)
+		{
+			usize word = position >> 6, shift = position & 63;
+			words[word] |= deltas[i] << shift;
+			if(shift + bits > 64)
+				words[word + 1] |= deltas[i] >> (64 - shift);
+		}
+	}
+
+	//unpacks the first count deltas and sums them up starting from the first value
+	inline static void
+	_delta_unpack(const u64* words, usize bits, u64 first, u64* values, usize count)
+	{
+		if(bits == 0)
+		{
+			for(usize i = 0; i < count; ++i)
+				values[i] = first;
+			return;
+		}
+
+		u64 mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+		u64 value = first;
+		usize position = 0;
+		for(usize i = 0; i < count; ++i, position += bits)
+		{
+			usize word = position >> 6, shift = position & 63;
+			u64 delta = words[word] >> shift;
+			if(shift + bits > 64)
+				delta |= words[word + 1] << (64 - shift);
+			value += delta & mask;
+			values[i] = value;
+		}
+	}
+
+	//index of the first value in the block which isn't less than the value or count
+	inline static usize
+	_delta_block_lower_bound(const u64* values, usize count, u64 value)
+	{
+		usize low = 0, high = count;
+		while(low < high)
+		{
+			usize mid = low + (high - low) / 2;
+			if(values[mid] < value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low;
+	}
+
+
+	//section(delta_array)
+	delta_array::delta_array(memory_context* context)
+		:_words(context), _firsts(context), _offsets(context), _tail(context), _count(0)
+	{}
+
+	bool
+	delta_array::append(u64 value)
+	{
+		if(_count > 0 && value < back())
+			return false;
+
+		_tail.insert_back(value);
+		++_count;
+		if(_tail.count() == block_size)
+			_pack_tail();
+		return true;
+	}
+
+	usize
+	delta_array::append(const slice<u64>& values)
+	{
+		usize count = values.count();
+		for(usize i = 0; i < count; ++i)
+			if(!append(values[i]))
+				return i;
+		return count;
+	}
+
+	u64
+	delta_array::operator[](usize index) const
+	{
+		u64 values[block_size];
+		usize position = index % block_size;
+		_decode_block(index / block_size, values, position + 1);
+		return values[position];
+	}
+
+	u64
+	delta_array::back() const
+	{
+		if(!_tail.empty())
+			return _tail[_tail.count() - 1];
+		return operator[](_count - 1);
+	}
+
+	usize
+	delta_array::lower_bound(u64 value) const
+	{
+		return seek(value).index();
+	}
+
+	bool
+	delta_array::contains(u64 value) const
+	{
+		auto it = seek(value);
+		return it.index() < _count && *it == value;
+	}
+
+	void
+	delta_array::decode(dynamic_array<u64>& output) const
+	{
+		usize start = output.count();
+		output.expand_back(_count);
+		u64* values = output.data() + start;
+		for(usize block = 0; block < _firsts.count(); ++block, values += block_size)
+			_decode_block(block, values, block_size);
+		for(usize i = 0; i < _tail.count(); ++i)
+			values[i] = _tail[i];
+	}
+
+	void
+	delta_array::clear()
+	{
+		_words.clear();
+		_firsts.clear();
+		_offsets.clear();
+		_tail.clear();
+		_count = 0;
+	}
+
+	usize
+	delta_array::memory_size() const
+	{
+		return _words.count() * sizeof(u64) +
+			   _firsts.count() * sizeof(u64) +
+			   _offsets.count() * sizeof(usize) +
+			   _tail.count() * sizeof(u64);
+	}
+
+	delta_array::const_iterator
+	delta_array::seek(u64 value) const
+	{
+		auto result = begin();
+		result.seek(value);
+		return result;
+	}
+
+	delta_array::const_iterator
+	delta_array::begin() const
+	{
+		const_iterator result{this, 0, 0, 0, 0};
+		if(_count > 0)
+			result._load(0);
+		return result;
+	}
+
+	delta_array::const_iterator
+	delta_array::cbegin() const
+	{
+		return begin();
+	}
+
+	delta_array::const_iterator
+	delta_array::end() const
+	{
+		return const_iterator{this, _count, 0, 0, 0};
+	}
+
+	delta_array::const_iterator
+	delta_array::cend() const
+	{
+		return end();
+	}
+
+	usize
+	delta_array::_find_block(u64 value, usize from) const
+	{
+		usize blocks_count = _blocks_count();
+		if(from >= blocks_count)
+			return blocks_count;
+
+		//the tail is the last block and its first value is its skip pointer
+		auto first = [this](usize block) {
+			return block < _firsts.count() ? _firsts[block] : _tail[0];
+		};
+
+		usize low = from + 1, high = blocks_count;
+		while(low < high)
+		{
+			usize mid = low + (high - low) / 2;
+			//a run of equal values could cross into this block so an equal first value doesn't rule out the block before
+			if(first(mid) < value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low - 1;
+	}
+
+	void
+	delta_array::_decode_block(usize block, u64* values, usize count) const
+	{
+		if(block == _firsts.count())
+		{
+			for(usize i = 0; i < count; ++i)
+				values[i] = _tail[i];
+			return;
+		}
+
+		usize offset = _offsets[block];
+		usize end = block + 1 < _offsets.count() ? _offsets[block + 1] : _words.count();
+		_delta_unpack(_words.data() + offset, (end - offset) / 2, _firsts[block], values, count);
+	}
+
+	void
+	delta_array::_pack_tail()
+	{
+		u64 deltas[block_size];
+		u64 biggest = 0;
+		deltas[0] = 0;
+		for(usize i = 1; i < block_size; ++i)
+		{
+			deltas[i] = _tail[i] - _tail[i - 1];
+			biggest |= deltas[i];
+		}
+
+		//128 values of b bits take exactly 2 * b words
+		usize bits = details::significant_bits(biggest);
+		usize offset = _words.count();
+		_words.expand_back(bits * 2, 0);
+		_delta_pack(deltas, bits, _words.data() + offset);
+
+		_firsts.insert_back(_tail[0]);
+		_offsets.insert_back(offset);
+		_tail.clear();
+	}
+
+
+	//section(const_iterator)
+	delta_array::const_iterator&
+	delta_array::const_iterator::operator++()
+	{
+		++_index;
+		if(++_position == _block_count && _index < _array->_count)
+			_load(_block + 1);
+		return *this;
+	}
+
+	delta_array::const_iterator
+	delta_array::const_iterator::operator++(int)
+	{
+		auto result = *this;
+		++(*this);
+		return result;
+	}
+
+	bool
+	delta_array::const_iterator::seek(u64 value)
+	{
+		while(_index < _array->_count)
+		{
+			if(value <= _values[_block_count - 1])
+			{
+				usize position = _delta_block_lower_bound(_values + _position, _block_count - _position, value);
+				_position += position;
+				_index += position;
+				return true;
+			}
+
+			//skips to the last block which could have the value, or the one after this if none could
+			usize block = _array->_find_block(value, _block + 1);
+			if(block == _array->_blocks_count())
+			{
+				_index = _array->_count;
+				break;
+			}
+			_load(block);
+		}
+		return false;
+	}
+
+	void
+	delta_array::const_iterator::_load(usize block)
+	{
+		_block = block;
+		_position = 0;
+		_index = block * block_size;
+		_block_count = block < _array->_firsts.count() ? block_size : _array->_tail.count();
+		_array->_decode_block(block, _values, _block_count);
+	}
+}
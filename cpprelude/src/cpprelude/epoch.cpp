@@ -0,0 +1,174 @@
+#include "cpprelude/epoch.h"
+#include "cpprelude/platform.h"
+
+#include <thread>
+#include <functional>
+#include <new>
+
+namespace cpprelude
+{
+	//slot state is (epoch << 1) | 1 when pinned and 0 when free
+	static usize
+	_pinned_state(usize epoch)
+	{
+		return (epoch << 1) | 1;
+	}
+
+	static void
+	_init_chunk(epoch_domain::_slot_chunk* chunk)
+	{
+		for(usize i = 0; i < epoch_domain::slots_count; ++i)
+			chunk->slots[i].state.store(0, std::memory_order_relaxed);
+		chunk->next.store(nullptr, std::memory_order_relaxed);
+	}
+
+	static epoch_domain::_slot_chunk*
+	_alloc_chunk()
+	{
+		auto chunk = new (platform->alloc<epoch_domain::_slot_chunk>().ptr) epoch_domain::_slot_chunk;
+		_init_chunk(chunk);
+		return chunk;
+	}
+
+	static void
+	_free_chunk(epoch_domain::_slot_chunk* chunk)
+	{
+		chunk->~_slot_chunk();
+		platform->free(make_slice(chunk));
+	}
+
+	epoch_domain::epoch_domain(free_func free_function, void* user_data)
+		:_epoch(0), _retired_count(0), _free(free_function), _user(user_data)
+	{
+		_init_chunk(&_slots);
+		for(usize i = 0; i < 3; ++i)
+			_limbo[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	epoch_domain::~epoch_domain()
+	{
+		flush();
+
+		_slot_chunk* chunk = _slots.next.load();
+		while(chunk != nullptr)
+		{
+			_slot_chunk* next = chunk->next.load();
+			_free_chunk(chunk);
+			chunk = next;
+		}
+	}
+
+	usize
+	epoch_domain::pin()
+	{
+		//start from a slot derived from the thread id so threads don't fight over the same slots
+		usize start = std::hash<std::thread::id>()(std::this_thread::get_id());
+		_slot_chunk* chunk = &_slots;
+		for(usize base = 0; ; base += slots_count)
+		{
+			for(usize i = 0; i < slots_count; ++i)
+			{
+				usize index = (start + i) % slots_count;
+				auto& state = chunk->slots[index].state;
+				if(state.load(std::memory_order_relaxed) != 0)
+					continue;
+
+				usize epoch = _epoch.load();
+				usize free_state = 0;
+				if(!state.compare_exchange_strong(free_state, _pinned_state(epoch)))
+					continue;
+
+				//the epoch could have moved before the slot was visible so announce it again until it's stable
+				usize current = _epoch.load();
+				while(current != epoch)
+				{
+					epoch = current;
+					state.store(_pinned_state(epoch));
+					current = _epoch.load();
+				}
+				return base + index;
+			}
+
+			//all the slots of the chunk are taken so move to the next one and add it if it's not there
+			_slot_chunk* next = chunk->next.load(std::memory_order_acquire);
+			if(next == nullptr)
+			{
+				_slot_chunk* new_chunk = _alloc_chunk();
+				if(chunk->next.compare_exchange_strong(next, new_chunk))
+					next = new_chunk;
+				else
+					_free_chunk(new_chunk);
+			}
+			chunk = next;
+		}
+	}
+
+	void
+	epoch_domain::unpin(usize slot)
+	{
+		_slot(slot).state.store(0, std::memory_order_release);
+	}
+
+	void
+	epoch_domain::retire(epoch_retired* object)
+	{
+		usize epoch = _epoch.load();
+		auto& list = _limbo[epoch % 3];
+		object->next = list.load(std::memory_order_relaxed);
+		while(!list.compare_exchange_weak(object->next, object,
+			std::memory_order_release, std::memory_order_relaxed));
+
+		//scanning the slots isn't free so only try to advance the epoch every once in a while
+		if((_retired_count.fetch_add(1, std::memory_order_relaxed) & 63) == 63)
+			_try_advance();
+	}
+
+	void
+	epoch_domain::flush()
+	{
+		for(usize i = 0; i < 3; ++i)
+			_free_list(_limbo[i].exchange(nullptr));
+	}
+
+	bool
+	epoch_domain::_try_advance()
+	{
+		usize epoch = _epoch.load();
+		for(_slot_chunk* chunk = &_slots; chunk != nullptr; chunk = chunk->next.load())
+		{
+			for(usize i = 0; i < slots_count; ++i)
+			{
+				usize state = chunk->slots[i].state.load();
+				if(state != 0 && state != _pinned_state(epoch))
+					return false;
+			}
+		}
+
+		if(!_epoch.compare_exchange_strong(epoch, epoch + 1))
+			return false;
+
+		//objects retired two epochs ago can't be seen by any thread now
+		_free_list(_limbo[(epoch + 2) % 3].exchange(nullptr));
+		return true;
+	}
+
+	void
+	epoch_domain::_free_list(epoch_retired* list)
+	{
+		while(list != nullptr)
+		{
+			epoch_retired* next = list->next;
+			_free(_user, list);
+			list = next;
+		}
+	}
+
+	epoch_domain::_slot_type&
+	epoch_domain::_slot(usize slot)
+	{
+		_slot_chunk* chunk = &_slots;
+		for(; slot >= slots_count; slot -= slots_count)
+			chunk = chunk->next.load(std::memory_order_acquire);
+		return chunk->slots[slot];
+	}
+}
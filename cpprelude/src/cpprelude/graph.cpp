@@ -0,0 +1,412 @@
+#include "cpprelude/graph.h"
+#include "cpprelude/algorithm.h"
+#include "cpprelude/bitset.h"
+#include "cpprelude/quick_union.h"
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace cpprelude
+{
+	//an edge in an adjacency list, it's how the weighted lists are sorted
+	struct _csr_entry
+	{
+		u32 to;
+		r32 weight;
+	};
+
+	//count of threads to use for the work, small work isn't worth starting a thread
+	inline usize
+	_graph_threads_count(usize threads_count, usize work)
+	{
+		if(threads_count == 0)
+			threads_count = std::thread::hardware_concurrency();
+		if(threads_count == 0)
+			threads_count = 1;
+		usize limit = work / 4096 + 1;
+		return threads_count < limit ? threads_count : limit;
+	}
+
+	//splits [0, count) into even parts whose boundaries are multiples of align
+	inline void
+	_even_boundaries(usize count, usize threads_count, usize align, dynamic_array<usize>& boundaries)
+	{
+		usize chunk = (count / threads_count + align - 1) / align * align;
+		boundaries.clear();
+		for(usize i = 0; i < threads_count; ++i)
+			boundaries.insert_back(i * chunk < count ? i * chunk : count);
+		boundaries.insert_back(count);
+	}
+
+	//splits the vertices into parts with about the same count of edges so a few big vertices don't end up in one part
+	inline void
+	_edge_boundaries(const dynamic_array<usize>& offsets, usize threads_count, usize align, dynamic_array<usize>& boundaries)
+	{
+		usize vertices_count = offsets.count() - 1;
+		usize edges_count = offsets[vertices_count];
+		boundaries.clear();
+		boundaries.insert_back(0);
+		for(usize i = 1; i < threads_count; ++i)
+		{
+			//first vertex whose edges start after the part's share of the edges
+			usize target = edges_count / threads_count * i;
+			usize lo = 0, hi = vertices_count;
+			while(lo < hi)
+			{
+				usize mid = lo + (hi - lo) / 2;
+				if(offsets[mid] < target)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			lo = lo / align * align;
+			boundaries.insert_back(lo > boundaries[i - 1] ? lo : boundaries[i - 1]);
+		}
+		boundaries.insert_back(vertices_count);
+	}
+
+	//calls function(begin, end, part) for every part on its own thread, the calling thread takes the first part
+	template<typename function_type>
+	inline void
+	_parallel_for(const dynamic_array<usize>& boundaries, function_type&& function)
+	{
+		usize parts_count = boundaries.count() - 1;
+		dynamic_array<std::thread> threads;
+		threads.reserve(parts_count - 1);
+		for(usize i = 1; i < parts_count; ++i)
+		{
+			usize begin = boundaries[i], end = boundaries[i + 1];
+			threads.emplace_back([&function, begin, end, i]() {
+				function(begin, end, i);
+			});
+		}
+		function(boundaries[0], boundaries[1], usize(0));
+		for(auto& thread: threads)
+			thread.join();
+	}
+
+	inline void
+	_sort_targets(u32* targets, usize count)
+	{
+		if(count <= 16)
+			insertion_sort(sequential_iterator<u32>(targets), count);
+		else
+			merge_sort(sequential_iterator<u32>(targets), count);
+	}
+
+	inline void
+	_sort_entries(u32* targets, r32* weights, usize count, dynamic_array<_csr_entry>& scratch)
+	{
+		scratch.clear();
+		for(usize i = 0; i < count; ++i)
+			scratch.insert_back(_csr_entry{targets[i], weights[i]});
+
+		auto less_than = [](const _csr_entry& a, const _csr_entry& b) {
+			return a.to < b.to || (a.to == b.to && a.weight < b.weight);
+		};
+		if(count <= 16)
+			insertion_sort(scratch.begin(), count, less_than);
+		else
+			merge_sort(scratch.begin(), count, less_than);
+
+		for(usize i = 0; i < count; ++i)
+		{
+			targets[i] = scratch[i].to;
+			weights[i] = scratch[i].weight;
+		}
+	}
+
+	csr_graph::csr_graph(memory_context* context)
+		:_offsets(context), _targets(context), _weights(context), _undirected(false)
+	{
+		_offsets.insert_back(0);
+	}
+
+	void
+	csr_graph::build(usize vertices_count, const slice<graph_edge>& edges,
+					 bool undirected, bool weighted, usize threads_count)
+	{
+		_undirected = undirected;
+		usize edges_count = edges.count();
+		usize stored_count = undirected ? edges_count * 2 : edges_count;
+		usize edge_threads = _graph_threads_count(threads_count, edges_count);
+		usize vertex_threads = _graph_threads_count(threads_count, vertices_count);
+
+		dynamic_array<usize> edge_parts, vertex_parts;
+		_even_boundaries(edges_count, edge_threads, 1, edge_parts);
+		_even_boundaries(vertices_count, vertex_threads, 1, vertex_parts);
+
+		//the cursors count the degrees first then they're the next free position in every list
+		memory_context* context = _offsets._context;
+		slice<std::atomic<usize>> cursors = context->template alloc<std::atomic<usize>>(vertices_count);
+		_parallel_for(vertex_parts, [&cursors](usize begin, usize end, usize) {
+			for(usize i = begin; i < end; ++i)
+				new (&cursors[i]) std::atomic<usize>(0);
+		});
+
+		_parallel_for(edge_parts, [&](usize begin, usize end, usize) {
+			for(usize i = begin; i < end; ++i)
+			{
+				cursors[edges[i].from].fetch_add(1, std::memory_order_relaxed);
+				if(undirected)
+					cursors[edges[i].to].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		_offsets.clear();
+		_offsets.expand_back(vertices_count + 1);
+		usize sum = 0;
+		for(usize i = 0; i < vertices_count; ++i)
+		{
+			_offsets[i] = sum;
+			sum += cursors[i].load(std::memory_order_relaxed);
+			cursors[i].store(_offsets[i], std::memory_order_relaxed);
+		}
+		_offsets[vertices_count] = sum;
+
+		_targets.clear();
+		_targets.expand_back(stored_count);
+		_weights.clear();
+		if(weighted)
+			_weights.expand_back(stored_count);
+
+		_parallel_for(edge_parts, [&](usize begin, usize end, usize) {
+			for(usize i = begin; i < end; ++i)
+			{
+				const graph_edge& edge = edges[i];
+				usize position = cursors[edge.from].fetch_add(1, std::memory_order_relaxed);
+				_targets[position] = edge.to;
+				if(weighted)
+					_weights[position] = edge.weight;
+
+				if(undirected)
+				{
+					position = cursors[edge.to].fetch_add(1, std::memory_order_relaxed);
+					_targets[position] = edge.from;
+					if(weighted)
+						_weights[position] = edge.weight;
+				}
+			}
+		});
+		context->free(cursors);
+
+		//the threads raced for the positions in the lists so they're sorted to make the graph the same on every build
+		_edge_boundaries(_offsets, vertex_threads, 1, vertex_parts);
+		_parallel_for(vertex_parts, [this, weighted](usize begin, usize end, usize) {
+			dynamic_array<_csr_entry> scratch;
+			for(usize i = begin; i < end; ++i)
+			{
+				usize offset = _offsets[i], count = _offsets[i + 1] - offset;
+				if(weighted)
+					_sort_entries(_targets.data() + offset, _weights.data() + offset, count, scratch);
+				else
+					_sort_targets(_targets.data() + offset, count);
+			}
+		});
+	}
+
+	usize
+	csr_graph::bfs(u32 source, dynamic_array<u32>& levels, usize threads_count) const
+	{
+		//the frontier switches to scanning the unreached vertices when its edges are more than the unexplored edges over alpha
+		//and back to expanding the frontier when it's less than the vertices over beta
+		constexpr usize alpha = 15;
+		constexpr usize beta = 18;
+
+		usize vertices_count = this->vertices_count();
+		usize max_threads = _graph_threads_count(threads_count, edges_count());
+		memory_context* context = _offsets._context;
+
+		slice<std::atomic<u32>> depth = context->template alloc<std::atomic<u32>>(vertices_count);
+		dynamic_array<usize> parts;
+		_even_boundaries(vertices_count, _graph_threads_count(max_threads, vertices_count), 1, parts);
+		_parallel_for(parts, [&depth](usize begin, usize end, usize) {
+			for(usize i = begin; i < end; ++i)
+				new (&depth[i]) std::atomic<u32>(unreached);
+		});
+		depth[source].store(0, std::memory_order_relaxed);
+
+		dynamic_array<u32> frontier;
+		frontier.insert_back(source);
+		dynamic_bitset frontier_bits, next_bits;
+		if(_undirected)
+		{
+			frontier_bits.resize(vertices_count);
+			next_bits.resize(vertices_count);
+		}
+
+		dynamic_array<dynamic_array<u32>> next_frontiers;
+		dynamic_array<usize> found_counts, found_edges;
+		for(usize i = 0; i < max_threads; ++i)
+			next_frontiers.emplace_back(context);
+		found_counts.expand_back(max_threads, 0);
+		found_edges.expand_back(max_threads, 0);
+
+		usize reached = 1;
+		usize frontier_count = 1;
+		usize frontier_edges = degree(source);
+		usize unexplored_edges = edges_count() - frontier_edges;
+		bool bottom_up = false;
+		for(u32 level = 0; frontier_count > 0; ++level)
+		{
+			if(_undirected && !bottom_up && frontier_edges > unexplored_edges / alpha)
+			{
+				bottom_up = true;
+				frontier_bits.reset_all();
+				for(u32 vertex: frontier)
+					frontier_bits.set(vertex);
+			}
+			else if(bottom_up && frontier_count < vertices_count / beta)
+			{
+				bottom_up = false;
+				frontier.clear();
+				for(usize i = frontier_bits.find_first(); i < vertices_count; i = frontier_bits.find_next(i))
+					frontier.insert_back(u32(i));
+			}
+
+			if(bottom_up)
+			{
+				//every part owns whole words of the next frontier so the threads never write the same word
+				next_bits.reset_all();
+				_edge_boundaries(_offsets, max_threads, dynamic_bitset::word_bits, parts);
+				_parallel_for(parts, [&](usize begin, usize end, usize part) {
+					usize count = 0, edges = 0;
+					for(usize vertex = begin; vertex < end; ++vertex)
+					{
+						if(depth[vertex].load(std::memory_order_relaxed) != unreached)
+							continue;
+						for(u32 neighbour: neighbours(u32(vertex)))
+						{
+							if(frontier_bits.test(neighbour))
+							{
+								depth[vertex].store(level + 1, std::memory_order_relaxed);
+								next_bits.set(vertex);
+								++count;
+								edges += degree(u32(vertex));
+								break;
+							}
+						}
+					}
+					found_counts[part] = count;
+					found_edges[part] = edges;
+				});
+				std::swap(frontier_bits, next_bits);
+			}
+			else
+			{
+				_even_boundaries(frontier.count(), _graph_threads_count(max_threads, frontier_edges), 1, parts);
+				_parallel_for(parts, [&](usize begin, usize end, usize part) {
+					dynamic_array<u32>& next = next_frontiers[part];
+					next.clear();
+					usize edges = 0;
+					for(usize i = begin; i < end; ++i)
+					{
+						for(u32 neighbour: neighbours(frontier[i]))
+						{
+							u32 expected = unreached;
+							if(depth[neighbour].load(std::memory_order_relaxed) == unreached &&
+							   depth[neighbour].compare_exchange_strong(expected, level + 1, std::memory_order_relaxed))
+							{
+								next.insert_back(neighbour);
+								edges += degree(neighbour);
+							}
+						}
+					}
+					found_counts[part] = next.count();
+					found_edges[part] = edges;
+				});
+
+				frontier.clear();
+				for(usize part = 0; part + 1 < parts.count(); ++part)
+					for(u32 vertex: next_frontiers[part])
+						frontier.insert_back(vertex);
+			}
+
+			frontier_count = 0;
+			frontier_edges = 0;
+			for(usize part = 0; part + 1 < parts.count(); ++part)
+			{
+				frontier_count += found_counts[part];
+				frontier_edges += found_edges[part];
+			}
+			unexplored_edges = unexplored_edges > frontier_edges ? unexplored_edges - frontier_edges : 0;
+			reached += frontier_count;
+		}
+
+		levels.clear();
+		levels.expand_back(vertices_count);
+		for(usize i = 0; i < vertices_count; ++i)
+			levels[i] = depth[i].load(std::memory_order_relaxed);
+		context->free(depth);
+		return reached;
+	}
+
+	usize
+	csr_graph::connected_components(dynamic_array<u32>& labels, usize threads_count) const
+	{
+		usize vertices_count = this->vertices_count();
+		concurrent_quick_union sets(vertices_count, _offsets._context);
+
+		dynamic_array<usize> parts;
+		_edge_boundaries(_offsets, _graph_threads_count(threads_count, edges_count()), 1, parts);
+		_parallel_for(parts, [&](usize begin, usize end, usize) {
+			for(usize vertex = begin; vertex < end; ++vertex)
+			{
+				//an undirected edge is stored in both directions so it's connected from its smaller end only
+				for(u32 neighbour: neighbours(u32(vertex)))
+					if(!_undirected || neighbour > vertex)
+						sets.connect(vertex, neighbour);
+			}
+		});
+
+		//the root of a set is its smallest element so the labels come in the order of the smallest vertices
+		labels.clear();
+		labels.expand_back(vertices_count, u32(unreached));
+		u32 components_count = 0;
+		for(usize i = 0; i < vertices_count; ++i)
+		{
+			usize root = sets._root(i);
+			if(labels[root] == unreached)
+				labels[root] = components_count++;
+			labels[i] = labels[root];
+		}
+		return components_count;
+	}
+
+	r64
+	csr_graph::minimum_spanning_forest(dynamic_array<graph_edge>& edges) const
+	{
+		usize vertices_count = this->vertices_count();
+		dynamic_array<graph_edge> candidates(_offsets._context);
+		candidates.reserve(_undirected ? edges_count() / 2 : edges_count());
+		for(usize vertex = 0; vertex < vertices_count; ++vertex)
+		{
+			csr_neighbours list = neighbours(u32(vertex));
+			for(usize i = 0; i < list.count(); ++i)
+				if(list[i] != vertex && (!_undirected || list[i] > vertex))
+					candidates.insert_back(graph_edge{u32(vertex), list[i], list.weight(i)});
+		}
+
+		//the sort is stable so edges of equal weight are taken in the order of their vertices
+		merge_sort(candidates.begin(), candidates.count(), [](const graph_edge& a, const graph_edge& b) {
+			return a.weight < b.weight;
+		});
+
+		compact_quick_union sets(vertices_count, _offsets._context);
+		edges.clear();
+		r64 result = 0;
+		for(const graph_edge& edge: candidates)
+		{
+			if(sets.connect(edge.from, edge.to))
+			{
+				edges.insert_back(edge);
+				result += edge.weight;
+				if(edges.count() + 1 == vertices_count)
+					break;
+			}
+		}
+		return result;
+	}
+}
@@ -22,6 +22,9 @@
 #include <unistd.h>
 #include <string.h>
 #include <cxxabi.h>
+#include <time.h>
+#else
+#include <chrono>
 #endif
 
 namespace cpprelude
@@ -527,6 +530,34 @@ namespace cpprelude
 		#endif
 	}
 
+	u64
+	platform_t::monotonic_time() const
+	{
+		#if defined(OS_WINDOWS)
+		{
+			LARGE_INTEGER counter, frequency;
+			QueryPerformanceCounter(&counter);
+			QueryPerformanceFrequency(&frequency);
+
+			//split the conversion so the multiplication doesn't overflow
+			u64 seconds = counter.QuadPart / frequency.QuadPart;
+			u64 remainder = counter.QuadPart % frequency.QuadPart;
+			return seconds * 1000000000ULL + (remainder * 1000000000ULL) / frequency.QuadPart;
+		}
+		#elif defined(OS_LINUX)
+		{
+			timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			return u64(now.tv_sec) * 1000000000ULL + u64(now.tv_nsec);
+		}
+		#else
+		{
+			auto now = std::chrono::steady_clock::now().time_since_epoch();
+			return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+		}
+		#endif
+	}
+
 	//private functions
 	slice<byte>
 	_default_alloc(void*, usize count)
@@ -31,6 +31,19 @@ namespace cpprelude{
 		}
 	}
 
+	void
+	quick_find::connect_all(const slice<quick_union_edge>& edges)
+	{
+		//the current sets go in a union find with the edges then every element takes the root of its set as id
+		compact_quick_union sets(_nodes.count());
+		for (usize i = 0; i < _nodes.count(); ++i)
+			sets.connect(static_cast<u32>(i), static_cast<u32>(_nodes[i]));
+		sets.connect_all(edges);
+
+		for (usize i = 0; i < _nodes.count(); ++i)
+			_nodes[i] = sets._root(static_cast<u32>(i));
+	}
+
 	usize 
 	quick_find::count() const
 	{
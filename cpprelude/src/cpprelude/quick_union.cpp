@@ -1,5 +1,9 @@
 #include "cpprelude/quick_union.h"
 
+#include <new>
+#include <thread>
+#include <utility>
+
 namespace cpprelude
 {
 	quick_union::quick_union()
@@ -67,4 +71,234 @@ namespace cpprelude
 		}
 		return a;
 	}
+
+	compact_quick_union::compact_quick_union(memory_context* context)
+		:_nodes(context), _ranks(context)
+	{}
+
+	compact_quick_union::compact_quick_union(usize count, memory_context* context)
+		:_nodes(context), _ranks(context)
+	{
+		init(count);
+	}
+
+	void
+	compact_quick_union::init(usize count)
+	{
+		usize start = _nodes.count();
+		_nodes.expand_back(count);
+		for(usize i = 0; i < count; ++i)
+			_nodes[start + i] = static_cast<u32>(start + i);
+
+		_ranks.expand_back(count, 0);
+	}
+
+	bool
+	compact_quick_union::connect(u32 a, u32 b)
+	{
+		auto a_root = _root(a);
+		auto b_root = _root(b);
+
+		if(a_root == b_root)
+			return false;
+
+		//put the lower tree under the higher one, equal trees make the result one level higher
+		if(_ranks[a_root] < _ranks[b_root])
+		{
+			_nodes[a_root] = b_root;
+		}
+		else
+		{
+			_nodes[b_root] = a_root;
+			if(_ranks[a_root] == _ranks[b_root])
+				++_ranks[a_root];
+		}
+		return true;
+	}
+
+	usize
+	compact_quick_union::connect_all(const slice<quick_union_edge>& edges)
+	{
+		usize result = 0;
+		for(usize i = 0; i < edges.count(); ++i)
+			result += connect(static_cast<u32>(edges[i].a), static_cast<u32>(edges[i].b));
+		return result;
+	}
+
+	bool
+	compact_quick_union::is_connected(u32 a, u32 b)
+	{
+		return _root(a) == _root(b);
+	}
+
+	usize
+	compact_quick_union::label_components(dynamic_array<u32>& labels, dynamic_array<u32>& sizes)
+	{
+		constexpr u32 unlabeled = static_cast<u32>(-1);
+		usize count = _nodes.count();
+		labels.clear();
+		labels.expand_back(count, unlabeled);
+		sizes.clear();
+
+		//the label of a set is kept at its root until the root itself is reached
+		u32 components_count = 0;
+		for(usize i = 0; i < count; ++i)
+		{
+			u32 root = _root(static_cast<u32>(i));
+			if(labels[root] == unlabeled)
+			{
+				labels[root] = components_count++;
+				sizes.insert_back(0);
+			}
+			labels[i] = labels[root];
+			++sizes[labels[i]];
+		}
+		return components_count;
+	}
+
+	usize
+	compact_quick_union::count() const
+	{
+		return _nodes.count();
+	}
+
+	u32
+	compact_quick_union::_root(u32 a)
+	{
+		while(a != _nodes[a])
+		{
+			//path halving, every other node on the way points to its grand parent
+			_nodes[a] = _nodes[_nodes[a]];
+			a = _nodes[a];
+		}
+		return a;
+	}
+
+	concurrent_quick_union::concurrent_quick_union(memory_context* context)
+		:_context(context)
+	{}
+
+	concurrent_quick_union::concurrent_quick_union(usize count, memory_context* context)
+		:_context(context)
+	{
+		init(count);
+	}
+
+	concurrent_quick_union::~concurrent_quick_union()
+	{
+		if(_nodes.ptr != nullptr)
+			_context->free(_nodes);
+	}
+
+	void
+	concurrent_quick_union::init(usize count)
+	{
+		if(_nodes.ptr != nullptr)
+			_context->free(_nodes);
+
+		_nodes = _context->template alloc<std::atomic<usize>>(count);
+		for(usize i = 0; i < count; ++i)
+			new (&_nodes[i]) std::atomic<usize>(i);
+	}
+
+	bool
+	concurrent_quick_union::connect(usize a, usize b)
+	{
+		while(true)
+		{
+			a = _root(a);
+			b = _root(b);
+			if(a == b)
+				return false;
+
+			if(a < b)
+				std::swap(a, b);
+
+			//fails if another thread linked a since it was found so the roots are found again
+			usize expected = a;
+			if(_nodes[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+				return true;
+		}
+	}
+
+	bool
+	concurrent_quick_union::is_connected(usize a, usize b)
+	{
+		while(true)
+		{
+			a = _root(a);
+			b = _root(b);
+			if(a == b)
+				return true;
+
+			//if a is still a root then they weren't connected when b's root was found
+			if(_nodes[a].load(std::memory_order_relaxed) == a)
+				return false;
+		}
+	}
+
+	usize
+	concurrent_quick_union::count() const
+	{
+		return _nodes.count();
+	}
+
+	usize
+	concurrent_quick_union::_root(usize a)
+	{
+		while(true)
+		{
+			usize parent = _nodes[a].load(std::memory_order_relaxed);
+			if(parent == a)
+				return a;
+
+			usize grand_parent = _nodes[parent].load(std::memory_order_relaxed);
+			if(grand_parent == parent)
+				return parent;
+
+			//path halving, if it fails another thread already changed the link to something closer to the root
+			_nodes[a].compare_exchange_weak(parent, grand_parent, std::memory_order_relaxed);
+			a = grand_parent;
+		}
+	}
+
+	usize
+	connect_all(concurrent_quick_union& sets, const slice<quick_union_edge>& edges, usize threads_count)
+	{
+		if(threads_count == 0)
+			threads_count = std::thread::hardware_concurrency();
+		usize edges_count = edges.count();
+		if(threads_count == 0 || edges_count < threads_count * 1024)
+			threads_count = 1;
+
+		auto connect_range = [&sets, &edges](usize begin, usize end, usize* merged) {
+			usize result = 0;
+			for(usize i = begin; i < end; ++i)
+				result += sets.connect(edges[i].a, edges[i].b);
+			*merged = result;
+		};
+
+		dynamic_array<usize> merged;
+		merged.expand_back(threads_count, 0);
+		dynamic_array<std::thread> threads;
+		threads.reserve(threads_count - 1);
+
+		usize chunk = edges_count / threads_count;
+		for(usize i = 1; i < threads_count; ++i)
+		{
+			usize begin = i * chunk;
+			usize end = i + 1 == threads_count ? edges_count : begin + chunk;
+			threads.emplace_back(connect_range, begin, end, &merged[i]);
+		}
+		connect_range(0, chunk, &merged[0]);
+
+		usize result = 0;
+		for(usize i = 0; i < threads_count; ++i)
+		{
+			if(i > 0)
+				threads[i - 1].join();
+			result += merged[i];
+		}
+		return result;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,1159 @@
+#include "cpprelude/roaring_bitmap.h"
+#include "cpprelude/bits.h"
+#include "cpprelude/fmt.h"
+
+#include <cstring>
+
+namespace cpprelude
+{
+	using container_type = roaring_bitmap::_container_type;
+
+	constexpr static u32 _roaring_cookie = 0x524F4152;
+	constexpr static u32 _chunk_values = 65536;
+
+
+	//section(container helpers)
+	inline static container_type
+	_container_make(u16 key, container_type::kind_type kind)
+	{
+		container_type result;
+		result.key = key;
+		result.kind = kind;
+		result.size = 0;
+		result.cardinality = 0;
+		return result;
+	}
+
+	inline static void
+	_container_free(memory_context* context, container_type& c)
+	{
+		if(c.values.valid())
+			context->free(c.values);
+		if(c.words.valid())
+			context->free(c.words);
+	}
+
+	inline static usize
+	_container_values_count(const container_type& c)
+	{
+		return c.kind == container_type::RUN ? c.size * 2 : c.size;
+	}
+
+	inline static container_type
+	_container_copy(memory_context* context, const container_type& c)
+	{
+		container_type result = _container_make(c.key, c.kind);
+		result.size = c.size;
+		result.cardinality = c.cardinality;
+		if(c.kind == container_type::BITMAP)
+		{
+			result.words = context->template alloc<u64>(roaring_bitmap::bitmap_words);
+			std::memcpy(result.words.ptr, c.words.ptr, result.words.size);
+		}
+		else
+		{
+			usize count = _container_values_count(c);
+			result.values = context->template alloc<u16>(count);
+			std::memcpy(result.values.ptr, c.values.ptr, count * sizeof(u16));
+		}
+		return result;
+	}
+
+	inline static u32
+	_array_lower_bound(const u16* values, u32 count, u16 value)
+	{
+		u32 low = 0, high = count;
+		while(low < high)
+		{
+			u32 mid = low + (high - low) / 2;
+			if(values[mid] < value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low;
+	}
+
+	inline static void
+	_array_reserve(memory_context* context, container_type& c, u32 count)
+	{
+		usize capacity = c.values.count();
+		if(capacity >= count)
+			return;
+
+		capacity = capacity * 2 > count ? capacity * 2 : count;
+		if(capacity > roaring_bitmap::array_limit)
+			capacity = roaring_bitmap::array_limit;
+
+		if(c.values.valid())
+			context->template realloc<u16>(c.values, capacity);
+		else
+			c.values = context->template alloc<u16>(capacity);
+	}
+
+	inline static bool
+	_bitmap_test(const u64* words, u16 value)
+	{
+		return (words[value >> 6] >> (value & 63)) & 1;
+	}
+
+	//first set bit at or after the position or 65536 if there's none
+	inline static u32
+	_bitmap_next(const u64* words, u32 position)
+	{
+		if(position >= _chunk_values)
+			return _chunk_values;
+
+		usize i = position >> 6;
+		u64 word = words[i] & (~u64(0) << (position & 63));
+		while(word == 0)
+		{
+			if(++i == roaring_bitmap::bitmap_words)
+				return _chunk_values;
+			word = words[i];
+		}
+		return u32(i * 64 + details::lowest_set_bit(word));
+	}
+
+	inline static void
+	_bitmap_set_range(u64* words, u32 first, u32 last)
+	{
+		usize first_word = first >> 6, last_word = last >> 6;
+		u64 first_mask = ~u64(0) << (first & 63);
+		u64 last_mask = ~u64(0) >> (63 - (last & 63));
+		if(first_word == last_word)
+		{
+			words[first_word] |= first_mask & last_mask;
+			return;
+		}
+
+		words[first_word] |= first_mask;
+		for(usize i = first_word + 1; i < last_word; ++i)
+			words[i] = ~u64(0);
+		words[last_word] |= last_mask;
+	}
+
+	inline static u64*
+	_bitmap_alloc(memory_context* context, container_type& c)
+	{
+		c.words = context->template alloc<u64>(roaring_bitmap::bitmap_words);
+		std::memset(c.words.ptr, 0, c.words.size);
+		return c.words.ptr;
+	}
+
+	inline static void
+	_array_to_bitmap(memory_context* context, container_type& c)
+	{
+		u64* words = _bitmap_alloc(context, c);
+		for(u32 i = 0; i < c.size; ++i)
+			words[c.values[i] >> 6] |= u64(1) << (c.values[i] & 63);
+
+		context->free(c.values);
+		c.kind = container_type::BITMAP;
+		c.size = 0;
+	}
+
+	inline static void
+	_bitmap_to_array(memory_context* context, container_type& c)
+	{
+		c.values = context->template alloc<u16>(c.cardinality);
+		u32 count = 0;
+		for(usize i = 0; i < roaring_bitmap::bitmap_words; ++i)
+		{
+			u64 word = c.words[i];
+			while(word)
+			{
+				c.values[count++] = u16(i * 64 + details::lowest_set_bit(word));
+				word &= word - 1;
+			}
+		}
+
+		context->free(c.words);
+		c.kind = container_type::ARRAY;
+		c.size = count;
+	}
+
+	inline static bool
+	_run_contains(const container_type& c, u16 value)
+	{
+		//the last run which starts at or before the value
+		u32 low = 0, high = c.size;
+		while(low < high)
+		{
+			u32 mid = low + (high - low) / 2;
+			if(c.values[mid * 2] <= value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low > 0 && value - c.values[(low - 1) * 2] <= c.values[(low - 1) * 2 + 1];
+	}
+
+	//converts a run container to an array or a bitmap depending on its cardinality
+	inline static void
+	_run_to_normal(memory_context* context, container_type& c)
+	{
+		slice<u16> runs = std::move(c.values);
+		u32 runs_count = c.size;
+		if(c.cardinality <= roaring_bitmap::array_limit)
+		{
+			c.values = context->template alloc<u16>(c.cardinality);
+			u32 count = 0;
+			for(u32 i = 0; i < runs_count; ++i)
+				for(u32 value = runs[i * 2]; value <= u32(runs[i * 2]) + runs[i * 2 + 1]; ++value)
+					c.values[count++] = u16(value);
+			c.kind = container_type::ARRAY;
+			c.size = count;
+		}
+		else
+		{
+			u64* words = _bitmap_alloc(context, c);
+			for(u32 i = 0; i < runs_count; ++i)
+				_bitmap_set_range(words, runs[i * 2], u32(runs[i * 2]) + runs[i * 2 + 1]);
+			c.kind = container_type::BITMAP;
+			c.size = 0;
+		}
+		context->free(runs);
+	}
+
+	inline static u32
+	_array_runs_count(const container_type& c)
+	{
+		u32 result = 1;
+		for(u32 i = 1; i < c.size; ++i)
+			result += c.values[i] != c.values[i - 1] + 1;
+		return result;
+	}
+
+	inline static u32
+	_bitmap_runs_count(const container_type& c)
+	{
+		//a run starts at each set bit whose previous bit is not set
+		u32 result = 0;
+		u64 carry = 0;
+		for(usize i = 0; i < roaring_bitmap::bitmap_words; ++i)
+		{
+			u64 word = c.words[i];
+			result += u32(details::popcount(word & ~((word << 1) | carry)));
+			carry = word >> 63;
+		}
+		return result;
+	}
+
+	inline static void
+	_container_to_run(memory_context* context, container_type& c, u32 runs_count)
+	{
+		slice<u16> runs = context->template alloc<u16>(runs_count * 2);
+		u32 count = 0;
+		auto add = [&](u32 value) {
+			if(count > 0 && u32(runs[(count - 1) * 2]) + runs[(count - 1) * 2 + 1] + 1 == value)
+			{
+				++runs[(count - 1) * 2 + 1];
+				return;
+			}
+			runs[count * 2] = u16(value);
+			runs[count * 2 + 1] = 0;
+			++count;
+		};
+
+		if(c.kind == container_type::ARRAY)
+		{
+			for(u32 i = 0; i < c.size; ++i)
+				add(c.values[i]);
+			context->free(c.values);
+		}
+		else
+		{
+			for(u32 value = _bitmap_next(c.words.ptr, 0); value < _chunk_values; value = _bitmap_next(c.words.ptr, value + 1))
+				add(value);
+			context->free(c.words);
+		}
+
+		c.values = std::move(runs);
+		c.kind = container_type::RUN;
+		c.size = count;
+	}
+
+	//a run container as an array or bitmap, the temp holds the converted copy which the caller frees
+	inline static const container_type&
+	_container_normal(memory_context* context, const container_type& c, container_type& temp)
+	{
+		if(c.kind != container_type::RUN)
+			return c;
+
+		temp = _container_copy(context, c);
+		_run_to_normal(context, temp);
+		return temp;
+	}
+
+	inline static void
+	_container_free_normal(memory_context* context, const container_type& c, container_type& temp)
+	{
+		if(c.kind == container_type::RUN)
+			_container_free(context, temp);
+	}
+
+	//sets the cardinality of a bitmap result and converts it to an array if it got small
+	inline static void
+	_bitmap_settle(memory_context* context, container_type& c)
+	{
+		c.cardinality = u32(details::popcount_words(c.words.ptr, roaring_bitmap::bitmap_words));
+		if(c.cardinality > 0 && c.cardinality <= roaring_bitmap::array_limit)
+			_bitmap_to_array(context, c);
+	}
+
+	//sets the size of an array result and gives back the unused memory
+	inline static void
+	_array_settle(memory_context* context, container_type& c, u32 count)
+	{
+		c.size = count;
+		c.cardinality = count;
+		if(count > 0 && count < c.values.count())
+			context->template realloc<u16>(c.values, count);
+	}
+
+
+	//section(array set operations)
+	inline static u32
+	_array_intersect(const u16* a, u32 a_count, const u16* b, u32 b_count, u16* out)
+	{
+		if(a_count > b_count)
+		{
+			std::swap(a, b);
+			std::swap(a_count, b_count);
+		}
+
+		u32 count = 0;
+		//gallop through the large array when the sizes are far apart
+		if(a_count * 32 < b_count)
+		{
+			u32 j = 0;
+			for(u32 i = 0; i < a_count && j < b_count; ++i)
+			{
+				u16 value = a[i];
+				u32 low = j, step = 1;
+				while(j < b_count && b[j] < value)
+				{
+					low = j + 1;
+					j += step;
+					step *= 2;
+				}
+				u32 high = j < b_count ? j : b_count;
+				j = low + _array_lower_bound(b + low, high - low, value);
+				if(j < b_count && b[j] == value)
+					out[count++] = value;
+			}
+			return count;
+		}
+
+		//branchless merge
+		u32 i = 0, j = 0;
+		while(i < a_count && j < b_count)
+		{
+			u16 x = a[i], y = b[j];
+			out[count] = x;
+			count += x == y;
+			i += x <= y;
+			j += y <= x;
+		}
+		return count;
+	}
+
+	inline static u32
+	_array_union(const u16* a, u32 a_count, const u16* b, u32 b_count, u16* out)
+	{
+		u32 i = 0, j = 0, count = 0;
+		while(i < a_count && j < b_count)
+		{
+			u16 x = a[i], y = b[j];
+			out[count++] = x < y ? x : y;
+			i += x <= y;
+			j += y <= x;
+		}
+		for(; i < a_count; ++i)
+			out[count++] = a[i];
+		for(; j < b_count; ++j)
+			out[count++] = b[j];
+		return count;
+	}
+
+	inline static u32
+	_array_difference(const u16* a, u32 a_count, const u16* b, u32 b_count, u16* out)
+	{
+		u32 i = 0, j = 0, count = 0;
+		while(i < a_count && j < b_count)
+		{
+			u16 x = a[i], y = b[j];
+			out[count] = x;
+			count += x < y;
+			i += x <= y;
+			j += y <= x;
+		}
+		for(; i < a_count; ++i)
+			out[count++] = a[i];
+		return count;
+	}
+
+
+	//section(container set operations)
+	//each returns false if the result is empty
+	inline static bool
+	_container_and(memory_context* context, const container_type& a_in, const container_type& b_in, container_type& out)
+	{
+		container_type a_temp, b_temp;
+		const container_type& a = _container_normal(context, a_in, a_temp);
+		const container_type& b = _container_normal(context, b_in, b_temp);
+
+		out = _container_make(a.key, container_type::ARRAY);
+		if(a.kind == container_type::BITMAP && b.kind == container_type::BITMAP)
+		{
+			u64* words = _bitmap_alloc(context, out);
+			out.kind = container_type::BITMAP;
+			for(usize i = 0; i < roaring_bitmap::bitmap_words; ++i)
+				words[i] = a.words[i] & b.words[i];
+			_bitmap_settle(context, out);
+		}
+		else if(a.kind == container_type::ARRAY && b.kind == container_type::ARRAY)
+		{
+			out.values = context->template alloc<u16>(a.size < b.size ? a.size : b.size);
+			_array_settle(context, out, _array_intersect(a.values.ptr, a.size, b.values.ptr, b.size, out.values.ptr));
+		}
+		else
+		{
+			const container_type& array = a.kind == container_type::ARRAY ? a : b;
+			const container_type& bitmap = a.kind == container_type::ARRAY ? b : a;
+			out.values = context->template alloc<u16>(array.size);
+			u32 count = 0;
+			for(u32 i = 0; i < array.size; ++i)
+			{
+				out.values[count] = array.values[i];
+				count += _bitmap_test(bitmap.words.ptr, array.values[i]);
+			}
+			_array_settle(context, out, count);
+		}
+
+		_container_free_normal(context, a_in, a_temp);
+		_container_free_normal(context, b_in, b_temp);
+		if(out.cardinality == 0)
+		{
+			_container_free(context, out);
+			return false;
+		}
+		return true;
+	}
+
+	inline static bool
+	_container_or(memory_context* context, const container_type& a_in, const container_type& b_in, container_type& out)
+	{
+		container_type a_temp, b_temp;
+		const container_type& a = _container_normal(context, a_in, a_temp);
+		const container_type& b = _container_normal(context, b_in, b_temp);
+
+		out = _container_make(a.key, container_type::ARRAY);
+		if(a.kind == container_type::ARRAY && b.kind == container_type::ARRAY &&
+		   a.size + b.size <= roaring_bitmap::array_limit)
+		{
+			out.values = context->template alloc<u16>(a.size + b.size);
+			_array_settle(context, out, _array_union(a.values.ptr, a.size, b.values.ptr, b.size, out.values.ptr));
+		}
+		else
+		{
+			u64* words = _bitmap_alloc(context, out);
+			out.kind = container_type::BITMAP;
+			for(const container_type* c: {&a, &b})
+			{
+				if(c->kind == container_type::BITMAP)
+				{
+					for(usize i = 0; i < roaring_bitmap::bitmap_words; ++i)
+						words[i] |= c->words[i];
+				}
+				else
+				{
+					for(u32 i = 0; i < c->size; ++i)
+						words[c->values[i] >> 6] |= u64(1) << (c->values[i] & 63);
+				}
+			}
+			_bitmap_settle(context, out);
+		}
+
+		_container_free_normal(context, a_in, a_temp);
+		_container_free_normal(context, b_in, b_temp);
+		return true;
+	}
+
+	inline static bool
+	_container_and_not(memory_context* context, const container_type& a_in, const container_type& b_in, container_type& out)
+	{
+		container_type a_temp, b_temp;
+		const container_type& a = _container_normal(context, a_in, a_temp);
+		const container_type& b = _container_normal(context, b_in, b_temp);
+
+		out = _container_make(a.key, container_type::ARRAY);
+		if(a.kind == container_type::ARRAY)
+		{
+			out.values = context->template alloc<u16>(a.size);
+			u32 count = 0;
+			if(b.kind == container_type::ARRAY)
+			{
+				count = _array_difference(a.values.ptr, a.size, b.values.ptr, b.size, out.values.ptr);
+			}
+			else
+			{
+				for(u32 i = 0; i < a.size; ++i)
+				{
+					out.values[count] = a.values[i];
+					count += !_bitmap_test(b.words.ptr, a.values[i]);
+				}
+			}
+			_array_settle(context, out, count);
+		}
+		else
+		{
+			u64* words = _bitmap_alloc(context, out);
+			out.kind = container_type::BITMAP;
+			if(b.kind == container_type::BITMAP)
+			{
+				for(usize i = 0; i < roaring_bitmap::bitmap_words; ++i)
+					words[i] = a.words[i] & ~b.words[i];
+			}
+			else
+			{
+				std::memcpy(words, a.words.ptr, out.words.size);
+				for(u32 i = 0; i < b.size; ++i)
+					words[b.values[i] >> 6] &= ~(u64(1) << (b.values[i] & 63));
+			}
+			_bitmap_settle(context, out);
+		}
+
+		_container_free_normal(context, a_in, a_temp);
+		_container_free_normal(context, b_in, b_temp);
+		if(out.cardinality == 0)
+		{
+			_container_free(context, out);
+			return false;
+		}
+		return true;
+	}
+
+
+	//section(roaring_bitmap)
+	roaring_bitmap::roaring_bitmap(memory_context* context)
+		:_containers(context), _context(context)
+	{}
+
+	roaring_bitmap::roaring_bitmap(const roaring_bitmap& other)
+		:roaring_bitmap(other, other._context)
+	{}
+
+	roaring_bitmap::roaring_bitmap(const roaring_bitmap& other, memory_context* context)
+		:_containers(context), _context(context)
+	{
+		_containers.reserve(other._containers.count());
+		for(const auto& c: other._containers)
+			_containers.insert_back(_container_copy(_context, c));
+	}
+
+	roaring_bitmap::roaring_bitmap(roaring_bitmap&& other)
+		:_containers(std::move(other._containers)), _context(other._context)
+	{
+		other._containers = dynamic_array<_container_type>(other._context);
+	}
+
+	roaring_bitmap&
+	roaring_bitmap::operator=(const roaring_bitmap& other)
+	{
+		if(this == &other)
+			return *this;
+
+		_reset();
+		_containers.reserve(other._containers.count());
+		for(const auto& c: other._containers)
+			_containers.insert_back(_container_copy(_context, c));
+		return *this;
+	}
+
+	roaring_bitmap&
+	roaring_bitmap::operator=(roaring_bitmap&& other)
+	{
+		_reset();
+		_containers = std::move(other._containers);
+		_context = other._context;
+		other._containers = dynamic_array<_container_type>(other._context);
+		return *this;
+	}
+
+	roaring_bitmap::~roaring_bitmap()
+	{
+		_reset();
+	}
+
+	bool
+	roaring_bitmap::insert(u32 value)
+	{
+		u16 key = u16(value >> 16), low = u16(value);
+		usize index = _find(key);
+		if(index == _containers.count() || _containers[index].key != key)
+		{
+			_containers.insert_back(_container_make(key, _container_type::ARRAY));
+			for(usize i = _containers.count() - 1; i > index; --i)
+				_containers[i] = _containers[i - 1];
+			_containers[index] = _container_make(key, _container_type::ARRAY);
+		}
+
+		_container_type& c = _containers[index];
+		if(c.kind == _container_type::RUN)
+		{
+			if(_run_contains(c, low))
+				return false;
+			_run_to_normal(_context, c);
+		}
+
+		if(c.kind == _container_type::ARRAY)
+		{
+			u32 position = _array_lower_bound(c.values.ptr, c.size, low);
+			if(position < c.size && c.values[position] == low)
+				return false;
+
+			if(c.size < array_limit)
+			{
+				_array_reserve(_context, c, c.size + 1);
+				std::memmove(c.values.ptr + position + 1, c.values.ptr + position, (c.size - position) * sizeof(u16));
+				c.values[position] = low;
+				++c.size;
+				++c.cardinality;
+				return true;
+			}
+			_array_to_bitmap(_context, c);
+		}
+
+		u64& word = c.words[low >> 6];
+		u64 bit = u64(1) << (low & 63);
+		if(word & bit)
+			return false;
+		word |= bit;
+		++c.cardinality;
+		return true;
+	}
+
+	bool
+	roaring_bitmap::remove(u32 value)
+	{
+		u16 key = u16(value >> 16), low = u16(value);
+		usize index = _find(key);
+		if(index == _containers.count() || _containers[index].key != key)
+			return false;
+
+		_container_type& c = _containers[index];
+		if(c.kind == _container_type::RUN)
+		{
+			if(!_run_contains(c, low))
+				return false;
+			_run_to_normal(_context, c);
+		}
+
+		if(c.kind == _container_type::ARRAY)
+		{
+			u32 position = _array_lower_bound(c.values.ptr, c.size, low);
+			if(position == c.size || c.values[position] != low)
+				return false;
+
+			std::memmove(c.values.ptr + position, c.values.ptr + position + 1, (c.size - position - 1) * sizeof(u16));
+			--c.size;
+			--c.cardinality;
+		}
+		else
+		{
+			u64& word = c.words[low >> 6];
+			u64 bit = u64(1) << (low & 63);
+			if(!(word & bit))
+				return false;
+			word &= ~bit;
+			--c.cardinality;
+
+			//half the limit so a chunk around the limit doesn't convert back and forth on every insert and remove
+			if(c.cardinality <= array_limit / 2)
+				_bitmap_to_array(_context, c);
+		}
+
+		if(c.cardinality == 0)
+		{
+			_container_free(_context, c);
+			for(usize i = index + 1; i < _containers.count(); ++i)
+				_containers[i - 1] = _containers[i];
+			_containers.remove_back();
+		}
+		return true;
+	}
+
+	bool
+	roaring_bitmap::contains(u32 value) const
+	{
+		u16 key = u16(value >> 16), low = u16(value);
+		usize index = _find(key);
+		if(index == _containers.count() || _containers[index].key != key)
+			return false;
+
+		const _container_type& c = _containers[index];
+		switch(c.kind)
+		{
+			case _container_type::ARRAY:
+			{
+				u32 position = _array_lower_bound(c.values.ptr, c.size, low);
+				return position < c.size && c.values[position] == low;
+			}
+			case _container_type::BITMAP:
+				return _bitmap_test(c.words.ptr, low);
+			default:
+				return _run_contains(c, low);
+		}
+	}
+
+	usize
+	roaring_bitmap::cardinality() const
+	{
+		usize result = 0;
+		for(const auto& c: _containers)
+			result += c.cardinality;
+		return result;
+	}
+
+	bool
+	roaring_bitmap::empty() const
+	{
+		return _containers.count() == 0;
+	}
+
+	void
+	roaring_bitmap::clear()
+	{
+		_reset();
+	}
+
+	void
+	roaring_bitmap::run_optimize()
+	{
+		for(auto& c: _containers)
+		{
+			if(c.kind == _container_type::RUN)
+				continue;
+
+			u32 runs_count;
+			usize size;
+			if(c.kind == _container_type::ARRAY)
+			{
+				runs_count = _array_runs_count(c);
+				size = c.size * sizeof(u16);
+			}
+			else
+			{
+				runs_count = _bitmap_runs_count(c);
+				size = bitmap_words * sizeof(u64);
+			}
+
+			if(runs_count * 2 * sizeof(u16) < size)
+				_container_to_run(_context, c, runs_count);
+		}
+	}
+
+	usize
+	roaring_bitmap::memory_size() const
+	{
+		usize result = _containers.capacity() * sizeof(_container_type);
+		for(const auto& c: _containers)
+			result += c.values.size + c.words.size;
+		return result;
+	}
+
+	roaring_bitmap&
+	roaring_bitmap::operator&=(const roaring_bitmap& other)
+	{
+		*this = *this & other;
+		return *this;
+	}
+
+	roaring_bitmap&
+	roaring_bitmap::operator|=(const roaring_bitmap& other)
+	{
+		dynamic_array<_container_type> result(_context);
+		result.reserve(_containers.count() + other._containers.count());
+
+		usize i = 0, j = 0;
+		while(i < _containers.count() || j < other._containers.count())
+		{
+			if(j == other._containers.count() ||
+			   (i < _containers.count() && _containers[i].key < other._containers[j].key))
+			{
+				//the containers only in this bitmap are moved as they are
+				result.insert_back(_containers[i]);
+				_containers[i].values = slice<u16>();
+				_containers[i].words = slice<u64>();
+				++i;
+			}
+			else if(i == _containers.count() || other._containers[j].key < _containers[i].key)
+			{
+				result.insert_back(_container_copy(_context, other._containers[j++]));
+			}
+			else
+			{
+				_container_type out;
+				_container_or(_context, _containers[i++], other._containers[j++], out);
+				result.insert_back(out);
+			}
+		}
+
+		_reset();
+		_containers = std::move(result);
+		return *this;
+	}
+
+	roaring_bitmap&
+	roaring_bitmap::and_not(const roaring_bitmap& other)
+	{
+		dynamic_array<_container_type> result(_context);
+		result.reserve(_containers.count());
+
+		usize j = 0;
+		for(usize i = 0; i < _containers.count(); ++i)
+		{
+			while(j < other._containers.count() && other._containers[j].key < _containers[i].key)
+				++j;
+
+			if(j < other._containers.count() && other._containers[j].key == _containers[i].key)
+			{
+				_container_type out;
+				if(_container_and_not(_context, _containers[i], other._containers[j], out))
+					result.insert_back(out);
+			}
+			else
+			{
+				result.insert_back(_containers[i]);
+				_containers[i].values = slice<u16>();
+				_containers[i].words = slice<u64>();
+			}
+		}
+
+		_reset();
+		_containers = std::move(result);
+		return *this;
+	}
+
+	bool
+	roaring_bitmap::operator==(const roaring_bitmap& other) const
+	{
+		if(_containers.count() != other._containers.count() || cardinality() != other.cardinality())
+			return false;
+
+		for(auto it = begin(), other_it = other.begin(); it != end(); ++it, ++other_it)
+			if(*it != *other_it)
+				return false;
+		return true;
+	}
+
+	bool
+	roaring_bitmap::operator!=(const roaring_bitmap& other) const
+	{
+		return !operator==(other);
+	}
+
+	roaring_bitmap::const_iterator
+	roaring_bitmap::begin() const
+	{
+		const_iterator result{this, 0, 0, 0};
+		result._load_first();
+		return result;
+	}
+
+	roaring_bitmap::const_iterator
+	roaring_bitmap::cbegin() const
+	{
+		return begin();
+	}
+
+	roaring_bitmap::const_iterator
+	roaring_bitmap::end() const
+	{
+		return const_iterator{this, _containers.count(), 0, 0};
+	}
+
+	roaring_bitmap::const_iterator
+	roaring_bitmap::cend() const
+	{
+		return end();
+	}
+
+	usize
+	roaring_bitmap::_find(u16 key) const
+	{
+		usize low = 0, high = _containers.count();
+		while(low < high)
+		{
+			usize mid = low + (high - low) / 2;
+			if(_containers[mid].key < key)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low;
+	}
+
+	void
+	roaring_bitmap::_reset()
+	{
+		for(auto& c: _containers)
+			_container_free(_context, c);
+		_containers.clear();
+	}
+
+
+	//section(const_iterator)
+	roaring_bitmap::const_iterator&
+	roaring_bitmap::const_iterator::operator++()
+	{
+		const _container_type& c = _bitmap->_containers[_container];
+		u32 high = _value & 0xFFFF0000;
+		u32 low = _value & 0xFFFF;
+		switch(c.kind)
+		{
+			case _container_type::ARRAY:
+				if(++_index < c.size)
+				{
+					_value = high | c.values[_index];
+					return *this;
+				}
+				break;
+
+			case _container_type::BITMAP:
+				low = _bitmap_next(c.words.ptr, low + 1);
+				if(low < _chunk_values)
+				{
+					_value = high | low;
+					return *this;
+				}
+				break;
+
+			default:
+				if(low < u32(c.values[_index * 2]) + c.values[_index * 2 + 1])
+				{
+					++_value;
+					return *this;
+				}
+				if(++_index < c.size)
+				{
+					_value = high | c.values[_index * 2];
+					return *this;
+				}
+				break;
+		}
+
+		++_container;
+		_load_first();
+		return *this;
+	}
+
+	roaring_bitmap::const_iterator
+	roaring_bitmap::const_iterator::operator++(int)
+	{
+		auto result = *this;
+		++(*this);
+		return result;
+	}
+
+	bool
+	roaring_bitmap::const_iterator::operator==(const const_iterator& other) const
+	{
+		return _container == other._container && _value == other._value;
+	}
+
+	bool
+	roaring_bitmap::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return !operator==(other);
+	}
+
+	void
+	roaring_bitmap::const_iterator::_load_first()
+	{
+		_index = 0;
+		if(_container == _bitmap->_containers.count())
+		{
+			_value = 0;
+			return;
+		}
+
+		const _container_type& c = _bitmap->_containers[_container];
+		u32 high = u32(c.key) << 16;
+		if(c.kind == _container_type::BITMAP)
+			_value = high | _bitmap_next(c.words.ptr, 0);
+		else
+			_value = high | c.values[0];
+	}
+
+
+	//section(operators)
+	roaring_bitmap
+	operator&(const roaring_bitmap& a, const roaring_bitmap& b)
+	{
+		roaring_bitmap result(a._context);
+		usize i = 0, j = 0;
+		while(i < a._containers.count() && j < b._containers.count())
+		{
+			const container_type& x = a._containers[i];
+			const container_type& y = b._containers[j];
+			if(x.key < y.key)
+			{
+				++i;
+			}
+			else if(y.key < x.key)
+			{
+				++j;
+			}
+			else
+			{
+				container_type out;
+				if(_container_and(result._context, x, y, out))
+					result._containers.insert_back(out);
+				++i;
+				++j;
+			}
+		}
+		return result;
+	}
+
+	roaring_bitmap
+	operator|(const roaring_bitmap& a, const roaring_bitmap& b)
+	{
+		roaring_bitmap result(a);
+		result |= b;
+		return result;
+	}
+
+
+	//section(serialization)
+	//checks the read values keep the container invariants
+	inline static bool
+	_container_valid(const container_type& c)
+	{
+		if(c.kind == container_type::BITMAP)
+			return details::popcount_words(c.words.ptr, roaring_bitmap::bitmap_words) == c.cardinality;
+
+		if(c.kind == container_type::ARRAY)
+		{
+			for(u32 i = 1; i < c.size; ++i)
+				if(c.values[i - 1] >= c.values[i])
+					return false;
+			return true;
+		}
+
+		//the runs must be sorted and apart from each other and sum up to the cardinality
+		u32 cardinality = 0;
+		for(u32 i = 0; i < c.size; ++i)
+		{
+			u32 start = c.values[i * 2], last = start + c.values[i * 2 + 1];
+			if(last >= _chunk_values || (i > 0 && start <= u32(c.values[i * 2 - 2]) + c.values[i * 2 - 1] + 1))
+				return false;
+			cardinality += last - start + 1;
+		}
+		return cardinality == c.cardinality;
+	}
+
+	usize
+	print_bin(io_trait *trait, const roaring_bitmap& bitmap)
+	{
+		usize result = 0;
+		result += print_bin(trait, _roaring_cookie);
+		result += print_bin(trait, u32(bitmap._containers.count()));
+		for(const auto& c: bitmap._containers)
+		{
+			result += print_bin(trait, c.key);
+			result += print_bin(trait, u8(c.kind));
+			result += print_bin(trait, c.size);
+			result += print_bin(trait, c.cardinality);
+			if(c.kind == container_type::BITMAP)
+				result += print_bin(trait, c.words);
+			else
+				result += print_bin(trait, c.values.view(0, _container_values_count(c)));
+		}
+		return result;
+	}
+
+	usize
+	scan_bin(io_trait *trait, roaring_bitmap& bitmap)
+	{
+		bitmap.clear();
+
+		usize result = 0;
+		u32 cookie = 0, count = 0;
+		result += scan_bin(trait, cookie);
+		result += scan_bin(trait, count);
+		if(cookie != _roaring_cookie || result != sizeof(u32) * 2)
+			return result;
+
+		//there's at most a container per value of the high 16 bits so a bigger count is corrupt
+		//and it's checked before reserving so a corrupt header can't ask for gigabytes
+		if(count > _chunk_values)
+			return result;
+
+		bitmap._containers.reserve(count);
+		for(u32 i = 0; i < count; ++i)
+		{
+			u16 key = 0;
+			u8 kind = 0;
+			u32 size = 0, cardinality = 0;
+			usize header_size = 0;
+			header_size += scan_bin(trait, key);
+			header_size += scan_bin(trait, kind);
+			header_size += scan_bin(trait, size);
+			header_size += scan_bin(trait, cardinality);
+			result += header_size;
+
+			bool valid = header_size == sizeof(key) + sizeof(kind) + sizeof(size) + sizeof(cardinality);
+			valid &= bitmap.empty() || bitmap._containers[bitmap._containers.count() - 1].key < key;
+			switch(kind)
+			{
+				case container_type::ARRAY:
+					valid &= size > 0 && size <= roaring_bitmap::array_limit && cardinality == size;
+					break;
+				case container_type::BITMAP:
+					valid &= size == 0 && cardinality > 0 && cardinality <= _chunk_values;
+					break;
+				case container_type::RUN:
+					valid &= size > 0 && size <= _chunk_values / 2 && cardinality > 0 && cardinality <= _chunk_values;
+					break;
+				default:
+					valid = false;
+					break;
+			}
+			if(!valid)
+			{
+				bitmap.clear();
+				return result;
+			}
+
+			container_type c = _container_make(key, container_type::kind_type(kind));
+			c.size = size;
+			c.cardinality = cardinality;
+			usize expected_size, read_size;
+			if(c.kind == container_type::BITMAP)
+			{
+				c.words = bitmap._context->template alloc<u64>(roaring_bitmap::bitmap_words);
+				expected_size = c.words.size;
+				read_size = scan_bin(trait, c.words);
+			}
+			else
+			{
+				c.values = bitmap._context->template alloc<u16>(_container_values_count(c));
+				expected_size = c.values.size;
+				read_size = scan_bin(trait, c.values);
+			}
+			result += read_size;
+			bitmap._containers.insert_back(c);
+
+			if(read_size != expected_size || !_container_valid(c))
+			{
+				bitmap.clear();
+				return result;
+			}
+		}
+		return result;
+	}
+}
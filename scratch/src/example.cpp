@@ -1,49 +1,28 @@
 // #include <iostream>
 // #include <thread>
-// #include <cpprelude/queue_array.h>
-// #include <cpprelude/threading.h>
+// #include <cpprelude/mpmc_queue.h>
 // using namespace cpprelude;
 //
-// void producer(thread_unique<queue_array<i32>>* production_queue, i32 limit)
+// void producer(mpmc_queue<i32>* production_queue, i32 limit)
 // {
-// 	thread_context context = production_queue->new_context();
 // 	while(limit--)
-// 	{
-// 		if(production_queue->write(context))
-// 		{
-// 			production_queue->value.enqueue(limit);
-// 			production_queue->write_release(context);
-// 		}
-// 	}
+// 		production_queue->enqueue(limit);
 // }
 //
-// void consumer(thread_unique<queue_array<i32>>* production_queue, i32 limit)
+// void consumer(mpmc_queue<i32>* production_queue, i32 limit)
 // {
-// 	thread_context context = production_queue->new_context();
-// 	while(limit)
+// 	i32 value;
+// 	while(limit--)
 // 	{
-// 		if(production_queue->write(context))
-// 		{
-// 			if(!production_queue->value.empty())
-// 			{
-// 				std::cout << "consumed: " << production_queue->value.front() << std::endl;
-// 				production_queue->value.dequeue();
-// 				limit--;
-// 			}
-// 			else
-// 			{
-// 				std::cout << "nothing!" << std::endl;
-// 			}
-//
-// 			production_queue->write_release(context);
-// 		}
+// 		production_queue->dequeue(value);
+// 		std::cout << "consumed: " << value << std::endl;
 // 	}
 // }
 //
 // int
 // main(int argc, char** argv)
 // {
-// 	thread_unique<queue_array<i32>> production_queue;
+// 	mpmc_queue<i32> production_queue(256);
 //
 // 	std::thread p1(producer, &production_queue, 1000);
 // 	std::thread p2(producer, &production_queue, 1000);
@@ -56,6 +35,6 @@
 // 	c1.join();
 // 	c2.join();
 //
-// 	std::cout << (production_queue.value.empty() ? "queue is empty" : "oops! not empty queue") << std::endl;
+// 	std::cout << (production_queue.empty() ? "queue is empty" : "oops! not empty queue") << std::endl;
 // 	return 0;
 // }
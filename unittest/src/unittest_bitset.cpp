@@ -0,0 +1,162 @@
+#include "catch.hpp"
+#include <cpprelude/bitset.h>
+
+using namespace cpprelude;
+
+TEST_CASE("dynamic_bitset test", "[dynamic_bitset]")
+{
+	SECTION("Case 01")
+	{
+		dynamic_bitset bits;
+		CHECK(bits.empty());
+		CHECK(bits.find_first() == 0);
+
+		for(usize i = 0; i < 200; ++i)
+			bits.insert_back(i % 3 == 0);
+		CHECK(bits.count() == 200);
+		CHECK(bits.popcount() == 67);
+		CHECK(bits[3]);
+		CHECK(!bits[4]);
+
+		bits.flip(4);
+		bits.reset(3);
+		bits.set(5, true);
+		bits.set(6, false);
+		CHECK(bits.test(4));
+		CHECK(!bits.test(3));
+		CHECK(bits.test(5));
+		CHECK(!bits.test(6));
+
+		bits.remove_back();
+		CHECK(bits.count() == 199);
+		CHECK(bits.popcount() == 67);
+
+		bits.flip_all();
+		CHECK(bits.popcount() == 199 - 67);
+		bits.set_all();
+		CHECK(bits.all());
+		CHECK(bits.popcount() == 199);
+		bits.reset_all();
+		CHECK(bits.none());
+		CHECK(!bits.any());
+	}
+
+	SECTION("Case 02")
+	{
+		dynamic_bitset bits(130, true);
+		CHECK(bits.popcount() == 130);
+		CHECK(bits.all());
+
+		//shrinking then growing back must not bring the dropped bits back
+		bits.resize(70);
+		bits.resize(140);
+		CHECK(bits.popcount() == 70);
+		CHECK(!bits.test(70));
+		bits.resize(300, true);
+		CHECK(bits.popcount() == 70 + 160);
+		CHECK(bits.test(139) == false);
+		CHECK(bits.test(140));
+
+		bits.clear();
+		CHECK(bits.empty());
+		bits.resize(10);
+		CHECK(bits.none());
+
+		bits.shrink_to_fit();
+		CHECK(bits.capacity() == 64);
+	}
+
+	SECTION("Case 03")
+	{
+		dynamic_bitset a(300), b(200);
+		for(usize i = 0; i < 300; i += 2)
+			a.set(i);
+		for(usize i = 0; i < 200; i += 3)
+			b.set(i);
+
+		dynamic_bitset c = a;
+		c &= b;
+		CHECK(c.count() == 300);
+		CHECK(c.popcount() == 34);
+
+		c = a;
+		c |= b;
+		CHECK(c.popcount() == 150 + 67 - 34);
+
+		c = a;
+		c ^= b;
+		CHECK(c.popcount() == 150 + 67 - 2 * 34);
+
+		c = a;
+		c.and_not(b);
+		CHECK(c.popcount() == 150 - 34);
+
+		//a longer other bitset doesn't leak bits past the count
+		dynamic_bitset d(100);
+		d |= a;
+		CHECK(d.popcount() == 50);
+		d.flip_all();
+		d ^= a;
+		CHECK(d.all());
+
+		dynamic_bitset e(std::move(c));
+		CHECK(e.popcount() == 150 - 34);
+		CHECK(e != a);
+		e = a;
+		CHECK(e == a);
+	}
+
+	SECTION("Case 04")
+	{
+		dynamic_bitset bits(1000);
+		usize positions[] = {0, 63, 64, 65, 500, 999};
+		for(auto position: positions)
+			bits.set(position);
+
+		usize found = 0;
+		bool in_order = true;
+		for(usize i = bits.find_first(); i < bits.count(); i = bits.find_next(i))
+			in_order &= positions[found++] == i;
+		CHECK(in_order);
+		CHECK(found == 6);
+		CHECK(bits.find_next(999) == 1000);
+		CHECK(bits.find_next(65) == 500);
+	}
+
+	SECTION("Case 05")
+	{
+		//rank and select against a plain scan
+		dynamic_bitset bits(100000);
+		u64 seed = 88172645463325252ULL;
+		for(usize i = 0; i < bits.count(); ++i)
+		{
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			//dense and sparse runs
+			if(seed % ((i / 10000) % 2 ? 97 : 3) == 0)
+				bits.set(i);
+		}
+
+		bitset_rank_index index(bits);
+		CHECK(index.popcount() == bits.popcount());
+
+		bool ranks_match = true;
+		bool selects_match = true;
+		usize rank = 0;
+		for(usize i = 0; i < bits.count(); ++i)
+		{
+			ranks_match &= index.rank(i) == rank;
+			if(bits.test(i))
+				selects_match &= index.select(rank++) == i;
+		}
+		ranks_match &= index.rank(bits.count()) == rank;
+		CHECK(ranks_match);
+		CHECK(selects_match);
+
+		dynamic_bitset empty;
+		index.build(empty);
+		CHECK(index.popcount() == 0);
+		CHECK(index.rank(0) == 0);
+	}
+}
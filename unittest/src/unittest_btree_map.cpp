@@ -0,0 +1,188 @@
+#include "catch.hpp"
+#include <cpprelude/btree_map.h>
+#include <cpprelude/tree_map.h>
+#include <cpprelude/algorithm.h>
+#include <cpprelude/dynamic_array.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+TEST_CASE("btree_map test", "[btree_map]")
+{
+	SECTION("Case 01")
+	{
+		btree_set<i32, default_less_than<i32>, 4> tree;
+		for(i32 i = 0; i < 100; ++i)
+		{
+			tree.insert(i);
+			CHECK(tree._is_b_tree());
+		}
+		CHECK(tree.count() == 100);
+
+		i32 expected = 0;
+		for(const auto& value: tree)
+			CHECK(value == expected++);
+		CHECK(expected == 100);
+
+		for(i32 i = 0; i < 100; ++i)
+			CHECK(tree.lookup(i) != tree.end());
+		CHECK(tree.lookup(100) == tree.end());
+		CHECK(tree.lookup(-1) == tree.end());
+	}
+
+	SECTION("Case 02")
+	{
+		btree_set<usize, default_less_than<usize>, 4> tree;
+		for(usize i = 100; i > 0; --i)
+			tree.insert(i);
+		tree.insert(50);
+		CHECK(tree.count() == 100);
+		CHECK(tree._is_b_tree());
+
+		for(usize i = 1; i <= 100; i += 2)
+		{
+			tree.remove(i);
+			CHECK(tree._is_b_tree());
+		}
+		CHECK(tree.count() == 50);
+		CHECK(*tree.min() == 2);
+		CHECK(*tree.max() == 100);
+
+		for(usize i = 2; i <= 100; i += 2)
+		{
+			tree.remove(i);
+			CHECK(tree._is_b_tree());
+		}
+		CHECK(tree.empty());
+		CHECK(tree.begin() == tree.end());
+	}
+
+	SECTION("Case 03")
+	{
+		btree_set<u32> tree;
+		dynamic_array<u32> reference;
+
+		u32 seed = 7;
+		for(usize i = 0; i < 5000; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			u32 value = seed % 100000;
+			if(tree.lookup(value) == tree.end())
+				reference.insert_back(value);
+			tree.insert(value);
+		}
+		CHECK(tree._is_b_tree());
+		CHECK(tree.count() == reference.count());
+
+		quick_sort(reference.begin(), reference.count());
+		usize i = 0;
+		for(const auto& value: tree)
+			CHECK(value == reference[i++]);
+
+		//remove the first half in random order
+		for(usize j = 0; j < reference.count(); j += 2)
+			tree.remove(reference[j]);
+		CHECK(tree._is_b_tree());
+		CHECK(tree.count() == reference.count() / 2);
+
+		for(usize j = 0; j < reference.count(); ++j)
+		{
+			if(j % 2 == 0)
+				CHECK(tree.lookup(reference[j]) == tree.end());
+			else
+				CHECK(tree.lookup(reference[j]) != tree.end());
+		}
+	}
+
+	SECTION("Case 04")
+	{
+		btree_map<string, usize> map;
+		map["mostafa"] = 1;
+		map["nora"] = 2;
+		map["ahmed"] = 3;
+		map.insert("zeyad", 4);
+		map.insert("nora", 5);
+
+		CHECK(map.count() == 4);
+		CHECK(map["nora"] == 2);
+		CHECK(map.lookup("ahmed").value() == 3);
+		CHECK(*map.begin() == "ahmed");
+		CHECK(map.lookup("foo") == map.end());
+
+		map.remove("ahmed");
+		CHECK(map.count() == 3);
+		CHECK(*map.begin() == "mostafa");
+
+		auto copy = map;
+		CHECK(copy.count() == 3);
+		CHECK(copy["zeyad"] == 4);
+	}
+
+	SECTION("Case 05")
+	{
+		btree_map<i64, i64, default_less_than<i64>, 8> map;
+		for(i64 i = 0; i < 1000; i += 10)
+			map.insert(i, i * 2);
+
+		auto it = map.lower_bound(35);
+		CHECK(*it == 40);
+		CHECK(it.value() == 80);
+
+		it = map.lower_bound(40);
+		CHECK(*it == 40);
+
+		it = map.upper_bound(40);
+		CHECK(*it == 50);
+
+		CHECK(map.lower_bound(991) == map.end());
+		CHECK(map.upper_bound(990) == map.end());
+
+		//range scan
+		i64 sum = 0;
+		for(auto it = map.lower_bound(100); it != map.upper_bound(200); ++it)
+			sum += *it;
+		CHECK(sum == 100 + 110 + 120 + 130 + 140 + 150 + 160 + 170 + 180 + 190 + 200);
+
+		for(auto it = map.begin(); it != map.end(); ++it)
+			it.value() = 0;
+		for(auto it = map.begin(); it != map.end(); ++it)
+			CHECK(it.value() == 0);
+
+		auto last = map.max();
+		--last;
+		CHECK(*last == 980);
+	}
+
+	SECTION("Case 06")
+	{
+		btree_set<i32, default_less_than<i32>, 5> tree;
+		tree_set<i32> reference;
+
+		u32 seed = 13;
+		for(usize i = 0; i < 4000; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			i32 value = static_cast<i32>(seed % 512) - 256;
+			if(seed & 0x10000)
+			{
+				tree.insert(value);
+				reference.insert(value);
+			}
+			else
+			{
+				tree.remove(value);
+				reference.remove(value);
+			}
+		}
+
+		CHECK(tree._is_b_tree());
+		CHECK(tree.count() == reference.count());
+
+		auto ref_it = reference.begin();
+		for(const auto& value: tree)
+		{
+			CHECK(value == *ref_it);
+			++ref_it;
+		}
+	}
+}
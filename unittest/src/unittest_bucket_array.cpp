@@ -1,8 +1,34 @@
 #include "catch.hpp"
 #include <cpprelude/bucket_array.h>
+#include <cpprelude/string.h>
 
 using namespace cpprelude;
 
+namespace
+{
+	//forwards to the global memory and counts the allocations
+	struct counting_memory
+	{
+		usize allocations = 0;
+		memory_context context;
+
+		counting_memory()
+		{
+			context._self = this;
+			context._alloc = [](void* self, usize size) {
+				++reinterpret_cast<counting_memory*>(self)->allocations;
+				return platform->global_memory->_alloc(platform->global_memory->_self, size);
+			};
+			context._realloc = [](void* self, slice<byte>& data, usize size) {
+				platform->global_memory->_realloc(platform->global_memory->_self, data, size);
+			};
+			context._free = [](void* self, slice<byte>& data) {
+				platform->global_memory->_free(platform->global_memory->_self, data);
+			};
+		}
+	};
+}
+
 TEST_CASE("bucket_array test", "[bucket_array]")
 {
 	bucket_array<i32> array;
@@ -510,4 +536,74 @@ TEST_CASE("bucket_array test", "[bucket_array]")
 		for (auto number : array)
 			CHECK(number == i++);
 	}
-}
\ No newline at end of file
+
+	SECTION("Case 29")
+	{
+		counting_memory memory;
+		{
+			bucket_array<i32> queue(&memory.context);
+			CHECK(memory.allocations == 0);
+
+			queue.insert_back(0);
+			//the map and one small bucket
+			CHECK(memory.allocations == 2);
+			CHECK(queue.capacity() == 16);
+
+			for(i32 i = 1; i < 100; ++i)
+				queue.insert_back(i);
+
+			//after warming up a steady stream of queue traffic recycles the buckets
+			usize allocations = 0;
+			for(i32 i = 100; i < 100000; ++i)
+			{
+				if(i == 1000)
+					allocations = memory.allocations;
+				CHECK(*queue.front() == i - 100);
+				queue.remove_front();
+				queue.insert_back(i);
+			}
+			CHECK(memory.allocations == allocations);
+			CHECK(queue.count() == 100);
+
+			usize i = 0;
+			for(auto value: queue)
+				CHECK(value == i32(99900 + i++));
+			for(i = 0; i < queue.count(); i += 7)
+				CHECK(queue[i] == i32(99900 + i));
+		}
+	}
+
+	SECTION("Case 30")
+	{
+		bucket_array<string, 8> strings;
+		for(i32 i = 0; i < 50; ++i)
+		{
+			strings.insert_back(string("back"));
+			strings.emplace_front("front");
+		}
+		CHECK(strings.count() == 100);
+		CHECK(strings[0] == "front");
+		CHECK(strings[49] == "front");
+		CHECK(strings[50] == "back");
+		CHECK(strings[99] == "back");
+
+		strings.remove_back(50);
+		strings.remove_front(25);
+		usize capacity = strings.capacity();
+		strings.shrink_to_fit();
+		CHECK(strings.capacity() < capacity);
+		CHECK(strings.capacity() >= strings.count());
+		CHECK(strings.count() == 25);
+		for(const auto& value: strings)
+			CHECK(value == "front");
+
+		strings.insert_back({"a", "b"});
+		CHECK(*strings.back() == "b");
+
+		strings.clear();
+		strings.shrink_to_fit();
+		CHECK(strings.capacity() == 0);
+		strings.insert_front(string("again"));
+		CHECK(*strings.front() == "again");
+	}
+}
@@ -0,0 +1,246 @@
+#include "catch.hpp"
+#include <cpprelude/cache.h>
+#include <cpprelude/string.h>
+#include <thread>
+
+using namespace cpprelude;
+
+TEST_CASE("bounded_cache test", "[bounded_cache]")
+{
+	SECTION("Case 01")
+	{
+		bounded_cache<i32, i32> cache(3);
+		CHECK(cache.empty());
+		CHECK(cache.get(1) == nullptr);
+
+		cache.put(1, 10);
+		cache.put(2, 20);
+		cache.put(3, 30);
+		CHECK(*cache.get(1) == 10);
+
+		//2 is the least recently used now
+		cache.put(4, 40);
+		CHECK(cache.count() == 3);
+		CHECK(!cache.contains(2));
+		CHECK(cache.contains(1));
+		CHECK(cache.contains(3));
+
+		i32 value = 0;
+		CHECK(cache.get(4, value));
+		CHECK(value == 40);
+
+		//updating doesn't add an entry
+		cache.put(3, 33);
+		CHECK(*cache.peek(3) == 33);
+		CHECK(cache.count() == 3);
+
+		CHECK(cache.remove(1));
+		CHECK(!cache.remove(1));
+		CHECK(cache.count() == 2);
+
+		auto stats = cache.stats();
+		CHECK(stats.hits == 2);
+		CHECK(stats.misses == 1);
+		CHECK(stats.insertions == 4);
+		CHECK(stats.evictions == 1);
+
+		cache.clear();
+		CHECK(cache.empty());
+		cache.reset_stats();
+		CHECK(cache.stats().hits == 0);
+	}
+
+	SECTION("Case 02")
+	{
+		//byte budget with weighted entries
+		bounded_cache<i32, string> cache(100);
+		CHECK(cache.put(1, string("a"), 40));
+		CHECK(cache.put(2, string("b"), 40));
+		CHECK(!cache.put(3, string("c"), 101));
+		CHECK(cache.weight() == 80);
+
+		CHECK(cache.put(3, string("c"), 50));
+		CHECK(cache.weight() == 90);
+		CHECK(!cache.contains(1));
+		CHECK(cache.contains(2));
+
+		//growing an entry evicts the others
+		CHECK(cache.put(3, string("cc"), 70));
+		CHECK(cache.weight() == 70);
+		CHECK(cache.count() == 1);
+		CHECK(*cache.get(3) == "cc");
+	}
+
+	SECTION("Case 03")
+	{
+		//clock gives used entries a second chance
+		bounded_cache<i32, i32, CACHE_POLICY::CLOCK> cache(3);
+		cache.put(1, 1);
+		cache.put(2, 2);
+		cache.put(3, 3);
+		cache.get(1);
+		cache.put(4, 4);
+		CHECK(cache.contains(1));
+		CHECK(!cache.contains(2));
+		cache.put(5, 5);
+		CHECK(!cache.contains(3));
+		CHECK(cache.count() == 3);
+	}
+
+	SECTION("Case 04")
+	{
+		//a scan over cold keys doesn't flush the frequently used keys out of arc but it does out of lru
+		bounded_cache<i32, i32, CACHE_POLICY::ARC> arc(100);
+		bounded_cache<i32, i32> lru(100);
+
+		for(i32 key = 0; key < 50; ++key)
+		{
+			arc.put(key, key);
+			lru.put(key, key);
+			arc.get(key);
+			lru.get(key);
+		}
+
+		usize arc_hot_hits = 0, lru_hot_hits = 0;
+		for(i32 round = 0; round < 5; ++round)
+		{
+			for(i32 key = 0; key < 200; ++key)
+			{
+				i32 cold = 1000 + round * 200 + key;
+				if(!arc.get(cold))
+					arc.put(cold, cold);
+				if(!lru.get(cold))
+					lru.put(cold, cold);
+			}
+			for(i32 key = 0; key < 50; ++key)
+			{
+				if(arc.get(key))
+					++arc_hot_hits;
+				else
+					arc.put(key, key);
+				if(lru.get(key))
+					++lru_hot_hits;
+				else
+					lru.put(key, key);
+			}
+		}
+
+		CHECK(arc.count() <= 100);
+		CHECK(arc.weight() <= 100);
+		CHECK(arc_hot_hits == 250);
+		CHECK(lru_hot_hits == 0);
+	}
+
+	SECTION("Case 05")
+	{
+		//random operations against the capacity and the stats invariants of every policy
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		bounded_cache<u32, string> lru(500);
+		bounded_cache<u32, string, CACHE_POLICY::CLOCK> clock(500);
+		bounded_cache<u32, string, CACHE_POLICY::ARC> arc(500);
+
+		bool valid = true;
+		for(usize i = 0; i < 50000; ++i)
+		{
+			u32 key = u32(random() % 2000);
+			usize weight = 1 + random() % 8;
+			switch(random() % 4)
+			{
+				case 0:
+					lru.remove(key);
+					clock.remove(key);
+					arc.remove(key);
+					break;
+				case 1:
+				{
+					string* value = lru.get(key);
+					valid &= value == nullptr || *value == "value";
+					value = clock.get(key);
+					valid &= value == nullptr || *value == "value";
+					value = arc.get(key);
+					valid &= value == nullptr || *value == "value";
+					break;
+				}
+				default:
+					lru.put(key, string("value"), weight);
+					clock.put(key, string("value"), weight);
+					arc.put(key, string("value"), weight);
+					break;
+			}
+			valid &= lru.weight() <= 500 && clock.weight() <= 500 && arc.weight() <= 500;
+		}
+		CHECK(valid);
+		CHECK(lru.stats().insertions - lru.stats().evictions >= lru.count());
+		CHECK(arc.stats().insertions - arc.stats().evictions >= arc.count());
+	}
+
+	SECTION("Case 06")
+	{
+		sharded_cache<u32, u32, CACHE_POLICY::LRU> cache(4096);
+		constexpr usize threads_count = 4;
+		std::thread threads[threads_count];
+		std::atomic<bool> valid(true);
+		for(usize t = 0; t < threads_count; ++t)
+		{
+			threads[t] = std::thread([&cache, &valid, t]() {
+				u64 seed = 88172645463325252ULL + t;
+				for(usize i = 0; i < 50000; ++i)
+				{
+					seed ^= seed << 13;
+					seed ^= seed >> 7;
+					seed ^= seed << 17;
+					u32 key = u32(seed % 8192);
+					u32 value = 0;
+					if(cache.get(key, value))
+					{
+						if(value != key * 2)
+							valid = false;
+					}
+					else
+					{
+						cache.put(key, key * 2);
+					}
+				}
+			});
+		}
+		for(auto& thread: threads)
+			thread.join();
+
+		CHECK(valid.load());
+		auto stats = cache.stats();
+		CHECK(stats.hits + stats.misses == threads_count * 50000);
+		CHECK(cache.count() <= 4096);
+		CHECK(cache.count() > 0);
+
+		//the keys spread over all the shards
+		usize used_shards = 0;
+		for(usize i = 0; i < cache._shards.count(); ++i)
+			used_shards += cache._shards[i].cache.count() > 0 ? 1 : 0;
+		CHECK(used_shards == 16);
+		for(usize i = 0; i < cache._shards.count(); ++i)
+			CHECK(reinterpret_cast<usize>(&cache._shards[i]) % 64 == 0);
+
+		//the shards add up to the requested capacity
+		sharded_cache<u32, u32, CACHE_POLICY::LRU, hash<u32>, 4> odd(10);
+		CHECK(odd._shards[0].cache.capacity() == 3);
+		CHECK(odd._shards[1].cache.capacity() == 3);
+		CHECK(odd._shards[3].cache.capacity() == 2);
+		for(u32 i = 0; i < 1000; ++i)
+			odd.put(i, i);
+		CHECK(odd.count() == 10);
+
+		cache.put(u32(10000), u32(1));
+		CHECK(cache.contains(10000));
+		CHECK(cache.remove(10000));
+		CHECK(!cache.contains(10000));
+		cache.clear();
+		CHECK(cache.count() == 0);
+	}
+}
@@ -0,0 +1,165 @@
+#include "catch.hpp"
+#include <cpprelude/concurrent_map.h>
+#include <cpprelude/tree_map.h>
+#include <cpprelude/algorithm.h>
+#include <cpprelude/string.h>
+#include <thread>
+#include <atomic>
+
+using namespace cpprelude;
+
+TEST_CASE("concurrent_map test", "[concurrent_map]")
+{
+	SECTION("Case 01")
+	{
+		concurrent_map<i32, i32> map;
+		CHECK(map.empty());
+
+		for(i32 i = 0; i < 1000; ++i)
+			map.insert((i * 7919) % 1000, i);
+		CHECK(map.count() == 1000);
+
+		i32 expected = 0;
+		for(auto it = map.begin(); it != map.end(); ++it)
+			CHECK(*it == expected++);
+		CHECK(expected == 1000);
+
+		CHECK(map.lookup(500) != map.end());
+		CHECK(map.lookup(1000) == map.end());
+		CHECK(map.lookup(-1) == map.end());
+
+		//inserting an existing key keeps the old value
+		auto old_value = map.lookup(10).value();
+		map.insert(10, -1);
+		CHECK(map.lookup(10).value() == old_value);
+
+		for(i32 i = 0; i < 1000; i += 2)
+			CHECK(map.remove(i));
+		CHECK(map.remove(0) == false);
+		CHECK(map.count() == 500);
+
+		expected = 1;
+		for(auto it = map.begin(); it != map.end(); ++it)
+		{
+			CHECK(*it == expected);
+			expected += 2;
+		}
+	}
+
+	SECTION("Case 02")
+	{
+		concurrent_map<string, usize> map;
+		map["mostafa"] = 1;
+		map["nora"] = 2;
+		map.insert("ahmed", 3);
+		map["mostafa"] += 10;
+
+		CHECK(map.count() == 3);
+		CHECK(map["mostafa"] == 11);
+		CHECK(*map.begin() == "ahmed");
+		CHECK(*map.lower_bound("b") == "mostafa");
+		CHECK(*map.upper_bound("mostafa") == "nora");
+		CHECK(map.upper_bound("nora") == map.end());
+
+		map.clear();
+		CHECK(map.empty());
+		CHECK(map.begin() == map.end());
+	}
+
+	SECTION("Case 03")
+	{
+		concurrent_map<u32, u32> map;
+		constexpr u32 threads_count = 4;
+		constexpr u32 per_thread = 4000;
+		std::atomic<bool> writing(true);
+		std::atomic<usize> bad_order(0);
+
+		//readers iterate the map while the writers are modifying it
+		std::thread reader([&]() {
+			while(writing.load())
+			{
+				//the iterator could land on nodes that the writers remove so keep them alive until it's done
+				epoch_guard guard(map.epoch());
+				u32 last = 0;
+				bool first = true;
+				for(auto it = map.begin(); it != map.end(); ++it)
+				{
+					if(!first && *it <= last)
+						++bad_order;
+					last = *it;
+					first = false;
+				}
+			}
+		});
+
+		std::thread writers[threads_count];
+		for(u32 t = 0; t < threads_count; ++t)
+		{
+			writers[t] = std::thread([&map, t]() {
+				//each thread owns the keys equal to t modulo threads_count
+				for(u32 i = 0; i < per_thread; ++i)
+					map.insert(i * threads_count + t, t);
+				for(u32 i = 0; i < per_thread; i += 2)
+					map.remove(i * threads_count + t);
+				//and all of them fight over the same shared keys
+				for(u32 i = 0; i < 1000; ++i)
+				{
+					map.insert(1000000 + i, t);
+					map.remove(1000000 + (i * 7) % 1000);
+				}
+			});
+		}
+		for(u32 t = 0; t < threads_count; ++t)
+			writers[t].join();
+		writing.store(false);
+		reader.join();
+
+		CHECK(bad_order.load() == 0);
+
+		usize below_shared = 0;
+		for(auto it = map.begin(); it != map.end(); ++it)
+			if(*it < 1000000)
+				++below_shared;
+		CHECK(below_shared == threads_count * per_thread / 2);
+
+		for(u32 i = 0; i < per_thread * threads_count; ++i)
+			CHECK((map.lookup(i) != map.end()) == ((i / threads_count) % 2 == 1));
+
+		usize counted = 0;
+		for(auto it = map.begin(); it != map.end(); ++it)
+			++counted;
+		CHECK(counted == map.count());
+	}
+
+	SECTION("Case 04")
+	{
+		//iterators don't hold on to epoch slots so any number of them could be kept around
+		concurrent_map<u32, u32> map;
+		dynamic_array<concurrent_map<u32, u32>::iterator> iterators;
+		for(u32 i = 0; i < 1000; ++i)
+			iterators.insert_back(map.insert(i, i));
+		for(u32 i = 0; i < 1000; ++i)
+			iterators.insert_back(map.lookup(i));
+
+		bool valid = true;
+		for(usize i = 0; i < iterators.count(); ++i)
+			valid &= iterators[i].key() == i % 1000;
+		CHECK(valid);
+
+		//more pins than slots in one chunk adds chunks instead of waiting for a slot
+		dynamic_array<usize> slots;
+		for(usize i = 0; i < 3 * epoch_domain::slots_count; ++i)
+			slots.insert_back(map.epoch().pin());
+		usize distinct = 1;
+		insertion_sort(slots.begin(), slots.count());
+		for(usize i = 1; i < slots.count(); ++i)
+			distinct += slots[i] != slots[i - 1];
+		CHECK(distinct == slots.count());
+		for(auto slot: slots)
+			map.epoch().unpin(slot);
+
+		for(u32 i = 0; i < 1000; i += 2)
+			CHECK(map.remove(i));
+		CHECK(map.count() == 500);
+	}
+}
@@ -0,0 +1,153 @@
+#include "catch.hpp"
+#include <cpprelude/delta_array.h>
+
+using namespace cpprelude;
+
+TEST_CASE("delta_array test", "[delta_array]")
+{
+	SECTION("Case 01")
+	{
+		delta_array array;
+		CHECK(array.empty());
+		CHECK(array.begin() == array.end());
+		CHECK(array.lower_bound(5) == 0);
+		CHECK(!array.contains(5));
+
+		CHECK(array.append(3));
+		CHECK(array.append(3));
+		CHECK(array.append(10));
+		CHECK(!array.append(9));
+		CHECK(array.count() == 3);
+		CHECK(array[1] == 3);
+		CHECK(array.back() == 10);
+		CHECK(array.lower_bound(4) == 2);
+		CHECK(array.lower_bound(11) == 3);
+		CHECK(array.contains(10));
+		CHECK(!array.contains(4));
+
+		//full blocks get packed, equal values take no bits at all
+		for(usize i = 0; i < 2 * delta_array::block_size; ++i)
+			array.append(1000);
+		CHECK(array.count() == 259);
+		CHECK(array._firsts.count() == 2);
+		CHECK(array[130] == 1000);
+		CHECK(array[2] == 10);
+		CHECK(array.back() == 1000);
+
+		//deltas that need all the 64 bits
+		delta_array wide;
+		const u64 values[] = {0, ~0ULL, ~0ULL};
+		for(usize i = 0; i < delta_array::block_size; ++i)
+			wide.append(values[i * 3 / delta_array::block_size]);
+		CHECK(wide._words.count() == 128);
+		CHECK(wide[0] == 0);
+		CHECK(wide[127] == ~0ULL);
+		CHECK(wide.lower_bound(1) == 43);
+
+		array.clear();
+		CHECK(array.empty());
+		CHECK(array.memory_size() == 0);
+		CHECK(array.append(1));
+		CHECK(array[0] == 1);
+	}
+
+	SECTION("Case 02")
+	{
+		//random sorted ids with small gaps against a plain array
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		dynamic_array<u64> expected;
+		u64 value = 1ULL << 40;
+		for(usize i = 0; i < 100000; ++i)
+		{
+			value += random() % 300;
+			expected.insert_back(value);
+		}
+
+		delta_array array;
+		CHECK(array.append(make_slice(expected.data(), expected.count())) == expected.count());
+		CHECK(array.count() == expected.count());
+		CHECK(array.memory_size() * 4 < expected.count() * sizeof(u64));
+
+		bool valid = true;
+		usize i = 0;
+		for(u64 x: array)
+			valid &= x == expected[i++];
+		valid &= i == expected.count();
+
+		dynamic_array<u64> decoded;
+		array.decode(decoded);
+		valid &= decoded.count() == expected.count();
+		for(usize j = 0; j < decoded.count(); ++j)
+			valid &= decoded[j] == expected[j];
+
+		for(usize j = 0; j < 1000; ++j)
+		{
+			usize index = random() % expected.count();
+			valid &= array[index] == expected[index];
+			valid &= array.contains(expected[index]);
+		}
+
+		//seeking forward with growing targets like an intersection does
+		auto it = array.begin();
+		u64 target = expected[0];
+		usize index = 0;
+		while(true)
+		{
+			target += random() % 5000;
+			while(index < expected.count() && expected[index] < target)
+				++index;
+			bool found = it.seek(target);
+			valid &= found == (index < expected.count());
+			valid &= it.index() == index;
+			if(!found)
+				break;
+			valid &= *it == expected[index];
+			valid &= array.lower_bound(target) == index;
+		}
+		valid &= it == array.end();
+		CHECK(valid);
+
+		CHECK(array.append(expected[expected.count() - 1] - 1) == false);
+		CHECK(array.append(~0ULL));
+		CHECK(array.back() == ~0ULL);
+	}
+
+	SECTION("Case 03")
+	{
+		//a run of equal values crossing block boundaries, the first copy is in an earlier block
+		delta_array array;
+		for(u64 i = 0; i < 255; ++i)
+			array.append(i);
+		for(usize i = 0; i < 2 + delta_array::block_size; ++i)
+			array.append(785);
+		array.append(786);
+		CHECK(array[255] == 785);
+		CHECK(array[256] == 785);
+		CHECK(array[385] == 786);
+
+		CHECK(array.lower_bound(785) == 255);
+		CHECK(array.lower_bound(786) == 385);
+		CHECK(array.contains(785));
+
+		auto it = array.begin();
+		CHECK(it.seek(785));
+		CHECK(it.index() == 255);
+		CHECK(*it == 785);
+
+		it = array.begin();
+		CHECK(it.seek(100));
+		CHECK(it.seek(785));
+		CHECK(it.index() == 255);
+		CHECK(it.seek(786));
+		CHECK(*it == 786);
+		CHECK(!it.seek(787));
+		CHECK(it == array.end());
+	}
+}
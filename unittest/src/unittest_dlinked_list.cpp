@@ -1,8 +1,35 @@
 #include "catch.hpp"
 #include <cpprelude/dlinked_list.h>
+#include <cpprelude/dynamic_array.h>
 
 using namespace cpprelude;
 
+namespace
+{
+	//forwards to the global memory and counts the live allocations
+	struct live_memory
+	{
+		isize live = 0;
+		memory_context context;
+
+		live_memory()
+		{
+			context._self = this;
+			context._alloc = [](void* self, usize size) {
+				++reinterpret_cast<live_memory*>(self)->live;
+				return platform->global_memory->_alloc(platform->global_memory->_self, size);
+			};
+			context._realloc = [](void* self, slice<byte>& data, usize size) {
+				platform->global_memory->_realloc(platform->global_memory->_self, data, size);
+			};
+			context._free = [](void* self, slice<byte>& data) {
+				--reinterpret_cast<live_memory*>(self)->live;
+				platform->global_memory->_free(platform->global_memory->_self, data);
+			};
+		}
+	};
+}
+
 TEST_CASE("dlinked_list test", "[dlinked_list]")
 {
 	dlinked_list<i32> array;
@@ -599,4 +626,131 @@ TEST_CASE("dlinked_list test", "[dlinked_list]")
 		}
 
 	}
+
+	SECTION("Case 33")
+	{
+		auto tens_less = [](i32 a, i32 b) { return a / 10 < b / 10; };
+		for(i32 i = 0; i < 1000; ++i)
+			array.insert_back((i * 7919) % 1000);
+
+		dynamic_array<i32*> addresses;
+		dynamic_array<usize> position(1000, usize(0));
+		usize index = 0;
+		for(auto& value: array)
+		{
+			addresses.insert_back(&value);
+			position[value] = index++;
+		}
+
+		array.sort(tens_less);
+		CHECK(array.count() == 1000);
+		for(usize i = 0; i < addresses.count(); ++i)
+			CHECK(position[*addresses[i]] == i);
+
+		i32 last = -1;
+		for(auto it = array.begin(); it != array.end(); ++it)
+		{
+			CHECK(last / 10 <= *it / 10);
+			if(last != -1 && last / 10 == *it / 10)
+				CHECK(position[last] < position[*it]);
+			last = *it;
+		}
+
+		array.sort();
+		i32 expected = 0;
+		for(auto& value: array)
+			CHECK(value == expected++);
+
+		//walk backwards to make sure the prev pointers were fixed
+		for(auto it = --array.end(); it != array.begin(); --it)
+			CHECK(*it == --expected);
+	}
+
+	SECTION("Case 34")
+	{
+		dlinked_list<i32> other;
+		array.insert_back({1, 3, 5, 7});
+		other.insert_back({0, 3, 4, 8, 9});
+
+		array.merge(other);
+		CHECK(other.empty());
+		CHECK(other.begin() == other.end());
+		CHECK(array.count() == 9);
+
+		i32 expected[] = {0, 1, 3, 3, 4, 5, 7, 8, 9};
+		usize i = 0;
+		for(auto& value: array)
+			CHECK(value == expected[i++]);
+
+		//move [3, 4) to the other list
+		auto first = ++(++array.begin());
+		auto last = first;
+		for(usize j = 0; j < 3; ++j)
+			++last;
+		other.splice_before(other.end(), array, first, last);
+		CHECK(array.count() == 6);
+		CHECK(other.count() == 3);
+		CHECK(*other.begin() == 3);
+		CHECK(*--other.end() == 4);
+
+		//and the whole list back to the front
+		array.splice_before(array.begin(), other);
+		CHECK(other.empty());
+		CHECK(array.count() == 9);
+		CHECK(array[0] == 3);
+		CHECK(array[3] == 0);
+
+		//splicing inside the same list moves [0, 1] to the back
+		first = array.begin();
+		for(usize j = 0; j < 3; ++j)
+			++first;
+		last = first;
+		++last; ++last;
+		array.splice_before(array.end(), array, first, last);
+		CHECK(array.count() == 9);
+		CHECK(*--array.end() == 1);
+		CHECK(array[3] == 5);
+	}
+	SECTION("Case 35")
+	{
+		//lists of different memory contexts copy the elements instead of relinking the nodes
+		live_memory memory;
+		{
+			dlinked_list<i32> other(&memory.context);
+			isize sentinels = memory.live;
+			array.insert_back({1, 5, 9});
+			other.insert_back({2, 3, 4, 10});
+
+			array.merge(other);
+			CHECK(other.empty());
+			CHECK(memory.live == sentinels);
+			CHECK(array.count() == 7);
+			i32 expected[] = {1, 2, 3, 4, 5, 9, 10};
+			usize i = 0;
+			for(auto& value: array)
+				CHECK(value == expected[i++]);
+
+			//move [2, 3, 4] to the other list
+			auto first = ++array.begin();
+			auto last = first;
+			++last; ++last; ++last;
+			other.splice_before(other.end(), array, first, last);
+			CHECK(array.count() == 4);
+			CHECK(other.count() == 3);
+			CHECK(memory.live == sentinels + 3);
+			CHECK(*other.begin() == 2);
+			CHECK(array[1] == 5);
+
+			array.splice_before(++array.begin(), other);
+			CHECK(other.empty());
+			CHECK(memory.live == sentinels);
+			CHECK(array.count() == 7);
+			CHECK(array[1] == 2);
+			CHECK(array[4] == 5);
+
+			other.insert_back(0);
+			array.reset();
+		}
+		CHECK(memory.live == 0);
+	}
 }
@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include <cpprelude/flat_map.h>
+#include <cpprelude/tree_map.h>
+#include <cpprelude/dynamic_array.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+TEST_CASE("flat_map test", "[flat_map]")
+{
+	SECTION("Case 01")
+	{
+		flat_set<i32> set;
+		CHECK(set.empty());
+
+		for(i32 i = 0; i < 500; ++i)
+			set.insert((i * 7919) % 500);
+		set.insert(10);
+		CHECK(set.count() == 500);
+		CHECK(set._is_sorted());
+
+		i32 expected = 0;
+		for(const auto& value: set)
+			CHECK(value == expected++);
+		CHECK(expected == 500);
+
+		CHECK(set.lookup(250) != set.end());
+		CHECK(set.lookup(500) == set.end());
+		CHECK(set.lookup(-1) == set.end());
+		CHECK(*set.lower_bound(-5) == 0);
+		CHECK(set.upper_bound(499) == set.end());
+
+		for(i32 i = 0; i < 500; i += 2)
+			set.remove(i);
+		set.remove(1000);
+		CHECK(set.count() == 250);
+		CHECK(set._is_sorted());
+		CHECK(set[0] == 1);
+
+		set.remove(set.lookup(1));
+		CHECK(*set.begin() == 3);
+
+		//removing the end leaves the set as is
+		set.remove(set.end());
+		CHECK(set.count() == 249);
+		CHECK(set[248] == 499);
+	}
+
+	SECTION("Case 02")
+	{
+		flat_set<i32> set{5, 3, 9, 3, 1};
+		CHECK(set.count() == 4);
+
+		//the batch has duplicates of itself and of the existing elements
+		dynamic_array<i32> batch;
+		for(i32 i = 20; i > 0; --i)
+			batch.insert_back(i % 12);
+		set.insert_batch(batch.begin(), batch.count());
+		CHECK(set._is_sorted());
+		CHECK(set.count() == 12);
+
+		set.insert_batch({100, -100, 50});
+		CHECK(set.count() == 15);
+		CHECK(*set.begin() == -100);
+		CHECK(*prev(set.end()) == 100);
+
+		flat_set<i32> empty_batch;
+		empty_batch.insert_batch(batch.begin(), 0);
+		CHECK(empty_batch.empty());
+	}
+
+	SECTION("Case 03")
+	{
+		flat_map<string, usize> map{{"mostafa", 1}, {"nora", 2}, {"mostafa", 3}};
+		CHECK(map.count() == 2);
+		CHECK(map.lookup("mostafa").value() == 1);
+
+		map["ahmed"] = 4;
+		map["nora"] += 10;
+		map.insert("zeyad", 5);
+		map.insert("ahmed", 100);
+
+		CHECK(map.count() == 4);
+		CHECK(map["ahmed"] == 4);
+		CHECK(map["nora"] == 12);
+		CHECK(map.begin().key() == "ahmed");
+		CHECK(map.lower_bound("b").key() == "mostafa");
+		CHECK(map.upper_bound("nora").key() == "zeyad");
+		CHECK(map.upper_bound("zeyad") == map.end());
+
+		map.remove("nora");
+		map.remove(map.lookup("ahmed"));
+		CHECK(map.count() == 2);
+		CHECK(map.begin().key() == "mostafa");
+
+		map.remove(map.end());
+		map.remove(map.lookup("omar"));
+		CHECK(map.count() == 2);
+		CHECK(map.upper_bound("mostafa").key() == "zeyad");
+
+		const auto& const_map = map;
+		usize sum = 0;
+		for(auto it = const_map.begin(); it != const_map.end(); ++it)
+			sum += it.value();
+		CHECK(sum == 6);
+	}
+
+	SECTION("Case 04")
+	{
+		flat_map<i32, i32> map;
+		red_black_map<i32, i32> tree;
+
+		//grow the map with batches of random keys mixed with single operations
+		u32 seed = 12345;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			return seed;
+		};
+
+		for(usize round = 0; round < 20; ++round)
+		{
+			dynamic_array<i32> keys, values;
+			for(usize i = 0; i < 50; ++i)
+			{
+				i32 key = random() % 1000;
+				keys.insert_back(key);
+				values.insert_back(i32(round * 100 + i));
+				if(tree.lookup(key) == tree.end())
+					tree.insert(key, i32(round * 100 + i));
+			}
+			map.insert_batch(keys.begin(), values.begin(), keys.count());
+
+			i32 key = random() % 1000;
+			map.remove(key);
+			tree.remove(key);
+
+			CHECK(map._is_sorted());
+			CHECK(map.count() == tree.count());
+		}
+
+		auto tree_it = tree.begin();
+		for(auto it = map.begin(); it != map.end(); ++it, ++tree_it)
+		{
+			CHECK(it.key() == tree_it.key());
+			CHECK(it.value() == tree_it.value());
+		}
+	}
+}
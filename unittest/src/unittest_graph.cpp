@@ -0,0 +1,132 @@
+#include "catch.hpp"
+#include <cpprelude/graph.h>
+#include <cpprelude/quick_union.h>
+
+using namespace cpprelude;
+
+TEST_CASE("csr_graph test", "[csr_graph]")
+{
+	SECTION("Case 01")
+	{
+		csr_graph graph;
+		CHECK(graph.vertices_count() == 0);
+
+		graph_edge edges[] = {{0, 1, 4}, {0, 2, 1}, {2, 1, 2}, {1, 3, 5}, {2, 3, 8}, {3, 4, 3}, {5, 6, 7}};
+		graph.build(8, make_slice(edges, 7), false, true);
+		CHECK(graph.vertices_count() == 8);
+		CHECK(graph.edges_count() == 7);
+		CHECK(graph.degree(0) == 2);
+		CHECK(graph.degree(4) == 0);
+		CHECK(graph.neighbours(0)[0] == 1);
+		CHECK(graph.neighbours(0).weight(0) == 4);
+		CHECK(graph.neighbours(0)[1] == 2);
+		CHECK(graph.neighbours(0).weight(1) == 1);
+
+		//directed so 3 doesn't reach back
+		dynamic_array<u32> levels;
+		CHECK(graph.bfs(0, levels) == 5);
+		u32 expected_levels[] = {0, 1, 1, 2, 3, csr_graph::unreached, csr_graph::unreached, csr_graph::unreached};
+		for(usize i = 0; i < 8; ++i)
+			CHECK(levels[i] == expected_levels[i]);
+		CHECK(graph.bfs(3, levels) == 2);
+
+		dynamic_array<u32> labels;
+		CHECK(graph.connected_components(labels) == 3);
+		u32 expected_labels[] = {0, 0, 0, 0, 0, 1, 1, 2};
+		for(usize i = 0; i < 8; ++i)
+			CHECK(labels[i] == expected_labels[i]);
+
+		dynamic_array<graph_edge> forest;
+		CHECK(graph.minimum_spanning_forest(forest) == Approx(1 + 2 + 5 + 3 + 7));
+		CHECK(forest.count() == 5);
+		CHECK(forest[0].weight == 1);
+
+		graph.build(8, make_slice(edges, 7), true, false);
+		CHECK(!graph.weighted());
+		CHECK(graph.edges_count() == 14);
+		CHECK(graph.neighbours(3).count() == 3);
+		CHECK(graph.neighbours(3).weight(0) == 1);
+		CHECK(graph.bfs(3, levels) == 5);
+		CHECK(levels[0] == 2);
+	}
+
+	SECTION("Case 02")
+	{
+		//a random graph on many threads against a single threaded build and the union find
+		constexpr usize vertices_count = 30000;
+		constexpr usize edges_count = 120000;
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		dynamic_array<graph_edge> edges;
+		compact_quick_union expected_sets(vertices_count);
+		for(usize i = 0; i < edges_count; ++i)
+		{
+			//a few hub vertices so the parts aren't even
+			u32 from = i % 7 == 0 ? u32(random() % 8) : u32(random() % vertices_count);
+			u32 to = u32(random() % (vertices_count - 1000));
+			edges.insert_back(graph_edge{from, to, r32(random() % 1000)});
+			expected_sets.connect(from, to);
+		}
+
+		auto same = [](const auto& a, const auto& b) {
+			if(a.count() != b.count())
+				return false;
+			for(usize i = 0; i < a.count(); ++i)
+				if(a[i] != b[i])
+					return false;
+			return true;
+		};
+
+		csr_graph graph, single;
+		graph.build(vertices_count, make_slice(edges.data(), edges.count()), true, true, 4);
+		single.build(vertices_count, make_slice(edges.data(), edges.count()), true, true, 1);
+		CHECK(same(graph._offsets, single._offsets));
+		CHECK(same(graph._targets, single._targets));
+		CHECK(same(graph._weights, single._weights));
+
+		bool valid = true;
+		for(usize vertex = 0; vertex < vertices_count; ++vertex)
+		{
+			csr_neighbours list = graph.neighbours(u32(vertex));
+			for(usize i = 1; i < list.count(); ++i)
+				valid &= list[i - 1] <= list[i];
+		}
+		CHECK(valid);
+
+		dynamic_array<u32> labels, expected_labels, sizes;
+		usize components_count = graph.connected_components(labels, 4);
+		CHECK(components_count == expected_sets.label_components(expected_labels, sizes));
+		CHECK(same(labels, expected_labels));
+
+		//the levels are the same with and without the bottom up steps and every edge spans at most one level
+		dynamic_array<u32> levels, expected_levels;
+		usize reached = graph.bfs(0, levels, 4);
+		CHECK(reached == sizes[labels[0]]);
+		for(usize vertex = 0; vertex < vertices_count; ++vertex)
+		{
+			valid &= (levels[vertex] != csr_graph::unreached) == (labels[vertex] == labels[0]);
+			if(levels[vertex] == csr_graph::unreached)
+				continue;
+			bool has_parent = levels[vertex] == 0;
+			for(u32 neighbour: graph.neighbours(u32(vertex)))
+			{
+				valid &= levels[neighbour] + 1 >= levels[vertex] && levels[vertex] + 1 >= levels[neighbour];
+				has_parent |= levels[neighbour] + 1 == levels[vertex];
+			}
+			valid &= has_parent;
+		}
+		CHECK(valid);
+
+		dynamic_array<graph_edge> forest;
+		r64 weight = graph.minimum_spanning_forest(forest);
+		CHECK(forest.count() == vertices_count - components_count);
+		dynamic_array<graph_edge> single_forest;
+		CHECK(single.minimum_spanning_forest(single_forest) == weight);
+	}
+}
@@ -0,0 +1,158 @@
+#include "catch.hpp"
+#include <cpprelude/intrusive.h>
+#include <cpprelude/dynamic_array.h>
+#include <cpprelude/tree_map.h>
+
+using namespace cpprelude;
+
+namespace
+{
+	struct by_age;
+	struct by_owner;
+
+	struct job: intrusive_list_hook<by_age>,
+				intrusive_list_hook<by_owner>,
+				intrusive_slist_hook<>,
+				intrusive_tree_hook<>
+	{
+		i32 id;
+
+		bool
+		operator<(const job& other) const
+		{
+			return id < other.id;
+		}
+	};
+}
+
+TEST_CASE("intrusive test", "[intrusive]")
+{
+	SECTION("Case 01")
+	{
+		job jobs[10];
+		for(i32 i = 0; i < 10; ++i)
+			jobs[i].id = i;
+
+		//the same jobs are in two lists at once with different orders
+		intrusive_list<job, by_age> ages;
+		intrusive_list<job, by_owner> owners;
+		for(i32 i = 0; i < 10; ++i)
+		{
+			ages.insert_back(jobs[i]);
+			owners.insert_front(jobs[i]);
+		}
+		CHECK(ages.count() == 10);
+		CHECK(owners.count() == 10);
+
+		i32 expected = 0;
+		for(auto& j: ages)
+			CHECK(j.id == expected++);
+		expected = 9;
+		for(auto& j: owners)
+			CHECK(j.id == expected--);
+
+		ages.remove(jobs[5]);
+		owners.remove(jobs[5]);
+		CHECK(!jobs[5].intrusive_list_hook<by_age>::linked());
+		CHECK(jobs[4].intrusive_list_hook<by_age>::linked());
+		CHECK(ages.count() == 9);
+		CHECK(ages.iterator_of(jobs[4])->id == 4);
+		CHECK((++ages.iterator_of(jobs[4]))->id == 6);
+		CHECK((--ages.end())->id == 9);
+
+		ages.insert_before(ages.iterator_of(jobs[6]), jobs[5]);
+		expected = 0;
+		for(auto& j: ages)
+			CHECK(j.id == expected++);
+		CHECK(expected == 10);
+
+		ages.remove_front();
+		ages.remove_back();
+		CHECK(ages.front().id == 1);
+		CHECK(ages.back().id == 8);
+
+		intrusive_list<job, by_age> moved(std::move(ages));
+		CHECK(ages.empty());
+		CHECK(moved.count() == 8);
+
+		ages.insert_back(jobs[0]);
+		ages.splice_back(moved);
+		CHECK(moved.empty());
+		CHECK(ages.count() == 9);
+		CHECK(ages.back().id == 8);
+
+		ages.clear();
+		CHECK(!jobs[3].intrusive_list_hook<by_age>::linked());
+	}
+
+	SECTION("Case 02")
+	{
+		job jobs[5];
+		intrusive_slist<job> list;
+		for(i32 i = 0; i < 5; ++i)
+		{
+			jobs[i].id = i;
+			list.insert_front(jobs[i]);
+		}
+		CHECK(list.count() == 5);
+		CHECK(list.front().id == 4);
+
+		list.remove_after(list.begin());
+		list.insert_after(list.begin(), jobs[3]);
+
+		i32 expected = 4;
+		for(auto& j: list)
+			CHECK(j.id == expected--);
+
+		list.remove_front();
+		CHECK(list.front().id == 3);
+		CHECK(list.count() == 4);
+	}
+
+	SECTION("Case 03")
+	{
+		constexpr usize count = 2000;
+		dynamic_array<job> jobs(count);
+		intrusive_tree<job> tree;
+		red_black_tree<i32> reference;
+
+		for(usize i = 0; i < count; ++i)
+		{
+			jobs[i].id = i32((i * 7919) % count);
+			tree.insert(jobs[i]);
+			reference.insert(jobs[i].id);
+		}
+		CHECK(tree.count() == count);
+		CHECK(tree._is_red_black_tree());
+
+		job duplicate;
+		duplicate.id = 10;
+		CHECK(&*tree.insert(duplicate) != &duplicate);
+		CHECK(tree.count() == count);
+
+		//remove in a different order than the insertion to hit all the relinking cases
+		for(usize i = 0; i < count; i += 3)
+		{
+			tree.remove(jobs[i]);
+			reference.remove(jobs[i].id);
+		}
+		CHECK(tree._is_red_black_tree());
+		CHECK(tree.count() == reference.count());
+
+		auto ref_it = reference.begin();
+		for(auto it = tree.begin(); it != tree.end(); ++it, ++ref_it)
+			CHECK(it->id == *ref_it);
+
+		job key;
+		key.id = 1;
+		CHECK((tree.lookup(key) == tree.end()) == (reference.lookup(1) == reference.end()));
+		key.id = -1;
+		CHECK(tree.lower_bound(key)->id == *reference.begin());
+		key.id = count;
+		CHECK(tree.upper_bound(key) == tree.end());
+
+		tree.clear();
+		CHECK(tree.empty());
+		CHECK(jobs[1].intrusive_tree_hook<>::parent == nullptr);
+	}
+}
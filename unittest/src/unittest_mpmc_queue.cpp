@@ -0,0 +1,130 @@
+#include "catch.hpp"
+#include <cpprelude/mpmc_queue.h>
+#include <cpprelude/string.h>
+#include <thread>
+
+using namespace cpprelude;
+
+TEST_CASE("mpmc_queue test", "[mpmc_queue]")
+{
+	SECTION("Case 01")
+	{
+		mpmc_queue<i32> queue(3);
+		CHECK(queue.capacity() == 4);
+		CHECK(queue.empty());
+
+		//the positions sit on cache lines of their own
+		CHECK(reinterpret_cast<usize>(&queue._enqueue_pos) % mpmc_queue<i32>::cache_line_size == 0);
+		CHECK(reinterpret_cast<usize>(&queue._dequeue_pos) % mpmc_queue<i32>::cache_line_size == 0);
+
+		i32 value = -1;
+		CHECK(!queue.try_dequeue(value));
+
+		for(i32 i = 0; i < 4; ++i)
+			CHECK(queue.try_enqueue(i));
+		CHECK(!queue.try_enqueue(4));
+		CHECK(queue.count() == 4);
+
+		//wrap around the ring a few times
+		for(i32 i = 4; i < 50; ++i)
+		{
+			CHECK(queue.try_dequeue(value));
+			CHECK(value == i - 4);
+			queue.enqueue(i);
+		}
+
+		i32 batch[8];
+		CHECK(queue.try_dequeue_batch(batch, 8) == 4);
+		CHECK(batch[0] == 46);
+		CHECK(batch[3] == 49);
+		CHECK(queue.try_dequeue_batch(batch, 8) == 0);
+
+		i32 values[6] = {0, 1, 2, 3, 4, 5};
+		CHECK(queue.try_enqueue_batch(values, 6) == 4);
+		CHECK(queue.try_enqueue_batch(values, 6) == 0);
+		queue.dequeue(value);
+		CHECK(value == 0);
+		CHECK(queue.try_enqueue_batch(values + 4, 2) == 1);
+		CHECK(queue.count() == 4);
+	}
+
+	SECTION("Case 02")
+	{
+		mpmc_queue<string> queue(4);
+		queue.emplace("a");
+		queue.enqueue(string("b"));
+		CHECK(queue.try_emplace("c"));
+
+		string value;
+		queue.dequeue(value);
+		CHECK(value == "a");
+		//the rest are destroyed with the queue
+	}
+
+	SECTION("Case 03")
+	{
+		constexpr usize producers_count = 4;
+		constexpr usize consumers_count = 4;
+		constexpr usize per_producer = 50000;
+		mpmc_queue<usize> queue(128);
+
+		std::atomic<usize> consumed(0);
+		std::atomic<usize> sum(0);
+
+		std::thread producers[producers_count];
+		for(usize p = 0; p < producers_count; ++p)
+		{
+			producers[p] = std::thread([&queue, p]() {
+				usize batch[16];
+				usize next = 0;
+				while(next < per_producer)
+				{
+					if(next % 2 == 0)
+					{
+						queue.enqueue(p * per_producer + next);
+						++next;
+						continue;
+					}
+
+					usize batch_count = 0;
+					for(; batch_count < 16 && next + batch_count < per_producer; ++batch_count)
+						batch[batch_count] = p * per_producer + next + batch_count;
+					queue.enqueue_batch(batch, batch_count);
+					next += batch_count;
+				}
+			});
+		}
+
+		std::thread consumers[consumers_count];
+		for(usize c = 0; c < consumers_count; ++c)
+		{
+			consumers[c] = std::thread([&]() {
+				usize batch[8];
+				usize local_sum = 0;
+				while(consumed.load() < producers_count * per_producer)
+				{
+					usize popped = queue.try_dequeue_batch(batch, 8);
+					if(popped == 0)
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					for(usize i = 0; i < popped; ++i)
+						local_sum += batch[i];
+					consumed += popped;
+				}
+				sum += local_sum;
+			});
+		}
+
+		for(auto& producer: producers)
+			producer.join();
+		for(auto& consumer: consumers)
+			consumer.join();
+
+		constexpr usize total = producers_count * per_producer;
+		CHECK(consumed.load() == total);
+		CHECK(sum.load() == total * (total - 1) / 2);
+		CHECK(queue.empty());
+	}
+}
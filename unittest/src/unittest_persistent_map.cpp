@@ -0,0 +1,154 @@
+#include "catch.hpp"
+#include <cpprelude/persistent_map.h>
+#include <cpprelude/tree_map.h>
+#include <cpprelude/dynamic_array.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+TEST_CASE("persistent_map test", "[persistent_map]")
+{
+	SECTION("Case 01")
+	{
+		persistent_map<i32, i32> map;
+		for(i32 i = 0; i < 200; ++i)
+		{
+			CHECK(map.insert(i, i * 2));
+			CHECK(map._is_avl_tree());
+		}
+		CHECK(map.insert(5, 0) == false);
+		CHECK(map.count() == 200);
+		CHECK(*map.lookup_value(5) == 10);
+
+		i32 expected = 0;
+		for(auto it = map.begin(); it != map.end(); ++it)
+		{
+			CHECK(it.key() == expected);
+			CHECK(it.value() == expected * 2);
+			++expected;
+		}
+		CHECK(expected == 200);
+
+		for(i32 i = 0; i < 200; i += 3)
+		{
+			CHECK(map.remove(i));
+			CHECK(map._is_avl_tree());
+		}
+		CHECK(map.remove(0) == false);
+		CHECK(map.count() == 200 - 67);
+		CHECK(map.lookup(3) == map.end());
+		CHECK(map.lookup(4).value() == 8);
+	}
+
+	SECTION("Case 02")
+	{
+		persistent_map<usize, usize> map;
+		dynamic_array<persistent_map<usize, usize>> versions;
+
+		for(usize i = 0; i < 100; ++i)
+		{
+			versions.insert_back(map.snapshot());
+			map.insert(i, i);
+		}
+		for(usize i = 0; i < 100; i += 2)
+		{
+			versions.insert_back(map.snapshot());
+			map.update(i, 1000 + i);
+		}
+		for(usize i = 0; i < 100; ++i)
+			map.remove(i);
+		CHECK(map.empty());
+
+		//every version still sees the state at the time it was taken
+		for(usize v = 0; v < 100; ++v)
+		{
+			CHECK(versions[v].count() == v);
+			usize expected = 0;
+			for(auto it = versions[v].begin(); it != versions[v].end(); ++it)
+			{
+				CHECK(*it == expected);
+				CHECK(it.value() == expected);
+				++expected;
+			}
+			CHECK(expected == v);
+		}
+
+		for(usize v = 100; v < versions.count(); ++v)
+		{
+			usize updated = (v - 100) * 2;
+			CHECK(versions[v].count() == 100);
+			for(usize i = 0; i < 100; ++i)
+			{
+				bool is_updated = i % 2 == 0 && i < updated;
+				CHECK(*versions[v].lookup_value(i) == (is_updated ? 1000 + i : i));
+			}
+		}
+	}
+
+	SECTION("Case 03")
+	{
+		persistent_map<i32, i32> map;
+		tree_map<i32, i32> reference;
+
+		u32 seed = 11;
+		for(usize i = 0; i < 5000; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			i32 key = static_cast<i32>((seed >> 8) % 700);
+			if(seed & 0x40000000)
+			{
+				map.update(key, static_cast<i32>(i));
+				reference[key] = static_cast<i32>(i);
+			}
+			else
+			{
+				map.remove(key);
+				reference.remove(key);
+			}
+
+			if(i % 500 == 0)
+			{
+				auto snapshot = map;
+				map.remove(key);
+				map.update(key + 1, 0);
+				map = snapshot;
+			}
+		}
+
+		CHECK(map._is_avl_tree());
+		CHECK(map.count() == reference.count());
+
+		auto ref_it = reference.begin();
+		for(auto it = map.begin(); it != map.end(); ++it)
+		{
+			CHECK(*it == *ref_it);
+			CHECK(it.value() == ref_it.value());
+			++ref_it;
+		}
+
+		auto it = map.lower_bound(350);
+		CHECK(*it == *reference.lower_bound(350));
+		it = map.upper_bound(350);
+		CHECK(*it == *reference.upper_bound(350));
+		CHECK(map.upper_bound(10000) == map.end());
+	}
+
+	SECTION("Case 04")
+	{
+		persistent_map<string, usize> map{ {"a", 1}, {"b", 2}, {"c", 3} };
+		auto old = map.snapshot();
+		map.remove("a");
+		map.update("b", 20);
+		map.insert("d", 4);
+
+		CHECK(old.count() == 3);
+		CHECK(*old.lookup_value("a") == 1);
+		CHECK(*old.lookup_value("b") == 2);
+		CHECK(old.lookup_value("d") == nullptr);
+
+		CHECK(map.count() == 3);
+		CHECK(map.lookup_value("a") == nullptr);
+		CHECK(*map.lookup_value("b") == 20);
+		CHECK(*map.begin() == "b");
+	}
+}
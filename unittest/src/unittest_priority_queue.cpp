@@ -0,0 +1,241 @@
+#include "catch.hpp"
+#include <cpprelude/priority_queue.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+namespace
+{
+	u32
+	xorshift(u32& seed)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+
+	struct greater_than
+	{
+		bool
+		operator()(i32 a, i32 b) const
+		{
+			return a > b;
+		}
+	};
+}
+
+TEST_CASE("priority_queue test", "[priority_queue]")
+{
+	SECTION("Case 01")
+	{
+		priority_queue<i32> queue{5, 3, 9, 1, 7, 3, 8, 2, 6, 4, 0};
+		CHECK(queue.count() == 11);
+
+		i32 last = -1;
+		while (!queue.empty())
+		{
+			CHECK(queue.front() >= last);
+			last = queue.front();
+			queue.dequeue();
+		}
+		CHECK(last == 9);
+		CHECK(!queue.dequeue());
+	}
+
+	SECTION("Case 02")
+	{
+		//binary and 8-ary layouts with a max heap comparator
+		priority_queue<i32, greater_than, 2> binary;
+		priority_queue<i32, greater_than, 8> wide(usize(100));
+		u32 seed = 2463534242;
+		for (usize i = 0; i < 1000; ++i)
+		{
+			i32 value = i32(xorshift(seed) % 500);
+			binary.enqueue(value);
+			wide.enqueue(value);
+		}
+
+		bool same = true, ordered = true;
+		i32 last = 500;
+		while (!binary.empty())
+		{
+			same &= binary.front() == wide.front();
+			ordered &= binary.front() <= last;
+			last = binary.front();
+			binary.dequeue();
+			wide.dequeue();
+		}
+		CHECK(same);
+		CHECK(ordered);
+		CHECK(wide.empty());
+	}
+
+	SECTION("Case 03")
+	{
+		addressable_priority_queue<i32> queue;
+		auto a = queue.enqueue(50);
+		auto b = queue.enqueue(40);
+		auto c = queue.enqueue(30);
+		auto d = queue.enqueue(60);
+		CHECK(queue.front() == 30);
+		CHECK(queue.front_handle() == c);
+
+		queue.decrease_key(d, 10);
+		CHECK(queue.front_handle() == d);
+		queue.increase_key(d, 45);
+		CHECK(queue.front_handle() == c);
+		CHECK(queue[d] == 45);
+
+		CHECK(queue.remove(c));
+		CHECK(!queue.contains(c));
+		CHECK(!queue.remove(c));
+		CHECK(queue.front() == 40);
+
+		queue.update(a, 1);
+		CHECK(queue.front_handle() == a);
+		queue.update(a, 100);
+		CHECK(queue.front_handle() == b);
+
+		//the freed slot is given to the next element with a new generation so the old handle stays dead
+		auto e = queue.enqueue(0);
+		CHECK(e.index == c.index);
+		CHECK(e != c);
+		CHECK(!queue.contains(c));
+		CHECK(!queue.remove(c));
+		CHECK(queue.contains(e));
+		CHECK(queue.count() == 4);
+
+		i32 expected[] = {0, 40, 45, 100};
+		for (i32 value: expected)
+		{
+			CHECK(queue.front() == value);
+			queue.dequeue();
+		}
+		CHECK(queue.empty());
+		CHECK(!queue.contains(e));
+
+		//clearing keeps the generations so handles from before don't match the new elements
+		auto f = queue.enqueue(7);
+		queue.clear();
+		auto g = queue.enqueue(8);
+		CHECK(g.index == f.index);
+		CHECK(!queue.contains(f));
+		CHECK(queue.contains(g));
+	}
+
+	SECTION("Case 04")
+	{
+		//random updates and removals against a brute force reference
+		constexpr usize count = 500;
+		using queue_type = addressable_priority_queue<u32, default_less_than<u32>, 3>;
+		queue_type queue;
+		dynamic_array<queue_type::handle> handles;
+		dynamic_array<u32> values;
+		dynamic_array<bool> alive;
+		u32 seed = 88172645;
+
+		for (usize i = 0; i < count; ++i)
+		{
+			u32 value = xorshift(seed) % 10000;
+			handles.insert_back(queue.enqueue(value));
+			CHECK(handles[i].index == i);
+			values.insert_back(value);
+			alive.insert_back(true);
+		}
+
+		for (usize step = 0; step < 3000; ++step)
+		{
+			usize id = xorshift(seed) % count;
+			if (!alive[id]) continue;
+
+			if (step % 5 == 0)
+			{
+				queue.remove(handles[id]);
+				alive[id] = false;
+			}
+			else
+			{
+				u32 value = xorshift(seed) % 10000;
+				if (value < values[id])
+					queue.decrease_key(handles[id], value);
+				else
+					queue.increase_key(handles[id], value);
+				values[id] = value;
+			}
+		}
+
+		bool matches = true;
+		while (!queue.empty())
+		{
+			usize id = queue.front_handle().index;
+			matches &= queue.front_handle() == handles[id];
+			matches &= alive[id] && values[id] == queue.front();
+			for (usize i = 0; i < count; ++i)
+				matches &= !alive[i] || values[i] >= queue.front();
+			alive[id] = false;
+			queue.dequeue();
+		}
+		CHECK(matches);
+	}
+
+	SECTION("Case 05")
+	{
+		addressable_priority_queue<string> queue;
+		auto first = queue.enqueue(string("m"));
+		queue.emplace("z");
+		queue.enqueue(string("c"));
+		queue.update(first, "a");
+		CHECK(queue.front() == "a");
+		queue.dequeue();
+		CHECK(queue.front() == "c");
+	}
+
+	SECTION("Case 06")
+	{
+		radix_heap<u32, i32> heap;
+		u32 seed = 1234567;
+		usize popped = 0;
+		u32 last = 0;
+		bool monotone = true;
+
+		for (i32 i = 0; i < 2000; ++i)
+		{
+			//keys are always at least the last extracted key
+			heap.enqueue(heap.last_key() + xorshift(seed) % 1000, i);
+			if (i % 3 == 0)
+			{
+				monotone &= heap.front().key >= last;
+				last = heap.front().key;
+				heap.dequeue();
+				++popped;
+			}
+		}
+		while (!heap.empty())
+		{
+			monotone &= heap.front().key >= last;
+			last = heap.front().key;
+			heap.dequeue();
+			++popped;
+		}
+		CHECK(monotone);
+		CHECK(popped == 2000);
+		CHECK(heap.last_key() == last);
+
+		radix_heap<u8, string> small;
+		small.enqueue(255, "max");
+		small.enqueue(0, "min");
+		small.enqueue(0, "min");
+		CHECK(small.front().value == "min");
+		small.dequeue();
+		small.dequeue();
+		CHECK(small.front().key == 255);
+		CHECK(small.dequeue());
+
+		//dequeuing an empty heap doesn't search past the last bucket
+		CHECK(small.empty());
+		CHECK(!small.dequeue());
+		small.enqueue(255, "again");
+		CHECK(small.front().value == "again");
+	}
+}
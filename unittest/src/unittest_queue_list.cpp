@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <cpprelude/queue_list.h>
+#include <cpprelude/unrolled_list.h>
 
 using namespace cpprelude;
 
@@ -30,4 +31,30 @@ TEST_CASE("queue_list test", "[queue_list]")
 
 	}
 
-}
\ No newline at end of file
+	SECTION("Case 02")
+	{
+		queue_list<usize, unrolled_list<usize, 8>> queue;
+
+		//interleave so the queue keeps draining the head node while filling the tail node
+		usize next_in = 0, next_out = 0;
+		for (usize round = 0; round < 50; round++)
+		{
+			for (usize i = 0; i < 7; i++)
+				queue.enqueue(next_in++);
+			for (usize i = 0; i < 5; i++)
+			{
+				CHECK(queue.front() == next_out++);
+				CHECK(queue.dequeue());
+			}
+		}
+
+		CHECK(queue.count() == 100);
+		while (!queue.empty())
+		{
+			CHECK(queue.front() == next_out++);
+			queue.dequeue();
+		}
+		CHECK(next_out == next_in);
+		CHECK(queue.dequeue() == false);
+	}
+}
@@ -58,5 +58,27 @@ TEST_CASE("quick_find test", "[quick_find]")
 		CHECK(array.is_connected(0, 9) == false);
 
 	}
-	
-}
\ No newline at end of file
+
+	SECTION("Case 02")
+	{
+		quick_find array(10);
+		array.connect(0, 1);
+
+		dynamic_array<quick_union_edge> edges;
+		edges.insert_back(quick_union_edge{1, 2});
+		edges.insert_back(quick_union_edge{5, 6});
+		edges.insert_back(quick_union_edge{6, 9});
+		edges.insert_back(quick_union_edge{9, 5});
+		array.connect_all(make_slice(edges.data(), edges.count()));
+
+		CHECK(array.is_connected(0, 2) == true);
+		CHECK(array.is_connected(5, 9) == true);
+		CHECK(array.is_connected(2, 5) == false);
+		CHECK(array.is_connected(3, 4) == false);
+
+		//the ids are still usable by connect
+		array.connect(3, 9);
+		CHECK(array.is_connected(3, 6) == true);
+		CHECK(array.is_connected(3, 0) == false);
+	}
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <cpprelude/quick_union.h>
+#include <thread>
 
 using namespace cpprelude;
 
@@ -76,4 +77,168 @@ TEST_CASE("quick_union test", "[quick_union]")
 		CHECK(graph.is_connected(5, 8) == false);
 			
 	}	
-}
\ No newline at end of file
+}
+
+TEST_CASE("concurrent_quick_union test", "[concurrent_quick_union]")
+{
+	SECTION("Case 01")
+	{
+		concurrent_quick_union graph(32);
+		CHECK(graph.count() == 32);
+		CHECK(graph.is_connected(3, 3) == true);
+		CHECK(graph.is_connected(3, 4) == false);
+
+		CHECK(graph.connect(0, 31) == true);
+		CHECK(graph.connect(31, 1) == true);
+		CHECK(graph.connect(1, 0) == false);
+		CHECK(graph.is_connected(1, 31) == true);
+
+		graph.connect(20, 2);
+		graph.connect(5, 2);
+		graph.connect(5, 1);
+		CHECK(graph.is_connected(31, 20) == true);
+		CHECK(graph.is_connected(15, 6) == false);
+
+		graph.init(8);
+		CHECK(graph.count() == 8);
+		CHECK(graph.is_connected(0, 1) == false);
+	}
+
+	SECTION("Case 02")
+	{
+		//random edges connected from many threads against the sequential union find
+		constexpr usize nodes_count = 20000;
+		constexpr usize edges_count = 15000;
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		dynamic_array<quick_union_edge> edges;
+		quick_union expected(nodes_count);
+		for(usize i = 0; i < edges_count; ++i)
+		{
+			quick_union_edge edge{random() % nodes_count, random() % nodes_count};
+			edges.insert_back(edge);
+			expected.connect(edge.a, edge.b);
+		}
+
+		concurrent_quick_union graph(nodes_count);
+		usize merged = connect_all(graph, make_slice(edges.data(), edges.count()), 4);
+
+		usize sets_count = 0;
+		for(usize i = 0; i < nodes_count; ++i)
+			sets_count += expected._root(i) == i;
+		CHECK(nodes_count - merged == sets_count);
+
+		bool valid = true;
+		for(usize i = 0; i < 50000; ++i)
+		{
+			usize a = random() % nodes_count, b = random() % nodes_count;
+			valid &= graph.is_connected(a, b) == expected.is_connected(a, b);
+		}
+		CHECK(valid);
+	}
+
+	SECTION("Case 03")
+	{
+		//threads connecting a chain from both ends while others query it
+		constexpr usize nodes_count = 4096;
+		concurrent_quick_union graph(nodes_count);
+		std::thread threads[4];
+		for(usize t = 0; t < 4; ++t)
+		{
+			threads[t] = std::thread([&graph, t]() {
+				if(t % 2)
+					for(usize i = nodes_count - 1; i > 0; --i)
+						graph.connect(i, i - 1);
+				else
+					for(usize i = 1; i < nodes_count; ++i)
+						graph.connect(i - 1, i);
+			});
+		}
+		for(auto& thread: threads)
+			thread.join();
+
+		bool valid = true;
+		for(usize i = 0; i < nodes_count; ++i)
+			valid &= graph._root(i) == 0;
+		CHECK(valid);
+	}
+}
+
+TEST_CASE("compact_quick_union test", "[compact_quick_union]")
+{
+	SECTION("Case 01")
+	{
+		compact_quick_union graph(10);
+		CHECK(graph.count() == 10);
+		CHECK(graph.connect(0, 9) == true);
+		CHECK(graph.connect(9, 0) == false);
+		CHECK(graph.connect(4, 3) == true);
+		CHECK(graph.connect(3, 9) == true);
+		CHECK(graph.is_connected(4, 0) == true);
+		CHECK(graph.is_connected(4, 5) == false);
+
+		graph.init(2);
+		CHECK(graph.count() == 12);
+		CHECK(graph.connect(11, 5) == true);
+
+		dynamic_array<u32> labels, sizes;
+		CHECK(graph.label_components(labels, sizes) == 8);
+		CHECK(labels.count() == 12);
+		u32 expected_labels[] = {0, 1, 2, 0, 0, 3, 4, 5, 6, 0, 7, 3};
+		u32 expected_sizes[] = {4, 1, 1, 2, 1, 1, 1, 1};
+		for(usize i = 0; i < 12; ++i)
+			CHECK(labels[i] == expected_labels[i]);
+		for(usize i = 0; i < 8; ++i)
+			CHECK(sizes[i] == expected_sizes[i]);
+	}
+
+	SECTION("Case 02")
+	{
+		//random edges against the usize union find
+		constexpr usize nodes_count = 5000;
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		dynamic_array<quick_union_edge> edges;
+		quick_union expected(nodes_count);
+		for(usize i = 0; i < 4000; ++i)
+		{
+			quick_union_edge edge{random() % nodes_count, random() % nodes_count};
+			edges.insert_back(edge);
+			expected.connect(edge.a, edge.b);
+		}
+
+		compact_quick_union graph(nodes_count);
+		usize merged = graph.connect_all(make_slice(edges.data(), edges.count()));
+
+		dynamic_array<u32> labels, sizes;
+		usize components_count = graph.label_components(labels, sizes);
+		CHECK(components_count == nodes_count - merged);
+
+		bool valid = true;
+		usize total = 0;
+		for(usize i = 0; i < components_count; ++i)
+			total += sizes[i];
+		valid &= total == nodes_count;
+		for(usize i = 0; i < 20000; ++i)
+		{
+			usize a = random() % nodes_count, b = random() % nodes_count;
+			valid &= (labels[a] == labels[b]) == expected.is_connected(a, b);
+		}
+		//every rank is at most log2 of the count of elements
+		for(usize i = 0; i < nodes_count; ++i)
+			valid &= graph._ranks[i] <= 13;
+		CHECK(valid);
+	}
+}
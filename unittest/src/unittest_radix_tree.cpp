@@ -0,0 +1,214 @@
+#include "catch.hpp"
+#include <cpprelude/radix_tree.h>
+#include <cpprelude/tree_map.h>
+#include <cpprelude/dynamic_array.h>
+
+using namespace cpprelude;
+
+TEST_CASE("radix_tree test", "[radix_tree]")
+{
+	SECTION("Case 01")
+	{
+		radix_tree<i32> tree;
+		CHECK(tree.empty());
+		CHECK(tree.lookup("a") == nullptr);
+
+		CHECK(tree.insert("romane", 1));
+		CHECK(tree.insert("romanus", 2));
+		CHECK(tree.insert("romulus", 3));
+		CHECK(tree.insert("rubens", 4));
+		CHECK(tree.insert("ruber", 5));
+		CHECK(tree.insert("rubicon", 6));
+		CHECK(tree.insert("rubicundus", 7));
+		//keys which are prefixes of others
+		CHECK(tree.insert("rom", 8));
+		CHECK(tree.insert("", 9));
+		CHECK(!tree.insert("ruber", 50));
+		CHECK(tree.count() == 9);
+
+		CHECK(*tree.lookup("ruber") == 50);
+		CHECK(*tree.lookup("rom") == 8);
+		CHECK(*tree.lookup("") == 9);
+		CHECK(tree.lookup("roma") == nullptr);
+		CHECK(tree.lookup("rubiconx") == nullptr);
+		CHECK(tree.contains(string("romulus")));
+
+		usize size = 0;
+		CHECK(*tree.longest_prefix("romanesque", &size) == 1);
+		CHECK(size == 6);
+		CHECK(*tree.longest_prefix("romanus", &size) == 2);
+		CHECK(*tree.longest_prefix("romanum", &size) == 8);
+		CHECK(size == 3);
+		CHECK(*tree.longest_prefix("romane", &size) == 1);
+		CHECK(size == 6);
+		CHECK(*tree.longest_prefix("x") == 9);
+
+		dynamic_array<string> keys;
+		tree.prefix_traverse("rub", [&keys](const radix_key& key, i32&, void*) {
+			byte buffer[16] = {};
+			std::memcpy(buffer, key.ptr, key.size);
+			keys.insert_back(string(buffer));
+		});
+		CHECK(keys.count() == 4);
+		CHECK(keys[0] == "rubens");
+		CHECK(keys[1] == "ruber");
+		CHECK(keys[2] == "rubicon");
+		CHECK(keys[3] == "rubicundus");
+
+		i32 sum = 0;
+		const radix_tree<i32>& const_tree = tree;
+		const_tree.prefix_traverse("rom", [&sum](const radix_key&, const i32& value, void*) {
+			sum += value;
+		});
+		CHECK(sum == 1 + 2 + 3 + 8);
+
+		CHECK(tree.remove("rom"));
+		CHECK(!tree.remove("rom"));
+		CHECK(tree.remove(""));
+		CHECK(tree.longest_prefix("x") == nullptr);
+		CHECK(*tree.longest_prefix("romanesque") == 1);
+		CHECK(tree.remove("romane"));
+		CHECK(tree.remove("romanus"));
+		CHECK(*tree.lookup("romulus") == 3);
+		CHECK(tree.count() == 5);
+
+		tree.clear();
+		CHECK(tree.empty());
+		CHECK(tree.lookup("ruber") == nullptr);
+	}
+
+	SECTION("Case 02")
+	{
+		//integers are ordered by value and the nodes grow to 256 children and shrink back
+		radix_tree<i64> tree;
+		for(i64 i = -500; i < 500; ++i)
+			CHECK(tree.insert(radix_key(i * 3), i));
+		CHECK(tree.count() == 1000);
+		CHECK(*tree.lookup(radix_key(i64(-300))) == -100);
+		CHECK(tree.lookup(radix_key(i64(1))) == nullptr);
+
+		i64 previous = -1000;
+		bool sorted = true;
+		tree.inorder_traverse([&](const radix_key&, i64& value, void*) {
+			sorted &= value == previous + 1 || previous == -1000;
+			previous = value;
+		});
+		CHECK(sorted);
+		CHECK(previous == 499);
+
+		for(i64 i = -500; i < 500; ++i)
+			if(i % 10)
+				CHECK(tree.remove(radix_key(i * 3)));
+		CHECK(tree.count() == 100);
+		for(i64 i = -500; i < 500; ++i)
+			CHECK((tree.lookup(radix_key(i * 3)) != nullptr) == (i % 10 == 0));
+
+		//a u32 key is a prefix of the u64 keys with the same high bytes
+		radix_tree<u32> ids;
+		ids.insert(radix_key(u32(0x0A000000)), 8);
+		ids.insert(radix_key(u64(0x0A00000000000001ULL)), 64);
+		usize size = 0;
+		CHECK(*ids.longest_prefix(radix_key(u64(0x0A00000000000002ULL)), &size) == 8);
+		CHECK(size == 4);
+	}
+
+	SECTION("Case 03")
+	{
+		//random keys with long shared prefixes against a tree_map
+		radix_tree<usize> tree;
+		tree_map<string, usize> reference;
+
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		const char* prefixes[] = {"", "/api/v1/namespaces/default/", "/api/v1/namespaces/kube/", "ab"};
+		byte buffer[64];
+		auto make_key = [&]() {
+			const char* prefix = prefixes[random() % 4];
+			usize size = std::strlen(prefix);
+			std::memcpy(buffer, prefix, size);
+			usize extra = random() % 14;
+			for(usize i = 0; i < extra; ++i)
+				buffer[size++] = "abc/"[random() % 4];
+			buffer[size] = 0;
+			return string(buffer);
+		};
+
+		bool valid = true;
+		for(usize i = 0; i < 30000; ++i)
+		{
+			string key = make_key();
+			if(random() % 3 == 0)
+			{
+				bool removed = tree.remove(key);
+				valid &= removed == (reference.lookup(key) != reference.end());
+				reference.remove(key);
+			}
+			else
+			{
+				bool inserted = tree.insert(key, i);
+				valid &= inserted == (reference.lookup(key) == reference.end());
+				reference[key] = i;
+			}
+		}
+		CHECK(valid);
+		CHECK(tree.count() == reference.count());
+
+		auto it = reference.begin();
+		tree.inorder_traverse([&](const radix_key& key, usize& value, void*) {
+			valid &= it != reference.end() && radix_key(*it).size == key.size &&
+					 std::memcmp(radix_key(*it).ptr, key.ptr, key.size) == 0 && it.value() == value;
+			++it;
+		});
+		CHECK(valid);
+		CHECK(it == reference.end());
+
+		for(usize i = 0; i < 2000; ++i)
+		{
+			string query = make_key();
+
+			usize size = 0;
+			usize* value = tree.longest_prefix(query, &size);
+			usize expected_size = 0;
+			usize* expected = nullptr;
+			for(usize j = 0; j < query.size(); ++j)
+			{
+				std::memcpy(buffer, query.data(), j);
+				buffer[j] = 0;
+				auto found = reference.lookup(string(buffer));
+				if(found != reference.end())
+				{
+					expected = &found.value();
+					expected_size = j;
+				}
+			}
+			CHECK((value == nullptr) == (expected == nullptr));
+			if(value && expected)
+			{
+				CHECK(*value == *expected);
+				CHECK(size == expected_size);
+			}
+
+			usize count = 0, expected_count = 0;
+			tree.prefix_traverse(query, [&count](const radix_key&, usize&, void*) { ++count; });
+			for(auto ref_it = reference.begin(); ref_it != reference.end(); ++ref_it)
+			{
+				const string& key = *ref_it;
+				expected_count += key.size() >= query.size() && std::memcmp(key.data(), query.data(), query.size() - 1) == 0;
+			}
+			CHECK(count == expected_count);
+		}
+		CHECK(valid);
+
+		for(auto ref_it = reference.begin(); ref_it != reference.end(); ++ref_it)
+			valid &= tree.remove(*ref_it);
+		CHECK(valid);
+		CHECK(tree.empty());
+		CHECK(tree._root == nullptr);
+	}
+}
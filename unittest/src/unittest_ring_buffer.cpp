@@ -0,0 +1,141 @@
+#include "catch.hpp"
+#include <cpprelude/ring_buffer.h>
+#include <cpprelude/string.h>
+#include <thread>
+
+using namespace cpprelude;
+
+TEST_CASE("ring_buffer test", "[ring_buffer]")
+{
+	SECTION("Case 01")
+	{
+		ring_buffer<i32> buffer(5);
+		CHECK(buffer.capacity() == 8);
+		CHECK(buffer.empty());
+
+		for(i32 i = 0; i < 8; ++i)
+			CHECK(buffer.push(i));
+		CHECK(buffer.full());
+		CHECK(!buffer.push(8));
+
+		//wrap the heads around the slice a few times
+		for(i32 i = 8; i < 100; ++i)
+		{
+			CHECK(buffer.front() == i - 8);
+			CHECK(buffer.pop());
+			CHECK(buffer.push(i));
+			CHECK(buffer.back() == i);
+		}
+		CHECK(buffer.count() == 8);
+		for(usize i = 0; i < buffer.count(); ++i)
+			CHECK(buffer[i] == i32(92 + i));
+
+		CHECK(buffer.expand());
+		CHECK(buffer.capacity() == 16);
+		CHECK(buffer.front() == 92);
+		for(i32 i = 100; i < 108; ++i)
+			CHECK(buffer.push(i));
+		CHECK(buffer.full());
+
+		i32 expected = 92;
+		while(!buffer.empty())
+		{
+			CHECK(buffer.front() == expected++);
+			buffer.pop();
+		}
+		CHECK(expected == 108);
+		CHECK(!buffer.pop());
+	}
+
+	SECTION("Case 02")
+	{
+		ring_buffer<string, 4> buffer;
+		buffer.push("a");
+		buffer.emplace("b");
+		buffer.push("c");
+		buffer.pop();
+		buffer.push("d");
+		buffer.push("e");
+
+		ring_buffer<string, 4> copy(buffer);
+		ring_buffer<string, 4> moved(std::move(buffer));
+		CHECK(moved.count() == 4);
+		CHECK(copy.count() == 4);
+		CHECK(copy.front() == "b");
+		CHECK(copy.back() == "e");
+
+		buffer = copy;
+		CHECK(buffer[2] == "d");
+		copy.clear();
+		CHECK(copy.empty());
+		CHECK(moved.front() == "b");
+	}
+
+	SECTION("Case 03")
+	{
+		spsc_ring_buffer<i32> buffer(6);
+		CHECK(buffer.capacity() == 8);
+		CHECK(buffer.front() == nullptr);
+
+		//the heads sit on cache lines of their own
+		CHECK(reinterpret_cast<usize>(&buffer._producer) % spsc_ring_buffer<i32>::cache_line_size == 0);
+		CHECK(reinterpret_cast<usize>(&buffer._consumer) % spsc_ring_buffer<i32>::cache_line_size == 0);
+
+		i32 values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+		CHECK(buffer.push_batch(values, 10) == 8);
+		CHECK(!buffer.push(8));
+
+		i32 out[3];
+		CHECK(buffer.pop_batch(out, 3) == 3);
+		CHECK(out[2] == 2);
+		CHECK(*buffer.front() == 3);
+		CHECK(buffer.push_batch(values + 8, 2) == 2);
+		CHECK(buffer.count() == 7);
+
+		i32 value = -1;
+		i32 expected = 3;
+		while(buffer.pop(value))
+			CHECK(value == expected++);
+		CHECK(expected == 10);
+		CHECK(buffer.empty());
+	}
+
+	SECTION("Case 04")
+	{
+		constexpr i32 total = 200000;
+		spsc_ring_buffer<i32> buffer(256);
+
+		std::thread producer([&]() {
+			i32 batch[32];
+			i32 next = 0;
+			while(next < total)
+			{
+				if(next % 3 == 0)
+				{
+					if(buffer.push(next))
+						++next;
+					continue;
+				}
+
+				i32 batch_count = 0;
+				for(; batch_count < 32 && next + batch_count < total; ++batch_count)
+					batch[batch_count] = next + batch_count;
+				next += i32(buffer.push_batch(batch, batch_count));
+			}
+		});
+
+		i32 expected = 0;
+		bool in_order = true;
+		i32 batch[16];
+		while(expected < total)
+		{
+			usize popped = buffer.pop_batch(batch, 16);
+			for(usize i = 0; i < popped; ++i)
+				in_order &= batch[i] == expected++;
+		}
+		producer.join();
+
+		CHECK(in_order);
+		CHECK(buffer.empty());
+	}
+}
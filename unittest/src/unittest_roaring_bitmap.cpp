@@ -0,0 +1,219 @@
+#include "catch.hpp"
+#include <cpprelude/roaring_bitmap.h>
+#include <cpprelude/bitset.h>
+#include <cpprelude/stream.h>
+#include <cpprelude/fmt.h>
+
+using namespace cpprelude;
+
+TEST_CASE("roaring_bitmap test", "[roaring_bitmap]")
+{
+	SECTION("Case 01")
+	{
+		roaring_bitmap bitmap;
+		CHECK(bitmap.empty());
+		CHECK(bitmap.begin() == bitmap.end());
+
+		CHECK(bitmap.insert(5));
+		CHECK(!bitmap.insert(5));
+		CHECK(bitmap.insert(70000));
+		CHECK(bitmap.insert(1));
+		CHECK(bitmap.insert(0xFFFFFFFF));
+		CHECK(bitmap.cardinality() == 4);
+		CHECK(bitmap.contains(70000));
+		CHECK(!bitmap.contains(70001));
+
+		u32 expected[] = {1, 5, 70000, 0xFFFFFFFF};
+		usize i = 0;
+		for(auto value: bitmap)
+			CHECK(value == expected[i++]);
+		CHECK(i == 4);
+
+		CHECK(bitmap.remove(70000));
+		CHECK(!bitmap.remove(70000));
+		CHECK(!bitmap.contains(70000));
+		CHECK(bitmap._containers.count() == 2);
+		bitmap.clear();
+		CHECK(bitmap.cardinality() == 0);
+	}
+
+	SECTION("Case 02")
+	{
+		//a chunk goes from array to bitmap and back to array
+		roaring_bitmap bitmap;
+		for(u32 i = 0; i < 10000; ++i)
+			bitmap.insert(i * 3);
+		CHECK(bitmap.cardinality() == 10000);
+		CHECK(bitmap._containers.count() == 1);
+		CHECK(bitmap._containers[0].kind == roaring_bitmap::_container_type::BITMAP);
+
+		for(u32 i = 0; i < 10000; ++i)
+			if(i % 5)
+				bitmap.remove(i * 3);
+		CHECK(bitmap.cardinality() == 2000);
+		CHECK(bitmap._containers[0].kind == roaring_bitmap::_container_type::ARRAY);
+		CHECK(bitmap.contains(15));
+		CHECK(!bitmap.contains(3));
+
+		u32 previous = 0;
+		usize count = 0;
+		bool sorted = true;
+		for(auto value: bitmap)
+		{
+			sorted &= count == 0 || value > previous;
+			previous = value;
+			++count;
+		}
+		CHECK(sorted);
+		CHECK(count == 2000);
+	}
+
+	SECTION("Case 03")
+	{
+		//runs are much smaller than a bitmap of the same chunk and stay usable
+		roaring_bitmap bitmap;
+		for(u32 i = 100; i < 60000; ++i)
+			bitmap.insert(i);
+		for(u32 i = 200000; i < 200010; ++i)
+			bitmap.insert(i);
+		roaring_bitmap copy = bitmap;
+
+		usize size = bitmap.memory_size();
+		bitmap.run_optimize();
+		CHECK(bitmap.memory_size() < size);
+		CHECK(bitmap._containers[0].kind == roaring_bitmap::_container_type::RUN);
+		CHECK(bitmap._containers[1].kind == roaring_bitmap::_container_type::RUN);
+		CHECK(bitmap == copy);
+		CHECK(bitmap.contains(100));
+		CHECK(bitmap.contains(59999));
+		CHECK(!bitmap.contains(60000));
+		CHECK(bitmap.cardinality() == 59900 + 10);
+
+		CHECK(bitmap.insert(60000));
+		CHECK(bitmap._containers[0].kind == roaring_bitmap::_container_type::BITMAP);
+		CHECK(bitmap.cardinality() == 59901 + 10);
+	}
+
+	SECTION("Case 04")
+	{
+		//set operations on mixed containers against dense bitsets
+		constexpr u32 universe = 5 * 65536;
+		roaring_bitmap a, b;
+		dynamic_bitset a_bits(universe), b_bits(universe);
+
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		for(u32 i = 0; i < universe; ++i)
+		{
+			//sparse, dense and run chunks
+			u32 chunk = i >> 16;
+			bool in_a = chunk == 0 ? random() % 50 == 0 : chunk == 1 ? random() % 2 == 0 : chunk == 2 ? (i & 0xFFFF) < 30000 : random() % 7 == 0;
+			bool in_b = chunk == 0 ? random() % 3 == 0 : chunk == 1 ? random() % 60 == 0 : chunk == 2 ? (i & 0xFFFF) > 20000 : chunk == 3 ? false : random() % 5 == 0;
+			if(in_a) { a.insert(i); a_bits.set(i); }
+			if(in_b) { b.insert(i); b_bits.set(i); }
+		}
+		b.run_optimize();
+
+		auto matches = [](const roaring_bitmap& bitmap, const dynamic_bitset& bits) {
+			if(bitmap.cardinality() != bits.popcount())
+				return false;
+			usize i = bits.find_first();
+			for(auto value: bitmap)
+			{
+				if(value != i)
+					return false;
+				i = bits.find_next(i);
+			}
+			return i == bits.count();
+		};
+
+		dynamic_bitset expected = a_bits;
+		expected &= b_bits;
+		CHECK(matches(a & b, expected));
+		CHECK(matches(b & a, expected));
+
+		expected = a_bits;
+		expected |= b_bits;
+		CHECK(matches(a | b, expected));
+		roaring_bitmap c = b;
+		c |= a;
+		CHECK(matches(c, expected));
+
+		expected = a_bits;
+		expected.and_not(b_bits);
+		c = a;
+		c.and_not(b);
+		CHECK(matches(c, expected));
+
+		expected = b_bits;
+		expected.and_not(a_bits);
+		c = b;
+		c.and_not(a);
+		CHECK(matches(c, expected));
+
+		c = a;
+		c &= c;
+		CHECK(c == a);
+		c.and_not(a);
+		CHECK(c.empty());
+	}
+
+	SECTION("Case 05")
+	{
+		roaring_bitmap bitmap;
+		for(u32 i = 0; i < 300000; i += 7)
+			bitmap.insert(i);
+		for(u32 i = 1000000; i < 1100000; ++i)
+			bitmap.insert(i);
+		bitmap.run_optimize();
+
+		memory_stream stream;
+		usize written = print_bin(stream, bitmap);
+		CHECK(written == stream.size());
+
+		stream.move_to_start();
+		roaring_bitmap read;
+		read.insert(42);
+		CHECK(scan_bin(stream, read) == written);
+		CHECK(read == bitmap);
+
+		//a truncated stream leaves the bitmap empty
+		slice<byte> part = make_slice(stream._data.ptr, written - 10);
+		memory_stream broken(part);
+		CHECK(scan_bin(broken, read) == written - 10);
+		CHECK(read.empty());
+
+		//a corrupt container count is rejected before anything is reserved for it
+		memory_stream corrupt;
+		print_bin(corrupt, u32(0x524F4152));
+		print_bin(corrupt, u32(0xFFFFFFFF));
+		corrupt.move_to_start();
+		CHECK(scan_bin(corrupt, read) == 8);
+		CHECK(read.empty());
+		CHECK(read._containers.capacity() < 65536);
+
+		//a valid count with missing containers leaves the bitmap empty too
+		memory_stream short_stream;
+		print_bin(short_stream, u32(0x524F4152));
+		print_bin(short_stream, u32(65536));
+		short_stream.move_to_start();
+		CHECK(scan_bin(short_stream, read) == 8);
+		CHECK(read.empty());
+	}
+
+	SECTION("Case 06")
+	{
+		//sparse ids take a fraction of the memory of a hash set
+		roaring_bitmap bitmap;
+		for(u32 i = 0; i < 1000000; ++i)
+			bitmap.insert(i * 13);
+		CHECK(bitmap.cardinality() == 1000000);
+		CHECK(bitmap.memory_size() < 1000000 * 3);
+	}
+}
@@ -0,0 +1,152 @@
+#include "catch.hpp"
+#include <cpprelude/algorithm.h>
+#include <cpprelude/dlinked_list.h>
+
+using namespace cpprelude;
+
+TEST_CASE("set algorithms test", "[set_algorithms]")
+{
+	auto same = [](const dynamic_array<u32>& a, std::initializer_list<u32> b) {
+		if(a.count() != b.size())
+			return false;
+		usize i = 0;
+		for(auto value: b)
+			if(a[i++] != value)
+				return false;
+		return true;
+	};
+
+	SECTION("Case 01")
+	{
+		dynamic_array<u32> a = {1, 3, 5, 7, 9, 11};
+		dynamic_array<u32> b = {2, 3, 4, 5, 11, 12};
+		dynamic_array<u32> result;
+
+		CHECK(sorted_intersection(a.begin(), a.count(), b.begin(), b.count(), result) == 3);
+		CHECK(same(result, {3, 5, 11}));
+
+		result.clear();
+		CHECK(sorted_union(a.begin(), a.count(), b.begin(), b.count(), result) == 9);
+		CHECK(same(result, {1, 2, 3, 4, 5, 7, 9, 11, 12}));
+
+		result.clear();
+		CHECK(sorted_difference(a.begin(), a.count(), b.begin(), b.count(), result) == 3);
+		CHECK(same(result, {1, 7, 9}));
+
+		result.clear();
+		CHECK(galloping_intersection(a.begin(), a.count(), b.begin(), b.count(), result) == 3);
+		CHECK(same(result, {3, 5, 11}));
+
+		result.clear();
+		CHECK(sorted_intersection(a.data(), a.count(), b.data(), 0, result) == 0);
+		CHECK(sorted_union(a.begin(), 0, b.begin(), 2, result) == 2);
+		CHECK(same(result, {2, 3}));
+
+		//other containers and comparators work as long as they're sorted by the same criteria
+		dlinked_list<u32> list = {12, 9, 5, 3};
+		dynamic_array<u32> descending = {11, 9, 4, 3};
+		result.clear();
+		CHECK(sorted_intersection(list.begin(), list.count(), descending.begin(), descending.count(),
+								  result, [](u32 a, u32 b) { return a > b; }) == 2);
+		CHECK(same(result, {9, 3}));
+	}
+
+	SECTION("Case 02")
+	{
+		//the integer kernels against the generic merge on random sets of different densities and sizes
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		auto random_set = [&random](usize count, u64 range, dynamic_array<u32>& narrow, dynamic_array<u64>& wide) {
+			narrow.clear();
+			wide.clear();
+			u64 value = 0;
+			for(usize i = 0; i < count; ++i)
+			{
+				value += 1 + random() % range;
+				narrow.insert_back(u32(value));
+				wide.insert_back(value << 20);
+			}
+		};
+
+		const usize sizes[][2] = {{1000, 1000}, {1000, 37}, {5, 20000}, {3, 3}, {0, 100}, {4096, 4000}};
+		const u64 ranges[] = {1, 2, 4, 16};
+
+		bool valid = true;
+		for(auto size: sizes)
+		{
+			for(auto range: ranges)
+			{
+				dynamic_array<u32> a32, b32, expected32, result32;
+				dynamic_array<u64> a64, b64, expected64, result64;
+				random_set(size[0], range, a32, a64);
+				random_set(size[1], range * 2, b32, b64);
+
+				sorted_intersection(a32.begin(), a32.count(), b32.begin(), b32.count(), expected32);
+				sorted_intersection(a64.begin(), a64.count(), b64.begin(), b64.count(), expected64);
+
+				valid &= sorted_intersection(a32.data(), a32.count(), b32.data(), b32.count(), result32) == expected32.count();
+				valid &= sorted_intersection(a64.data(), a64.count(), b64.data(), b64.count(), result64) == expected64.count();
+				valid &= result32.count() == expected32.count() && result64.count() == expected64.count();
+				for(usize i = 0; i < expected32.count() && i < result32.count(); ++i)
+					valid &= result32[i] == expected32[i];
+				for(usize i = 0; i < expected64.count() && i < result64.count(); ++i)
+					valid &= result64[i] == expected64[i];
+
+				result32.clear();
+				galloping_intersection(b32.begin(), b32.count(), a32.begin(), a32.count(), result32);
+				valid &= result32.count() == expected32.count();
+				for(usize i = 0; i < expected32.count() && i < result32.count(); ++i)
+					valid &= result32[i] == expected32[i];
+
+				//|a| + |b| = |a or b| + |a and b| and |a - b| = |a| - |a and b|
+				dynamic_array<u32> merged, difference;
+				sorted_union(a32.begin(), a32.count(), b32.begin(), b32.count(), merged);
+				sorted_difference(a32.begin(), a32.count(), b32.begin(), b32.count(), difference);
+				valid &= merged.count() + expected32.count() == a32.count() + b32.count();
+				valid &= difference.count() + expected32.count() == a32.count();
+				valid &= is_sorted(merged.begin(), merged.count());
+			}
+		}
+		CHECK(valid);
+	}
+
+	SECTION("Case 03")
+	{
+		dynamic_array<u32> a = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+		dynamic_array<u32> b = {2, 4, 6, 8, 10, 12};
+		dynamic_array<u32> c = {4, 8, 12, 16};
+		dynamic_array<u32> d = {0, 4, 8};
+
+		using run = sorted_run<sequential_iterator<u32>>;
+		run runs[] = {make_sorted_run(a.begin(), a.count()),
+					  make_sorted_run(b.begin(), b.count()),
+					  make_sorted_run(c.begin(), c.count()),
+					  make_sorted_run(d.begin(), d.count())};
+
+		dynamic_array<u32> result;
+		CHECK(kway_intersection(runs, 4, result) == 2);
+		CHECK(same(result, {4, 8}));
+
+		result.clear();
+		CHECK(kway_union(runs, 4, result) == 13);
+		CHECK(same(result, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 16}));
+
+		result.clear();
+		CHECK(kway_intersection(runs, 1, result) == 10);
+		CHECK(kway_intersection(runs, 0, result) == 0);
+		CHECK(kway_union(runs, 0, result) == 0);
+		CHECK(result.count() == 10);
+
+		//an empty run empties the intersection
+		run with_empty[] = {runs[0], make_sorted_run(b.begin(), 0)};
+		result.clear();
+		CHECK(kway_intersection(with_empty, 2, result) == 0);
+		CHECK(kway_union(with_empty, 2, result) == 10);
+	}
+}
@@ -1,8 +1,35 @@
 #include "catch.hpp"
 #include <cpprelude/slinked_list.h>
+#include <cpprelude/dynamic_array.h>
 
 using namespace cpprelude;
 
+namespace
+{
+	//forwards to the global memory and counts the live allocations
+	struct live_memory
+	{
+		isize live = 0;
+		memory_context context;
+
+		live_memory()
+		{
+			context._self = this;
+			context._alloc = [](void* self, usize size) {
+				++reinterpret_cast<live_memory*>(self)->live;
+				return platform->global_memory->_alloc(platform->global_memory->_self, size);
+			};
+			context._realloc = [](void* self, slice<byte>& data, usize size) {
+				platform->global_memory->_realloc(platform->global_memory->_self, data, size);
+			};
+			context._free = [](void* self, slice<byte>& data) {
+				--reinterpret_cast<live_memory*>(self)->live;
+				platform->global_memory->_free(platform->global_memory->_self, data);
+			};
+		}
+	};
+}
+
 TEST_CASE("slinked_list test", "[slinked_list]")
 {
 	slinked_list<i32> array;
@@ -262,4 +289,133 @@ TEST_CASE("slinked_list test", "[slinked_list]")
 			CHECK(*it == 0);
 		}
 	}
-}
\ No newline at end of file
+
+	SECTION("Case 15")
+	{
+		//sort by the tens digit only so the stability is visible
+		auto tens_less = [](i32 a, i32 b) { return a / 10 < b / 10; };
+		for(i32 i = 0; i < 1000; ++i)
+			array.insert_front((i * 7919) % 1000);
+
+		dynamic_array<i32*> addresses;
+		dynamic_array<usize> position(1000, usize(0));
+		usize index = 0;
+		for(auto& value: array)
+		{
+			addresses.insert_back(&value);
+			position[value] = index++;
+		}
+
+		array.sort(tens_less);
+		CHECK(array.count() == 1000);
+
+		//the nodes are relinked, so the elements stay at the same addresses
+		for(usize i = 0; i < addresses.count(); ++i)
+			CHECK(position[*addresses[i]] == i);
+
+		//elements with equal tens keep their original order
+		i32 last = -1;
+		for(auto it = array.begin(); it != array.end(); ++it)
+		{
+			CHECK(last / 10 <= *it / 10);
+			if(last != -1 && last / 10 == *it / 10)
+				CHECK(position[last] < position[*it]);
+			last = *it;
+		}
+
+		array.sort();
+		i32 expected = 0;
+		for(auto& value: array)
+			CHECK(value == expected++);
+	}
+
+	SECTION("Case 16")
+	{
+		slinked_list<i32> other;
+		array.insert_front({1, 3, 5, 7});
+		other.insert_front({0, 3, 4, 8, 9});
+
+		array.merge(other);
+		CHECK(other.empty());
+		CHECK(array.count() == 9);
+
+		i32 expected[] = {0, 1, 3, 3, 4, 5, 7, 8, 9};
+		usize i = 0;
+		for(auto& value: array)
+			CHECK(value == expected[i++]);
+
+		//move the 3 elements after 1 to another list then back to the front
+		other.insert_front(100);
+		other.splice_after(other.begin(), array, ++array.begin(), 3);
+		CHECK(array.count() == 6);
+		CHECK(other.count() == 4);
+		CHECK(other[1] == 1);
+		CHECK(other[3] == 3);
+
+		array.splice_front(other);
+		CHECK(other.empty());
+		CHECK(array.count() == 10);
+		CHECK(array[0] == 100);
+		CHECK(array[4] == 0);
+
+		other.insert_front(-1);
+		other.splice_front(array, array.begin(), 2);
+		CHECK(other.count() == 3);
+		CHECK(other[0] == 100);
+		CHECK(other[2] == -1);
+
+		array.reset();
+		CHECK(array.begin() == array.end());
+		array.splice_after(array.end(), other, other.begin(), 0);
+		CHECK(array.empty());
+	}
+	SECTION("Case 17")
+	{
+		//lists of different memory contexts copy the elements instead of relinking the nodes
+		live_memory memory;
+		{
+			slinked_list<i32> other(&memory.context);
+			array.insert_front({1, 5, 9});
+			other.insert_front({2, 3, 4, 10});
+
+			array.merge(other);
+			CHECK(other.empty());
+			CHECK(memory.live == 0);
+			CHECK(array.count() == 7);
+			i32 expected[] = {1, 2, 3, 4, 5, 9, 10};
+			usize i = 0;
+			for(auto& value: array)
+				CHECK(value == expected[i++]);
+
+			//move [2, 3] after the head of the other list then back
+			other.insert_front(100);
+			other.splice_after(other.begin(), array, ++array.begin(), 2);
+			CHECK(array.count() == 5);
+			CHECK(other.count() == 3);
+			CHECK(memory.live == 3);
+			CHECK(other[1] == 2);
+			CHECK(array[1] == 4);
+
+			array.splice_after(array.begin(), other);
+			CHECK(other.empty());
+			CHECK(memory.live == 0);
+			CHECK(array.count() == 8);
+			CHECK(array[1] == 100);
+			CHECK(array[3] == 3);
+
+			other.insert_front(-1);
+			other.splice_front(array, array.begin(), 2);
+			CHECK(other.count() == 3);
+			CHECK(other[1] == 100);
+			CHECK(memory.live == 3);
+
+			array.splice_front(other);
+			CHECK(other.empty());
+			CHECK(memory.live == 0);
+			CHECK(array.count() == 9);
+			CHECK(array[0] == 1);
+			CHECK(array[2] == -1);
+		}
+		CHECK(memory.live == 0);
+	}
+}
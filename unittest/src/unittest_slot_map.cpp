@@ -0,0 +1,101 @@
+#include "catch.hpp"
+#include <cpprelude/slot_map.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+TEST_CASE("slot_map test", "[slot_map]")
+{
+	SECTION("Case 01")
+	{
+		slot_map<i32> map;
+		CHECK(map.empty());
+
+		auto a = map.insert(1);
+		auto b = map.insert(2);
+		auto c = map.emplace(3);
+		CHECK(map.count() == 3);
+		CHECK(map[a] == 1);
+		CHECK(*map.get(c) == 3);
+
+		//removing from the middle moves the last value but its handle keeps working
+		CHECK(map.remove(a));
+		CHECK(!map.remove(a));
+		CHECK(!map.contains(a));
+		CHECK(map.get(a) == nullptr);
+		CHECK(map.count() == 2);
+		CHECK(map[c] == 3);
+		CHECK(map[b] == 2);
+
+		//the freed slot is reused with a new generation
+		auto d = map.insert(4);
+		CHECK(d.index == a.index);
+		CHECK(d != a);
+		CHECK(!map.contains(a));
+		CHECK(map[d] == 4);
+
+		i32 sum = 0;
+		for(auto value: map)
+			sum += value;
+		CHECK(sum == 9);
+
+		for(usize i = 0; i < map.count(); ++i)
+			CHECK(map[map.handle_of(i)] == map._values[i]);
+
+		map.clear();
+		CHECK(map.empty());
+		CHECK(!map.contains(b));
+		CHECK(!map.contains(d));
+		auto e = map.insert(5);
+		CHECK(map.count() == 1);
+		CHECK(map[e] == 5);
+	}
+
+	SECTION("Case 02")
+	{
+		//random inserts and removes against the handles that should still be alive
+		struct entry
+		{
+			slot_map<string>::handle value_handle;
+			bool odd;
+		};
+
+		slot_map<string> map;
+		dynamic_array<entry> alive;
+		dynamic_array<slot_map<string>::handle> dead;
+
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		bool valid = true;
+		for(usize i = 0; i < 20000; ++i)
+		{
+			if(alive.count() > 0 && random() % 3 == 0)
+			{
+				usize index = random() % alive.count();
+				auto value_handle = alive[index].value_handle;
+				valid &= map.remove(value_handle);
+				alive[index] = alive[alive.count() - 1];
+				alive.remove_back();
+				dead.insert_back(value_handle);
+			}
+			else
+			{
+				bool odd = i % 2;
+				alive.insert_back(entry{map.emplace(odd ? "odd" : "even"), odd});
+			}
+		}
+
+		for(auto value: alive)
+			valid &= map.contains(value.value_handle) && *map.get(value.value_handle) == (value.odd ? "odd" : "even");
+		for(auto value_handle: dead)
+			valid &= !map.contains(value_handle);
+		CHECK(valid);
+		CHECK(map.count() == alive.count());
+	}
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <cpprelude/stack_list.h>
+#include <cpprelude/unrolled_list.h>
 
 using namespace cpprelude;
 
@@ -86,4 +87,20 @@ TEST_CASE("stack_list test", "[stack_list]")
 		CHECK(arr.count() == 0);
 	}
 
-}
\ No newline at end of file
+	SECTION("Case 05")
+	{
+		stack_list<usize, unrolled_list<usize>> arr;
+
+		for (usize i = 0; i < 1000; i++)
+			arr.push(i);
+		CHECK(arr.count() == 1000);
+
+		for (usize i = 1000; i > 0; i--)
+		{
+			CHECK(arr.top() == i - 1);
+			CHECK(arr.pop());
+		}
+		CHECK(arr.empty());
+		CHECK(arr.pop() == false);
+	}
+}
@@ -0,0 +1,182 @@
+#include "catch.hpp"
+#include <cpprelude/timing_wheel.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+TEST_CASE("timing_wheel test", "[timing_wheel]")
+{
+	SECTION("Case 01")
+	{
+		timing_wheel<i32> wheel;
+		dynamic_array<i32> expired;
+
+		auto a = wheel.schedule_at_tick(10, 1);
+		wheel.schedule_at_tick(10, 2);
+		wheel.schedule_at_tick(100, 3);
+		auto d = wheel.schedule_at_tick(5000, 4);
+		wheel.schedule_at_tick(0, 5);
+		CHECK(wheel.count() == 5);
+		CHECK(wheel.armed(a));
+
+		//a tick that's already reached expires on the next advance
+		CHECK(wheel.advance(1, expired) == 1);
+		CHECK(expired[0] == 5);
+
+		CHECK(wheel.advance(9, expired) == 0);
+		CHECK(wheel.advance(10, expired) == 2);
+		CHECK(!wheel.armed(a));
+		CHECK(!wheel.cancel(a));
+
+		CHECK(wheel.cancel(d));
+		CHECK(!wheel.armed(d));
+		CHECK(wheel.next_event_tick() <= 100);
+
+		CHECK(wheel.advance(1000000, expired) == 1);
+		CHECK(expired.count() == 4);
+		CHECK(expired[3] == 3);
+		CHECK(wheel.empty());
+		CHECK(wheel.now() == 1000000);
+		CHECK(wheel.next_event_tick() == u64(-1));
+
+		//the freed nodes are reused but the old handles stay invalid
+		for(i32 i = 0; i < 4; ++i)
+			wheel.schedule_at_tick(1000001, i);
+		CHECK(!wheel.armed(a));
+		CHECK(!wheel.armed(d));
+		CHECK(!wheel.cancel(d));
+		CHECK(wheel.count() == 4);
+
+		//advancing to the end of time returns
+		CHECK(wheel.advance(u64(-1), expired) == 4);
+		CHECK(wheel.empty());
+		CHECK(wheel.advance(u64(-1), expired) == 0);
+		CHECK(wheel.now() == u64(-1));
+	}
+
+	SECTION("Case 02")
+	{
+		//random deadlines on all the levels checked against the ticks they should fire at
+		timing_wheel<u32> wheel;
+		dynamic_array<u64> deadlines;
+		dynamic_array<timing_wheel<u32>::handle> handles;
+		dynamic_array<bool> cancelled;
+
+		u64 seed = 88172645463325252ULL;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return seed;
+		};
+
+		constexpr u32 count = 20000;
+		for(u32 i = 0; i < count; ++i)
+		{
+			u64 range = u64(1) << (random() % 40);
+			u64 deadline = 1 + random() % range;
+			deadlines.insert_back(deadline);
+			handles.insert_back(wheel.schedule_at_tick(deadline, i));
+			cancelled.insert_back(false);
+		}
+
+		for(u32 i = 0; i < count; i += 7)
+		{
+			CHECK(wheel.cancel(handles[i]));
+			cancelled[i] = true;
+		}
+
+		dynamic_array<u32> expired;
+		dynamic_array<bool> fired(count, false);
+		u64 now = 0;
+		bool on_time = true;
+		while(!wheel.empty())
+		{
+			u64 next = now + 1 + random() % (u64(1) << (random() % 36));
+			expired.clear();
+			wheel.advance(next, expired);
+			for(auto id: expired)
+			{
+				on_time &= !cancelled[id] && !fired[id];
+				on_time &= deadlines[id] > now && deadlines[id] <= next;
+				fired[id] = true;
+			}
+			now = next;
+		}
+		CHECK(on_time);
+
+		bool all_fired = true;
+		for(u32 i = 0; i < count; ++i)
+			all_fired &= fired[i] != cancelled[i];
+		CHECK(all_fired);
+	}
+
+	SECTION("Case 03")
+	{
+		//1 microsecond ticks driven by the monotonic clock
+		timing_wheel<string> wheel(1000);
+		u64 start = platform->monotonic_time();
+		wheel.schedule(0, string("now"));
+		wheel.schedule(2000, string("later"));
+		auto never = wheel.schedule(3600000000000ULL, string("never"));
+
+		dynamic_array<string> expired;
+		while(expired.count() < 2)
+			wheel.poll(expired);
+
+		CHECK(platform->monotonic_time() - start >= 2000);
+		CHECK(expired[0] == "now");
+		CHECK(expired[1] == "later");
+		CHECK(wheel.count() == 1);
+		CHECK(wheel.cancel(never));
+	}
+
+	SECTION("Case 04")
+	{
+		//cancelled timers destroy their values right away, not when their nodes get reused
+		struct tracked
+		{
+			i32* live;
+
+			tracked(i32* live_)
+				:live(live_)
+			{
+				++*live;
+			}
+
+			tracked(tracked&& other)
+				:live(other.live)
+			{
+				++*live;
+			}
+
+			~tracked()
+			{
+				--*live;
+			}
+		};
+
+		i32 live = 0;
+		{
+			timing_wheel<tracked> wheel;
+			auto a = wheel.schedule_at_tick(10, tracked(&live));
+			wheel.schedule_at_tick(20, tracked(&live));
+			wheel.schedule_at_tick(30, tracked(&live));
+			CHECK(live == 3);
+
+			CHECK(wheel.cancel(a));
+			CHECK(live == 2);
+
+			{
+				dynamic_array<tracked> expired;
+				CHECK(wheel.advance(20, expired) == 1);
+				CHECK(live == 2);
+			}
+			CHECK(live == 1);
+
+			wheel.schedule_at_tick(40, tracked(&live));
+			CHECK(live == 2);
+		}
+		CHECK(live == 0);
+	}
+}
@@ -676,4 +676,247 @@ TEST_CASE("tree_map test", "[tree_map]")
 		CHECK(str_map.empty() == false);
 		CHECK(str_map.count() == 6);
 	}
+
+	SECTION("Case 25")
+	{
+		dynamic_array<usize> sorted;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			sorted.insert_back(i * 2);
+			if(i % 7 == 0)
+				sorted.insert_back(i * 2);
+		}
+
+		for(usize count = 0; count < 70; ++count)
+		{
+			tree_set<usize> tree(sorted.begin(), count);
+			CHECK(tree._is_red_black_tree());
+			CHECK((tree.empty() || tree.root().node->color == details::red_black_tree_node<usize>::BLACK));
+		}
+
+		tree_set<usize> tree(sorted.begin(), sorted.count());
+		CHECK(tree.count() == 1000);
+		CHECK(tree._is_red_black_tree());
+
+		usize expected = 0;
+		for(const auto& value: tree)
+		{
+			CHECK(value == expected);
+			expected += 2;
+		}
+
+		for(usize i = 0; i < 1000; i += 3)
+			tree.remove(i * 2);
+		for(usize i = 1; i < 2000; i += 2)
+			tree.insert(i);
+		CHECK(tree._is_red_black_tree());
+		CHECK(tree.count() == 1666);
+
+		tree.clear();
+		CHECK(tree.empty());
+	}
+
+	SECTION("Case 26")
+	{
+		tree_set<i32> a, b;
+		for(i32 i = 0; i < 500; ++i)
+		{
+			if(i % 2 == 0)
+				a.insert(i);
+			if(i % 3 == 0)
+				b.insert(i);
+		}
+
+		tree_set<i32> copy(b);
+		CHECK(copy._is_red_black_tree());
+		CHECK(copy.count() == b.count());
+
+		a.merge(b);
+		CHECK(a._is_red_black_tree());
+		CHECK(b.count() == 167);
+
+		usize expected_count = 0;
+		for(i32 i = 0; i < 500; ++i)
+		{
+			bool expected = (i % 2 == 0) || (i % 3 == 0);
+			CHECK((a.lookup(i) != a.end()) == expected);
+			if(expected)
+				++expected_count;
+		}
+		CHECK(a.count() == expected_count);
+
+		tree_set<i32> c{ -5, 1000, 6, 7 };
+		a.merge(std::move(c));
+		CHECK(c.empty());
+		CHECK(a._is_red_black_tree());
+		CHECK(a.count() == expected_count + 3);
+		CHECK(*a.min() == -5);
+		CHECK(*a.max() == 1000);
+
+		for(i32 i = -5; i <= 1000; ++i)
+			a.remove(i);
+		CHECK(a.empty());
+
+		tree_set<i32> d;
+		d.merge(std::move(copy));
+		CHECK(d.count() == 167);
+		CHECK(copy.empty());
+	}
+
+	SECTION("Case 27")
+	{
+		using pair_type = details::pair_node<usize, usize>;
+		dynamic_array<pair_type> sorted;
+		for(usize i = 0; i < 100; ++i)
+			sorted.insert_back(pair_type(i, i * i));
+
+		tree_map<usize, usize> map(sorted.begin(), sorted.count());
+		CHECK(map._is_red_black_tree());
+		CHECK(map.count() == 100);
+		CHECK(map[9] == 81);
+
+		tree_map<usize, usize> other;
+		other[500] = 1;
+		other[9] = 1;
+		map.merge(other);
+		CHECK(map.count() == 101);
+		CHECK(map[9] == 81);
+		CHECK(map[500] == 1);
+	}
+	SECTION("Case 28")
+	{
+		tree_set<i32> tree{ 10, 20, 30, 40 };
+
+		CHECK(*tree.lower_bound(20) == 20);
+		CHECK(*tree.lower_bound(21) == 30);
+		CHECK(*tree.upper_bound(20) == 30);
+		CHECK(*tree.lower_bound(-100) == 10);
+		CHECK(tree.lower_bound(41) == tree.end());
+		CHECK(tree.upper_bound(40) == tree.end());
+
+		auto range = tree.equal_range(30);
+		CHECK(*range.first == 30);
+		CHECK(*range.last == 40);
+		CHECK(tree.equal_range(35).empty());
+
+		tree_map<usize, usize> map;
+		for(usize i = 0; i < 100; i += 10)
+			map[i] = i * 2;
+		CHECK(map.lower_bound(15).value() == 40);
+		CHECK(map.upper_bound(20).key() == 30);
+
+		usize sum = 0;
+		for(auto it = map.lower_bound(20); it != map.upper_bound(50); ++it)
+			sum += it.value();
+		CHECK(sum == 40 + 60 + 80 + 100);
+	}
+
+	SECTION("Case 29")
+	{
+		rank_tree_set<u32> tree;
+		dynamic_array<bool> reference;
+		for(usize i = 0; i < 1024; ++i)
+			reference.insert_back(false);
+
+		u32 seed = 3;
+		for(usize i = 0; i < 6000; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			u32 value = (seed >> 8) % 1024;
+			if(seed & 0x40000000)
+			{
+				tree.insert(value);
+				reference[value] = true;
+			}
+			else
+			{
+				tree.remove(value);
+				reference[value] = false;
+			}
+		}
+		CHECK(tree._is_red_black_tree());
+
+		usize rank = 0;
+		for(u32 i = 0; i < 1024; ++i)
+		{
+			CHECK(tree.rank(i) == rank);
+			if(reference[i])
+			{
+				CHECK(*tree.select(rank) == i);
+				++rank;
+			}
+		}
+		CHECK(rank == tree.count());
+		CHECK(tree.select(rank) == tree.end());
+
+		usize expected = 0;
+		for(u32 i = 100; i < 600; ++i)
+			if(reference[i])
+				++expected;
+		CHECK(tree.count_range(100, 600) == expected);
+		CHECK(tree.count_range(600, 100) == 0);
+
+		dynamic_array<u32> sorted;
+		for(u32 i = 0; i < 500; ++i)
+			sorted.insert_back(i * 3);
+		rank_tree_set<u32> bulk(sorted.begin(), sorted.count());
+		CHECK(bulk.rank(300) == 100);
+		CHECK(*bulk.select(250) == 750);
+		bulk.merge(tree);
+		CHECK(bulk._is_red_black_tree());
+		CHECK(bulk.rank(0xFFFFFFFF) == bulk.count());
+
+		rank_tree_map<string, usize> map;
+		map["c"] = 3;
+		map["a"] = 1;
+		map["b"] = 2;
+		CHECK(map.rank("b") == 1);
+		CHECK(map.select(2).value() == 3);
+		CHECK(map.count_range("a", "c") == 2);
+	}
+
+	SECTION("Case 30")
+	{
+		interval_tree<i32> tree;
+		dynamic_array<interval<i32>> reference;
+
+		u32 seed = 5;
+		for(usize i = 0; i < 500; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			i32 low = (seed >> 8) % 1000;
+			i32 high = low + (seed >> 20) % 50;
+			if(tree.lookup(interval<i32>(low, high)) == tree.end())
+				reference.insert_back(interval<i32>(low, high));
+			tree.insert(interval<i32>(low, high));
+		}
+
+		//remove every other interval to exercise the delete fixups
+		for(usize i = 0; i < reference.count(); i += 2)
+			tree.remove(reference[i]);
+		CHECK(tree._is_red_black_tree());
+
+		for(i32 point = -10; point < 1100; point += 7)
+		{
+			interval<i32> query(point, point + 5);
+
+			usize expected = 0;
+			for(usize i = 1; i < reference.count(); i += 2)
+				if(reference[i].overlaps(query))
+					++expected;
+
+			usize found = 0;
+			tree.overlap_traverse(query, [&found, &query](interval_tree<i32>::const_iterator it, void*) {
+				CHECK(it->overlaps(query));
+				++found;
+			});
+			CHECK(found == expected);
+
+			auto it = tree.lookup_overlap(query);
+			if(expected == 0)
+				CHECK(it == tree.end());
+			else
+				CHECK(it->overlaps(query));
+		}
+	}
 }
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+#include <cpprelude/unrolled_list.h>
+#include <cpprelude/dlinked_list.h>
+#include <cpprelude/string.h>
+
+using namespace cpprelude;
+
+TEST_CASE("unrolled_list test", "[unrolled_list]")
+{
+	SECTION("Case 01")
+	{
+		unrolled_list<i32> list;
+		CHECK(list.empty());
+		CHECK(list.begin() == list.end());
+
+		for(i32 i = 0; i < 1000; ++i)
+			list.insert_back(i);
+		for(i32 i = -1; i >= -1000; --i)
+			list.insert_front(i);
+		CHECK(list.count() == 2000);
+
+		i32 expected = -1000;
+		for(const auto& value: list)
+			CHECK(value == expected++);
+		CHECK(expected == 1000);
+
+		for(usize i = 0; i < list.count(); i += 37)
+			CHECK(list[i] == i32(i) - 1000);
+
+		auto it = list.end();
+		for(i32 i = 999; i >= -1000; --i)
+			CHECK(*--it == i);
+		CHECK(it == list.begin());
+
+		list.remove_front(500);
+		list.remove_back(500);
+		CHECK(list.count() == 1000);
+		CHECK(*list.front() == -500);
+		CHECK(*list.back() == 499);
+	}
+
+	SECTION("Case 02")
+	{
+		//a small capacity to exercise the node splits and merges
+		unrolled_list<i32, 4> list;
+		dlinked_list<i32> reference;
+
+		u32 seed = 2463534242;
+		auto random = [&seed]() {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			return seed;
+		};
+
+		for(i32 i = 0; i < 3000; ++i)
+		{
+			usize index = reference.count() == 0 ? 0 : random() % reference.count();
+			auto it = list.begin();
+			auto ref_it = reference.begin();
+			for(usize j = 0; j < index; ++j, ++it, ++ref_it);
+
+			switch(random() % 4)
+			{
+				case 0:
+					list.insert_before(it, i);
+					reference.insert_before(ref_it, i);
+					break;
+				case 1:
+					if(reference.count() > 0)
+					{
+						list.insert_after(it, i);
+						reference.insert_after(ref_it, i);
+					}
+					break;
+				case 2:
+					if(reference.count() > 0)
+					{
+						list.remove(it);
+						reference.remove(ref_it);
+					}
+					break;
+				default:
+					list.insert_back(i);
+					reference.insert_back(i);
+					break;
+			}
+		}
+
+		CHECK(list.count() == reference.count());
+		auto ref_it = reference.begin();
+		for(auto it = list.begin(); it != list.end(); ++it, ++ref_it)
+			CHECK(*it == *ref_it);
+	}
+
+	SECTION("Case 03")
+	{
+		unrolled_list<string> list{"b", "c"};
+		list.insert_front({"a"});
+		list.emplace_back("d");
+
+		unrolled_list<string> copy(list);
+		unrolled_list<string> moved(std::move(list));
+		CHECK(list.empty());
+		CHECK(moved.count() == 4);
+		CHECK(copy.count() == 4);
+
+		list = copy;
+		CHECK(list.count() == 4);
+		CHECK(list[0] == "a");
+		CHECK(list[3] == "d");
+
+		auto continuous = copy.decay_continuous();
+		CHECK(copy.empty());
+		CHECK(continuous[2] == "c");
+		for(usize i = 0; i < 4; ++i)
+			continuous[i].~string();
+		platform->global_memory->free(continuous);
+	}
+}
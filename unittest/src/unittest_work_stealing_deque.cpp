@@ -0,0 +1,138 @@
+#include "catch.hpp"
+#include <cpprelude/work_stealing_deque.h>
+#include <cpprelude/dynamic_array.h>
+#include <thread>
+
+using namespace cpprelude;
+
+TEST_CASE("work_stealing_deque test", "[work_stealing_deque]")
+{
+	SECTION("Case 01")
+	{
+		work_stealing_deque<i32> deque(4);
+		CHECK(deque.capacity() == 4);
+		CHECK(deque.empty());
+
+		i32 value = -1;
+		CHECK(!deque.pop(value));
+		CHECK(!deque.steal(value));
+
+		for(i32 i = 0; i < 100; ++i)
+			deque.push(i);
+		CHECK(deque.count() == 100);
+		CHECK(deque.capacity() == 128);
+
+		//the owner gets the newest values and the thieves get the oldest
+		CHECK(deque.pop(value));
+		CHECK(value == 99);
+		CHECK(deque.steal(value));
+		CHECK(value == 0);
+		CHECK(deque.steal(value));
+		CHECK(value == 1);
+
+		i32 expected = 98;
+		while(deque.pop(value))
+			CHECK(value == expected--);
+		CHECK(expected == 1);
+		CHECK(deque.empty());
+
+		deque.push(7);
+		CHECK(deque.steal(value));
+		CHECK(value == 7);
+		CHECK(!deque.pop(value));
+	}
+
+	SECTION("Case 02")
+	{
+		constexpr usize thieves_count = 3;
+		constexpr usize total = 200000;
+		work_stealing_deque<usize> deque(16);
+		dynamic_array<std::atomic<u32>> taken(total);
+		for(usize i = 0; i < total; ++i)
+			taken[i].store(0);
+
+		std::atomic<bool> done(false);
+		std::atomic<usize> stolen(0);
+		std::thread thieves[thieves_count];
+		for(auto& thief: thieves)
+		{
+			thief = std::thread([&]() {
+				usize value;
+				while(!done.load())
+				{
+					if(deque.steal(value))
+					{
+						taken[value].fetch_add(1);
+						++stolen;
+					}
+				}
+			});
+		}
+
+		usize popped = 0;
+		usize value;
+		for(usize i = 0; i < total; ++i)
+		{
+			deque.push(i);
+			//pop every few pushes to race the thieves at the bottom
+			if(i % 3 == 0 && deque.pop(value))
+			{
+				taken[value].fetch_add(1);
+				++popped;
+			}
+		}
+		while(deque.pop(value))
+		{
+			taken[value].fetch_add(1);
+			++popped;
+		}
+		while(popped + stolen.load() < total);
+		done.store(true);
+		for(auto& thief: thieves)
+			thief.join();
+
+		bool exactly_once = true;
+		for(usize i = 0; i < total; ++i)
+			exactly_once &= taken[i].load() == 1;
+		CHECK(exactly_once);
+		CHECK(popped + stolen.load() == total);
+		CHECK(deque.empty());
+	}
+
+	SECTION("Case 03")
+	{
+		//more thieves than epoch slots in a chunk, the slots are all held before they start
+		//so every steal has to pin a slot from a new chunk instead of waiting for one to be free
+		constexpr usize thieves_count = 100;
+		constexpr usize total = 5000;
+		work_stealing_deque<usize> deque(16);
+		for(usize i = 0; i < total; ++i)
+			deque.push(i);
+
+		dynamic_array<usize> held;
+		for(usize i = 0; i < epoch_domain::slots_count; ++i)
+			held.insert_back(deque._epoch.pin());
+
+		std::atomic<usize> stolen(0);
+		std::thread thieves[thieves_count];
+		for(auto& thief: thieves)
+		{
+			thief = std::thread([&]() {
+				usize value;
+				while(deque.steal(value))
+					++stolen;
+			});
+		}
+		for(auto& thief: thieves)
+			thief.join();
+
+		for(auto slot: held)
+			deque._epoch.unpin(slot);
+
+		usize value;
+		usize popped = 0;
+		while(deque.pop(value))
+			++popped;
+		CHECK(stolen.load() + popped == total);
+	}
+}